@@ -0,0 +1,53 @@
+/**
+* @file      BenchUtils.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark utilities.
+*/
+
+#ifndef BENCODING_BENCH_UTILS_H
+#define BENCODING_BENCH_UTILS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+
+namespace bencoding {
+namespace bench {
+
+/**
+* @brief Runs @a f @a repetitions times and returns the shortest run time in
+*        seconds.
+*/
+template <typename F>
+double measure(F f, std::size_t repetitions = 5) {
+	double best = std::numeric_limits<double>::max();
+	for (std::size_t i = 0; i < repetitions; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		double elapsed = std::chrono::duration<double>(end - start).count();
+		if (elapsed < best) {
+			best = elapsed;
+		}
+	}
+	return best;
+}
+
+/**
+* @brief Returns the number given as the @a index-th argument of the program,
+*        or @a defaultValue when there is no such argument.
+*/
+inline std::size_t getNumArg(int argc, char **argv, int index,
+		std::size_t defaultValue) {
+	if (argc <= index) {
+		return defaultValue;
+	}
+	return std::strtoul(argv[index], nullptr, 10);
+}
+
+} // namespace bench
+} // namespace bencoding
+
+#endif
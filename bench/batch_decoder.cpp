@@ -0,0 +1,116 @@
+/**
+* @file      batch_decoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: scaling of batch decoding with the number of threads.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BatchDecoder.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates a torrent-like file with a file list of the given length.
+*/
+std::string createTorrent(std::size_t id, std::size_t numOfFiles) {
+	std::string files;
+	for (std::size_t i = 0; i < numOfFiles; ++i) {
+		std::string path("file" + std::to_string(i) + ".dat");
+		files += "d6:lengthi" + std::to_string(i * 1000 + 1) + "e4:pathl" +
+			std::to_string(path.size()) + ":" + path + "ee";
+	}
+	std::string name("torrent" + std::to_string(id));
+	return "d8:announce31:http://tracker.example/announce4:infod5:filesl" +
+		files + "e4:name" + std::to_string(name.size()) + ":" + name +
+		"12:piece lengthi262144e6:pieces20:" + std::string(20, 'x') + "ee";
+}
+
+/**
+* @brief Creates a KRPC-like response with a list of compact node infos.
+*/
+std::string createKrpcPacket(std::size_t id) {
+	return "d1:rd2:id20:" + std::string(20, static_cast<char>(id)) +
+		"5:nodes208:" + std::string(208, 'n') + "5:token8:abcdefghe"
+		"1:t2:aa1:y1:re";
+}
+
+/**
+* @brief Creates the given number of documents of mixed types and sizes.
+*/
+std::vector<std::string> createDocuments(std::size_t numOfDocuments) {
+	std::vector<std::string> documents;
+	for (std::size_t i = 0; i < numOfDocuments; ++i) {
+		// Every tenth document is a torrent (some of them large), the other
+		// ones are small KRPC packets.
+		documents.push_back(i % 10 == 0 ?
+			createTorrent(i, 1 + (i * 7919) % 200) : createKrpcPacket(i));
+	}
+	return documents;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfDocuments = getNumArg(argc, argv, 1, 200000);
+	std::size_t maxNumOfThreads = getNumArg(argc, argv, 2,
+		std::thread::hardware_concurrency());
+
+	auto documents = createDocuments(numOfDocuments);
+	std::size_t totalSize = 0;
+	for (const auto &document : documents) {
+		totalSize += document.size();
+	}
+	std::cout << "Documents: " << documents.size() << " (" << totalSize
+		<< " bytes)\n";
+
+	// Decode the documents once before the measurements so that all of them
+	// start with a heap of the same size.
+	std::size_t numOfValid = 0;
+	for (const auto &result : decodeBatch(documents, 1)) {
+		numOfValid += result.ok();
+	}
+
+	auto decoder = Decoder::create();
+	double serialTime = measure([&]() {
+		// Keep all the results, like BatchDecoder does.
+		std::vector<DecodingResult> results;
+		results.reserve(documents.size());
+		for (const auto &document : documents) {
+			results.push_back(decoder->tryDecode(document));
+		}
+		for (const auto &result : results) {
+			numOfValid += result.ok();
+		}
+	});
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Decoder:          " << serialTime * 1000 << " ms ("
+		<< totalSize / serialTime / 1e6 << " MB/s)\n";
+
+	for (std::size_t threads = 1; threads <= maxNumOfThreads; ++threads) {
+		auto batchDecoder = BatchDecoder::create(threads);
+		double batchTime = measure([&]() {
+			for (const auto &result : batchDecoder->decode(documents)) {
+				numOfValid += result.ok();
+			}
+		});
+		std::cout << "BatchDecoder(" << std::setw(2) << threads << "): "
+			<< batchTime * 1000 << " ms (" << totalSize / batchTime / 1e6
+			<< " MB/s, speedup " << serialTime / batchTime << "x)\n";
+	}
+
+	// Use the results so that the decoding is not optimized away.
+	std::cout << "Valid documents: " << numOfValid << "\n";
+
+	return 0;
+}
@@ -0,0 +1,152 @@
+/**
+* @file      binding_decoding.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: decoding into structs versus decoding and copying.
+*/
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Binding.h"
+#include "Decoder.h"
+
+namespace {
+
+/// A file of a torrent.
+struct File {
+	std::int64_t length = 0;
+	std::vector<std::string> path;
+};
+
+/// Information about a torrent.
+struct Info {
+	std::vector<File> files;
+	std::string name;
+	std::int64_t pieceLength = 0;
+	std::string pieces;
+};
+
+/// A torrent.
+struct Torrent {
+	std::string announce;
+	Info info;
+};
+
+} // anonymous namespace
+
+BENCODING_BIND(File,
+	BENCODING_FIELD(length, "length"),
+	BENCODING_FIELD(path, "path")
+)
+
+BENCODING_BIND(Info,
+	BENCODING_FIELD(files, "files"),
+	BENCODING_FIELD(name, "name"),
+	BENCODING_FIELD(pieceLength, "piece length"),
+	BENCODING_FIELD(pieces, "pieces")
+)
+
+BENCODING_BIND(Torrent,
+	BENCODING_FIELD(announce, "announce"),
+	BENCODING_FIELD(info, "info")
+)
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of torrent-like files.
+*/
+std::vector<std::string> createTorrents(std::size_t numOfTorrents) {
+	std::vector<std::string> torrents;
+	for (std::size_t i = 0; i < numOfTorrents; ++i) {
+		std::string files;
+		for (std::size_t j = 0; j < 20; ++j) {
+			std::string name("file" + std::to_string(j) + ".dat");
+			files += "d6:lengthi" + std::to_string(1000000 + j) + "e4:pathl" +
+				std::to_string(name.size()) + ":" + name + "ee";
+		}
+		std::string name("torrent" + std::to_string(i));
+		std::string pieces(20 * 50, 'x');
+		torrents.push_back("d8:announce31:http://tracker.example/announce"
+			"7:comment9:a torrent4:infod5:filesl" + files + "e4:name" +
+			std::to_string(name.size()) + ":" + name +
+			"12:piece lengthi262144e6:pieces" +
+			std::to_string(pieces.size()) + ":" + pieces + "ee");
+	}
+	return torrents;
+}
+
+/**
+* @brief Returns the value of the given @a key in @a dict.
+*/
+std::shared_ptr<BItem> get(BDictionary &dict, const char *key) {
+	return dict[BString::create(key)];
+}
+
+/**
+* @brief Copies the decoded @a data into a struct in the way every consumer
+*        of BItem trees does.
+*/
+Torrent copyIntoStruct(BItem &data) {
+	Torrent torrent;
+	auto &dict = *data.as<BDictionary>();
+	torrent.announce = get(dict, "announce")->as<BString>()->value();
+	auto &info = *get(dict, "info")->as<BDictionary>();
+	for (const auto &fileItem : *get(info, "files")->as<BList>()) {
+		auto &fileDict = *fileItem->as<BDictionary>();
+		File file;
+		file.length = get(fileDict, "length")->as<BInteger>()->value();
+		for (const auto &component : *get(fileDict, "path")->as<BList>()) {
+			file.path.push_back(component->as<BString>()->value());
+		}
+		torrent.info.files.push_back(file);
+	}
+	torrent.info.name = get(info, "name")->as<BString>()->value();
+	torrent.info.pieceLength =
+		get(info, "piece length")->as<BInteger>()->value();
+	torrent.info.pieces = get(info, "pieces")->as<BString>()->value();
+	return torrent;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfTorrents = getNumArg(argc, argv, 1, 10000);
+	auto torrents = createTorrents(numOfTorrents);
+
+	std::size_t checksum = 0;
+	auto decoder = Decoder::create();
+	double copyingTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			std::shared_ptr<BItem> data(decoder->decode(torrent));
+			auto bound = copyIntoStruct(*data);
+			checksum += bound.info.files.size() + bound.info.name.size();
+		}
+	});
+
+	double bindingTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			auto bound = decodeAs<Torrent>(torrent);
+			checksum += bound.info.files.size() + bound.info.name.size();
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "decode() and copying: " << copyingTime * 1000 << " ms\n"
+		<< "decodeAs<Torrent>(): " << bindingTime * 1000 << " ms (speedup "
+		<< copyingTime / bindingTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
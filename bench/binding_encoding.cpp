@@ -0,0 +1,117 @@
+/**
+* @file      binding_encoding.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: encoding structs versus building and encoding items.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BList.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Binding.h"
+#include "Encoder.h"
+
+namespace {
+
+/// Arguments of a KRPC reply to a get_peers query.
+struct GetPeersArgs {
+	std::string id;
+	std::string token;
+	std::vector<std::string> values;
+};
+
+/// A KRPC reply to a get_peers query.
+struct GetPeersReply {
+	GetPeersArgs reply;
+	std::string transactionId;
+	std::string type;
+};
+
+} // anonymous namespace
+
+BENCODING_BIND(GetPeersArgs,
+	BENCODING_FIELD(id, "id"),
+	BENCODING_FIELD(token, "token"),
+	BENCODING_FIELD(values, "values")
+)
+
+BENCODING_BIND(GetPeersReply,
+	BENCODING_FIELD(reply, "r"),
+	BENCODING_FIELD(transactionId, "t"),
+	BENCODING_FIELD(type, "y")
+)
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of replies.
+*/
+std::vector<GetPeersReply> createReplies(std::size_t numOfReplies) {
+	std::vector<GetPeersReply> replies(numOfReplies);
+	for (std::size_t i = 0; i < numOfReplies; ++i) {
+		replies[i].transactionId = std::to_string(i % 100);
+		replies[i].type = "r";
+		replies[i].reply.id = std::string(20, 'i');
+		replies[i].reply.token = "token" + std::to_string(i);
+		for (std::size_t j = 0; j < 25; ++j) {
+			replies[i].reply.values.push_back(std::string(6, 'p'));
+		}
+	}
+	return replies;
+}
+
+/**
+* @brief Converts the given @a reply into items, in the way the replies are
+*        encoded without bindings.
+*/
+std::shared_ptr<BItem> createItems(const GetPeersReply &reply) {
+	std::shared_ptr<BList> values(BList::create());
+	for (const auto &value : reply.reply.values) {
+		values->push_back(BString::create(value));
+	}
+	std::shared_ptr<BDictionary> args(BDictionary::create());
+	(*args)[BString::create("id")] = BString::create(reply.reply.id);
+	(*args)[BString::create("token")] = BString::create(reply.reply.token);
+	(*args)[BString::create("values")] = values;
+	std::shared_ptr<BDictionary> data(BDictionary::create());
+	(*data)[BString::create("r")] = args;
+	(*data)[BString::create("t")] = BString::create(reply.transactionId);
+	(*data)[BString::create("y")] = BString::create(reply.type);
+	return data;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfReplies = getNumArg(argc, argv, 1, 50000);
+	auto replies = createReplies(numOfReplies);
+
+	std::size_t checksum = 0;
+	double itemsTime = measure([&]() {
+		for (const auto &reply : replies) {
+			checksum += encode(createItems(reply)).size();
+		}
+	});
+
+	double bindingTime = measure([&]() {
+		for (const auto &reply : replies) {
+			checksum += encode(reply).size();
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "building items and encode(): " << itemsTime * 1000 << " ms\n"
+		<< "encode(GetPeersReply): " << bindingTime * 1000 << " ms (speedup "
+		<< itemsTime / bindingTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
@@ -0,0 +1,107 @@
+/**
+* @file      compact_list.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: converting compact peers by views versus copying the
+*            strings.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BString.h"
+#include "BenchUtils.h"
+#include "CompactList.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of @c peers strings of announce responses,
+*        each with 200 peers.
+*/
+std::vector<std::shared_ptr<BString>> createPeers(std::size_t numOfResponses) {
+	std::vector<std::shared_ptr<BString>> responses;
+	for (std::size_t i = 0; i < numOfResponses; ++i) {
+		std::string peers;
+		for (std::size_t j = 0; j < 200; ++j) {
+			std::size_t k = i + j;
+			peers += {static_cast<char>(10), static_cast<char>(k >> 16),
+				static_cast<char>(k >> 8), static_cast<char>(k),
+				static_cast<char>(0x1a), static_cast<char>(0xe1)};
+		}
+		responses.push_back(BString::create(peers));
+	}
+	return responses;
+}
+
+/**
+* @brief Converts the given @a peers string in the way it is done without
+*        views (copying the string and converting it byte by byte).
+*/
+void convertByCopying(const BString &peers, std::vector<Ipv4Endpoint> &out) {
+	std::string data = peers.value();
+	out.clear();
+	for (std::size_t i = 0; i + 6 <= data.size(); i += 6) {
+		Ipv4Endpoint endpoint;
+		endpoint.address = 0;
+		for (std::size_t j = 0; j < 4; ++j) {
+			endpoint.address = (endpoint.address << 8) |
+				static_cast<unsigned char>(data[i + j]);
+		}
+		endpoint.port = static_cast<std::uint16_t>(
+			(static_cast<unsigned char>(data[i + 4]) << 8) |
+			static_cast<unsigned char>(data[i + 5]));
+		out.push_back(endpoint);
+	}
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfResponses = getNumArg(argc, argv, 1, 20000);
+	auto responses = createPeers(numOfResponses);
+	std::vector<Ipv4Endpoint> endpoints;
+	endpoints.reserve(200);
+
+	std::size_t checksum = 0;
+	double copyingTime = measure([&]() {
+		for (const auto &peers : responses) {
+			convertByCopying(*peers, endpoints);
+			checksum += endpoints.back().address + endpoints.size();
+		}
+	});
+
+	double iteratingTime = measure([&]() {
+		for (const auto &peers : responses) {
+			endpoints.clear();
+			for (auto endpoint : CompactPeers(*peers)) {
+				endpoints.push_back(endpoint);
+			}
+			checksum += endpoints.back().address + endpoints.size();
+		}
+	});
+
+	double bulkTime = measure([&]() {
+		for (const auto &peers : responses) {
+			CompactPeers view(*peers);
+			endpoints.resize(view.size());
+			view.copyTo(endpoints.data());
+			checksum += endpoints.back().address + endpoints.size();
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "copying and converting: " << copyingTime * 1000 << " ms\n"
+		<< "iterating CompactPeers: " << iteratingTime * 1000
+		<< " ms (speedup " << copyingTime / iteratingTime << "x)\n"
+		<< "CompactPeers::copyTo(): " << bulkTime * 1000
+		<< " ms (speedup " << copyingTime / bulkTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
@@ -0,0 +1,68 @@
+/**
+* @file      decoder_errors.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: rejecting invalid input with and without exceptions.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "Decoder.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of invalid DHT-like packets.
+*/
+std::vector<std::string> createInvalidPackets(std::size_t numOfPackets) {
+	std::vector<std::string> packets;
+	for (std::size_t i = 0; i < numOfPackets; ++i) {
+		std::string packet("d1:ad2:id20:" + std::string(20, 'x') +
+			"6:target20:" + std::string(20, 'y') + "e1:q9:find_node1:t2:");
+		// Cut the packet at various places.
+		packet.resize(packet.size() - i % 16);
+		packets.push_back(packet);
+	}
+	return packets;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfPackets = getNumArg(argc, argv, 1, 100000);
+	auto packets = createInvalidPackets(numOfPackets);
+	auto decoder = Decoder::create();
+
+	std::size_t numOfErrors = 0;
+	double throwingTime = measure([&]() {
+		for (const auto &packet : packets) {
+			try {
+				decoder->decode(packet);
+			} catch (const DecodingError &) {
+				++numOfErrors;
+			}
+		}
+	});
+
+	double nonThrowingTime = measure([&]() {
+		for (const auto &packet : packets) {
+			if (!decoder->tryDecode(packet)) {
+				++numOfErrors;
+			}
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "decode():    " << throwingTime * 1000 << " ms\n"
+		<< "tryDecode(): " << nonThrowingTime * 1000 << " ms (speedup "
+		<< throwingTime / nonThrowingTime << "x)\n"
+		<< "(" << numOfErrors << " errors)\n";
+	return 0;
+}
@@ -0,0 +1,138 @@
+/**
+* @file      decoder_limits.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: overhead of checking decoder limits.
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include "Reader.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+// Built against the copy of the library whose limit checks are compiled out
+// (see decoder_limits_unchecked.cpp).
+namespace bencoding_unchecked {
+namespace bench {
+
+void readAllTokensWithoutLimitChecks(const std::string &data);
+void decodeWithoutLimitChecks(const std::string &data);
+
+} // namespace bench
+} // namespace bencoding_unchecked
+
+namespace {
+
+/**
+* @brief Creates encoded torrent-like data with the given number of files.
+*/
+std::string createEncodedData(std::size_t numOfFiles) {
+	auto files = BList::create();
+	for (std::size_t i = 0; i < numOfFiles; ++i) {
+		auto path = BList::create();
+		path->push_back(BString::create("directory"));
+		path->push_back(BString::create("file-" + std::to_string(i) + ".txt"));
+		auto file = BDictionary::create();
+		(*file)[BString::create("length")] = BInteger::create(
+			static_cast<BInteger::ValueType>(i) * 4096);
+		(*file)[BString::create("path")] = std::move(path);
+		files->push_back(std::move(file));
+	}
+	std::shared_ptr<BDictionary> info(BDictionary::create());
+	(*info)[BString::create("files")] = std::move(files);
+	(*info)[BString::create("pieces")] = BString::create(
+		std::string(20 * numOfFiles, 'p'));
+	return encode(info);
+}
+
+/**
+* @brief Measures @a unlimited (built without limit checks) and @a limited
+*        alternately and prints their times and the overhead of the limits.
+*
+* The order alternates (ABBA) so that both variants run under the same
+* conditions (e.g. the state of the memory allocator).
+*/
+template <typename F, typename G>
+void compare(const std::string &name, F unlimited, G limited) {
+	// Warm up (the very first run is faster because the heap is fresh).
+	unlimited();
+	limited();
+
+	double unlimitedTime = std::numeric_limits<double>::max();
+	double limitedTime = std::numeric_limits<double>::max();
+	for (int i = 0; i < 5; ++i) {
+		unlimitedTime = std::min(unlimitedTime, measure(unlimited, 3));
+		limitedTime = std::min(limitedTime, measure(limited, 3));
+		limitedTime = std::min(limitedTime, measure(limited, 3));
+		unlimitedTime = std::min(unlimitedTime, measure(unlimited, 3));
+	}
+	std::cout << std::fixed << std::setprecision(2) << name << ":\n"
+		<< "    without checks: " << unlimitedTime * 1000 << " ms\n"
+		<< "    with limits:    " << limitedTime * 1000 << " ms (overhead "
+		<< (limitedTime / unlimitedTime - 1) * 100 << " %)\n";
+}
+
+/**
+* @brief Reads all tokens of @a data with the given @a limits.
+*/
+void readAllTokens(const std::string &data, const DecoderLimits &limits) {
+	Reader reader(data);
+	reader.setLimits(limits);
+	while (reader.next() != TokenType::EndOfInput) {
+		if (reader.tokenType() == TokenType::Error) {
+			std::cerr << "error: " << getErrorDescription(reader.error())
+				<< "\n";
+			return;
+		}
+	}
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfFiles = getNumArg(argc, argv, 1, 50000);
+	std::string data = createEncodedData(numOfFiles);
+	std::cout << "Encoded size: " << data.size() << " bytes\n";
+
+	// Limits that are checked but not exceeded.
+	DecoderLimits limits;
+	limits.maxDepth = 64;
+	limits.maxInputLength = data.size();
+	limits.maxNumOfItems = 100 * numOfFiles;
+	limits.maxStringLength = data.size();
+	limits.maxTotalStringLength = data.size();
+
+	// The limits are always checked (the default ones are just the maximal
+	// values), so the baseline is the copy of the library built without the
+	// checks. Reading tokens alone shows the cost of the checks without the
+	// noise of memory allocations.
+	compare("Reader", [&]() {
+		bencoding_unchecked::bench::readAllTokensWithoutLimitChecks(data);
+	}, [&]() {
+		readAllTokens(data, limits);
+	});
+
+	compare("Decoder::decode(std::string)", [&]() {
+		bencoding_unchecked::bench::decodeWithoutLimitChecks(data);
+	}, [&]() {
+		auto decoder = Decoder::create();
+		decoder->setLimits(limits);
+		decoder->decode(data);
+	});
+
+	return 0;
+}
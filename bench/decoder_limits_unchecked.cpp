@@ -0,0 +1,38 @@
+/**
+* @file      decoder_limits_unchecked.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: the part of decoder_limits built against the copy of
+*            the library whose limit checks are compiled out.
+*
+* This file is compiled with @c BENCODING_WITHOUT_LIMIT_CHECKS and with the
+* @c bencoding namespace renamed to @c bencoding_unchecked (see
+* bench/CMakeLists.txt).
+*/
+
+#include <string>
+
+#include "Decoder.h"
+#include "Reader.h"
+
+namespace bencoding {
+namespace bench {
+
+/**
+* @brief Reads all tokens of @a data without checking any limits.
+*/
+void readAllTokensWithoutLimitChecks(const std::string &data) {
+	Reader reader(data);
+	while (reader.next() != TokenType::EndOfInput &&
+		reader.tokenType() != TokenType::Error) {}
+}
+
+/**
+* @brief Decodes @a data without checking any limits.
+*/
+void decodeWithoutLimitChecks(const std::string &data) {
+	Decoder::create()->decode(data);
+}
+
+} // namespace bench
+} // namespace bencoding
@@ -0,0 +1,91 @@
+/**
+* @file      decoder_validate.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: validating bencoded data versus decoding them.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "BenchUtils.h"
+#include "Decoder.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates a torrent-like file with the given number of files and
+*        pieces.
+*
+* Most of the data are the concatenated piece hashes.
+*/
+std::string createTorrent(std::size_t numOfFiles, std::size_t numOfPieces) {
+	std::string files;
+	for (std::size_t i = 0; i < numOfFiles; ++i) {
+		std::string name("file" + std::to_string(i) + ".dat");
+		files += "d6:lengthi" + std::to_string(1000000 + i) + "e4:pathl" +
+			std::to_string(name.size()) + ":" + name + "ee";
+	}
+	std::string pieces(20 * numOfPieces, 'x');
+	return "d8:announce31:http://tracker.example/announce4:infod5:filesl" +
+		files + "e4:name7:example12:piece lengthi262144e6:pieces" +
+		std::to_string(pieces.size()) + ":" + pieces + "ee";
+}
+
+/**
+* @brief Creates a list of the given number of small dictionaries.
+*
+* There are no long strings, so the data consist of many small items.
+*/
+std::string createManySmallItems(std::size_t numOfItems) {
+	std::string data("l");
+	for (std::size_t i = 0; i < numOfItems; ++i) {
+		data += "d2:idi" + std::to_string(i) + "e4:port" + "i6881e1:t2:aae";
+	}
+	return data + "e";
+}
+
+/**
+* @brief Measures decoding and validation of the given @a data and prints the
+*        throughput.
+*/
+void compare(const std::string &name, const std::string &data) {
+	auto decoder = Decoder::create();
+	auto checkingDecoder = Decoder::create();
+	checkingDecoder->setKeyOrderChecking(true);
+
+	std::size_t numOfErrors = 0;
+	double decodingTime = measure([&]() {
+		numOfErrors += !decoder->tryDecode(data);
+	});
+	double validationTime = measure([&]() {
+		numOfErrors += !decoder->validate(data);
+	});
+	double checkingTime = measure([&]() {
+		numOfErrors += !checkingDecoder->validate(data);
+	});
+
+	double gb = static_cast<double>(data.size()) / 1e9;
+	std::cout << std::fixed << std::setprecision(2) << name << " ("
+		<< data.size() / 1000000.0 << " MB):\n"
+		<< "  tryDecode():              " << gb / decodingTime << " GB/s\n"
+		<< "  validate():               " << gb / validationTime << " GB/s\n"
+		<< "  validate() checking keys: " << gb / checkingTime << " GB/s\n";
+	if (numOfErrors != 0) {
+		std::cout << "  (" << numOfErrors << " errors)\n";
+	}
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t scale = getNumArg(argc, argv, 1, 100000);
+
+	compare("torrent", createTorrent(scale / 100, scale * 10));
+	compare("many small items", createManySmallItems(scale * 10));
+	return 0;
+}
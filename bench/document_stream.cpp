@@ -0,0 +1,107 @@
+/**
+* @file      document_stream.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: decoding of concatenated documents.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "DocumentStream.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates a log of the given number of KRPC-like messages.
+*/
+std::string createLog(std::size_t numOfMessages) {
+	std::string log;
+	for (std::size_t i = 0; i < numOfMessages; ++i) {
+		std::string transactionId(std::to_string(i % 65536));
+		if (i % 2 == 0) {
+			log += "d1:ad2:id20:" + std::string(20, static_cast<char>(i)) +
+				"9:info_hash20:" + std::string(20, 'h') + "e1:q9:get_peers"
+				"1:t" + std::to_string(transactionId.size()) + ":" +
+				transactionId + "1:y1:qe";
+		} else {
+			log += "d1:rd2:id20:" + std::string(20, static_cast<char>(i)) +
+				"5:nodes208:" + std::string(208, 'n') + "5:token8:abcdefghe"
+				"1:t" + std::to_string(transactionId.size()) + ":" +
+				transactionId + "1:y1:re";
+		}
+	}
+	return log;
+}
+
+/**
+* @brief Decodes all documents from @a documents and returns their number.
+*/
+std::size_t decodeAll(DocumentStream &documents) {
+	std::size_t numOfDocuments = 0;
+	while (documents.hasNext()) {
+		numOfDocuments += documents.next().ok();
+	}
+	return numOfDocuments;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfMessages = getNumArg(argc, argv, 1, 200000);
+	std::size_t maxNumOfThreads = getNumArg(argc, argv, 2,
+		std::thread::hardware_concurrency());
+
+	auto log = createLog(numOfMessages);
+	std::cout << "Log size: " << log.size() << " bytes\n";
+
+	std::size_t numOfDocuments = 0;
+	auto decoder = Decoder::create();
+	double istreamTime = measure([&]() {
+		std::istringstream input(log);
+		while (input.peek() != std::char_traits<char>::eof()) {
+			decoder->decode(input);
+			++numOfDocuments;
+		}
+	});
+
+	double memoryTime = measure([&]() {
+		numOfDocuments += decodeAll(*DocumentStream::create(log));
+	});
+
+	double streamTime = measure([&]() {
+		std::istringstream input(log);
+		numOfDocuments += decodeAll(*DocumentStream::create(input));
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Decoder::decode(istream):   " << istreamTime * 1000 << " ms\n"
+		<< "DocumentStream(memory):     " << memoryTime * 1000
+		<< " ms (speedup " << istreamTime / memoryTime << "x)\n"
+		<< "DocumentStream(istream):    " << streamTime * 1000
+		<< " ms (speedup " << istreamTime / streamTime << "x)\n";
+
+	for (std::size_t threads = 2; threads <= maxNumOfThreads; ++threads) {
+		double parallelTime = measure([&]() {
+			auto documents = DocumentStream::create(log);
+			documents->setNumOfThreads(threads);
+			numOfDocuments += decodeAll(*documents);
+		});
+		std::cout << "DocumentStream(memory, " << std::setw(2) << threads
+			<< "): " << parallelTime * 1000 << " ms (speedup "
+			<< memoryTime / parallelTime << "x over one thread)\n";
+	}
+
+	// Use the results so that the decoding is not optimized away.
+	std::cout << "Decoded documents: " << numOfDocuments << "\n";
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+/**
+* @file      info_hash.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: computing infohashes during decoding versus after it.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include "Sha1.h"
+#include "Sha256.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of torrent-like files, each with the given
+*        number of pieces.
+*/
+std::vector<std::string> createTorrents(std::size_t numOfTorrents,
+		std::size_t numOfPieces) {
+	std::vector<std::string> torrents;
+	for (std::size_t i = 0; i < numOfTorrents; ++i) {
+		std::string name("torrent" + std::to_string(i));
+		std::string pieces(20 * numOfPieces, static_cast<char>(i));
+		torrents.push_back("d8:announce31:http://tracker.example/announce"
+			"4:infod6:lengthi" + std::to_string(numOfPieces * 262144) +
+			"e4:name" + std::to_string(name.size()) + ":" + name +
+			"12:piece lengthi262144e6:pieces" +
+			std::to_string(pieces.size()) + ":" + pieces + "ee");
+	}
+	return torrents;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfTorrents = getNumArg(argc, argv, 1, 1000);
+	std::size_t numOfPieces = getNumArg(argc, argv, 2, 2000);
+	auto torrents = createTorrents(numOfTorrents, numOfPieces);
+
+	std::size_t checksum = 0;
+	auto decoder = Decoder::create();
+	auto encoder = Encoder::create();
+	std::shared_ptr<BString> infoKey(BString::create("info"));
+	double separateTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			auto result = decoder->tryDecode(torrent);
+			std::shared_ptr<BItem> data(result.releaseData());
+			auto info = (*data->as<BDictionary>())[infoKey];
+			auto encodedInfo = encoder->encode(info);
+			checksum += static_cast<unsigned char>(Sha1::hash(encodedInfo)[0]);
+			checksum += static_cast<unsigned char>(Sha256::hash(encodedInfo)[0]);
+		}
+	});
+
+	auto hashingDecoder = Decoder::create();
+	hashingDecoder->setInfoHashComputation(true);
+	double fusedTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			auto result = hashingDecoder->tryDecode(torrent);
+			checksum += static_cast<unsigned char>(result.infoHashV1()[0]);
+			checksum += static_cast<unsigned char>(result.infoHashV2()[0]);
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "decode, encode info, and hash: " << separateTime * 1000 << " ms\n"
+		<< "decode with infohashes:        " << fusedTime * 1000
+		<< " ms (speedup " << separateTime / fusedTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
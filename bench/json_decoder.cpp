@@ -0,0 +1,98 @@
+/**
+* @file      json_decoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: converting JSON into bencoded data directly vs. via
+*            a tree of items.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Encoder.h"
+#include "JsonDecoder.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates JSON with a list of torrent-like records with the given
+*        number of items.
+*
+* The keys of the records are deliberately not sorted.
+*/
+std::string createJson(std::size_t numOfRecords) {
+	std::string json("[");
+	for (std::size_t i = 0; i < numOfRecords; ++i) {
+		if (i > 0) {
+			json += ',';
+		}
+		json += R"({"name":"Some.Linux.Distribution-)" + std::to_string(i) +
+			R"(.iso","length":)" + std::to_string(i * 1048576) +
+			R"(,"comment":"A \"quoted\" comment\nspanning two lines, record )" +
+			std::to_string(i) + R"(","private":true})";
+	}
+	json += ']';
+	return json;
+}
+
+/**
+* @brief Builds a tree of items equivalent to createJson() by hand and
+*        encodes it.
+*
+* This is what one would have to do without JsonDecoder.
+*/
+std::string encodeViaTree(std::size_t numOfRecords) {
+	std::shared_ptr<BList> records(BList::create());
+	for (std::size_t i = 0; i < numOfRecords; ++i) {
+		auto record = BDictionary::create();
+		(*record)[BString::create("name")] = BString::create(
+			"Some.Linux.Distribution-" + std::to_string(i) + ".iso");
+		(*record)[BString::create("length")] = BInteger::create(
+			static_cast<BInteger::ValueType>(i) * 1048576);
+		(*record)[BString::create("comment")] = BString::create(
+			"A \"quoted\" comment\nspanning two lines, record " +
+			std::to_string(i));
+		(*record)[BString::create("private")] = BInteger::create(1);
+		records->push_back(std::move(record));
+	}
+	return encode(records);
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfRecords = getNumArg(argc, argv, 1, 20000);
+	std::string json = createJson(numOfRecords);
+
+	auto decoder = JsonDecoder::create();
+	std::string direct;
+	double directTime = measure([&]() {
+		direct = decoder->decodeIntoBencode(json);
+	});
+
+	std::string viaTree;
+	double viaTreeTime = measure([&]() {
+		viaTree = encodeViaTree(numOfRecords);
+	});
+
+	if (direct != viaTree) {
+		std::cerr << "error: the outputs differ\n";
+		return 1;
+	}
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< "JsonDecoder:    " << json.size() / directTime / 1e6
+		<< " MB/s of JSON (" << directTime * 1e3 << " ms)\n"
+		<< "tree + encode(): " << viaTreeTime * 1e3 << " ms\n";
+	return 0;
+}
@@ -0,0 +1,78 @@
+/**
+* @file      json_encoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: throughput of encoding into JSON.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "JsonEncoder.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates a list of torrent-like records with the given number of
+*        items.
+*/
+std::shared_ptr<BItem> createRecords(std::size_t numOfRecords) {
+	std::shared_ptr<BList> records(BList::create());
+	for (std::size_t i = 0; i < numOfRecords; ++i) {
+		std::string pieces(20 * 64, char());
+		for (std::size_t j = 0; j < pieces.size(); ++j) {
+			pieces[j] = static_cast<char>(i * 31 + j * 7);
+		}
+		auto record = BDictionary::create();
+		(*record)[BString::create("comment")] = BString::create(
+			"A \"quoted\" comment\nspanning two lines, record " +
+			std::to_string(i));
+		(*record)[BString::create("length")] = BInteger::create(
+			static_cast<BInteger::ValueType>(i) * 1048576);
+		(*record)[BString::create("name")] = BString::create(
+			"Some.Linux.Distribution-" + std::to_string(i) + ".iso");
+		(*record)[BString::create("pieces")] = BString::create(pieces);
+		records->push_back(std::move(record));
+	}
+	return records;
+}
+
+/**
+* @brief Measures and prints the throughput of the given encoder.
+*/
+void benchmark(const std::string &name, JsonEncoder &encoder,
+		std::shared_ptr<BItem> data) {
+	std::string output;
+	double time = measure([&]() {
+		output.clear();
+		encoder.encode(data, output);
+	});
+	std::cout << std::fixed << std::setprecision(1) << name << ": "
+		<< output.size() / time / 1e6 << " MB/s of JSON ("
+		<< output.size() << " bytes)\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfRecords = getNumArg(argc, argv, 1, 20000);
+	auto data = createRecords(numOfRecords);
+
+	auto encoder = JsonEncoder::create(BinaryEncoding::Base64);
+	benchmark("base64", *encoder, data);
+
+	encoder->setBinaryEncoding(BinaryEncoding::Hex);
+	benchmark("hex   ", *encoder, data);
+
+	return 0;
+}
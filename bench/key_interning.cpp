@@ -0,0 +1,81 @@
+/**
+* @file      key_interning.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: decoding KRPC messages with and without key interning.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "KeyInternTable.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of KRPC queries and replies.
+*/
+std::vector<std::string> createMessages(std::size_t numOfMessages) {
+	std::string id(20, 'i');
+	std::vector<std::string> messages;
+	for (std::size_t i = 0; i < numOfMessages; ++i) {
+		std::string t(std::to_string(i % 100));
+		std::string tid(std::to_string(t.size()) + ":" + t);
+		if (i % 2 == 0) {
+			messages.push_back("d1:ad2:id20:" + id + "9:info_hash20:" + id +
+				"e1:q9:get_peers1:t" + tid + "1:y1:qe");
+		} else {
+			messages.push_back("d1:rd2:id20:" + id + "5:nodes26:" +
+				std::string(26, 'n') + "5:token8:abcdefgh6:valuesl6:" +
+				std::string(6, 'p') + "6:" + std::string(6, 'q') + "ee1:t" +
+				tid + "1:y1:re");
+		}
+	}
+	return messages;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfMessages = getNumArg(argc, argv, 1, 200000);
+	auto messages = createMessages(numOfMessages);
+
+	std::size_t checksum = 0;
+	auto decoder = Decoder::create();
+	double plainTime = measure([&]() {
+		for (const auto &message : messages) {
+			checksum += decoder->tryDecode(message).ok();
+		}
+	});
+
+	decoder->setKeyInterning(KeyInternTable::createForKrpc());
+	double fixedTime = measure([&]() {
+		for (const auto &message : messages) {
+			checksum += decoder->tryDecode(message).ok();
+		}
+	});
+
+	decoder->setKeyInterning(KeyInternTable::create());
+	double adaptiveTime = measure([&]() {
+		for (const auto &message : messages) {
+			checksum += decoder->tryDecode(message).ok();
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "tryDecode(): " << plainTime * 1000 << " ms\n"
+		<< "tryDecode() with the KRPC table: " << fixedTime * 1000
+		<< " ms (speedup " << plainTime / fixedTime << "x)\n"
+		<< "tryDecode() with an adaptive table: " << adaptiveTime * 1000
+		<< " ms (speedup " << plainTime / adaptiveTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
@@ -0,0 +1,134 @@
+/**
+* @file      krpc.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: handling KRPC messages with the fast-path codec versus
+*            decoding and encoding items.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include "Krpc.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of KRPC queries of the four BEP 5 methods.
+*/
+std::vector<std::string> createQueries(std::size_t numOfQueries) {
+	std::string id(20, 'i');
+	std::vector<std::string> queries;
+	for (std::size_t i = 0; i < numOfQueries; ++i) {
+		std::string t(std::to_string(i % 100));
+		std::string tail("1:t" + std::to_string(t.size()) + ":" + t +
+			"1:v4:LT011:y1:qe");
+		switch (i % 4) {
+			case 0:
+				queries.push_back("d1:ad2:id20:" + id + "e1:q4:ping" + tail);
+				break;
+			case 1:
+				queries.push_back("d1:ad2:id20:" + id + "6:target20:" + id +
+					"e1:q9:find_node" + tail);
+				break;
+			case 2:
+				queries.push_back("d1:ad2:id20:" + id + "9:info_hash20:" + id +
+					"e1:q9:get_peers" + tail);
+				break;
+			default:
+				queries.push_back("d1:ad2:id20:" + id + "9:info_hash20:" + id +
+					"4:porti6881e5:token8:abcdefghe1:q13:announce_peer" + tail);
+				break;
+		}
+	}
+	return queries;
+}
+
+/**
+* @brief Returns the value of the given @a key in @a dict.
+*/
+std::shared_ptr<BItem> get(BDictionary &dict, const char *key) {
+	return dict[BString::create(key)];
+}
+
+/**
+* @brief Handles the given query by decoding it into items and encoding a
+*        reply from items, in the way KRPC messages are handled without the
+*        fast-path codec.
+*/
+std::size_t handleByItems(Decoder &decoder, const std::string &query,
+		const std::shared_ptr<BString> &ownId) {
+	std::shared_ptr<BItem> data(decoder.decode(query));
+	auto &dict = *data->as<BDictionary>();
+	auto &args = *get(dict, "a")->as<BDictionary>();
+	auto senderId = get(args, "id")->as<BString>();
+
+	std::shared_ptr<BDictionary> values(BDictionary::create());
+	(*values)[BString::create("id")] = ownId;
+	std::shared_ptr<BDictionary> reply(BDictionary::create());
+	(*reply)[BString::create("r")] = values;
+	(*reply)[BString::create("t")] = get(dict, "t");
+	(*reply)[BString::create("y")] = BString::create("r");
+	return encode(reply).size() + senderId->value().size();
+}
+
+/**
+* @brief Handles the given query by the fast-path codec.
+*/
+std::size_t handleByCodec(const std::string &query, KrpcMessage &message,
+		KrpcMessage &reply, char *buffer, std::size_t size) {
+	if (!decodeKrpc(query, message)) {
+		return 0;
+	}
+	reply.transactionId = message.transactionId;
+	return encodeKrpc(reply, buffer, size) + message.id.length;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfQueries = getNumArg(argc, argv, 1, 200000);
+	auto queries = createQueries(numOfQueries);
+	std::string ownIdData(20, 'o');
+	std::shared_ptr<BString> ownId(BString::create(ownIdData));
+
+	std::size_t checksum = 0;
+	auto decoder = Decoder::create();
+	double itemsTime = measure([&]() {
+		for (const auto &query : queries) {
+			checksum += handleByItems(*decoder, query, ownId);
+		}
+	});
+
+	KrpcMessage message;
+	KrpcMessage reply;
+	reply.type = KrpcMessageType::Response;
+	reply.id = KrpcBytes(ownIdData.data(), ownIdData.size());
+	char buffer[1500];
+	double codecTime = measure([&]() {
+		for (const auto &query : queries) {
+			checksum += handleByCodec(query, message, reply, buffer,
+				sizeof(buffer));
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "decode() + encode() of items: " << itemsTime * 1000 << " ms ("
+		<< numOfQueries / itemsTime / 1e6 << "M messages/s)\n"
+		<< "decodeKrpc() + encodeKrpc(): " << codecTime * 1000 << " ms ("
+		<< numOfQueries / codecTime / 1e6 << "M messages/s, speedup "
+		<< itemsTime / codecTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
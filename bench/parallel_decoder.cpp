@@ -0,0 +1,88 @@
+/**
+* @file      parallel_decoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: scaling of parallel decoding with the number of threads.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include "ParallelDecoder.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates a session-like dictionary with the given number of torrents.
+*/
+std::shared_ptr<BItem> createSession(std::size_t numOfTorrents) {
+	auto torrents = BList::create();
+	for (std::size_t i = 0; i < numOfTorrents; ++i) {
+		auto torrent = BDictionary::create();
+		(*torrent)[BString::create("info-hash")] = BString::create(
+			std::string(20, static_cast<char>(i)));
+		(*torrent)[BString::create("name")] = BString::create(
+			"torrent-" + std::to_string(i));
+		(*torrent)[BString::create("save path")] = BString::create(
+			"/home/user/downloads/torrent-" + std::to_string(i));
+		(*torrent)[BString::create("downloaded")] = BInteger::create(
+			static_cast<BInteger::ValueType>(i) * 16384);
+		(*torrent)[BString::create("uploaded")] = BInteger::create(
+			static_cast<BInteger::ValueType>(i) * 1024);
+		(*torrent)[BString::create("pieces")] = BString::create(
+			std::string(256, '\x01'));
+		torrents->push_back(std::move(torrent));
+	}
+	std::shared_ptr<BDictionary> session(BDictionary::create());
+	(*session)[BString::create("torrents")] = std::move(torrents);
+	return session;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfTorrents = getNumArg(argc, argv, 1, 100000);
+	std::size_t maxNumOfThreads = getNumArg(argc, argv, 2,
+		std::thread::hardware_concurrency());
+
+	auto data = encode(createSession(numOfTorrents));
+	auto expectedOutput = encode(std::shared_ptr<BItem>(decode(data)));
+	std::cout << "Encoded size: " << data.size() << " bytes\n";
+
+	// Every measured run also destroys the decoded data so that all the runs
+	// start with the same state of the heap.
+	double serialTime = measure([&]() {
+		decode(data);
+	});
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Decoder:            " << serialTime * 1000 << " ms\n";
+
+	for (std::size_t threads = 1; threads <= maxNumOfThreads; ++threads) {
+		auto decoder = ParallelDecoder::create(threads);
+		double parallelTime = measure([&]() {
+			decoder->decode(data);
+		});
+		auto parallelOutput = encode(std::shared_ptr<BItem>(
+			decoder->decode(data)));
+		std::cout << "ParallelDecoder(" << std::setw(2) << threads << "): "
+			<< parallelTime * 1000 << " ms (speedup "
+			<< serialTime / parallelTime << "x)"
+			<< (parallelOutput == expectedOutput ? "" : " OUTPUT DIFFERS")
+			<< "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+/**
+* @file      path_query.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: extracting items by paths versus decoding.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "PathQuery.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of torrent-like files.
+*/
+std::vector<std::string> createTorrents(std::size_t numOfTorrents) {
+	std::vector<std::string> torrents;
+	for (std::size_t i = 0; i < numOfTorrents; ++i) {
+		std::string files;
+		for (std::size_t j = 0; j < 20; ++j) {
+			std::string name("file" + std::to_string(j) + ".dat");
+			files += "d6:lengthi" + std::to_string(1000000 + j) + "e4:pathl" +
+				std::to_string(name.size()) + ":" + name + "ee";
+		}
+		std::string name("torrent" + std::to_string(i));
+		std::string pieces(20 * 500, 'x');
+		torrents.push_back("d8:announce31:http://tracker.example/announce"
+			"4:infod5:filesl" + files + "e4:name" +
+			std::to_string(name.size()) + ":" + name +
+			"12:piece lengthi262144e6:pieces" +
+			std::to_string(pieces.size()) + ":" + pieces + "ee");
+	}
+	return torrents;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfTorrents = getNumArg(argc, argv, 1, 10000);
+	auto torrents = createTorrents(numOfTorrents);
+
+	std::size_t checksum = 0;
+	auto decoder = Decoder::create();
+	std::shared_ptr<BString> infoKey(BString::create("info"));
+	std::shared_ptr<BString> nameKey(BString::create("name"));
+	std::shared_ptr<BString> pieceLengthKey(BString::create("piece length"));
+	double decodingTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			std::shared_ptr<BItem> data(decoder->decode(torrent));
+			auto info = (*data->as<BDictionary>())[infoKey]->as<BDictionary>();
+			checksum += (*info)[nameKey]->as<BString>()->value().size();
+			checksum += static_cast<std::size_t>(
+				(*info)[pieceLengthKey]->as<BInteger>()->value());
+		}
+	});
+
+	auto query = PathQuery::create({"info/name", "info/piece length"});
+	std::vector<BItemView> values;
+	double extractionTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			query->extract(torrent, values);
+			checksum += values[0].length;
+			checksum += static_cast<std::size_t>(values[1].integer);
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "decode() and lookup: " << decodingTime * 1000 << " ms\n"
+		<< "PathQuery::extract(): " << extractionTime * 1000 << " ms (speedup "
+		<< decodingTime / extractionTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
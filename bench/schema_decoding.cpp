@@ -0,0 +1,96 @@
+/**
+* @file      schema_decoding.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: schema-guided decoding versus decoding everything.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "Schema.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates the given number of torrent-like files carrying keys that
+*        are not needed by their consumers.
+*/
+std::vector<std::string> createTorrents(std::size_t numOfTorrents) {
+	std::string junk("l");
+	for (std::size_t i = 0; i < 2000; ++i) {
+		junk += "d4:hashi" + std::to_string(i) + "e4:note8:whatevere";
+	}
+	junk += "e";
+
+	std::vector<std::string> torrents;
+	for (std::size_t i = 0; i < numOfTorrents; ++i) {
+		std::string files;
+		for (std::size_t j = 0; j < 20; ++j) {
+			std::string name("file" + std::to_string(j) + ".dat");
+			files += "d6:lengthi" + std::to_string(1000000 + j) + "e4:pathl" +
+				std::to_string(name.size()) + ":" + name + "ee";
+		}
+		std::string name("torrent" + std::to_string(i));
+		std::string pieces(20 * 500, 'x');
+		torrents.push_back("d8:announce31:http://tracker.example/announce"
+			"4:infod5:filesl" + files + "e4:name" +
+			std::to_string(name.size()) + ":" + name +
+			"12:piece lengthi262144e6:pieces" +
+			std::to_string(pieces.size()) + ":" + pieces + "e"
+			"4:junk" + junk + "e");
+	}
+	return torrents;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfTorrents = getNumArg(argc, argv, 1, 1000);
+	auto torrents = createTorrents(numOfTorrents);
+
+	std::shared_ptr<Schema> file(Schema::dictionary({
+		{"length", Schema::integer(), true},
+		{"path", Schema::list(Schema::string()), true}
+	}));
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"announce", Schema::string()},
+		{"announce-list", Schema::list(Schema::list(Schema::string()))},
+		{"info", Schema::dictionary({
+			{"files", Schema::list(file)},
+			{"length", Schema::integer()},
+			{"name", Schema::string(), true},
+			{"piece length", Schema::integer(), true},
+			{"pieces", Schema::string(), true}
+		}), true}
+	}));
+
+	std::size_t checksum = 0;
+	auto decoder = Decoder::create();
+	double decodingTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			checksum += decoder->tryDecode(torrent).ok();
+		}
+	});
+
+	double schemaTime = measure([&]() {
+		for (const auto &torrent : torrents) {
+			checksum += decoder->tryDecode(torrent, *schema).ok();
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "tryDecode(): " << decodingTime * 1000 << " ms\n"
+		<< "tryDecode() with schema: " << schemaTime * 1000
+		<< " ms (speedup " << decodingTime / schemaTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
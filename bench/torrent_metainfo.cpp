@@ -0,0 +1,89 @@
+/**
+* @file      torrent_metainfo.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: accessing piece hashes by TorrentMetainfo versus
+*            walking the items.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "BDictionary.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "TorrentMetainfo.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Creates a torrent with the given number of pieces of 16 KiB in 100
+*        files.
+*/
+std::string createTorrent(std::size_t numOfPieces) {
+	std::size_t totalLength = numOfPieces * 16384;
+	std::string files;
+	for (std::size_t i = 0; i < 100; ++i) {
+		std::size_t length = totalLength / 100 + (i < totalLength % 100);
+		std::string name("file" + std::to_string(i));
+		files += "d6:lengthi" + std::to_string(length) + "e4:pathl" +
+			std::to_string(name.size()) + ":" + name + "ee";
+	}
+	std::string pieces;
+	for (std::size_t i = 0; i < numOfPieces * 20; ++i) {
+		pieces += static_cast<char>(i * 7);
+	}
+	return "d8:announce31:http://tracker.example/announce4:infod5:filesl" +
+		files + "e4:name7:torrent12:piece lengthi16384e6:pieces" +
+		std::to_string(pieces.size()) + ":" + pieces + "ee";
+}
+
+/**
+* @brief Returns the hash of the piece with the given @a index by walking the
+*        items, in the way it is done without TorrentMetainfo.
+*/
+const char *getPieceHash(BDictionary &torrent, std::size_t index) {
+	auto info = torrent[BString::create("info")]->as<BDictionary>();
+	auto pieces = (*info)[BString::create("pieces")]->as<BString>();
+	return pieces->value().data() + index * 20;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfPieces = getNumArg(argc, argv, 1, 20000);
+	std::size_t numOfQueries = getNumArg(argc, argv, 2, 2000000);
+	std::shared_ptr<BItem> torrent(decode(createTorrent(numOfPieces)));
+	auto dict = torrent->as<BDictionary>();
+
+	std::size_t checksum = 0;
+	double itemsTime = measure([&]() {
+		for (std::size_t i = 0; i < numOfQueries; ++i) {
+			checksum += getPieceHash(*dict, i % numOfPieces)[i % 20];
+		}
+	});
+
+	std::unique_ptr<TorrentMetainfo> metainfo;
+	double createTime = measure([&]() {
+		metainfo = TorrentMetainfo::create(torrent);
+	});
+	double metainfoTime = measure([&]() {
+		for (std::size_t i = 0; i < numOfQueries; ++i) {
+			checksum += metainfo->pieceHash(i % numOfPieces)[i % 20];
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "walking items: " << itemsTime * 1000 << " ms\n"
+		<< "TorrentMetainfo::pieceHash(): " << metainfoTime * 1000
+		<< " ms (speedup " << itemsTime / metainfoTime << "x, create() "
+		<< createTime * 1000 << " ms)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
@@ -0,0 +1,111 @@
+/**
+* @file      torrent_v2_index.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Benchmark: looking up piece layers of a v2 torrent by
+*            TorrentV2Index versus decoding and walking the items.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BString.h"
+#include "BenchUtils.h"
+#include "Decoder.h"
+#include "TorrentV2Index.h"
+
+using namespace bencoding;
+using namespace bencoding::bench;
+
+namespace {
+
+/**
+* @brief Returns a 32-byte Merkle root of the file with the given @a index.
+*/
+std::string getRoot(std::size_t index) {
+	std::string root(32, 'r');
+	for (std::size_t i = 0; i < 8; ++i) {
+		root[i] = static_cast<char>(index >> (i * 8));
+	}
+	return root;
+}
+
+/**
+* @brief Creates a torrent with the given number of files of 64 KiB (four
+*        pieces of 16 KiB) in directories of 100 files.
+*/
+std::string createTorrent(std::size_t numOfFiles) {
+	std::string tree;
+	std::string layers;
+	for (std::size_t i = 0; i < numOfFiles; ++i) {
+		if (i % 100 == 0) {
+			std::string dir("dir" + std::to_string(i / 100));
+			tree += (i > 0 ? "e" : "") + std::to_string(dir.size()) + ":" +
+				dir + "d";
+		}
+		std::string name("file" + std::to_string(i % 100));
+		std::string root(getRoot(i));
+		tree += std::to_string(name.size()) + ":" + name +
+			"d0:d6:lengthi65536e11:pieces root32:" + root + "ee";
+		layers += "32:" + root + "128:" + std::string(128, 'h');
+	}
+	tree += numOfFiles > 0 ? "e" : "";
+	return "d4:infod9:file treed" + tree + "e12:meta versioni2e"
+		"4:name7:torrent12:piece lengthi16384ee12:piece layersd" + layers +
+		"ee";
+}
+
+/**
+* @brief Sums the first bytes of the piece layers of all files in the given
+*        file tree by walking the items, in the way it is done without
+*        TorrentV2Index.
+*/
+std::size_t sumLayers(BDictionary &tree, BDictionary &layers) {
+	std::size_t sum = 0;
+	for (const auto &item : tree) {
+		auto &dict = static_cast<BDictionary &>(*item.second);
+		if (!item.first->value().empty()) {
+			sum += sumLayers(dict, layers);
+			continue;
+		}
+		auto root = dict[BString::create("pieces root")]->as<BString>();
+		sum += layers[BString::create(root->value())]->as<BString>()->value()[0];
+	}
+	return sum;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::size_t numOfFiles = getNumArg(argc, argv, 1, 100000);
+	std::string data(createTorrent(numOfFiles));
+
+	std::size_t checksum = 0;
+	double itemsTime = measure([&]() {
+		std::shared_ptr<BItem> item(decode(data));
+		auto torrent = item->as<BDictionary>();
+		auto info = (*torrent)[BString::create("info")]->as<BDictionary>();
+		auto tree = (*info)[BString::create("file tree")]->as<BDictionary>();
+		auto layers = (*torrent)[BString::create("piece layers")]->
+			as<BDictionary>();
+		checksum += sumLayers(*tree, *layers);
+	});
+
+	double indexTime = measure([&]() {
+		auto index = TorrentV2Index::create(data);
+		for (const auto &file : index->files()) {
+			checksum += *index->pieceLayer(file).hash(0);
+		}
+	});
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "decoding and walking items: " << itemsTime * 1000 << " ms\n"
+		<< "TorrentV2Index: " << indexTime * 1000 << " ms (speedup "
+		<< itemsTime / indexTime << "x)\n"
+		<< "(checksum " << checksum << ")\n";
+	return 0;
+}
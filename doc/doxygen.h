@@ -36,9 +36,36 @@
 * - @ref bencoding::BInteger - Representation of an integer.
 * - @ref bencoding::BList - Representation of a list.
 * - @ref bencoding::BString - Representation of a string.
+* - @ref bencoding::BatchDecoder - Decoder of batches of independent documents
+*   utilizing multiple threads.
+* - @ref bencoding::Binding - Decoding and encoding of bencoded data directly
+*   from and into C++ types.
+* - @ref bencoding::CompactList - View of a compact list of peers or nodes.
 * - @ref bencoding::Decoder - Decoder of bencoded data.
+* - @ref bencoding::DocumentStream - Decoding of concatenated bencoded documents.
 * - @ref bencoding::Encoder - Data encoder.
+* - @ref bencoding::JsonDecoder - Decoder of JSON into bencoded data.
+* - @ref bencoding::JsonEncoder - Encoder of data into JSON.
+* - @ref bencoding::KeyInternTable - Table of dictionary keys shared by decoded
+*   dictionaries.
+* - @ref bencoding::KrpcMessage - Message of the BitTorrent DHT protocol (KRPC)
+*   decoded and encoded without allocations.
+* - @ref bencoding::ParallelDecoder - Decoder of bencoded data utilizing multiple
+*   threads.
+* - @ref bencoding::ParallelEncoder - Data encoder utilizing multiple threads.
+* - @ref bencoding::PathQuery - Extraction of items from bencoded data by their
+*   paths.
 * - @ref bencoding::PrettyPrinter - Pretty printer of data.
+* - @ref bencoding::Reader - Pull reader of bencoded data stored in memory.
+* - @ref bencoding::Schema - Description of expected structure of bencoded data.
+* - @ref bencoding::Sha1 - Computation of SHA-1 hashes.
+* - @ref bencoding::Sha256 - Computation of SHA-256 hashes.
+* - @ref bencoding::SourceMap - Mapping of decoded items to their places in the
+*   input.
+* - @ref bencoding::TorrentMetainfo - Read-only view of a decoded torrent file.
+* - @ref bencoding::TorrentV2Index - Index of the file tree and piece layers of a
+*   v2 torrent file.
+* - @ref bencoding::Writer - Streaming writer of bencoded data.
 * - @ref bencoding::BItemVisitor - Base class for all visitors of the @c BItem
 *   subclasses.
 *
@@ -28,7 +28,7 @@ public:
 public:
 	static std::unique_ptr<BString> create(ValueType value);
 
-	ValueType value() const;
+	const ValueType &value() const;
 	void setValue(ValueType value);
 	ValueType::size_type length() const;
 
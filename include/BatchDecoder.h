@@ -0,0 +1,77 @@
+/**
+* @file      BatchDecoder.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Decoder of batches of independent documents utilizing multiple
+*            threads.
+*/
+
+#ifndef BENCODING_BATCHDECODER_H
+#define BENCODING_BATCHDECODER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DecodingResult.h"
+
+namespace bencoding {
+
+class Decoder;
+class ThreadPool;
+
+/**
+* @brief Decoder of batches of independent documents utilizing multiple
+*        threads.
+*
+* The documents of a batch (e.g. torrent files or KRPC messages) are
+* distributed between threads of a ThreadPool, which balances them by work
+* stealing. Every thread has its own Decoder, which is reused for all the
+* documents decoded by the thread. The results are returned in the order of
+* the documents, and an invalid document affects only its own result:
+* @code
+* auto decoder = bencoding::BatchDecoder::create();
+* auto results = decoder->decode(documents);
+* for (std::size_t i = 0; i < results.size(); ++i) {
+*     if (!results[i]) {
+*         std::cerr << i << ": " << results[i].message() << "\n";
+*     }
+* }
+* @endcode
+*
+* Use create() to create instances.
+*/
+class BatchDecoder {
+public:
+	static std::unique_ptr<BatchDecoder> create(std::size_t numOfThreads = 0);
+	~BatchDecoder();
+
+	std::size_t numOfThreads() const;
+	void setDecoderOptions(const Decoder &decoder);
+
+	std::vector<DecodingResult> decode(
+		const std::vector<std::string> &documents);
+	std::vector<DecodingResult> decode(const std::string *documents,
+		std::size_t numOfDocuments);
+
+private:
+	explicit BatchDecoder(std::unique_ptr<ThreadPool> threadPool);
+
+private:
+	/// Threads used for the decoding.
+	std::unique_ptr<ThreadPool> threadPool;
+
+	/// Decoders of the threads (the i-th decoder is used by the i-th thread).
+	std::vector<std::unique_ptr<Decoder>> decoders;
+};
+
+/// @name Batch Decoding Without Explicit Decoder Creation
+/// @{
+std::vector<DecodingResult> decodeBatch(
+	const std::vector<std::string> &documents, std::size_t numOfThreads = 0);
+/// @}
+
+} // namespace bencoding
+
+#endif
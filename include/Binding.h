@@ -0,0 +1,731 @@
+/**
+* @file      Binding.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Decoding and encoding of bencoded data directly from and into C++
+*            types.
+*/
+
+#ifndef BENCODING_BINDING_H
+#define BENCODING_BINDING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <optional>
+#include <string_view>
+#endif
+
+#include "BInteger.h"
+#include "BItem.h"
+#include "Decoder.h"
+#include "DecodingResult.h"
+#include "Reader.h"
+#include "Writer.h"
+
+namespace bencoding {
+
+/**
+* @brief State of decoding into C++ types.
+*
+* Wraps the used Reader and remembers errors that the reader cannot detect
+* by itself, i.e. items of other types than the bound ones.
+*/
+class BindingContext {
+public:
+	explicit BindingContext(Reader &reader) noexcept;
+
+	Reader &reader() noexcept;
+	bool failAtCurrentToken(DecodingErrorCode error) noexcept;
+	DecodingResult result() const noexcept;
+
+private:
+	/// Reader of the input.
+	Reader &inputReader;
+
+	/// Reason of a failure not detected by the reader.
+	DecodingErrorCode errorCode = DecodingErrorCode::None;
+
+	/// Offset at which the decoding failed (for @c errorCode).
+	std::size_t errorPos = 0;
+};
+
+/**
+* @brief Member of a bound struct together with its dictionary key.
+*
+* Instances are created by the @c BENCODING_FIELD macro.
+*/
+struct FieldBinding {
+	/// Dictionary key (not terminated by a null character).
+	const char *key;
+
+	/// Length of @c key.
+	std::size_t keyLength;
+
+	/// Decodes the current item of the context into the member of the given
+	/// struct.
+	bool (*read)(BindingContext &context, void *object);
+
+	/// Writes the key and the value of the member of the given struct (unless
+	/// the member holds no value).
+	void (*write)(Writer &writer, const FieldBinding &field,
+		const void *object);
+};
+
+/**
+* @brief Decoding and encoding of a struct bound by @c BENCODING_BIND.
+*/
+class StructBinding {
+public:
+	StructBinding(const FieldBinding *fields, std::size_t numOfFields);
+
+	bool read(BindingContext &context, void *object) const;
+	void write(Writer &writer, const void *object) const;
+
+private:
+	std::size_t findField(std::size_t firstField, const char *key,
+		std::size_t length) const;
+
+private:
+	/// Bound members.
+	const FieldBinding *fields;
+
+	/// Number of @c fields.
+	std::size_t numOfFields;
+
+	/// Indexes of @c fields sorted by their keys.
+	std::vector<std::size_t> sortedFields;
+};
+
+/**
+* @brief Decoding and encoding of values of type @a T.
+*
+* A specialization provides
+* @code
+* static bool read(BindingContext &context, T &value);
+* static void write(Writer &writer, const T &value);
+* @endcode
+* @c read() decodes the item whose first token has just been read by the
+* reader of @a context into @a value. When the item is invalid or of a
+* different type, it returns @c false and the reason is available from @a
+* context. @c write() writes @a value as a single item. A specialization of a
+* type that is only encoded (or only decoded) may omit the other function.
+*
+* Specializations are provided for
+*  - integral types (other than @c bool),
+*  - @c std::string (and, for encoding only, <tt>const char *</tt>),
+*  - @c std::vector (lists),
+*  - @c std::tuple (lists of the given number of items),
+*  - @c std::map and @c std::unordered_map with @c std::string keys
+*    (dictionaries),
+*  - @c std::unique_ptr (a value that may be missing),
+*  - when compiling as C++17, @c std::optional (a value that may be missing)
+*    and, for encoding only, @c std::string_view,
+*  - structs bound by @c BENCODING_BIND.
+*
+* You can provide specializations for your own types.
+*/
+template<typename T, typename Enable = void>
+struct Binding;
+
+/// @cond
+namespace internal {
+
+/**
+* @brief Checks if @a value fits into the signed integral type @a T.
+*/
+template<typename T>
+bool fitsInto(BInteger::ValueType value, std::true_type /* isSigned */) {
+	return value >= std::numeric_limits<T>::min() &&
+		value <= std::numeric_limits<T>::max();
+}
+
+/**
+* @brief Checks if @a value fits into the unsigned integral type @a T.
+*/
+template<typename T>
+bool fitsInto(BInteger::ValueType value, std::false_type /* isSigned */) {
+	return value >= 0 &&
+		static_cast<unsigned long long>(value) <= std::numeric_limits<T>::max();
+}
+
+void writeLargeInteger(Writer &writer, unsigned long long value);
+
+/**
+* @brief Writes the given signed integral @a value.
+*/
+template<typename T>
+void writeInteger(Writer &writer, T value, std::true_type /* isSigned */) {
+	writer.integer(value);
+}
+
+/**
+* @brief Writes the given unsigned integral @a value.
+*/
+template<typename T>
+void writeInteger(Writer &writer, T value, std::false_type /* isSigned */) {
+	if (std::uint64_t{value} >
+			std::uint64_t{std::numeric_limits<BInteger::ValueType>::max()}) {
+		writeLargeInteger(writer, value);
+	} else {
+		writer.integer(value);
+	}
+}
+
+/**
+* @brief Checks if the given @a value is present, i.e. whether it is written
+*        as a value of a dictionary.
+*/
+template<typename T>
+bool isPresent(const T &) {
+	return true;
+}
+
+/**
+* @brief Checks if the given pointer holds a value.
+*/
+template<typename T>
+bool isPresent(const std::unique_ptr<T> &value) {
+	return value != nullptr;
+}
+
+#if __cplusplus >= 201703L
+/**
+* @brief Checks if the given optional holds a value.
+*/
+template<typename T>
+bool isPresent(const std::optional<T> &value) {
+	return value.has_value();
+}
+#endif
+
+/**
+* @brief Decodes the current item of @a context into the given member of the
+*        struct pointed to by @a object.
+*/
+template<typename S, typename M, M S::*member>
+bool readMember(BindingContext &context, void *object) {
+	return Binding<M>::read(context, static_cast<S *>(object)->*member);
+}
+
+/**
+* @brief Writes the given member of the struct pointed to by @a object under
+*        the key of @a field.
+*/
+template<typename S, typename M, M S::*member>
+void writeMember(Writer &writer, const FieldBinding &field,
+		const void *object) {
+	const M &value = static_cast<const S *>(object)->*member;
+	if (isPresent(value)) {
+		writer.key(field.key, field.keyLength);
+		Binding<M>::write(writer, value);
+	}
+}
+
+/**
+* @brief Decoding and encoding of the items of a tuple starting at index @a I.
+*/
+template<std::size_t I, std::size_t N>
+struct TupleItems {
+	template<typename Tuple>
+	static bool read(BindingContext &context, Tuple &value) {
+		Reader &reader = context.reader();
+		switch (reader.next()) {
+			case TokenType::End:
+				return context.failAtCurrentToken(
+					DecodingErrorCode::UnexpectedType);
+			case TokenType::Error:
+				return false;
+			default:
+				break;
+		}
+		using Item = typename std::tuple_element<I, Tuple>::type;
+		return Binding<Item>::read(context, std::get<I>(value)) &&
+			TupleItems<I + 1, N>::read(context, value);
+	}
+
+	template<typename Tuple>
+	static void write(Writer &writer, const Tuple &value) {
+		using Item = typename std::tuple_element<I, Tuple>::type;
+		Binding<Item>::write(writer, std::get<I>(value));
+		TupleItems<I + 1, N>::write(writer, value);
+	}
+};
+
+/**
+* @brief End of the items of a tuple.
+*/
+template<std::size_t N>
+struct TupleItems<N, N> {
+	template<typename Tuple>
+	static bool read(BindingContext &context, Tuple &) {
+		switch (context.reader().next()) {
+			case TokenType::End:
+				return true;
+			case TokenType::Error:
+				return false;
+			default:
+				return context.failAtCurrentToken(
+					DecodingErrorCode::UnexpectedType);
+		}
+	}
+
+	template<typename Tuple>
+	static void write(Writer &, const Tuple &) {}
+};
+
+/**
+* @brief Decodes a dictionary into the given map-like container.
+*/
+template<typename Map>
+bool readMap(BindingContext &context, Map &value) {
+	Reader &reader = context.reader();
+	if (reader.tokenType() != TokenType::DictBegin) {
+		return context.failAtCurrentToken(DecodingErrorCode::UnexpectedType);
+	}
+	value.clear();
+	for (;;) {
+		switch (reader.next()) {
+			case TokenType::End:
+				return true;
+			case TokenType::Error:
+				return false;
+			default:
+				break;
+		}
+		std::string key(reader.stringData(), reader.stringLength());
+		typename Map::mapped_type item{};
+		if (reader.next() == TokenType::Error ||
+				!Binding<typename Map::mapped_type>::read(context, item)) {
+			return false;
+		}
+		value[std::move(key)] = std::move(item);
+	}
+}
+
+/**
+* @brief Writes the given @a item of a map-like container (unless its value is
+*        not present).
+*/
+template<typename Item>
+void writeMapItem(Writer &writer, const Item &item) {
+	if (isPresent(item.second)) {
+		writer.key(item.first);
+		Binding<typename std::remove_cv<
+			decltype(item.second)>::type>::write(writer, item.second);
+	}
+}
+
+} // namespace internal
+/// @endcond
+
+/**
+* @brief Decoding and encoding of integers as integral types.
+*
+* Integers that do not fit into @a T are reported as
+* DecodingErrorCode::IntegerOutOfRange.
+*/
+template<typename T>
+struct Binding<T, typename std::enable_if<std::is_integral<T>::value &&
+		!std::is_same<T, bool>::value>::type> {
+	static bool read(BindingContext &context, T &value) {
+		Reader &reader = context.reader();
+		if (reader.tokenType() != TokenType::Integer) {
+			return context.failAtCurrentToken(DecodingErrorCode::UnexpectedType);
+		}
+		auto integer = reader.integer();
+		if (!internal::fitsInto<T>(integer, std::is_signed<T>())) {
+			return context.failAtCurrentToken(
+				DecodingErrorCode::IntegerOutOfRange);
+		}
+		value = integer;
+		return true;
+	}
+
+	static void write(Writer &writer, T value) {
+		internal::writeInteger(writer, value, std::is_signed<T>());
+	}
+};
+
+/**
+* @brief Decoding and encoding of strings as @c std::string.
+*/
+template<>
+struct Binding<std::string> {
+	static bool read(BindingContext &context, std::string &value) {
+		Reader &reader = context.reader();
+		if (reader.tokenType() != TokenType::String) {
+			return context.failAtCurrentToken(DecodingErrorCode::UnexpectedType);
+		}
+		value.assign(reader.stringData(), reader.stringLength());
+		return true;
+	}
+
+	static void write(Writer &writer, const std::string &value) {
+		writer.string(value);
+	}
+};
+
+/**
+* @brief Encoding of null-terminated strings.
+*/
+template<>
+struct Binding<const char *> {
+	static void write(Writer &writer, const char *value) {
+		writer.string(value, std::strlen(value));
+	}
+};
+
+#if __cplusplus >= 201703L
+/**
+* @brief Encoding of string views.
+*/
+template<>
+struct Binding<std::string_view> {
+	static void write(Writer &writer, std::string_view value) {
+		writer.string(value.data(), value.size());
+	}
+};
+#endif
+
+/**
+* @brief Decoding and encoding of lists as @c std::vector.
+*
+* When decoding, the previous contents of the vector are replaced.
+*/
+template<typename T>
+struct Binding<std::vector<T>> {
+	static bool read(BindingContext &context, std::vector<T> &value) {
+		Reader &reader = context.reader();
+		if (reader.tokenType() != TokenType::ListBegin) {
+			return context.failAtCurrentToken(DecodingErrorCode::UnexpectedType);
+		}
+		value.clear();
+		for (;;) {
+			switch (reader.next()) {
+				case TokenType::End:
+					return true;
+				case TokenType::Error:
+					return false;
+				default:
+					break;
+			}
+			value.emplace_back();
+			if (!Binding<T>::read(context, value.back())) {
+				return false;
+			}
+		}
+	}
+
+	static void write(Writer &writer, const std::vector<T> &value) {
+		writer.beginList();
+		for (const auto &item : value) {
+			Binding<T>::write(writer, item);
+		}
+		writer.end();
+	}
+};
+
+/**
+* @brief Decoding and encoding of lists of a fixed number of items of
+*        possibly different types.
+*
+* A list with a different number of items is reported as
+* DecodingErrorCode::UnexpectedType.
+*/
+template<typename... Types>
+struct Binding<std::tuple<Types...>> {
+	static bool read(BindingContext &context, std::tuple<Types...> &value) {
+		if (context.reader().tokenType() != TokenType::ListBegin) {
+			return context.failAtCurrentToken(DecodingErrorCode::UnexpectedType);
+		}
+		return internal::TupleItems<0, sizeof...(Types)>::read(context, value);
+	}
+
+	static void write(Writer &writer, const std::tuple<Types...> &value) {
+		writer.beginList();
+		internal::TupleItems<0, sizeof...(Types)>::write(writer, value);
+		writer.end();
+	}
+};
+
+/**
+* @brief Decoding and encoding of dictionaries as @c std::map with @c
+*        std::string keys.
+*
+* When decoding, the previous contents of the map are replaced and when a key
+* appears more than once, the last value is used. The map is already sorted,
+* so it is written in its order. Items whose values are not present (e.g.
+* null @c std::unique_ptr) are not written.
+*/
+template<typename T>
+struct Binding<std::map<std::string, T>> {
+	static bool read(BindingContext &context, std::map<std::string, T> &value) {
+		return internal::readMap(context, value);
+	}
+
+	static void write(Writer &writer, const std::map<std::string, T> &value) {
+		writer.beginDict();
+		for (const auto &item : value) {
+			internal::writeMapItem(writer, item);
+		}
+		writer.end();
+	}
+};
+
+/**
+* @brief Decoding and encoding of dictionaries as @c std::unordered_map with
+*        @c std::string keys.
+*
+* Like the @c std::map specialization, but the keys are sorted before they
+* are written.
+*/
+template<typename T>
+struct Binding<std::unordered_map<std::string, T>> {
+	static bool read(BindingContext &context,
+			std::unordered_map<std::string, T> &value) {
+		return internal::readMap(context, value);
+	}
+
+	static void write(Writer &writer,
+			const std::unordered_map<std::string, T> &value) {
+		using Item = typename std::unordered_map<std::string, T>::value_type;
+		std::vector<const Item *> items;
+		items.reserve(value.size());
+		for (const auto &item : value) {
+			items.push_back(&item);
+		}
+		std::sort(items.begin(), items.end(),
+			[](const Item *a, const Item *b) { return a->first < b->first; });
+
+		writer.beginDict();
+		for (const auto item : items) {
+			internal::writeMapItem(writer, *item);
+		}
+		writer.end();
+	}
+};
+
+/**
+* @brief Decoding and encoding of values that may be missing, held by @c
+*        std::unique_ptr.
+*
+* When decoding, a new value is allocated. A null pointer can be written only
+* as a member of a bound struct or as a value of a map, in which case its key
+* is omitted.
+*/
+template<typename T>
+struct Binding<std::unique_ptr<T>> {
+	static bool read(BindingContext &context, std::unique_ptr<T> &value) {
+		value.reset(new T());
+		return Binding<T>::read(context, *value);
+	}
+
+	static void write(Writer &writer, const std::unique_ptr<T> &value) {
+		Binding<T>::write(writer, *value);
+	}
+};
+
+#if __cplusplus >= 201703L
+/**
+* @brief Decoding and encoding of values that may be missing, held by @c
+*        std::optional.
+*
+* An empty optional can be written only as a member of a bound struct or as a
+* value of a map, in which case its key is omitted.
+*/
+template<typename T>
+struct Binding<std::optional<T>> {
+	static bool read(BindingContext &context, std::optional<T> &value) {
+		value.emplace();
+		return Binding<T>::read(context, *value);
+	}
+
+	static void write(Writer &writer, const std::optional<T> &value) {
+		Binding<T>::write(writer, *value);
+	}
+};
+#endif
+
+/**
+* @brief Binds the members of the given struct to dictionary keys.
+*
+* Use it in the global namespace with a fully qualified name of the struct,
+* followed by one @c BENCODING_FIELD for every bound member:
+* @code
+* struct Peer {
+*     std::string ip;
+*     std::uint16_t port = 0;
+* };
+* BENCODING_BIND(Peer,
+*     BENCODING_FIELD(ip, "ip"),
+*     BENCODING_FIELD(port, "port")
+* )
+* @endcode
+* A struct may have members of other bound structs, provided that those are
+* bound first. When decoding, members whose keys are not present in the input
+* keep their values; keys without a member are skipped. When a key appears
+* more than once, the last value is used. Listing the members in the order of
+* their keys (i.e. sorted, as required by the specification) makes the
+* dispatch fastest. When encoding, the keys are always written sorted and
+* members that hold no value (e.g. null @c std::unique_ptr) are omitted.
+*/
+#define BENCODING_BIND(Type, ...) \
+	namespace bencoding { \
+	template<> \
+	struct Binding<Type> { \
+		using BoundType = Type; \
+		static const StructBinding &structBinding() { \
+			static const FieldBinding fields[] = {__VA_ARGS__}; \
+			static const StructBinding binding(fields, \
+				sizeof(fields) / sizeof(fields[0])); \
+			return binding; \
+		} \
+		static bool read(BindingContext &context, BoundType &value) { \
+			return structBinding().read(context, &value); \
+		} \
+		static void write(Writer &writer, const BoundType &value) { \
+			structBinding().write(writer, &value); \
+		} \
+	}; \
+	}
+
+/**
+* @brief Binds the given member of a struct to the given dictionary @a key
+*        (a string literal).
+*
+* To be used only inside @c BENCODING_BIND.
+*/
+#define BENCODING_FIELD(member, key) \
+	::bencoding::FieldBinding{key, sizeof(key) - 1, \
+		&::bencoding::internal::readMember<BoundType, \
+			decltype(BoundType::member), &BoundType::member>, \
+		&::bencoding::internal::writeMember<BoundType, \
+			decltype(BoundType::member), &BoundType::member>}
+
+/// @name Decoding Into C++ Types
+/// @{
+
+/**
+* @brief Decodes the given @a length characters of bencoded @a data into
+*        @a value.
+*
+* @return Successful result (without data) or the reason of the failure. Items
+*         of other types than the bound ones are reported as
+*         DecodingErrorCode::UnexpectedType. In case of a failure, @a value
+*         may be modified only partially.
+*
+* The data are read by Reader and decoded straight into @a value, without
+* creating any BItem instances.
+*/
+template<typename T>
+DecodingResult decodeInto(const char *data, std::size_t length, T &value,
+		const DecoderLimits &limits = DecoderLimits()) {
+	Reader reader(data, length);
+	reader.setLimits(limits);
+	BindingContext context(reader);
+	switch (reader.next()) {
+		case TokenType::EndOfInput:
+			return DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+				reader.offset());
+		case TokenType::Error:
+			return context.result();
+		default:
+			break;
+	}
+
+	if (!Binding<T>::read(context, value)) {
+		return context.result();
+	} else if (reader.offset() != length) {
+		return DecodingResult(DecodingErrorCode::UndecodedCharacters,
+			reader.offset());
+	}
+	return DecodingResult();
+}
+
+/**
+* @brief Decodes the given bencoded @a data into @a value.
+*
+* See decodeInto(const char *, std::size_t, T &, const DecoderLimits &) for
+* more details.
+*/
+template<typename T>
+DecodingResult decodeInto(const std::string &data, T &value,
+		const DecoderLimits &limits = DecoderLimits()) {
+	return decodeInto(data.data(), data.size(), value, limits);
+}
+
+/**
+* @brief Decodes the given bencoded @a data into a value of type @a T.
+*
+* @throws DecodingError When @a data are not valid or do not match @a T.
+*
+* For example,
+* @code
+* auto peer = bencoding::decodeAs<Peer>(data);
+* @endcode
+*/
+template<typename T>
+T decodeAs(const std::string &data) {
+	T value;
+	auto result = decodeInto(data, value);
+	if (!result) {
+		throw DecodingError(result.message());
+	}
+	return value;
+}
+
+/// @}
+
+/// @name Encoding Of C++ Types
+/// @{
+
+/**
+* @brief Encodes the given @a value into a string.
+*
+* The value is written by Writer as it is traversed, without creating any
+* BItem instances. For example,
+* @code
+* std::map<std::string, std::vector<int>> data{{"b", {1, 2}}, {"a", {}}};
+* bencoding::encode(data); // "d1:ale1:bli1ei2eee"
+* @endcode
+*
+* Items (BItem instances) are encoded by encode(std::shared_ptr<BItem>).
+*/
+template<typename T>
+typename std::enable_if<!std::is_convertible<T, std::shared_ptr<BItem>>::value,
+	std::string>::type encode(const T &value) {
+	auto writer = Writer::create();
+	Binding<T>::write(*writer, value);
+	return writer->encodedData();
+}
+
+/**
+* @brief Encodes the given @a value directly into the given @a output stream.
+*
+* See encode(const T &) for more details.
+*/
+template<typename T>
+void encode(const T &value, std::ostream &output) {
+	auto writer = Writer::create(output);
+	Binding<T>::write(*writer, value);
+}
+
+/// @}
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,279 @@
+/**
+* @file      CompactList.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Views of compact peer and node lists.
+*/
+
+#ifndef BENCODING_COMPACTLIST_H
+#define BENCODING_COMPACTLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include "BString.h"
+#include "Krpc.h"
+
+namespace bencoding {
+
+/**
+* @brief IPv4 address and port of a peer.
+*
+* Compact form: 4 bytes of the address and 2 bytes of the port, both in
+* network byte order (BEP 23).
+*/
+struct Ipv4Endpoint {
+	/// Length of the compact form.
+	static const std::size_t COMPACT_SIZE = 6;
+
+	static Ipv4Endpoint fromCompact(const char *data) noexcept;
+	static void fromCompact(const char *data, std::size_t count,
+		Ipv4Endpoint *endpoints) noexcept;
+
+	std::string toString() const;
+
+	/// Address in host byte order (e.g. @c 0x7f000001 for 127.0.0.1).
+	std::uint32_t address;
+
+	/// Port in host byte order.
+	std::uint16_t port;
+};
+
+/**
+* @brief IPv6 address and port of a peer.
+*
+* Compact form: 16 bytes of the address and 2 bytes of the port, both in
+* network byte order (BEP 7).
+*/
+struct Ipv6Endpoint {
+	/// Length of the compact form.
+	static const std::size_t COMPACT_SIZE = 18;
+
+	static Ipv6Endpoint fromCompact(const char *data) noexcept;
+	static void fromCompact(const char *data, std::size_t count,
+		Ipv6Endpoint *endpoints) noexcept;
+
+	std::string toString() const;
+
+	/// Address in network byte order.
+	std::uint8_t address[16];
+
+	/// Port in host byte order.
+	std::uint16_t port;
+};
+
+/**
+* @brief ID and IPv4 endpoint of a DHT node.
+*
+* Compact form: 20 bytes of the ID followed by the compact form of
+* Ipv4Endpoint (BEP 5).
+*/
+struct DhtNode {
+	/// Length of the compact form.
+	static const std::size_t COMPACT_SIZE = 26;
+
+	static DhtNode fromCompact(const char *data) noexcept;
+	static void fromCompact(const char *data, std::size_t count,
+		DhtNode *nodes) noexcept;
+
+	/// Node ID (20 bytes pointing into the compact list).
+	const char *id;
+
+	/// Endpoint of the node.
+	Ipv4Endpoint endpoint;
+};
+
+/**
+* @brief ID and IPv6 endpoint of a DHT node.
+*
+* Compact form: 20 bytes of the ID followed by the compact form of
+* Ipv6Endpoint (BEP 32).
+*/
+struct DhtNode6 {
+	/// Length of the compact form.
+	static const std::size_t COMPACT_SIZE = 38;
+
+	static DhtNode6 fromCompact(const char *data) noexcept;
+	static void fromCompact(const char *data, std::size_t count,
+		DhtNode6 *nodes) noexcept;
+
+	/// Node ID (20 bytes pointing into the compact list).
+	const char *id;
+
+	/// Endpoint of the node.
+	Ipv6Endpoint endpoint;
+};
+
+/**
+* @brief View of a compact list of records of type @a Record.
+*
+* Tracker responses and DHT replies carry peers and nodes as strings of
+* fixed-size records (@c peers, @c peers6, @c nodes, and @c nodes6). The view
+* iterates the records directly over the storage of such a string, converting
+* each record when it is dereferenced, so the string is never copied:
+* @code
+* for (auto peer : bencoding::CompactPeers(*peersString)) {
+*     connect(peer.address, peer.port);
+* }
+* @endcode
+* To convert many records at once, use copyTo(), which is faster than
+* iterating.
+*
+* The view does not own any memory, so the viewed string has to outlive it.
+* Trailing bytes that do not form a whole record are ignored (see
+* isWellFormed()).
+*/
+template<typename Record>
+class CompactList {
+public:
+	/// Iterator over the records.
+	class const_iterator {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Record;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Record *;
+		using reference = Record;
+
+	public:
+		const_iterator() noexcept: pos(nullptr) {}
+		explicit const_iterator(const char *pos) noexcept: pos(pos) {}
+
+		/// Returns the current record.
+		Record operator*() const noexcept {
+			return Record::fromCompact(pos);
+		}
+
+		/// Moves to the next record.
+		const_iterator &operator++() noexcept {
+			pos += Record::COMPACT_SIZE;
+			return *this;
+		}
+
+		/// Moves to the next record and returns the previous position.
+		const_iterator operator++(int) noexcept {
+			const_iterator old(*this);
+			pos += Record::COMPACT_SIZE;
+			return old;
+		}
+
+		/// Checks if both iterators point to the same record.
+		bool operator==(const const_iterator &other) const noexcept {
+			return pos == other.pos;
+		}
+
+		/// Checks if the iterators point to different records.
+		bool operator!=(const const_iterator &other) const noexcept {
+			return pos != other.pos;
+		}
+
+	private:
+		/// The current record.
+		const char *pos;
+	};
+
+public:
+	/**
+	* @brief Constructs an empty view.
+	*/
+	CompactList() noexcept: data(nullptr), length(0) {}
+
+	/**
+	* @brief Constructs a view of the given @a length characters of @a data.
+	*/
+	CompactList(const char *data, std::size_t length) noexcept:
+		data(data), length(length) {}
+
+	/**
+	* @brief Constructs a view of the value of the given @a string.
+	*/
+	explicit CompactList(const BString &string) noexcept:
+		data(string.value().data()), length(string.value().size()) {}
+
+	/**
+	* @brief Constructs a view of the given string of a KRPC message.
+	*/
+	explicit CompactList(const KrpcBytes &bytes) noexcept:
+		data(bytes.data), length(bytes.length) {}
+
+	/**
+	* @brief Returns the number of whole records.
+	*/
+	std::size_t size() const noexcept {
+		return length / Record::COMPACT_SIZE;
+	}
+
+	/**
+	* @brief Checks if there are no records.
+	*/
+	bool empty() const noexcept {
+		return size() == 0;
+	}
+
+	/**
+	* @brief Checks if the viewed string consists only of whole records.
+	*/
+	bool isWellFormed() const noexcept {
+		return length % Record::COMPACT_SIZE == 0;
+	}
+
+	/**
+	* @brief Returns the record at the given @a index.
+	*
+	* @par Preconditions
+	*  - <tt>index < size()</tt>
+	*/
+	Record operator[](std::size_t index) const noexcept {
+		return Record::fromCompact(data + index * Record::COMPACT_SIZE);
+	}
+
+	/**
+	* @brief Returns an iterator to the first record.
+	*/
+	const_iterator begin() const noexcept {
+		return const_iterator(data);
+	}
+
+	/**
+	* @brief Returns an iterator past the last whole record.
+	*/
+	const_iterator end() const noexcept {
+		return const_iterator(data + size() * Record::COMPACT_SIZE);
+	}
+
+	/**
+	* @brief Converts all the records into @a records, which has to have room
+	*        for size() records.
+	*
+	* @return Number of converted records.
+	*/
+	std::size_t copyTo(Record *records) const noexcept {
+		Record::fromCompact(data, size(), records);
+		return size();
+	}
+
+private:
+	/// The viewed string.
+	const char *data;
+
+	/// Length of the viewed string.
+	std::size_t length;
+};
+
+/// View of compact IPv4 peers (@c peers of trackers, @c values of DHT).
+using CompactPeers = CompactList<Ipv4Endpoint>;
+
+/// View of compact IPv6 peers (@c peers6 of trackers).
+using CompactPeers6 = CompactList<Ipv6Endpoint>;
+
+/// View of compact IPv4 DHT nodes (@c nodes).
+using CompactNodes = CompactList<DhtNode>;
+
+/// View of compact IPv6 DHT nodes (@c nodes6).
+using CompactNodes6 = CompactList<DhtNode6>;
+
+} // namespace bencoding
+
+#endif
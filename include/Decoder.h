@@ -8,11 +8,17 @@
 #ifndef BENCODING_DECODER_H
 #define BENCODING_DECODER_H
 
+#include <cstddef>
 #include <exception>
+#include <istream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "BItem.h"
+#include "DecodingResult.h"
 
 namespace bencoding {
 
@@ -20,6 +26,9 @@ class BDictionary;
 class BInteger;
 class BList;
 class BString;
+class KeyInternTable;
+class Reader;
+class Schema;
 
 /**
 * @brief Exception thrown when there is an error during the decoding.
@@ -29,6 +38,39 @@ public:
 	explicit DecodingError(const std::string &what);
 };
 
+/**
+* @brief Exception thrown when the decoding exceeds a limit from
+*        DecoderLimits.
+*/
+class DecodingLimitExceeded: public DecodingError {
+public:
+	explicit DecodingLimitExceeded(const std::string &what);
+};
+
+/**
+* @brief Limits of resources that a single call of Decoder::decode() may use.
+*
+* By default, nothing is limited. The limits are meant to protect against
+* huge or adversarial inputs, e.g. when decoding data received from a
+* network.
+*/
+struct DecoderLimits {
+	/// Maximal nesting depth of lists and dictionaries.
+	std::size_t maxDepth = std::numeric_limits<std::size_t>::max();
+
+	/// Maximal number of characters read from the input.
+	std::size_t maxInputLength = std::numeric_limits<std::size_t>::max();
+
+	/// Maximal number of decoded items (including dictionary keys).
+	std::size_t maxNumOfItems = std::numeric_limits<std::size_t>::max();
+
+	/// Maximal length of a single string.
+	std::size_t maxStringLength = std::numeric_limits<std::size_t>::max();
+
+	/// Maximal total length of all decoded strings.
+	std::size_t maxTotalStringLength = std::numeric_limits<std::size_t>::max();
+};
+
 /**
 * @brief Decoder of bencoded data.
 *
@@ -36,6 +78,15 @@ public:
 * href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">BitTorrent
 * specification</a>.
 *
+* Memory for a string is never allocated up front based only on its declared
+* length. When the input does not provide that many characters, the decoding
+* fails after allocating at most about twice the number of available
+* characters. Resources used by a single decoding can be limited by using
+* setLimits(). When a limit is exceeded, DecodingLimitExceeded is thrown.
+*
+* To only check that data are well-formed, use validate(), which does not
+* build any items.
+*
 * Use create() to create instances.
 */
 class Decoder {
@@ -45,43 +96,77 @@ public:
 	std::unique_ptr<BItem> decode(const std::string &data);
 	std::unique_ptr<BItem> decode(std::istream &input);
 
-private:
-	Decoder();
-
-	void readExpectedChar(std::istream &input, char expected_char) const;
-
-	/// @name Integer Decoding
+	/// @name Decoding Without Exceptions
 	/// @{
-	std::unique_ptr<BDictionary> decodeDictionary(std::istream &input);
-	std::unique_ptr<BDictionary> decodeDictionaryItemsIntoDictionary(
-		std::istream &input);
-	std::shared_ptr<BString> decodeDictionaryKey(std::istream &input);
-	std::unique_ptr<BItem> decodeDictionaryValue(std::istream &input);
+	DecodingResult tryDecode(const std::string &data) noexcept;
+	DecodingResult tryDecode(const char *data, std::size_t length) noexcept;
+	DecodingResult tryDecodePrefix(const char *data, std::size_t length,
+		std::size_t &itemLength) noexcept;
 	/// @}
 
-	/// @name Integer Decoding
+	/// @name Schema-Guided Decoding
 	/// @{
-	std::unique_ptr<BInteger> decodeInteger(std::istream &input) const;
-	std::string readEncodedInteger(std::istream &input) const;
-	std::unique_ptr<BInteger> decodeEncodedInteger(
-		const std::string &encodedInteger) const;
+	std::unique_ptr<BItem> decode(const std::string &data,
+		const Schema &schema);
+	DecodingResult tryDecode(const std::string &data,
+		const Schema &schema) noexcept;
+	DecodingResult tryDecode(const char *data, std::size_t length,
+		const Schema &schema) noexcept;
 	/// @}
 
-	/// @name List Decoding
+	/// @name Validation
 	/// @{
-	std::unique_ptr<BList> decodeList(std::istream &input);
-	std::unique_ptr<BList> decodeListItemsIntoList(std::istream &input);
+	DecodingResult validate(const std::string &data) noexcept;
+	DecodingResult validate(const char *data, std::size_t length) noexcept;
 	/// @}
 
-	/// @name String Decoding
+	/// @name Options
 	/// @{
-	std::unique_ptr<BString> decodeString(std::istream &input) const;
-	std::string::size_type readStringLength(std::istream &input) const;
-	std::string readStringOfGivenLength(std::istream &input,
-		std::string::size_type length) const;
+	void setLimits(const DecoderLimits &limits);
+	const DecoderLimits &getLimits() const;
+	void setKeyOrderChecking(bool enabled);
+	void setSpanRecording(bool enabled);
+	void setSpanRecordingKeys(const std::vector<std::string> &keys);
+	void setInfoHashComputation(bool enabled);
+	void setKeyInterning(std::shared_ptr<KeyInternTable> table);
+	std::shared_ptr<KeyInternTable> getKeyInterning() const;
 	/// @}
 
-	void validateInputDoesNotContainUndecodedCharacters(std::istream &input);
+private:
+	struct InfoHashing;
+
+private:
+	Decoder();
+
+	std::unique_ptr<BItem> buildItem(Reader &reader,
+		SourceMap *sourceMap, InfoHashing *infoHashing,
+		bool tokenRead = false) const;
+	std::unique_ptr<BItem> buildItem(Reader &reader, const Schema &schema,
+		DecodingResult &mismatch) const;
+	bool isSpanRecordingKey(const BString &key) const;
+	std::shared_ptr<BString> createKey(const char *data, std::size_t length,
+		bool needsOwnKey) const;
+	[[noreturn]] void throwDecodingError(const DecodingResult &result) const;
+	void readEncodedItem(std::istream &input, std::string &data) const;
+
+private:
+	/// Limits of the used resources.
+	DecoderLimits limits;
+
+	/// Check that dictionary keys are sorted and unique?
+	bool keyOrderChecking = false;
+
+	/// Record spans of all decoded items?
+	bool spanRecording = false;
+
+	/// Keys whose values have their spans recorded.
+	std::vector<std::string> spanRecordingKeys;
+
+	/// Compute infohashes?
+	bool infoHashComputation = false;
+
+	/// Table of interned dictionary keys (@c nullptr when not interning).
+	std::shared_ptr<KeyInternTable> keyInternTable;
 };
 
 /// @name Decoding Without Explicit Decoder Creation
@@ -0,0 +1,105 @@
+/**
+* @file      DecodingResult.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Result of decoding that does not throw exceptions.
+*/
+
+#ifndef BENCODING_DECODINGRESULT_H
+#define BENCODING_DECODINGRESULT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "BItem.h"
+#include "SourceMap.h"
+
+namespace bencoding {
+
+/**
+* @brief Reason why decoding failed.
+*/
+enum class DecodingErrorCode {
+	None,                          ///< No error.
+	UnexpectedEndOfInput,          ///< The input ends in the middle of an item.
+	UnexpectedCharacter,           ///< A character that cannot appear here.
+	InvalidInteger,                ///< An integer of invalid format.
+	IntegerOutOfRange,             ///< An integer that does not fit its type.
+	InvalidStringLength,           ///< A string length of invalid format.
+	NonStringKey,                  ///< A dictionary key that is not a string.
+	UnsortedKeys,                  ///< A key smaller than the previous key.
+	DuplicateKey,                  ///< A key equal to the previous key.
+	UnexpectedType,                ///< An item of another type than expected.
+	MissingKey,                    ///< A required key is not present.
+	InvalidValue,                  ///< A value of invalid length or contents.
+	UndecodedCharacters,           ///< Characters after the decoded item.
+	DepthLimitExceeded,            ///< See DecoderLimits::maxDepth.
+	InputLengthLimitExceeded,      ///< See DecoderLimits::maxInputLength.
+	NumOfItemsLimitExceeded,       ///< See DecoderLimits::maxNumOfItems.
+	StringLengthLimitExceeded,     ///< See DecoderLimits::maxStringLength.
+	TotalStringLengthLimitExceeded,///< See DecoderLimits::maxTotalStringLength.
+	OutOfMemory                    ///< Memory for the decoded data ran out.
+};
+
+const char *getErrorDescription(DecodingErrorCode error) noexcept;
+bool isLimitError(DecodingErrorCode error) noexcept;
+
+/**
+* @brief Result of decoding that does not throw exceptions.
+*
+* Holds either the decoded data or the reason of the failure together with the
+* offset of the input character at which the decoding failed. A textual
+* description of the failure is created only when message() is called, so
+* rejecting invalid input is cheap.
+*/
+class DecodingResult {
+public:
+	DecodingResult() noexcept;
+	explicit DecodingResult(std::unique_ptr<BItem> data) noexcept;
+	DecodingResult(std::unique_ptr<BItem> data, SourceMap sourceMap,
+		std::string infoHashV1 = std::string(),
+		std::string infoHashV2 = std::string()) noexcept;
+	DecodingResult(DecodingErrorCode error, std::size_t offset) noexcept;
+
+	/// @name Status
+	/// @{
+	bool ok() const noexcept;
+	explicit operator bool() const noexcept;
+	DecodingErrorCode error() const noexcept;
+	std::size_t offset() const noexcept;
+	std::string message() const;
+	/// @}
+
+	/// @name Decoded Data
+	/// @{
+	BItem *data() const noexcept;
+	std::unique_ptr<BItem> releaseData() noexcept;
+	const SourceMap &sourceMap() const noexcept;
+	const std::string &infoHashV1() const noexcept;
+	const std::string &infoHashV2() const noexcept;
+	/// @}
+
+private:
+	/// Decoded data (@c nullptr on failure).
+	std::unique_ptr<BItem> decodedData;
+
+	/// Spans of the decoded items in the input.
+	SourceMap spans;
+
+	/// BitTorrent v1 infohash (SHA-1) of the decoded data.
+	std::string v1InfoHash;
+
+	/// BitTorrent v2 infohash (SHA-256) of the decoded data.
+	std::string v2InfoHash;
+
+	/// Reason of the failure.
+	DecodingErrorCode errorCode = DecodingErrorCode::None;
+
+	/// Offset of the input character at which the decoding failed.
+	std::size_t errorOffset = 0;
+};
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,137 @@
+/**
+* @file      DocumentStream.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Decoding of concatenated bencoded documents.
+*/
+
+#ifndef BENCODING_DOCUMENTSTREAM_H
+#define BENCODING_DOCUMENTSTREAM_H
+
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DecodingResult.h"
+
+namespace bencoding {
+
+class Decoder;
+class ThreadPool;
+
+/**
+* @brief Decoding of concatenated bencoded documents.
+*
+* The input consists of bencoded documents that directly follow each other
+* (e.g. a log of KRPC messages). Every call of next() returns the next
+* document:
+* @code
+* std::ifstream log("dht.log", std::ios::binary);
+* auto documents = bencoding::DocumentStream::create(log);
+* while (documents->hasNext()) {
+*     auto result = documents->next();
+*     if (!result) {
+*         std::cerr << result.message() << "\n";
+*         break;
+*     }
+*     process(result.releaseData());
+* }
+* @endcode
+*
+* The input is either in memory (e.g. a memory-mapped file, which is not
+* copied) or in a stream, which is read in large blocks into a buffer that
+* is reused for all the documents. The documents are decoded by the same
+* Decoder (see setDecoderOptions()). When more threads are used (see
+* setNumOfThreads()), the boundaries of the upcoming documents are found by
+* Reader and the documents are decoded in parallel ahead of the calls of
+* next().
+*
+* Documents cannot be found after an invalid document, so the first error
+* ends the stream. Offsets in errors are counted from the beginning of the
+* input. Spans of items (see Decoder::setSpanRecording()) are counted from the
+* beginning of their documents.
+*
+* Use create() to create instances.
+*/
+class DocumentStream {
+public:
+	static std::unique_ptr<DocumentStream> create(const std::string &data);
+	static std::unique_ptr<DocumentStream> create(std::string &&data) = delete;
+	static std::unique_ptr<DocumentStream> create(const char *data,
+		std::size_t length);
+	static std::unique_ptr<DocumentStream> create(std::istream &input);
+	~DocumentStream();
+
+	/// @name Options
+	/// @{
+	void setDecoderOptions(const Decoder &decoder);
+	void setNumOfThreads(std::size_t numOfThreads);
+	std::size_t numOfThreads() const;
+	/// @}
+
+	/// @name Decoding
+	/// @{
+	bool hasNext();
+	DecodingResult next();
+	std::size_t offset() const;
+	/// @}
+
+private:
+	/// A document that has been decoded ahead.
+	struct DecodedDocument {
+		/// Result of the decoding.
+		DecodingResult result;
+
+		/// Offset of the document in the input.
+		std::size_t begin;
+	};
+
+private:
+	DocumentStream(const char *data, std::size_t length, std::istream *input);
+
+	bool readMore();
+	DecodingResult decodeNext();
+	void decodeAhead();
+	DecodingResult finishDocument(DecodingResult result, std::size_t begin);
+
+private:
+	/// Characters of the input that are available (the whole input when it
+	/// is in memory, the contents of @c buffer otherwise).
+	const char *data;
+
+	/// Number of characters pointed to by @c data.
+	std::size_t length;
+
+	/// Offset of the next document in @c data.
+	std::size_t pos = 0;
+
+	/// Offset of @c data in the input.
+	std::size_t dataOffset = 0;
+
+	/// Stream from which the input is read (@c nullptr when the input is in
+	/// memory).
+	std::istream *input;
+
+	/// Buffer with characters read from @c input.
+	std::string buffer;
+
+	/// Has an invalid document been found?
+	bool failed = false;
+
+	/// Decoders (the i-th decoder is used by the i-th thread).
+	std::vector<std::unique_ptr<Decoder>> decoders;
+
+	/// Threads decoding documents ahead (@c nullptr when a single thread is
+	/// used).
+	std::unique_ptr<ThreadPool> threadPool;
+
+	/// Documents that have been decoded ahead.
+	std::deque<DecodedDocument> decodedDocuments;
+};
+
+} // namespace bencoding
+
+#endif
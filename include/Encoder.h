@@ -31,6 +31,7 @@ public:
 	static std::unique_ptr<Encoder> create();
 
 	std::string encode(std::shared_ptr<BItem> data);
+	void encode(std::shared_ptr<BItem> data, std::string &output);
 
 private:
 	Encoder();
@@ -0,0 +1,157 @@
+/**
+* @file      JsonDecoder.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Decoder of JSON into bencoded data.
+*/
+
+#ifndef BENCODING_JSONDECODER_H
+#define BENCODING_JSONDECODER_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BInteger.h"
+#include "BItem.h"
+
+namespace bencoding {
+
+/**
+* @brief Decoder of JSON into bencoded data.
+*
+* Converts JSON (RFC 8259) either directly into bencoded data, without
+* building a tree of BItem instances (decodeIntoBencode()), or directly into a
+* tree of BItem instances, without producing bencoded data (decode()):
+*  - objects are converted into dictionaries and arrays into lists,
+*  - integral numbers are converted into integers (numbers with a fraction or
+*    an exponent are not supported because bencoding has no such type),
+*  - strings are converted into strings (encoded in UTF-8),
+*  - @c true and @c false are converted into integers 1 and 0 (@c null is not
+*    supported).
+*
+* Strings marked as binary by JsonEncoder (prefixed with @c "hex:" or @c
+* "base64:") can be converted back into the original bytes (see
+* setBinaryDecoding()).
+*
+* By default, keys of dictionaries are sorted as required by the <a
+* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">specification</a>
+* (see setKeySorting()). Members of objects whose keys are already sorted are
+* not moved.
+*
+* Nested objects and arrays are decoded without recursion, so deeply nested
+* input cannot exhaust the stack. Their depth can be limited by setMaxDepth().
+*
+* Errors are reported by throwing DecodingError.
+*
+* Use create() to create instances.
+*/
+class JsonDecoder {
+public:
+	static std::unique_ptr<JsonDecoder> create();
+
+	std::string decodeIntoBencode(const std::string &json);
+	std::unique_ptr<BItem> decode(const std::string &json);
+
+	/// @name Options
+	/// @{
+	void setBinaryDecoding(bool enabled);
+	void setKeySorting(bool enabled);
+	void setMaxDepth(std::size_t depth);
+	/// @}
+
+private:
+	/// Position of a dictionary item in the output.
+	struct Member {
+		/// Offset of the first character of the encoded key.
+		std::size_t begin;
+
+		/// Offset of the first character of the key's value (without the
+		/// length).
+		std::size_t keyBegin;
+
+		/// Offset right after the key.
+		std::size_t keyEnd;
+
+		/// Offset right after the encoded value.
+		std::size_t end;
+	};
+
+	class Output;
+	class BencodeOutput;
+	class ItemOutput;
+
+private:
+	JsonDecoder();
+
+	/// @name Parsing
+	/// @{
+	void decodeInput(const std::string &json, Output &output);
+	void decodeValues(Output &output);
+	void readKey(Output &output);
+	BInteger::ValueType readNumber();
+	void readLiteral(const char *literal);
+	void readString(std::string &str);
+	void readEscapeSequence(std::string &str);
+	unsigned readHexQuad();
+	void skipWhitespace();
+	void readExpectedChar(char expectedChar);
+	[[noreturn]] void throwError(const std::string &what) const;
+	/// @}
+
+	/// @name Output
+	/// @{
+	void writeString(const std::string &str);
+	void sortMembers(std::size_t firstMember);
+	int compareKeys(const Member &lhs, const Member &rhs) const;
+	/// @}
+
+private:
+	/// Decode strings marked as binary?
+	bool binaryDecoding = false;
+
+	/// Sort keys of dictionaries?
+	bool keySorting = true;
+
+	/// Maximal nesting depth of objects and arrays.
+	std::size_t maxDepth = std::numeric_limits<std::size_t>::max();
+
+	/// Current position in the input.
+	const char *pos = nullptr;
+
+	/// End of the input.
+	const char *end = nullptr;
+
+	/// Start of the input.
+	const char *begin = nullptr;
+
+	/// Bencoded data.
+	std::string encodedData;
+
+	/// Buffer for the currently read string (reused to avoid allocations).
+	std::string stringBuffer;
+
+	/// Buffer for decoded binary strings (reused to avoid allocations).
+	std::string binaryBuffer;
+
+	/// Buffer for reordering dictionary items (reused to avoid allocations).
+	std::string sortBuffer;
+
+	/// Stack of items of the currently decoded dictionaries.
+	std::vector<Member> members;
+
+	/// Stack of the currently decoded objects (@c '{') and arrays (@c '[').
+	std::string openContainers;
+};
+
+/// @name JSON Decoding Without Explicit Decoder Creation
+/// @{
+std::string convertJsonToBencode(const std::string &json);
+std::unique_ptr<BItem> decodeJson(const std::string &json);
+/// @}
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,106 @@
+/**
+* @file      JsonEncoder.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Encoder of data into JSON.
+*/
+
+#ifndef BENCODING_JSONENCODER_H
+#define BENCODING_JSONENCODER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "BItemVisitor.h"
+
+namespace bencoding {
+
+class BItem;
+
+/**
+* @brief Encoding of strings that cannot be emitted as JSON strings.
+*/
+enum class BinaryEncoding {
+	Hex,   ///< Two lowercase hexadecimal digits per byte.
+	Base64 ///< Base64 with padding (RFC 4648).
+};
+
+/**
+* @brief Encoder of data into JSON.
+*
+* Produces valid compact JSON (RFC 8259):
+*  - dictionaries are emitted as objects and lists as arrays,
+*  - integers are emitted as numbers,
+*  - strings that are valid UTF-8 are emitted as JSON strings with all the
+*    necessary characters escaped,
+*  - other strings (binary data, such as @c pieces or compact peers) are
+*    emitted as JSON strings containing the hex or base64 encoding of their
+*    bytes, prefixed with a marker (@c "hex:" or @c "base64:" by default).
+*
+* A text string that starts with the marker is emitted in the binary encoding
+* as well, so the original bytes can always be unambiguously recovered. When
+* UTF-8 detection is disabled, all strings are emitted in the binary encoding.
+*
+* Scanning of strings for characters to escape and for non-ASCII bytes
+* processes eight bytes at a time.
+*
+* Use create() to create instances.
+*/
+class JsonEncoder: private BItemVisitor {
+public:
+	static std::unique_ptr<JsonEncoder> create(
+		BinaryEncoding binaryEncoding = BinaryEncoding::Base64);
+
+	std::string encode(std::shared_ptr<BItem> data);
+	void encode(std::shared_ptr<BItem> data, std::string &output);
+
+	/// @name Options
+	/// @{
+	void setBinaryEncoding(BinaryEncoding binaryEncoding);
+	void setBinaryPrefix(const std::string &prefix);
+	void setUtf8Detection(bool enabled);
+	/// @}
+
+private:
+	explicit JsonEncoder(BinaryEncoding binaryEncoding);
+
+	/// @name BItemVisitor Interface
+	/// @{
+	virtual void visit(BDictionary *bDictionary) override;
+	virtual void visit(BInteger *bInteger) override;
+	virtual void visit(BList *bList) override;
+	virtual void visit(BString *bString) override;
+	/// @}
+
+	/// @name String Encoding
+	/// @{
+	void encodeString(const std::string &str);
+	bool isEmittedAsText(const std::string &str) const;
+	void encodeText(const char *data, std::size_t length);
+	void encodeBinary(const char *data, std::size_t length);
+	/// @}
+
+private:
+	/// Encoded data.
+	std::string encodedData;
+
+	/// Encoding of binary strings.
+	BinaryEncoding binaryEncoding;
+
+	/// Marker prefixed to binary strings.
+	std::string binaryPrefix;
+
+	/// Are strings that are valid UTF-8 emitted as text?
+	bool utf8Detection = true;
+};
+
+/// @name JSON Encoding Without Explicit Encoder Creation
+/// @{
+std::string encodeAsJson(std::shared_ptr<BItem> data,
+	BinaryEncoding binaryEncoding = BinaryEncoding::Base64);
+/// @}
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,106 @@
+/**
+* @file      KeyInternTable.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Table of dictionary keys shared by decoded dictionaries.
+*/
+
+#ifndef BENCODING_KEYINTERNTABLE_H
+#define BENCODING_KEYINTERNTABLE_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BString.h"
+
+namespace bencoding {
+
+/**
+* @brief Table of dictionary keys shared by decoded dictionaries.
+*
+* When a decoder has a table (see Decoder::setKeyInterning()), every decoded
+* dictionary key that is in the table resolves to a single shared BString
+* instead of a newly allocated one. This saves allocations and memory when the
+* same keys appear in many decoded dictionaries, e.g. in KRPC messages. Lookups
+* of an interned key in a BDictionary whose key is the same instance are
+* resolved by comparing pointers.
+*
+* There are two kinds of tables:
+*  - A fixed table holds only the keys given to create(const
+*    std::vector<std::string> &) (see also createForKrpc()). It never changes,
+*    so it is looked up without locking.
+*  - An adaptive table, created by create(std::size_t), starts empty and adds
+*    every decoded key that is not longer than @c MAX_KEY_LENGTH until it
+*    holds the given number of keys. Then, it stops growing. It is guarded by
+*    a mutex, so it can be shared by decoders running in different threads.
+*
+* The interned strings are shared by all the dictionaries decoded with the
+* table, so they must not be modified.
+*
+* Use the static functions to create instances.
+*/
+class KeyInternTable {
+public:
+	/// @name Creation
+	/// @{
+	static std::unique_ptr<KeyInternTable> create(
+		std::size_t maxNumOfKeys = DEFAULT_MAX_NUM_OF_KEYS);
+	static std::unique_ptr<KeyInternTable> create(
+		const std::vector<std::string> &keys);
+	static std::unique_ptr<KeyInternTable> createForKrpc();
+	/// @}
+
+	std::shared_ptr<BString> intern(const std::string &key);
+	std::shared_ptr<BString> intern(const char *data, std::size_t length);
+
+	std::size_t size() const;
+	bool isAdaptive() const;
+
+	/// Default maximal number of keys in an adaptive table.
+	static const std::size_t DEFAULT_MAX_NUM_OF_KEYS = 256;
+
+	/// Maximal length of keys added to an adaptive table.
+	static const std::size_t MAX_KEY_LENGTH = 64;
+
+private:
+	/// A slot of the hash table.
+	struct Slot {
+		/// Hash of the key.
+		std::size_t hash;
+
+		/// The interned key (@c nullptr in an empty slot).
+		std::shared_ptr<BString> key;
+	};
+
+private:
+	KeyInternTable(std::size_t maxNumOfKeys, bool adaptive);
+
+	std::shared_ptr<BString> find(const char *data, std::size_t length,
+		std::size_t hash, std::size_t &slot) const;
+	std::shared_ptr<BString> add(const char *data, std::size_t length,
+		std::size_t hash, std::size_t slot);
+
+private:
+	/// Open-addressing hash table with linear probing (its size is a power of
+	/// two and at least twice @c maxNumOfKeys).
+	std::vector<Slot> slots;
+
+	/// Maximal number of keys in the table.
+	std::size_t maxNumOfKeys;
+
+	/// Number of keys in the table.
+	std::size_t numOfKeys = 0;
+
+	/// Does the table add decoded keys?
+	bool adaptive;
+
+	/// Guards an adaptive table.
+	mutable std::mutex mutex;
+};
+
+} // namespace bencoding
+
+#endif
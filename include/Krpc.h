@@ -0,0 +1,195 @@
+/**
+* @file      Krpc.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Fast decoding and encoding of messages of the BitTorrent DHT
+*            protocol (KRPC).
+*/
+
+#ifndef BENCODING_KRPC_H
+#define BENCODING_KRPC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "BInteger.h"
+#include "Decoder.h"
+#include "DecodingResult.h"
+
+namespace bencoding {
+
+/**
+* @brief Type of a KRPC message (the @c y key).
+*/
+enum class KrpcMessageType {
+	Query,    ///< A query (@c q).
+	Response, ///< A response (@c r).
+	Error     ///< An error (@c e).
+};
+
+/**
+* @brief Method of a KRPC query (the @c q key).
+*/
+enum class KrpcMethod {
+	Other,       ///< A method not listed below (see KrpcMessage::methodName).
+	Ping,        ///< @c ping
+	FindNode,    ///< @c find_node
+	GetPeers,    ///< @c get_peers
+	AnnouncePeer ///< @c announce_peer
+};
+
+/**
+* @brief View of a string inside a KRPC message.
+*
+* The view does not own any memory; it points into the datagram from which
+* the message was decoded (or into memory provided by the user when the
+* message is encoded), so the memory has to outlive it.
+*/
+struct KrpcBytes {
+	KrpcBytes() noexcept = default;
+	KrpcBytes(const char *data, std::size_t length) noexcept;
+
+	bool present() const noexcept;
+	std::string string() const;
+
+	/// Contents of the string (@c nullptr when the string is not present).
+	/// Not terminated by a null character (see @c length).
+	const char *data = nullptr;
+
+	/// Number of characters pointed to by @c data.
+	std::size_t length = 0;
+};
+
+/**
+* @brief Message of the BitTorrent DHT protocol (KRPC).
+*
+* A fixed-layout representation of the queries and responses of <a
+* href="http://bittorrent.org/beps/bep_0005.html">BEP 5</a> (@c ping, @c
+* find_node, @c get_peers, and @c announce_peer) and of errors. Strings are
+* views into the datagram, so neither decoding by decodeKrpc() nor encoding by
+* encodeKrpc() allocates memory. An instance is meant to be reused for many
+* datagrams:
+* @code
+* bencoding::KrpcMessage message;
+* while (receive(datagram, length)) {
+*     if (!bencoding::decodeKrpc(datagram, length, message)) {
+*         continue;
+*     }
+*     if (message.type == bencoding::KrpcMessageType::Query &&
+*             message.method == bencoding::KrpcMethod::Ping) {
+*         bencoding::KrpcMessage reply;
+*         reply.type = bencoding::KrpcMessageType::Response;
+*         reply.transactionId = message.transactionId;
+*         reply.id = bencoding::KrpcBytes(ownId, 20);
+*         send(buffer, bencoding::encodeKrpc(reply, buffer, sizeof(buffer)));
+*     }
+* }
+* @endcode
+*
+* Arguments of queries (the @c a dictionary) and return values of responses
+* (the @c r dictionary) share the same members because both use the same
+* keys. Members that are not present in a message are left empty (strings)
+* or zero (numbers).
+*/
+struct KrpcMessage {
+	void clear() noexcept;
+
+	/// Maximal number of peers in @c values.
+	static const std::size_t MAX_NUM_OF_VALUES = 256;
+
+	/// @name Message
+	/// @{
+
+	/// Type of the message (@c y).
+	KrpcMessageType type = KrpcMessageType::Query;
+
+	/// Transaction ID (@c t).
+	KrpcBytes transactionId;
+
+	/// Version of the sending client (@c v, optional).
+	KrpcBytes version;
+
+	/// Compact address of the receiver as seen by the sender (@c ip,
+	/// optional, BEP 42).
+	KrpcBytes externalIp;
+
+	/// Does the sender ask not to be added into routing tables (@c ro,
+	/// BEP 43)?
+	bool readOnly = false;
+	/// @}
+
+	/// @name Queries
+	/// @{
+
+	/// Method of a query.
+	KrpcMethod method = KrpcMethod::Other;
+
+	/// Name of the method of a query (@c q).
+	KrpcBytes methodName;
+	/// @}
+
+	/// @name Arguments (@c a) and Return Values (@c r)
+	/// @{
+
+	/// Node ID of the sender (@c id, 20 bytes).
+	KrpcBytes id;
+
+	/// Node ID searched by @c find_node (@c target, 20 bytes).
+	KrpcBytes target;
+
+	/// Infohash of @c get_peers and @c announce_peer (@c info_hash, 20
+	/// bytes).
+	KrpcBytes infoHash;
+
+	/// Token of @c get_peers and @c announce_peer (@c token).
+	KrpcBytes token;
+
+	/// Compact IPv4 node info (@c nodes, 26 bytes per node).
+	KrpcBytes nodes;
+
+	/// Compact IPv6 node info (@c nodes6, 38 bytes per node, BEP 32).
+	KrpcBytes nodes6;
+
+	/// Port of @c announce_peer (@c port).
+	std::uint16_t port = 0;
+
+	/// Should the source port of the datagram be used instead of @c port
+	/// (@c implied_port)?
+	bool impliedPort = false;
+
+	/// Compact peer info returned by @c get_peers (@c values).
+	KrpcBytes values[MAX_NUM_OF_VALUES];
+
+	/// Number of peers in @c values.
+	std::size_t numOfValues = 0;
+	/// @}
+
+	/// @name Errors (@c e)
+	/// @{
+
+	/// Error code.
+	BInteger::ValueType errorCode = 0;
+
+	/// Error message.
+	KrpcBytes errorMessage;
+	/// @}
+};
+
+/// @name Decoding And Encoding Of KRPC Messages
+/// @{
+DecodingResult decodeKrpc(const char *data, std::size_t length,
+	KrpcMessage &message, const DecoderLimits &limits = DecoderLimits());
+DecodingResult decodeKrpc(const std::string &data, KrpcMessage &message,
+	const DecoderLimits &limits = DecoderLimits());
+// The message points into the data, so temporaries are not allowed.
+DecodingResult decodeKrpc(std::string &&data, KrpcMessage &message,
+	const DecoderLimits &limits = DecoderLimits()) = delete;
+std::size_t encodeKrpc(const KrpcMessage &message, char *buffer,
+	std::size_t size) noexcept;
+std::string encodeKrpc(const KrpcMessage &message);
+/// @}
+
+} // namespace bencoding
+
+#endif
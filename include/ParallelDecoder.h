@@ -0,0 +1,79 @@
+/**
+* @file      ParallelDecoder.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Decoder of bencoded data utilizing multiple threads.
+*/
+
+#ifndef BENCODING_PARALLELDECODER_H
+#define BENCODING_PARALLELDECODER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bencoding {
+
+class BItem;
+class Decoder;
+class KeyInternTable;
+class ThreadPool;
+
+/**
+* @brief Decoder of bencoded data utilizing multiple threads.
+*
+* A structural pre-scan finds the boundaries of items of large lists and
+* dictionaries (the top-level one and, when a single item holds a large part
+* of the data, also the lists and dictionaries nested in it) without decoding
+* them. The found items are then decoded in parallel and put into their
+* lists and dictionaries in the original order. The result is the same as the
+* result of Decoder::decode().
+*
+* Small data are decoded by a single thread because splitting them would cost
+* more than it saves. Invalid data are decoded again by a single thread, so
+* the thrown DecodingError is the same as the one thrown by Decoder.
+*
+* The options of the decoding (limits, key order checking, key interning) are
+* taken from a Decoder given to setDecoderOptions(). Only the decoded data are
+* returned, so recorded spans and computed infohashes are not available.
+*
+* Use create() to create instances.
+*/
+class ParallelDecoder {
+public:
+	static std::unique_ptr<ParallelDecoder> create(std::size_t numOfThreads = 0);
+	~ParallelDecoder();
+
+	std::size_t numOfThreads() const;
+	void setDecoderOptions(const Decoder &decoder);
+	std::unique_ptr<BItem> decode(const std::string &data);
+
+private:
+	explicit ParallelDecoder(std::unique_ptr<ThreadPool> threadPool);
+
+private:
+	/// Threads used for the decoding.
+	std::unique_ptr<ThreadPool> threadPool;
+
+	/// Decoders of the threads (the i-th decoder is used by the i-th thread).
+	std::vector<std::unique_ptr<Decoder>> decoders;
+
+	/// Validate the whole data before decoding them in parallel (the options
+	/// of the decoders may contain limits or key order checking)?
+	bool wholeDataValidation = false;
+
+	/// Table of interned keys of the split dictionaries (@c nullptr when keys
+	/// are not interned).
+	std::shared_ptr<KeyInternTable> keyInternTable;
+};
+
+/// @name Parallel Decoding Without Explicit Decoder Creation
+/// @{
+std::unique_ptr<BItem> decodeInParallel(const std::string &data,
+	std::size_t numOfThreads = 0);
+/// @}
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,58 @@
+/**
+* @file      ParallelEncoder.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Data encoder utilizing multiple threads.
+*/
+
+#ifndef BENCODING_PARALLELENCODER_H
+#define BENCODING_PARALLELENCODER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace bencoding {
+
+class BItem;
+class ThreadPool;
+
+/**
+* @brief Data encoder utilizing multiple threads.
+*
+* Large lists and dictionaries are split into chunks of items that are encoded
+* in parallel. The size of every chunk is computed beforehand, so every chunk
+* is encoded into a buffer of the exact size, and the chunks are then stitched
+* together in the original order. The output is identical to the output of
+* Encoder.
+*
+* Small data are encoded by a single thread because splitting them would cost
+* more than it saves.
+*
+* Use create() to create instances.
+*/
+class ParallelEncoder {
+public:
+	static std::unique_ptr<ParallelEncoder> create(std::size_t numOfThreads = 0);
+	~ParallelEncoder();
+
+	std::size_t numOfThreads() const;
+	std::string encode(std::shared_ptr<BItem> data);
+
+private:
+	explicit ParallelEncoder(std::unique_ptr<ThreadPool> threadPool);
+
+private:
+	/// Threads used for the encoding.
+	std::unique_ptr<ThreadPool> threadPool;
+};
+
+/// @name Parallel Encoding Without Explicit Encoder Creation
+/// @{
+std::string encodeInParallel(std::shared_ptr<BItem> data,
+	std::size_t numOfThreads = 0);
+/// @}
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,148 @@
+/**
+* @file      PathQuery.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Extraction of items from bencoded data by their paths.
+*/
+
+#ifndef BENCODING_PATHQUERY_H
+#define BENCODING_PATHQUERY_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BInteger.h"
+#include "DecodingResult.h"
+
+namespace bencoding {
+
+/**
+* @brief View of an item inside bencoded data.
+*
+* The view does not own any memory; it points into the data from which it
+* was extracted, so the data have to outlive it.
+*/
+struct BItemView {
+	/// Type of the viewed item.
+	enum class Type {
+		None,       ///< No item (e.g. a path that was not found).
+		Integer,    ///< An integer.
+		String,     ///< A string.
+		List,       ///< A list.
+		Dictionary  ///< A dictionary.
+	};
+
+	bool found() const noexcept;
+	std::string string() const;
+
+	/// Type of the item.
+	Type type = Type::None;
+
+	/// Value of an integer.
+	BInteger::ValueType integer = 0;
+
+	/// Contents of a string, or the whole encoded list or dictionary. Not
+	/// terminated by a null character (see @c length).
+	const char *data = nullptr;
+
+	/// Number of characters pointed to by @c data.
+	std::size_t length = 0;
+
+	/// Offset of the first character of the encoded item in the input.
+	std::size_t offset = 0;
+};
+
+/**
+* @brief Compiled set of paths to items inside bencoded data.
+*
+* A path consists of components separated by slashes. A component is either
+* a dictionary key or a zero-based index into a list, depending on the type of
+* the item it is applied to. For example, @c "info/name" selects the value of
+* the @c name key in the dictionary under the @c info key, and @c
+* "announce-list/0/0" selects the first item of the first list under the @c
+* announce-list key. The empty path selects the whole data. To use a slash or a
+* tilde inside a key, write it as @c ~1 or @c ~0, respectively.
+*
+* A query is compiled once by create() and can then be used to extract items
+* from any number of inputs:
+* @code
+* auto query = bencoding::PathQuery::create({"info/name", "info/piece length"});
+* std::vector<bencoding::BItemView> values;
+* for (const auto &torrent : torrents) {
+*     if (query->extract(torrent, values)) {
+*         std::cout << values[0].string() << "\n";
+*     }
+* }
+* @endcode
+*
+* The extraction reads the input by using Reader and skips items that are not
+* on any of the paths. No BItem instances are created and strings are not
+* copied. The extraction stops as soon as all the paths have been found, so
+* the rest of the input is not checked (use Decoder::validate() for that).
+* When a dictionary contains a key more than once, only the first occurrence
+* is used: paths continuing through the key are matched only inside its first
+* value, even when they are not found there.
+*/
+class PathQuery {
+public:
+	static std::unique_ptr<PathQuery> create(
+		const std::vector<std::string> &paths);
+
+	std::size_t getNumOfPaths() const;
+
+	DecodingResult extract(const std::string &data,
+		std::vector<BItemView> &values) const;
+	DecodingResult extract(const char *data, std::size_t length,
+		std::vector<BItemView> &values) const;
+	// The views point into the data, so temporaries are not allowed.
+	DecodingResult extract(std::string &&data,
+		std::vector<BItemView> &values) const = delete;
+
+private:
+	/// A component of paths.
+	struct Node {
+		/// Dictionary key (unescaped).
+		std::string key;
+
+		/// Can the component be used as a list index?
+		bool isIndex;
+
+		/// List index (when @c isIndex is @c true).
+		std::size_t index;
+
+		/// Indexes of the nodes of the following components.
+		std::vector<std::size_t> children;
+
+		/// Indexes of the paths that end with this component.
+		std::vector<std::size_t> paths;
+	};
+
+	class Walker;
+
+private:
+	explicit PathQuery(const std::vector<std::string> &paths);
+
+	void addPath(const std::string &path, std::size_t pathIndex);
+	std::size_t addComponent(std::size_t parent, const std::string &key);
+
+private:
+	/// Number of compiled paths.
+	std::size_t numOfPaths;
+
+	/// Trie of components of all the paths (the root is the first node).
+	std::vector<Node> nodes;
+};
+
+/// @name Extraction Without Explicit Query Creation
+/// @{
+std::vector<BItemView> extract(const std::string &data,
+	const std::vector<std::string> &paths);
+std::vector<BItemView> extract(std::string &&data,
+	const std::vector<std::string> &paths) = delete;
+/// @}
+
+} // namespace bencoding
+
+#endif
@@ -8,7 +8,10 @@
 #ifndef BENCODING_PRETTYPRINTER_H
 #define BENCODING_PRETTYPRINTER_H
 
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <ostream>
 #include <string>
 
 #include "BItemVisitor.h"
@@ -20,7 +23,15 @@ class BItem;
 /**
 * @brief Pretty printer of data.
 *
-* Can format data in a readable way.
+* Can format data in a readable way. The representation can be either
+* returned as a string (getPrettyRepr()) or written directly into a stream
+* (printPrettyRepr()). The latter uses a constant amount of memory regardless
+* of the size of the representation.
+*
+* Huge data can be summarized by limiting the shown length of strings, the
+* number of shown items of lists and dictionaries, and the shown depth (see
+* setMaxStringLength(), setMaxNumOfItems(), and setMaxDepth()). Elided content
+* is skipped without being processed, so a summary of huge data is cheap.
 *
 * Use create() to create instances.
 */
@@ -30,6 +41,16 @@ public:
 
 	std::string getPrettyRepr(std::shared_ptr<BItem> data,
 		const std::string &indent = "    ");
+	void printPrettyRepr(std::shared_ptr<BItem> data, std::ostream &output,
+		const std::string &indent = "    ");
+
+	/// @name Limits
+	/// @{
+	void setMaxStringLength(std::size_t maxStringLength);
+	void setMaxNumOfItems(std::size_t maxNumOfItems);
+	void setMaxDepth(std::size_t maxDepth);
+	void removeLimits();
+	/// @}
 
 private:
 	PrettyPrinter();
@@ -42,6 +63,15 @@ private:
 	virtual void visit(BString *bString) override;
 	/// @}
 
+	/// @name Output
+	/// @{
+	void write(char c);
+	void write(const char *data, std::size_t length);
+	void write(std::size_t n);
+	void writeEscaped(const char *data, std::size_t length);
+	void writeElisionMarker(std::size_t count, const char *unit);
+	/// @}
+
 	/// @name Indentation
 	/// @{
 	void storeCurrentIndent();
@@ -50,20 +80,37 @@ private:
 	/// @}
 
 private:
-	/// Pretty representation of the data obtained so far.
-	std::string prettyRepr = "";
+	/// Stream into which the pretty representation is written.
+	std::ostream *output = nullptr;
 
 	/// A single level of indentation.
 	std::string indentLevel = "    ";
 
+	/// Indentation for the deepest level reached so far.
+	///
+	/// The indentation for any lower level is its prefix, so no string has to
+	/// be created when the indentation level changes.
+	std::string indentTable = "";
+
 	/// The current level of indentation.
-	std::string currentIndent = "";
+	std::size_t currentIndentLevel = 0;
+
+	/// Maximal number of bytes shown from every string.
+	std::size_t maxStringLength = std::numeric_limits<std::size_t>::max();
+
+	/// Maximal number of items shown from every list and dictionary.
+	std::size_t maxNumOfItems = std::numeric_limits<std::size_t>::max();
+
+	/// Maximal depth of lists and dictionaries whose items are shown.
+	std::size_t maxDepth = std::numeric_limits<std::size_t>::max();
 };
 
 /// @name Printing Without Explicit Printer Creation
 /// @{
 std::string getPrettyRepr(std::shared_ptr<BItem> data,
 	const std::string &indent = "    ");
+void printPrettyRepr(std::shared_ptr<BItem> data, std::ostream &output,
+	const std::string &indent = "    ");
 /// @}
 
 } // namespace bencoding
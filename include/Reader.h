@@ -0,0 +1,197 @@
+/**
+* @file      Reader.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Pull reader of bencoded data stored in memory.
+*/
+
+#ifndef BENCODING_READER_H
+#define BENCODING_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BInteger.h"
+#include "Decoder.h"
+#include "DecodingResult.h"
+
+namespace bencoding {
+
+/**
+* @brief Type of a token read by Reader.
+*/
+enum class TokenType {
+	DictBegin,  ///< Beginning of a dictionary (@c d).
+	ListBegin,  ///< Beginning of a list (@c l).
+	End,        ///< End of a dictionary or a list (@c e).
+	Integer,    ///< An integer.
+	String,     ///< A string (a value or a dictionary key).
+	EndOfInput, ///< The whole input has been read.
+	Error       ///< The input is invalid (see Reader::error()).
+};
+
+/**
+* @brief Pull reader of bencoded data stored in memory.
+*
+* Splits the input into tokens one by one, without building a tree of BItem
+* instances and without copying strings. For example,
+* @code
+* std::string data("d1:ai1ee");
+* Reader reader(data);
+* reader.next(); // TokenType::DictBegin
+* reader.next(); // TokenType::String, reader.string() == "a"
+* reader.next(); // TokenType::Integer, reader.integer() == 1
+* reader.next(); // TokenType::End
+* reader.next(); // TokenType::EndOfInput
+* @endcode
+*
+* The reader checks the same grammar as Decoder (including the limits from
+* DecoderLimits) and reports errors by returning TokenType::Error. After that,
+* error() and errorOffset() describe the error and next() keeps returning
+* TokenType::Error. No exceptions are thrown. The input may contain several
+* consecutive items; TokenType::EndOfInput is returned only between them.
+*
+* Optionally, the reader also checks that keys in every dictionary are sorted
+* and unique, as required by the specification (see setKeyOrderChecking()).
+*
+* The reader never allocates memory unless lists and dictionaries are nested
+* deeper than @c INLINE_DEPTH levels. The input has to outlive the reader.
+*
+* Unlike other classes in the library, a reader is a lightweight value that
+* is meant to be created directly on the stack.
+*/
+class Reader {
+public:
+	Reader(const char *data, std::size_t length) noexcept;
+	explicit Reader(const std::string &data) noexcept;
+	// The input has to outlive the reader, so temporaries are not allowed.
+	explicit Reader(std::string &&data) = delete;
+
+	void setLimits(const DecoderLimits &limits) noexcept;
+	void setKeyOrderChecking(bool enabled) noexcept;
+
+	/// @name Reading
+	/// @{
+	TokenType next() noexcept;
+	bool skip() noexcept;
+	/// @}
+
+	/// @name Current Token
+	/// @{
+	TokenType tokenType() const noexcept;
+	std::size_t tokenBegin() const noexcept;
+	BInteger::ValueType integer() const noexcept;
+	const char *stringData() const noexcept;
+	std::size_t stringLength() const noexcept;
+	std::string string() const;
+	bool isKey() const noexcept;
+	/// @}
+
+	/// @name State
+	/// @{
+	std::size_t offset() const noexcept;
+	std::size_t depth() const noexcept;
+	bool isInDict() const noexcept;
+	DecodingErrorCode error() const noexcept;
+	std::size_t errorOffset() const noexcept;
+	/// @}
+
+	/// Number of nesting levels kept without allocating memory.
+	static const std::size_t INLINE_DEPTH = 256;
+
+private:
+	/// A dictionary key in the input.
+	struct KeyRef {
+		const char *data;
+		std::size_t length;
+	};
+
+	/// Number of nesting levels whose last keys are kept without allocating
+	/// memory.
+	static const std::size_t INLINE_KEY_DEPTH = 64;
+
+	TokenType readInteger() noexcept;
+	TokenType readString() noexcept;
+	TokenType beginContainer(bool isDict) noexcept;
+	TokenType endContainer() noexcept;
+	DecodingErrorCode checkKeyOrder() noexcept;
+	KeyRef &lastKey(std::size_t level);
+	TokenType fail(DecodingErrorCode error, const char *at) noexcept;
+	TokenType failAtEndOfInput() noexcept;
+	void finishValue() noexcept;
+
+private:
+	/// Start of the input.
+	const char *begin;
+
+	/// Current position in the input.
+	const char *pos;
+
+	/// End of the input (or of its part allowed by the limits).
+	const char *end;
+
+	/// Length of the whole input.
+	std::size_t inputLength;
+
+	/// Limits of the used resources.
+	DecoderLimits limits;
+
+	/// Type of the current token.
+	TokenType type = TokenType::EndOfInput;
+
+	/// Offset of the first character of the current token.
+	std::size_t currentTokenBegin = 0;
+
+	/// Value of the current integer token.
+	BInteger::ValueType integerValue = 0;
+
+	/// First character of the current string token.
+	const char *stringBegin = nullptr;
+
+	/// Length of the current string token.
+	std::size_t stringSize = 0;
+
+	/// Is the current string token a dictionary key?
+	bool currentIsKey = false;
+
+	/// Is a key expected next (in the innermost dictionary)?
+	bool expectingKey = false;
+
+	/// Number of open lists and dictionaries.
+	std::size_t currentDepth = 0;
+
+	/// For every nesting level, is the open item a dictionary? (The first
+	/// @c INLINE_DEPTH levels; one bit per level.)
+	uint64_t inlineStack[INLINE_DEPTH / 64] = {};
+
+	/// Nesting levels above @c INLINE_DEPTH.
+	std::vector<bool> overflowStack;
+
+	/// Check that dictionary keys are sorted and unique?
+	bool keyOrderChecking = false;
+
+	/// For every nesting level, the last key read in the dictionary (the
+	/// first @c INLINE_KEY_DEPTH levels; used only when checking key order).
+	KeyRef inlineKeys[INLINE_KEY_DEPTH];
+
+	/// Last keys of nesting levels above @c INLINE_KEY_DEPTH.
+	std::vector<KeyRef> overflowKeys;
+
+	/// Number of items read so far.
+	std::size_t numOfItems = 0;
+
+	/// Total length of strings read so far.
+	std::size_t totalStringLength = 0;
+
+	/// Reason of the failure.
+	DecodingErrorCode errorCode = DecodingErrorCode::None;
+
+	/// Offset at which the reading failed.
+	std::size_t errorPos = 0;
+};
+
+} // namespace bencoding
+
+#endif
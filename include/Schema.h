@@ -0,0 +1,116 @@
+/**
+* @file      Schema.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Description of expected structure of bencoded data.
+*/
+
+#ifndef BENCODING_SCHEMA_H
+#define BENCODING_SCHEMA_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bencoding {
+
+/**
+* @brief Description of expected structure of bencoded data.
+*
+* A schema describes which items are expected in the data and of which types
+* they are. It is used by Decoder::tryDecode(const std::string &, const Schema
+* &), which validates the types of the items as they are read and skips
+* values of dictionary keys that are not declared in the schema, without
+* creating any items for them. For example, the following schema describes
+* a torrent file:
+* @code
+* using bencoding::Schema;
+* std::shared_ptr<Schema> file(Schema::dictionary({
+*     {"length", Schema::integer(), true},
+*     {"path", Schema::list(Schema::string()), true}
+* }));
+* std::shared_ptr<Schema> torrent(Schema::dictionary({
+*     {"announce", Schema::string()},
+*     {"announce-list", Schema::list(Schema::list(Schema::string()))},
+*     {"info", Schema::dictionary({
+*         {"files", Schema::list(file)},
+*         {"length", Schema::integer()},
+*         {"name", Schema::string(), true},
+*         {"piece length", Schema::integer(), true},
+*         {"pieces", Schema::string(), true}
+*     }), true}
+* }));
+* @endcode
+*
+* Schemas are immutable, so a single schema can be shared by any number of
+* other schemas and used by any number of threads.
+*
+* Use the static functions to create instances.
+*/
+class Schema {
+public:
+	/// Type of the described item.
+	enum class Type {
+		Any,       ///< An item of any type (decoded whole).
+		Integer,   ///< An integer.
+		String,    ///< A string.
+		List,      ///< A list.
+		Dictionary ///< A dictionary.
+	};
+
+	/// A declared key of a dictionary.
+	struct Field {
+		Field(std::string key, std::shared_ptr<const Schema> schema,
+			bool required = false);
+
+		/// Dictionary key.
+		std::string key;
+
+		/// Schema of the value of the key.
+		std::shared_ptr<const Schema> schema;
+
+		/// Does the key have to be present?
+		bool required;
+	};
+
+public:
+	/// @name Creation
+	/// @{
+	static std::unique_ptr<Schema> any();
+	static std::unique_ptr<Schema> integer();
+	static std::unique_ptr<Schema> string();
+	static std::unique_ptr<Schema> list(std::shared_ptr<const Schema> items);
+	static std::unique_ptr<Schema> dictionary(std::vector<Field> fields);
+	/// @}
+
+	/// @name Accessors
+	/// @{
+	Type getType() const;
+	const Schema &getItems() const;
+	const std::vector<Field> &getFields() const;
+	std::size_t findField(const char *key, std::size_t length,
+		std::size_t firstField = 0) const;
+	std::size_t getNumOfRequiredFields() const;
+	/// @}
+
+private:
+	explicit Schema(Type type);
+
+private:
+	/// Type of the described item.
+	Type type;
+
+	/// Schema of items of a list.
+	std::shared_ptr<const Schema> items;
+
+	/// Declared keys of a dictionary (sorted by the keys).
+	std::vector<Field> fields;
+
+	/// Number of required keys of a dictionary.
+	std::size_t numOfRequiredFields = 0;
+};
+
+} // namespace bencoding
+
+#endif
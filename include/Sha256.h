@@ -0,0 +1,59 @@
+/**
+* @file      Sha256.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Computation of SHA-256 hashes.
+*/
+
+#ifndef BENCODING_SHA256_H
+#define BENCODING_SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bencoding {
+
+/**
+* @brief Computation of SHA-256 hashes (FIPS 180-4).
+*
+* Used for computing BitTorrent v2 infohashes. It is used in the same way as
+* Sha1.
+*
+* Unlike other classes in the library, it is a lightweight value that is meant
+* to be created directly on the stack.
+*/
+class Sha256 {
+public:
+	/// Size of a digest (in bytes).
+	static const std::size_t DIGEST_SIZE = 32;
+
+public:
+	Sha256() noexcept;
+
+	void update(const char *data, std::size_t length) noexcept;
+	void update(const std::string &data) noexcept;
+	std::string finish();
+
+	static std::string hash(const std::string &data);
+
+private:
+	void processBlock(const unsigned char *block) noexcept;
+
+private:
+	/// Intermediate hash value.
+	uint32_t state[8];
+
+	/// Data that do not form a whole block yet.
+	unsigned char buffer[64];
+
+	/// Number of bytes in @c buffer.
+	std::size_t bufferSize = 0;
+
+	/// Number of hashed bytes.
+	uint64_t length = 0;
+};
+
+} // namespace bencoding
+
+#endif
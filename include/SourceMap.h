@@ -0,0 +1,67 @@
+/**
+* @file      SourceMap.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Mapping of decoded items to their places in the input.
+*/
+
+#ifndef BENCODING_SOURCEMAP_H
+#define BENCODING_SOURCEMAP_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "BItem.h"
+
+namespace bencoding {
+
+/**
+* @brief Range <tt>[begin, end)</tt> of input characters from which an item
+*        was decoded.
+*/
+struct SourceSpan {
+	std::size_t length() const noexcept;
+
+	/// Offset of the first character of the encoded item.
+	std::size_t begin = 0;
+
+	/// Offset right after the last character of the encoded item.
+	std::size_t end = 0;
+};
+
+/**
+* @brief Mapping of decoded items to their places in the input.
+*
+* Created by Decoder::tryDecode() when recording of spans is enabled (see
+* Decoder::setSpanRecording() and Decoder::setSpanRecordingKeys()). The items
+* are identified by their addresses, so the map is valid only while the
+* decoded data exist. Spans of items that are discarded during the decoding
+* (values of duplicate keys) are removed.
+*
+* The span of an item allows getting its original encoded form without
+* encoding it again, which matters when the input is not in the canonical
+* form (e.g. when computing an infohash of a torrent):
+* @code
+* auto span = result.sourceMap().getSpan(*info);
+* std::string encodedInfo = data.substr(span.begin, span.length());
+* @endcode
+*/
+class SourceMap {
+public:
+	void add(const BItem &item, std::size_t begin, std::size_t end);
+	void remove(BItem &item);
+
+	bool contains(const BItem &item) const;
+	SourceSpan getSpan(const BItem &item) const;
+	std::size_t size() const;
+	bool empty() const;
+
+private:
+	/// Spans of items.
+	std::unordered_map<const BItem *, SourceSpan> spans;
+};
+
+} // namespace bencoding
+
+#endif
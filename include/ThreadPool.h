@@ -0,0 +1,123 @@
+/**
+* @file      ThreadPool.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Pool of worker threads.
+*/
+
+#ifndef BENCODING_THREADPOOL_H
+#define BENCODING_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bencoding {
+
+/**
+* @brief Pool of worker threads.
+*
+* Runs batches of independent tasks in parallel. The thread calling run()
+* participates in the execution, so a pool with @c n threads uses @c n - 1
+* worker threads.
+*
+* The tasks of a batch are distributed by work stealing: every thread starts
+* with a contiguous range of task indexes and takes tasks from its beginning.
+* A thread whose range is exhausted steals the second half of the range of
+* another thread. Hence, threads do not contend for a shared counter, and
+* tasks of different lengths are still balanced between the threads.
+*
+* Use create() to create instances.
+*/
+class ThreadPool {
+public:
+	/// Task to be run. It is given the index of the task in the batch.
+	using Task = std::function<void (std::size_t)>;
+
+	/// Task to be run. It is given the index of the task in the batch and the
+	/// index of the thread running it (from <tt>[0, numOfThreads())</tt>).
+	using ThreadTask = std::function<void (std::size_t, std::size_t)>;
+
+public:
+	static std::unique_ptr<ThreadPool> create(std::size_t numOfThreads = 0);
+	~ThreadPool();
+
+	std::size_t numOfThreads() const;
+	void run(std::size_t numOfTasks, const Task &task);
+	void runWithThreadIndexes(std::size_t numOfTasks, const ThreadTask &task);
+
+private:
+	/// Range of task indexes (the first index in the upper half and the end
+	/// index in the lower half) that can be updated atomically.
+	using PackedRange = std::uint64_t;
+
+	/// Maximal number of tasks in a range.
+	static const std::size_t MAX_TASKS_PER_BATCH = 0xffffffff;
+
+private:
+	explicit ThreadPool(std::size_t numOfThreads);
+
+	// Disable copy construction and assignment.
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	void workerLoop(std::size_t threadIndex);
+	void runBatch(std::size_t firstTask, std::size_t numOfTasks,
+		const ThreadTask &task);
+	void runTasksOfCurrentBatch(std::unique_lock<std::mutex> &lock,
+		std::size_t threadIndex);
+	bool takeTask(std::size_t threadIndex, std::size_t &taskIndex);
+
+private:
+	/// Worker threads.
+	std::vector<std::thread> workers;
+
+	/// Ranges of tasks of the current batch that have not been taken yet (one
+	/// range per thread).
+	std::unique_ptr<std::atomic<PackedRange>[]> ranges;
+
+	/// Serializes calls to run() from different threads.
+	std::mutex runMutex;
+
+	/// Guards all the members below.
+	std::mutex mutex;
+
+	/// Signals that a new batch has been started or that the pool is stopping.
+	std::condition_variable batchStarted;
+
+	/// Signals that all the tasks of the current batch have finished.
+	std::condition_variable batchFinished;
+
+	/// Task of the current batch (@c nullptr when there is no batch).
+	const ThreadTask *currentTask = nullptr;
+
+	/// Index of the first task of the current batch (the indexes in @c ranges
+	/// are relative to it).
+	std::size_t firstTask = 0;
+
+	/// Number of tasks that have not finished yet.
+	std::size_t numOfUnfinishedTasks = 0;
+
+	/// Number of threads running tasks of the current batch.
+	std::size_t numOfActiveThreads = 0;
+
+	/// Identifier of the current batch (to wake up workers only once per batch).
+	std::size_t batchId = 0;
+
+	/// The first exception thrown by a task of the current call of run().
+	std::exception_ptr exception;
+
+	/// Should the workers stop?
+	bool stopping = false;
+};
+
+} // namespace bencoding
+
+#endif
@@ -0,0 +1,167 @@
+/**
+* @file      TorrentMetainfo.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Read-only view of a decoded torrent file.
+*/
+
+#ifndef BENCODING_TORRENTMETAINFO_H
+#define BENCODING_TORRENTMETAINFO_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+
+namespace bencoding {
+
+/**
+* @brief Exception thrown when decoded data are not a valid torrent file.
+*/
+class InvalidMetainfoError: public std::runtime_error {
+public:
+	explicit InvalidMetainfoError(const std::string &what);
+};
+
+/**
+* @brief Read-only view of a decoded torrent file (BitTorrent v1).
+*
+* The structure of the torrent file is validated once, by create(). Then, the
+* accessors do not look anything up in the tree of items: piece hashes are
+* pointers into the @c pieces string (it is never copied) and the lengths,
+* offsets, and paths of the files are recorded only when files() is called for
+* the first time. For example,
+* @code
+* auto metainfo = bencoding::TorrentMetainfo::create(bencoding::decode(data));
+* for (std::size_t i = 0; i < metainfo->pieceCount(); ++i) {
+*     verify(piece(i), metainfo->pieceHash(i)); // 20 bytes
+* }
+* for (const auto &file : metainfo->files()) {
+*     std::cout << file.length << "\n";
+* }
+* @endcode
+*
+* The view keeps the decoded items alive. They must not be modified while the
+* view is used.
+*
+* Use create() to create instances.
+*/
+class TorrentMetainfo {
+public:
+	/// A file of the torrent.
+	struct File {
+		/// Length of the file (in bytes).
+		BInteger::ValueType length;
+
+		/// Offset of the file in the concatenation of all the files.
+		BInteger::ValueType offset;
+
+		/// Components of the path to the file (BString instances). @c nullptr
+		/// in single-file torrents, whose only file is named by name().
+		const BList *path;
+	};
+
+	/// Range of the files of the torrent.
+	class FileRange {
+	public:
+		/// Iterator over the files.
+		class const_iterator {
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = File;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const File *;
+			using reference = File;
+
+		public:
+			const_iterator(const TorrentMetainfo *metainfo, std::size_t index);
+
+			File operator*() const;
+			const_iterator &operator++();
+			bool operator==(const const_iterator &other) const;
+			bool operator!=(const const_iterator &other) const;
+
+		private:
+			/// The torrent.
+			const TorrentMetainfo *metainfo;
+
+			/// Index of the current file.
+			std::size_t index;
+		};
+
+	public:
+		explicit FileRange(const TorrentMetainfo *metainfo);
+
+		std::size_t size() const;
+		const_iterator begin() const;
+		const_iterator end() const;
+
+	private:
+		/// The torrent.
+		const TorrentMetainfo *metainfo;
+	};
+
+public:
+	static std::unique_ptr<TorrentMetainfo> create(
+		std::shared_ptr<BItem> torrent);
+
+	/// @name Accessors
+	/// @{
+	const std::string &name() const;
+	BInteger::ValueType pieceLength() const;
+	BInteger::ValueType totalLength() const;
+	std::size_t pieceCount() const;
+	const char *pieceHash(std::size_t index) const;
+	bool isSingleFile() const;
+	FileRange files() const;
+	std::shared_ptr<BDictionary> infoDictionary() const;
+	/// @}
+
+	/// Length of a piece hash (in bytes).
+	static const std::size_t PIECE_HASH_SIZE = 20;
+
+private:
+	explicit TorrentMetainfo(std::shared_ptr<BDictionary> torrent);
+
+	void recordFiles() const;
+
+private:
+	/// The whole torrent.
+	std::shared_ptr<BDictionary> torrent;
+
+	/// The @c info dictionary.
+	std::shared_ptr<BDictionary> info;
+
+	/// Value of the @c name key.
+	const std::string *nameValue = nullptr;
+
+	/// Value of the @c pieces key (concatenated SHA-1 hashes).
+	const std::string *pieces = nullptr;
+
+	/// Value of the @c piece @c length key.
+	BInteger::ValueType pieceLengthValue = 0;
+
+	/// Sum of the lengths of all the files.
+	BInteger::ValueType totalLengthValue = 0;
+
+	/// Value of the @c files key (@c nullptr in single-file torrents).
+	std::shared_ptr<BList> fileList;
+
+	/// Files of the torrent (a single file in single-file torrents), recorded
+	/// by the first call of files().
+	mutable std::vector<File> fileEntries;
+
+	/// Ensures that the files are recorded only once.
+	mutable std::once_flag fileEntriesFlag;
+};
+
+} // namespace bencoding
+
+#endif
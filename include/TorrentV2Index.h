@@ -0,0 +1,159 @@
+/**
+* @file      TorrentV2Index.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Index of the file tree and piece layers of a BitTorrent v2
+*            torrent file.
+*/
+
+#ifndef BENCODING_TORRENTV2INDEX_H
+#define BENCODING_TORRENTV2INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BInteger.h"
+#include "TorrentMetainfo.h"
+
+namespace bencoding {
+
+/**
+* @brief Index of the file tree and piece layers of a BitTorrent v2 torrent
+*        file.
+*
+* <a href="http://bittorrent.org/beps/bep_0052.html">BEP 52</a> torrents
+* describe their files by a nested @c file @c tree dictionary and store the
+* hashes of pieces of every file in the @c piece @c layers dictionary, keyed
+* by the 32-byte Merkle root of the file (@c pieces @c root). Decoding these
+* into items creates a BDictionary entry (and a BString key) for every file,
+* directory, and layer.
+*
+* The index is built directly from the encoded torrent by Reader instead. The
+* file tree is read iteratively (without recursion, so its depth is not
+* limited by the stack) into flat arrays of files and names, and piece layers
+* are sorted by their roots and found by a binary search (unlike a hash table
+* indexed by the roots, it cannot be slowed down by crafted roots). Names and
+* hashes are not
+* copied; they point into the encoded torrent, which has to outlive the index:
+* @code
+* auto index = bencoding::TorrentV2Index::create(torrentData);
+* for (const auto &file : index->files()) {
+*     auto layer = index->pieceLayer(file);
+*     for (std::size_t i = 0; i < layer.numOfHashes; ++i) {
+*         verify(index->path(file), i, layer.hash(i)); // 32 bytes
+*     }
+* }
+* @endcode
+*
+* Use create() to create instances.
+*/
+class TorrentV2Index {
+public:
+	/// A file or directory name in the file tree.
+	struct Node {
+		/// The name (not terminated by a null character).
+		const char *name;
+
+		/// Length of the name.
+		std::size_t nameLength;
+
+		/// Index of the parent directory (@c NO_PARENT for top-level names).
+		std::size_t parent;
+	};
+
+	/// A file in the file tree.
+	struct File {
+		/// Index of the name of the file (see node()).
+		std::size_t node;
+
+		/// Length of the file (in bytes).
+		BInteger::ValueType length;
+
+		/// Merkle root of the file (32 bytes, @c nullptr for empty files).
+		const char *piecesRoot;
+	};
+
+	/// Hashes of the pieces of a file.
+	struct PieceLayer {
+		bool found() const;
+		const char *hash(std::size_t index) const;
+
+		/// Concatenated 32-byte hashes (@c nullptr when not found).
+		const char *hashes;
+
+		/// Number of hashes.
+		std::size_t numOfHashes;
+	};
+
+public:
+	static std::unique_ptr<TorrentV2Index> create(const std::string &data);
+	static std::unique_ptr<TorrentV2Index> create(const char *data,
+		std::size_t length);
+	// The index points into the data, so temporaries are not allowed.
+	static std::unique_ptr<TorrentV2Index> create(std::string &&data) = delete;
+
+	/// @name File Tree
+	/// @{
+	BInteger::ValueType pieceLength() const;
+	const std::vector<File> &files() const;
+	const Node &node(std::size_t index) const;
+	std::string path(const File &file, char separator = '/') const;
+	/// @}
+
+	/// @name Piece Layers
+	/// @{
+	std::size_t numOfPieceLayers() const;
+	PieceLayer pieceLayer(const char *piecesRoot) const;
+	PieceLayer pieceLayer(const File &file) const;
+	/// @}
+
+	/// Length of hashes and Merkle roots (in bytes).
+	static const std::size_t HASH_SIZE = 32;
+
+	/// Parent of top-level names.
+	static const std::size_t NO_PARENT =
+		std::numeric_limits<std::size_t>::max();
+
+private:
+	/// A piece layer with its Merkle root.
+	struct RootLayer {
+		/// First bytes of the root as a big-endian number, so most roots are
+		/// ordered without reading them.
+		std::uint64_t prefix;
+
+		/// Merkle root.
+		const char *root;
+
+		/// The layer.
+		PieceLayer layer;
+	};
+
+	class Parser;
+
+private:
+	TorrentV2Index();
+
+	static bool isSmallerLayer(const RootLayer &a, const RootLayer &b);
+	void setPieceLayers(std::vector<RootLayer> layers);
+
+private:
+	/// Value of the @c piece @c length key.
+	BInteger::ValueType pieceLengthValue = 0;
+
+	/// Names in the file tree (parents precede their children).
+	std::vector<Node> nodes;
+
+	/// Files in the order of the file tree.
+	std::vector<File> fileList;
+
+	/// Piece layers sorted by their roots (each root is there once).
+	std::vector<RootLayer> pieceLayers;
+};
+
+} // namespace bencoding
+
+#endif
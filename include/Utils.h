@@ -8,12 +8,16 @@
 #ifndef BENCODING_UTILS_H
 #define BENCODING_UTILS_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ios>
 #include <istream>
 #include <queue>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <utility>
 
 namespace bencoding {
 
@@ -44,6 +48,11 @@ bool strToNum(const std::string &str, N &num,
 	return false;
 }
 
+/// Maximal number of characters of an integer formatted by formatInteger().
+const std::size_t MAX_FORMATTED_INTEGER_LENGTH = 20;
+
+char *formatInteger(char *end, int64_t value);
+
 /// @}
 
 /// @name Data Reading
@@ -54,11 +63,86 @@ bool readUntil(std::istream &stream, std::string &readData, char last);
 
 /// @}
 
+/// @name Character and Byte Operations
+/// @{
+
+/**
+* @brief Checks if @a c is a decimal digit.
+*/
+inline bool isDigit(int c) {
+	return c >= '0' && c <= '9';
+}
+
+/**
+* @brief Reads a big-endian 32-bit number from @a p.
+*/
+inline uint32_t loadBigEndian32(const unsigned char *p) {
+	return (static_cast<uint32_t>(p[0]) << 24) |
+		(static_cast<uint32_t>(p[1]) << 16) |
+		(static_cast<uint32_t>(p[2]) << 8) |
+		static_cast<uint32_t>(p[3]);
+}
+
+/// @}
+
 /// @name String Operations
 /// @{
 
 std::string replace(const std::string &str, char what,
 	const std::string &withWhat);
+bool isValidUtf8(const char *data, std::size_t length);
+const char *findCharToEscapeInJson(const char *begin, const char *end);
+
+/**
+* @brief Returns the index of the field with the given @a key among the given
+*        @a numOfFields fields (@a numOfFields when there is no such field).
+*
+* @param[in] fields Searched fields.
+* @param[in] numOfFields Number of @a fields.
+* @param[in] firstField Index of the field at which the search starts.
+* @param[in] key Searched key (not terminated by a null character).
+* @param[in] length Length of @a key.
+* @param[in] getKey Function returning the data and the length of the key of
+*                   the given field.
+*
+* The search wraps around, so when the keys in the input are in the order of
+* the fields and the search starts after the previously found field, the first
+* comparison matches. The length and the first character are compared first,
+* so most of the other fields are rejected without calling @c memcmp().
+*/
+template<typename Field, typename GetKey>
+std::size_t findField(const Field *fields, std::size_t numOfFields,
+		std::size_t firstField, const char *key, std::size_t length,
+		GetKey getKey) {
+	auto hasKey = [&](const Field &field) {
+		std::pair<const char *, std::size_t> fieldKey(getKey(field));
+		return fieldKey.second == length && (length == 0 ||
+			(fieldKey.first[0] == key[0] &&
+				std::memcmp(fieldKey.first + 1, key + 1, length - 1) == 0));
+	};
+	for (std::size_t i = firstField; i < numOfFields; ++i) {
+		if (hasKey(fields[i])) {
+			return i;
+		}
+	}
+	for (std::size_t i = 0; i < firstField && i < numOfFields; ++i) {
+		if (hasKey(fields[i])) {
+			return i;
+		}
+	}
+	return numOfFields;
+}
+
+/// @}
+
+/// @name Binary-to-Text Encoding
+/// @{
+
+void appendAsHex(std::string &output, const char *data, std::size_t length);
+void appendAsBase64(std::string &output, const char *data, std::size_t length);
+bool appendFromHex(std::string &output, const char *data, std::size_t length);
+bool appendFromBase64(std::string &output, const char *data,
+	std::size_t length);
 
 /// @}
 
@@ -0,0 +1,117 @@
+/**
+* @file      Writer.h
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Streaming writer of bencoded data.
+*/
+
+#ifndef BENCODING_WRITER_H
+#define BENCODING_WRITER_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BInteger.h"
+
+namespace bencoding {
+
+/**
+* @brief Streaming writer of bencoded data.
+*
+* Emits bencoded data directly into a buffer or an output stream without
+* building a tree of BItem instances first. For example,
+* @code
+* auto writer = Writer::create();
+* writer->beginDict()
+*     .key("a").integer(1)
+*     .key("b").beginList()
+*         .string("x")
+*         .string("y")
+*     .end()
+* .end();
+* writer->encodedData(); // "d1:ai1e1:bl1:x1:yee"
+* @endcode
+*
+* Dictionary keys have to be written in a lexicographical order and they have
+* to be unique (see the <a
+* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">specification</a>).
+* The writer does not reorder them. Debug builds (without @c NDEBUG) check
+* that keys are sorted and unique and that the calls form a well-structured
+* sequence; release builds perform no checks.
+*
+* Use create() to create instances.
+*/
+class Writer {
+public:
+	static std::unique_ptr<Writer> create();
+	static std::unique_ptr<Writer> create(std::ostream &output);
+
+	/// @name Lists and Dictionaries
+	/// @{
+	Writer &beginDict();
+	Writer &beginList();
+	Writer &key(const std::string &key);
+	Writer &key(const char *data, std::size_t length);
+	Writer &end();
+	/// @}
+
+	/// @name Values
+	/// @{
+	Writer &integer(BInteger::ValueType value);
+	Writer &string(const std::string &value);
+	Writer &string(const char *data, std::size_t length);
+	Writer &raw(const std::string &encodedValue);
+	/// @}
+
+	/// @name State
+	/// @{
+	const std::string &encodedData() const;
+	bool isComplete() const;
+	void clear();
+	/// @}
+
+private:
+	/// Currently open list or dictionary.
+	struct Frame {
+		/// Is the open item a dictionary?
+		bool isDict;
+
+		/// Is a dictionary waiting for the value of the last written key?
+		bool expectsValue;
+
+		/// Has a key been written into the dictionary (debug builds only)?
+		bool hasKey;
+
+		/// The last written key (filled only in debug builds).
+		std::string lastKey;
+	};
+
+private:
+	explicit Writer(std::ostream *output);
+
+	void write(char c);
+	void write(const char *data, std::size_t length);
+	void writeStringWithLength(const char *data, std::size_t length);
+	void beginValue();
+
+private:
+	/// Stream into which the data are written (@c nullptr when writing into
+	/// @c buffer).
+	std::ostream *output;
+
+	/// Encoded data when no output stream has been given.
+	std::string buffer;
+
+	/// Stack of currently open lists and dictionaries.
+	std::vector<Frame> frames;
+
+	/// Has a complete top-level value been written?
+	bool complete = false;
+};
+
+} // namespace bencoding
+
+#endif
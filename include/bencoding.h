@@ -16,9 +16,30 @@
 #include "BItemVisitor.h"
 #include "BList.h"
 #include "BString.h"
+#include "BatchDecoder.h"
+#include "Binding.h"
+#include "CompactList.h"
 #include "Decoder.h"
+#include "DecodingResult.h"
+#include "DocumentStream.h"
 #include "Encoder.h"
+#include "JsonDecoder.h"
+#include "JsonEncoder.h"
+#include "KeyInternTable.h"
+#include "Krpc.h"
+#include "ParallelDecoder.h"
+#include "ParallelEncoder.h"
+#include "PathQuery.h"
 #include "PrettyPrinter.h"
+#include "Reader.h"
+#include "Schema.h"
+#include "Sha1.h"
+#include "Sha256.h"
+#include "SourceMap.h"
+#include "ThreadPool.h"
+#include "TorrentMetainfo.h"
+#include "TorrentV2Index.h"
 #include "Utils.h"
+#include "Writer.h"
 
 #endif
@@ -33,6 +33,23 @@ bool helpIsRequested(int argc, char **argv) {
 	return false;
 }
 
+/**
+* @brief Checks if a summary was requested.
+*
+* If so, the corresponding argument is removed from @a argv.
+*/
+bool summaryIsRequested(int &argc, char **argv) {
+	if (argc < 2 || std::string(argv[1]) != "--summary") {
+		return false;
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		argv[i] = argv[i + 1];
+	}
+	--argc;
+	return true;
+}
+
 /**
 * @brief Prints help to the standard output.
 */
@@ -40,10 +57,13 @@ void printHelp(const std::string &prog) {
 	std::cout
 		<< "A decoder of bencoded files.\n"
 		<< "\n"
-		<< "Usage: " << prog << " [FILE]\n"
+		<< "Usage: " << prog << " [--summary] [FILE]\n"
 		<< "\n"
 		<< "If FILE is not given, the data are read from the standard input.\n"
-		<< "The decoded data are printed to the standard output.\n";
+		<< "The decoded data are printed to the standard output.\n"
+		<< "\n"
+		<< "With --summary, long strings and lists and dictionaries with many\n"
+		<< "items are shortened, and deeply nested items are not shown.\n";
 }
 
 } // anonymous namespace
@@ -54,13 +74,17 @@ int main(int argc, char **argv) {
 		return 0;
 	}
 
+	bool printSummary = summaryIsRequested(argc, argv);
+
 	// Decoding.
 	std::shared_ptr<BItem> decodedData;
 	try {
 		if (argc > 1) {
-			std::ifstream input(argv[1]);
+			std::ifstream input(argv[1], std::ios::binary);
 			decodedData = decode(input);
 		} else {
+			// Let std::cin buffer its input so that it can be read in bulk.
+			std::ios::sync_with_stdio(false);
 			decodedData = decode(std::cin);
 		}
 	} catch (const DecodingError &ex) {
@@ -68,8 +92,16 @@ int main(int argc, char **argv) {
 		return 1;
 	}
 
-	// Printing.
-	std::cout << getPrettyRepr(decodedData) << "\n";
+	// Printing (directly into the output so that even the representation of
+	// huge data does not have to be stored in memory).
+	auto prettyPrinter = PrettyPrinter::create();
+	if (printSummary) {
+		prettyPrinter->setMaxStringLength(64);
+		prettyPrinter->setMaxNumOfItems(20);
+		prettyPrinter->setMaxDepth(8);
+	}
+	prettyPrinter->printPrettyRepr(decodedData, std::cout);
+	std::cout << "\n";
 
 	return 0;
 }
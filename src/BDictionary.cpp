@@ -22,7 +22,9 @@ namespace bencoding {
 bool BDictionary::BStringByValueComparator::operator()(
 		const std::shared_ptr<BString> &lhs,
 		const std::shared_ptr<BString> &rhs) const {
-	return lhs->value() < rhs->value();
+	// The same instance (e.g. an interned key, see KeyInternTable) is equal
+	// to itself, so its value does not have to be compared.
+	return lhs != rhs && lhs->value() < rhs->value();
 }
 
 /**
@@ -7,6 +7,8 @@
 
 #include "BString.h"
 
+#include <utility>
+
 #include "BItemVisitor.h"
 
 namespace bencoding {
@@ -14,19 +16,19 @@ namespace bencoding {
 /**
 * @brief Constructs the string with the given @a value.
 */
-BString::BString(ValueType value): _value(value) {}
+BString::BString(ValueType value): _value(std::move(value)) {}
 
 /**
 * @brief Creates and returns a new string.
 */
 std::unique_ptr<BString> BString::create(ValueType value) {
-	return std::unique_ptr<BString>(new BString(value));
+	return std::unique_ptr<BString>(new BString(std::move(value)));
 }
 
 /**
 * @brief Returns the string's value.
 */
-auto BString::value() const -> ValueType {
+auto BString::value() const -> const ValueType & {
 	return _value;
 }
 
@@ -0,0 +1,108 @@
+/**
+* @file      BatchDecoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the BatchDecoder class.
+*/
+
+#include "BatchDecoder.h"
+
+#include "Decoder.h"
+#include "ThreadPool.h"
+
+namespace bencoding {
+
+/**
+* @brief Constructs a decoder that uses the given thread pool.
+*/
+BatchDecoder::BatchDecoder(std::unique_ptr<ThreadPool> threadPool):
+		threadPool(std::move(threadPool)) {
+	for (std::size_t i = 0; i < this->threadPool->numOfThreads(); ++i) {
+		decoders.push_back(Decoder::create());
+	}
+}
+
+/**
+* @brief Creates a new decoder.
+*
+* @param[in] numOfThreads Number of threads to be used. When it is zero, the
+*                         number of hardware threads is used.
+*/
+std::unique_ptr<BatchDecoder> BatchDecoder::create(std::size_t numOfThreads) {
+	return std::unique_ptr<BatchDecoder>(
+		new BatchDecoder(ThreadPool::create(numOfThreads)));
+}
+
+/**
+* @brief Destructs the decoder.
+*/
+BatchDecoder::~BatchDecoder() = default;
+
+/**
+* @brief Returns the number of threads used by the decoder.
+*/
+std::size_t BatchDecoder::numOfThreads() const {
+	return threadPool->numOfThreads();
+}
+
+/**
+* @brief Makes the decoding of every document use the options of the given
+*        @a decoder.
+*
+* All the options are copied (limits, checking of the order of keys,
+* recording of spans, and computation of infohashes). The limits apply to
+* every document separately. Later changes of @a decoder do not affect this
+* decoder.
+*/
+void BatchDecoder::setDecoderOptions(const Decoder &decoder) {
+	for (auto &threadDecoder : decoders) {
+		*threadDecoder = decoder;
+	}
+}
+
+/**
+* @brief Decodes the given bencoded @a documents in parallel.
+*
+* @return For every document, the result of Decoder::tryDecode() (in the
+*         order of @a documents).
+*
+* This function does not throw exceptions because of invalid documents; their
+* errors are reported in their results.
+*/
+std::vector<DecodingResult> BatchDecoder::decode(
+		const std::vector<std::string> &documents) {
+	return decode(documents.data(), documents.size());
+}
+
+/**
+* @brief Decodes @a numOfDocuments bencoded documents starting at @a
+*        documents in parallel.
+*
+* See decode(const std::vector<std::string> &) for more details.
+*/
+std::vector<DecodingResult> BatchDecoder::decode(const std::string *documents,
+		std::size_t numOfDocuments) {
+	std::vector<DecodingResult> results(numOfDocuments);
+	threadPool->runWithThreadIndexes(numOfDocuments,
+		[&](std::size_t i, std::size_t thread) {
+			results[i] = decoders[thread]->tryDecode(documents[i]);
+		}
+	);
+	return results;
+}
+
+/**
+* @brief Decodes the given bencoded @a documents by using the given number of
+*        threads.
+*
+* This function provides an easier way of batch decoding without the need of
+* explicitly creating a BatchDecoder instance. When batches are decoded
+* repeatedly, create the decoder once and reuse it instead (this function
+* starts and joins the threads on every call).
+*/
+std::vector<DecodingResult> decodeBatch(
+		const std::vector<std::string> &documents, std::size_t numOfThreads) {
+	return BatchDecoder::create(numOfThreads)->decode(documents);
+}
+
+} // namespace bencoding
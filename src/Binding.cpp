@@ -0,0 +1,171 @@
+/**
+* @file      Binding.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of decoding and encoding of bencoded data directly
+*            from and into C++ types.
+*/
+
+#include "Binding.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Checks if the key of field @a a is smaller than the key of field @a b.
+*
+* Keys are compared as strings of unsigned characters.
+*/
+bool hasSmallerKey(const FieldBinding &a, const FieldBinding &b) {
+	int result = std::memcmp(a.key, b.key, std::min(a.keyLength, b.keyLength));
+	return result < 0 || (result == 0 && a.keyLength < b.keyLength);
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a context reading the input by the given @a reader.
+*/
+BindingContext::BindingContext(Reader &reader) noexcept:
+	inputReader(reader) {}
+
+/**
+* @brief Returns the reader of the input.
+*/
+Reader &BindingContext::reader() noexcept {
+	return inputReader;
+}
+
+/**
+* @brief Records that the decoding failed at the current token because of
+*        the given @a error.
+*
+* @return Always @c false, so the result can be returned directly from
+*         Binding::read().
+*/
+bool BindingContext::failAtCurrentToken(DecodingErrorCode error) noexcept {
+	errorCode = error;
+	errorPos = inputReader.tokenBegin();
+	return false;
+}
+
+/**
+* @brief Returns the reason of the failure of the decoding.
+*
+* When no failure has been recorded by failAtCurrentToken(), the error of the
+* reader is returned.
+*/
+DecodingResult BindingContext::result() const noexcept {
+	if (errorCode != DecodingErrorCode::None) {
+		return DecodingResult(errorCode, errorPos);
+	}
+	return DecodingResult(inputReader.error(), inputReader.errorOffset());
+}
+
+/**
+* @brief Constructs a binding of a struct with the given bound members.
+*
+* @param[in] fields Bound members of the struct. They have to outlive the
+*                   binding.
+* @param[in] numOfFields Number of @a fields.
+*/
+StructBinding::StructBinding(const FieldBinding *fields,
+		std::size_t numOfFields):
+		fields(fields), numOfFields(numOfFields), sortedFields(numOfFields) {
+	for (std::size_t i = 0; i < numOfFields; ++i) {
+		sortedFields[i] = i;
+	}
+	std::sort(sortedFields.begin(), sortedFields.end(),
+		[fields](std::size_t a, std::size_t b) {
+			return hasSmallerKey(fields[a], fields[b]);
+		});
+}
+
+/**
+* @brief Decodes the dictionary whose first token has just been read by the
+*        reader of @a context into the struct pointed to by @a object.
+*
+* Values of unknown keys are skipped by the reader.
+*/
+bool StructBinding::read(BindingContext &context, void *object) const {
+	Reader &reader = context.reader();
+	if (reader.tokenType() != TokenType::DictBegin) {
+		return context.failAtCurrentToken(DecodingErrorCode::UnexpectedType);
+	}
+
+	std::size_t nextField = 0;
+	for (;;) {
+		switch (reader.next()) {
+			case TokenType::End:
+				return true;
+			case TokenType::Error:
+				return false;
+			default:
+				break;
+		}
+		std::size_t field = findField(nextField, reader.stringData(),
+			reader.stringLength());
+		if (reader.next() == TokenType::Error) {
+			return false;
+		}
+
+		if (field == numOfFields) {
+			if (!reader.skip()) {
+				return false;
+			}
+		} else {
+			if (!fields[field].read(context, object)) {
+				return false;
+			}
+			nextField = field + 1;
+		}
+	}
+}
+
+/**
+* @brief Writes the struct pointed to by @a object as a dictionary.
+*
+* The keys are written sorted, regardless of the order of the members in the
+* binding.
+*/
+void StructBinding::write(Writer &writer, const void *object) const {
+	writer.beginDict();
+	for (auto field : sortedFields) {
+		fields[field].write(writer, fields[field], object);
+	}
+	writer.end();
+}
+
+/**
+* @brief Returns the index of the field bound to the given @a key (@c
+*        numOfFields when there is no such field), starting the search at @a
+*        firstField.
+*/
+std::size_t StructBinding::findField(std::size_t firstField, const char *key,
+		std::size_t length) const {
+	return bencoding::findField(fields, numOfFields, firstField, key, length,
+		[](const FieldBinding &field) {
+			return std::make_pair(field.key, field.keyLength);
+		});
+}
+
+namespace internal {
+
+/**
+* @brief Writes the given unsigned @a value that does not fit into
+*        BInteger::ValueType.
+*/
+void writeLargeInteger(Writer &writer, unsigned long long value) {
+	writer.raw("i" + std::to_string(value) + "e");
+}
+
+} // namespace internal
+
+} // namespace bencoding
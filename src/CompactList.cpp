@@ -0,0 +1,199 @@
+/**
+* @file      CompactList.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the records of compact peer and node lists.
+*/
+
+#include "CompactList.h"
+
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+
+#include "Utils.h"
+
+// On x86, IPv4 endpoints are converted in bulk by SSSE3 when the processor
+// supports it (checked at runtime, so the library still runs everywhere).
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BENCODING_SSSE3_AVAILABLE
+#include <tmmintrin.h>
+#endif
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Reads a big-endian 16-bit number from @a p.
+*/
+inline std::uint16_t loadBigEndian16(const char *p) {
+	auto bytes = reinterpret_cast<const unsigned char *>(p);
+	return static_cast<std::uint16_t>((bytes[0] << 8) | bytes[1]);
+}
+
+#ifdef BENCODING_SSSE3_AVAILABLE
+
+// The shuffle below produces Ipv4Endpoint instances byte by byte.
+static_assert(sizeof(Ipv4Endpoint) == 8 && offsetof(Ipv4Endpoint, port) == 4,
+	"unexpected layout of Ipv4Endpoint");
+
+/**
+* @brief Converts as many of the given @a count compact IPv4 endpoints as
+*        possible by SSSE3 and returns their number.
+*
+* Every 16-byte load holds two records (12 bytes), whose bytes are swapped
+* into two endpoints by a single shuffle. The loads must not cross the end of
+* the data, so the last one or two records are left to the caller.
+*/
+__attribute__((target("ssse3")))
+std::size_t convertIpv4EndpointsBySsse3(const char *data, std::size_t count,
+		Ipv4Endpoint *endpoints) noexcept {
+	const __m128i shuffle = _mm_setr_epi8(
+		3, 2, 1, 0, 5, 4, -1, -1, 9, 8, 7, 6, 11, 10, -1, -1);
+	std::size_t i = 0;
+	for (; i + 3 <= count; i += 2) {
+		__m128i records = _mm_loadu_si128(
+			reinterpret_cast<const __m128i *>(data + i * 6));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(endpoints + i),
+			_mm_shuffle_epi8(records, shuffle));
+	}
+	return i;
+}
+
+/**
+* @brief Checks if the processor supports SSSE3.
+*/
+bool hasSsse3() noexcept {
+	static const bool supported = __builtin_cpu_supports("ssse3");
+	return supported;
+}
+
+#endif
+
+/**
+* @brief Appends the given @a port to the given textual endpoint.
+*/
+std::string withPort(std::ostringstream &out, std::uint16_t port) {
+	out << ':' << port;
+	return out.str();
+}
+
+} // anonymous namespace
+
+// Static constants.
+const std::size_t Ipv4Endpoint::COMPACT_SIZE;
+const std::size_t Ipv6Endpoint::COMPACT_SIZE;
+const std::size_t DhtNode::COMPACT_SIZE;
+const std::size_t DhtNode6::COMPACT_SIZE;
+
+/**
+* @brief Converts the compact form of an endpoint starting at @a data.
+*/
+Ipv4Endpoint Ipv4Endpoint::fromCompact(const char *data) noexcept {
+	auto bytes = reinterpret_cast<const unsigned char *>(data);
+	return Ipv4Endpoint{loadBigEndian32(bytes), loadBigEndian16(data + 4)};
+}
+
+/**
+* @brief Converts the given @a count compact endpoints starting at @a data
+*        into @a endpoints.
+*
+* On x86 processors supporting SSSE3, two endpoints are converted by a single
+* instruction.
+*/
+void Ipv4Endpoint::fromCompact(const char *data, std::size_t count,
+		Ipv4Endpoint *endpoints) noexcept {
+	std::size_t i = 0;
+#ifdef BENCODING_SSSE3_AVAILABLE
+	if (hasSsse3()) {
+		i = convertIpv4EndpointsBySsse3(data, count, endpoints);
+	}
+#endif
+	for (; i < count; ++i) {
+		endpoints[i] = fromCompact(data + i * COMPACT_SIZE);
+	}
+}
+
+/**
+* @brief Returns the endpoint in the form @c a.b.c.d:port.
+*/
+std::string Ipv4Endpoint::toString() const {
+	std::ostringstream out;
+	out << (address >> 24) << '.' << ((address >> 16) & 0xff) << '.'
+		<< ((address >> 8) & 0xff) << '.' << (address & 0xff);
+	return withPort(out, port);
+}
+
+/**
+* @brief Converts the compact form of an endpoint starting at @a data.
+*/
+Ipv6Endpoint Ipv6Endpoint::fromCompact(const char *data) noexcept {
+	Ipv6Endpoint endpoint;
+	std::memcpy(endpoint.address, data, sizeof(endpoint.address));
+	endpoint.port = loadBigEndian16(data + 16);
+	return endpoint;
+}
+
+/**
+* @brief Converts the given @a count compact endpoints starting at @a data
+*        into @a endpoints.
+*/
+void Ipv6Endpoint::fromCompact(const char *data, std::size_t count,
+		Ipv6Endpoint *endpoints) noexcept {
+	for (std::size_t i = 0; i < count; ++i) {
+		endpoints[i] = fromCompact(data + i * COMPACT_SIZE);
+	}
+}
+
+/**
+* @brief Returns the endpoint in the form @c [a:b:c:d:e:f:g:h]:port (zeros
+*        are not compressed).
+*/
+std::string Ipv6Endpoint::toString() const {
+	std::ostringstream out;
+	out << '[' << std::hex;
+	for (std::size_t i = 0; i < sizeof(address); i += 2) {
+		out << (i > 0 ? ":" : "") << ((address[i] << 8) | address[i + 1]);
+	}
+	out << ']' << std::dec;
+	return withPort(out, port);
+}
+
+/**
+* @brief Converts the compact form of a node starting at @a data.
+*/
+DhtNode DhtNode::fromCompact(const char *data) noexcept {
+	return DhtNode{data, Ipv4Endpoint::fromCompact(data + 20)};
+}
+
+/**
+* @brief Converts the given @a count compact nodes starting at @a data into
+*        @a nodes.
+*/
+void DhtNode::fromCompact(const char *data, std::size_t count,
+		DhtNode *nodes) noexcept {
+	for (std::size_t i = 0; i < count; ++i) {
+		nodes[i] = fromCompact(data + i * COMPACT_SIZE);
+	}
+}
+
+/**
+* @brief Converts the compact form of a node starting at @a data.
+*/
+DhtNode6 DhtNode6::fromCompact(const char *data) noexcept {
+	return DhtNode6{data, Ipv6Endpoint::fromCompact(data + 20)};
+}
+
+/**
+* @brief Converts the given @a count compact nodes starting at @a data into
+*        @a nodes.
+*/
+void DhtNode6::fromCompact(const char *data, std::size_t count,
+		DhtNode6 *nodes) noexcept {
+	for (std::size_t i = 0; i < count; ++i) {
+		nodes[i] = fromCompact(data + i * COMPACT_SIZE);
+	}
+}
+
+} // namespace bencoding
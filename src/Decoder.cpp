@@ -7,28 +7,119 @@
 
 #include "Decoder.h"
 
-#include <cassert>
-#include <regex>
-#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <utility>
+#include <vector>
 
 #include "BDictionary.h"
 #include "BInteger.h"
 #include "BList.h"
 #include "BString.h"
+#include "KeyInternTable.h"
+#include "Reader.h"
+#include "Schema.h"
+#include "Sha1.h"
+#include "Sha256.h"
 #include "Utils.h"
 
 namespace bencoding {
 
+namespace {
+
+/// Number of characters of a string read at once when it is not known whether
+/// the input contains the whole string.
+const std::string::size_type STRING_CHUNK_SIZE = 64 * 1024;
+
+/**
+* @brief Appends at most @a length characters read from @a input to @a data.
+*
+* When @a input has not buffered the whole string, the string is read in
+* chunks whose size doubles (starting at @c STRING_CHUNK_SIZE). A bogus length
+* thus cannot make the decoder allocate much more memory than how many
+* characters are actually available.
+*
+* @return @c true if all the @a length characters have been read, @c false
+*         otherwise.
+*/
+bool appendFromStream(std::istream &input, std::string &data,
+		std::size_t length) {
+	std::size_t numOfReadChars = 0;
+	while (numOfReadChars < length) {
+		std::size_t chunkSize = length - numOfReadChars;
+		std::streamsize numOfAvailableChars = input.rdbuf()->in_avail();
+		if (numOfAvailableChars <= 0 ||
+				static_cast<std::size_t>(numOfAvailableChars) < chunkSize) {
+			chunkSize = std::min(chunkSize,
+				std::max(STRING_CHUNK_SIZE, numOfReadChars));
+		}
+		std::size_t oldSize = data.size();
+		data.resize(oldSize + chunkSize);
+		input.read(&data[oldSize], static_cast<std::streamsize>(chunkSize));
+		auto numOfChunkChars = static_cast<std::size_t>(input.gcount());
+		data.resize(oldSize + numOfChunkChars);
+		numOfReadChars += numOfChunkChars;
+		if (numOfChunkChars < chunkSize) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Hashing of the info dictionary of a torrent file while it is being
+*        decoded.
+*/
+struct Decoder::InfoHashing {
+	explicit InfoHashing(const char *input);
+
+	bool isActive() const;
+	void start(std::size_t offset);
+	void discard();
+	void update(std::size_t offset);
+	void finish(std::size_t offset);
+
+	/// Start of the input.
+	const char *input;
+
+	/// Is the info dictionary being hashed?
+	bool active = false;
+
+	/// Offset of the first input character that has not been hashed yet.
+	std::size_t hashedUpTo = 0;
+
+	/// Computation of the v1 infohash.
+	Sha1 sha1;
+
+	/// Computation of the v2 infohash.
+	Sha256 sha256;
+
+	/// The v1 infohash (empty when not computed).
+	std::string v1;
+
+	/// The v2 infohash (empty when not computed).
+	std::string v2;
+};
+
 /**
 * @brief Constructs a new exception with the given message.
 */
 DecodingError::DecodingError(const std::string &what):
 	std::runtime_error(what) {}
 
+/**
+* @brief Constructs a new exception with the given message.
+*/
+DecodingLimitExceeded::DecodingLimitExceeded(const std::string &what):
+	DecodingError(what) {}
+
 /**
 * @brief Constructs a decoder.
 */
-Decoder::Decoder() {}
+Decoder::Decoder() = default;
 
 /**
 * @brief Creates a new decoder.
@@ -42,12 +133,15 @@ std::unique_ptr<Decoder> Decoder::create() {
 *
 * If there are some characters left after the decoded data, this function
 * throws DecodingError.
+*
+* This is a throwing wrapper over tryDecode().
 */
 std::unique_ptr<BItem> Decoder::decode(const std::string &data) {
-	std::istringstream input(data);
-	auto decodedData = decode(input);
-	validateInputDoesNotContainUndecodedCharacters(input);
-	return decodedData;
+	auto result = tryDecode(data);
+	if (!result) {
+		throwDecodingError(result);
+	}
+	return result.releaseData();
 }
 
 /**
@@ -56,262 +150,690 @@ std::unique_ptr<BItem> Decoder::decode(const std::string &data) {
 * If there are some characters left after the decoding, they are left in @a
 * input, i.e. they are not read. This behavior differs for the overload of
 * decode() that takes @c std::string as the input.
+*
+* The characters of the item are read into memory first and then decoded in
+* the same way as by decode(const std::string &), so both overloads report
+* the same errors and apply the same limits and options. Offsets in error
+* messages are counted from the first character read from @a input.
 */
 std::unique_ptr<BItem> Decoder::decode(std::istream &input) {
-	switch (input.peek()) {
-		case 'd':
-			return decodeDictionary(input);
-		case 'i':
-			return decodeInteger(input);
-		case 'l':
-			return decodeList(input);
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			return decodeString(input);
-		default:
-			throw DecodingError(std::string("unexpected character: '") +
-				static_cast<char>(input.peek()) + "'");
-	}
+	std::string data;
+	readEncodedItem(input, data);
+	return decode(data);
+}
 
-	assert(false && "should never happen");
-	return std::unique_ptr<BItem>();
+/**
+* @brief Decodes the given bencoded @a data without throwing exceptions.
+*
+* Works like decode(const std::string &), but errors are reported in the
+* returned result as a DecodingErrorCode together with the offset of the
+* input character at which the decoding failed.
+*
+* When recording of spans is enabled (see setSpanRecording() and
+* setSpanRecordingKeys()), the result also holds the spans of the decoded
+* items in @a data (see DecodingResult::sourceMap()). When computation of
+* infohashes is enabled (see setInfoHashComputation()), the result also holds
+* the infohashes.
+*/
+DecodingResult Decoder::tryDecode(const std::string &data) noexcept {
+	return tryDecode(data.data(), data.size());
 }
 
 /**
-* @brief Reads @a expected_char from @a input and discards it.
+* @brief Decodes the given @a length characters of bencoded @a data without
+*        throwing exceptions.
+*
+* See tryDecode(const std::string &) for more details.
 */
-void Decoder::readExpectedChar(std::istream &input, char expected_char) const {
-	int c = input.get();
-	if (c != expected_char) {
-		throw DecodingError(std::string("expected '") + expected_char +
-			"', got '" + static_cast<char>(c) + "'");
+DecodingResult Decoder::tryDecode(const char *data,
+		std::size_t length) noexcept {
+	std::size_t itemLength = 0;
+	auto result = tryDecodePrefix(data, length, itemLength);
+	if (result && itemLength != length) {
+		return DecodingResult(DecodingErrorCode::UndecodedCharacters,
+			itemLength);
 	}
+	return result;
 }
 
 /**
-* @brief Decodes a dictionary from @a input.
-*
-* @par Format
-* @code
-* d<bencoded string><bencoded element>e
-* @endcode
+* @brief Decodes the item at the beginning of the given @a length characters
+*        of bencoded @a data without throwing exceptions.
 *
-* @par Example
-* @code
-* d3:cow3:moo4:spam4:eggse represents the dictionary {"cow": "moo", "spam": "eggs"}
-* d4:spaml1:a1:bee represents the dictionary {"spam": ["a", "b"]}
-* @endcode
+* @param[in] data Bencoded data.
+* @param[in] length Number of characters of @a data.
+* @param[out] itemLength Number of characters of the decoded item (only when
+*                        the decoding succeeds).
 *
-* The keys must be bencoded strings. The values may be any bencoded type,
-* including integers, strings, lists, and other dictionaries. This function
-* supports decoding of dictionaries whose keys are not lexicographically sorted
-* (according to the <a
-* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">specification</a>,
-* they must be sorted).
+* Unlike tryDecode(), characters after the item are neither read nor checked,
+* so this function can be used to decode data consisting of several
+* concatenated items (see also DocumentStream). Otherwise, it works like
+* tryDecode(). The limits (see setLimits()) apply to the decoded item.
 */
-std::unique_ptr<BDictionary> Decoder::decodeDictionary(std::istream &input) {
-	readExpectedChar(input, 'd');
-	auto bDictionary = decodeDictionaryItemsIntoDictionary(input);
-	readExpectedChar(input, 'e');
-	return bDictionary;
+DecodingResult Decoder::tryDecodePrefix(const char *data, std::size_t length,
+		std::size_t &itemLength) noexcept {
+	Reader reader(data, length);
+	reader.setLimits(limits);
+	reader.setKeyOrderChecking(keyOrderChecking);
+	try {
+		SourceMap sourceMap;
+		bool recordSpans = spanRecording || !spanRecordingKeys.empty();
+		InfoHashing infoHashing(data);
+		auto decodedData = buildItem(reader,
+			recordSpans ? &sourceMap : nullptr,
+			infoHashComputation ? &infoHashing : nullptr);
+		if (!decodedData) {
+			if (reader.tokenType() == TokenType::EndOfInput) {
+				return DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+					reader.offset());
+			}
+			return DecodingResult(reader.error(), reader.errorOffset());
+		}
+		itemLength = reader.offset();
+		return DecodingResult(std::move(decodedData), std::move(sourceMap),
+			std::move(infoHashing.v1), std::move(infoHashing.v2));
+	} catch (const std::bad_alloc &) {
+		return DecodingResult(DecodingErrorCode::OutOfMemory, reader.offset());
+	}
 }
 
 /**
-* @brief Decodes items from @a input, adds them to a dictionary, and returns
-*        that dictionary.
+* @brief Checks that the given @a data are well-formed bencoded data without
+*        decoding them.
+*
+* The same checks as in tryDecode() are performed, including the limits
+* (see setLimits()), the key order (see setKeyOrderChecking()), and the check
+* that there are no characters after the first item. However, no items are
+* built and no memory is allocated (unless lists and dictionaries are nested
+* deeper than Reader::INLINE_DEPTH levels), so the validation is much faster
+* than decoding.
+*
+* The returned result never holds any data.
 */
-std::unique_ptr<BDictionary> Decoder::decodeDictionaryItemsIntoDictionary(
-		std::istream &input) {
-	auto bDictionary = BDictionary::create();
-	while (input && input.peek() != 'e') {
-		std::shared_ptr<BString> key(decodeDictionaryKey(input));
-		std::shared_ptr<BItem> value(decodeDictionaryValue(input));
-		(*bDictionary)[key] = value;
-	}
-	return bDictionary;
+DecodingResult Decoder::validate(const std::string &data) noexcept {
+	return validate(data.data(), data.size());
 }
 
 /**
-* @brief Decodes a dictionary key from @a input.
+* @brief Checks that the given @a length characters of @a data are well-formed
+*        bencoded data without decoding them.
+*
+* See validate(const std::string &) for more details.
 */
-std::shared_ptr<BString> Decoder::decodeDictionaryKey(std::istream &input) {
-	std::shared_ptr<BItem> key(decode(input));
-	// A dictionary key has to be a string.
-	std::shared_ptr<BString> keyAsBString(key->as<BString>());
-	if (!keyAsBString) {
-		throw DecodingError(
-			"found a dictionary key that is not a bencoded string"
-		);
+DecodingResult Decoder::validate(const char *data,
+		std::size_t length) noexcept {
+	Reader reader(data, length);
+	reader.setLimits(limits);
+	reader.setKeyOrderChecking(keyOrderChecking);
+	switch (reader.next()) {
+		case TokenType::EndOfInput:
+			return DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+				reader.offset());
+		case TokenType::Error:
+			return DecodingResult(reader.error(), reader.errorOffset());
+		default:
+			break;
+	}
+	if (!reader.skip()) {
+		return DecodingResult(reader.error(), reader.errorOffset());
+	} else if (reader.offset() != length) {
+		return DecodingResult(DecodingErrorCode::UndecodedCharacters,
+			reader.offset());
 	}
-	return keyAsBString;
+	return DecodingResult();
 }
 
 /**
-* @brief Decodes a dictionary value from @a input.
+* @brief Decodes the given bencoded @a data guided by the given @a schema and
+*        returns them.
+*
+* This is a throwing wrapper over tryDecode(const std::string &, const Schema
+* &).
 */
-std::unique_ptr<BItem> Decoder::decodeDictionaryValue(std::istream &input) {
-	return decode(input);
+std::unique_ptr<BItem> Decoder::decode(const std::string &data,
+		const Schema &schema) {
+	auto result = tryDecode(data, schema);
+	if (!result) {
+		throwDecodingError(result);
+	}
+	return result.releaseData();
 }
 
 /**
-* @brief Decodes an integer from @a input.
+* @brief Decodes the given bencoded @a data guided by the given @a schema
+*        without throwing exceptions.
 *
-* @par Format
-* @code
-* i<integer encoded in base ten ASCII>e
-* @endcode
+* Only the items described by @a schema are built. Values of dictionary keys
+* that are not declared in the schema are checked to be well-formed but
+* skipped without creating any items or allocating memory, so the returned
+* tree is pruned. The types of the items are checked as they are read; an
+* item of another type is reported as DecodingErrorCode::UnexpectedType and
+* a dictionary without a required key as DecodingErrorCode::MissingKey (at
+* the end of the dictionary).
 *
-* @par Example
-* @code
-* i3e represents the integer 3
-* @endcode
+* The limits (see setLimits()) and the key order checking (see
+* setKeyOrderChecking()) apply to the whole input, including the skipped
+* values. Spans and infohashes are not computed.
 *
-* Moreover, only the significant digits should be used, one cannot pad the
-* integer with zeroes, such as @c i04e (see the <a
-* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">
-* specification</a>).
+* To decode data straight into your own structs, see decodeInto().
 */
-std::unique_ptr<BInteger> Decoder::decodeInteger(std::istream &input) const {
-	return decodeEncodedInteger(readEncodedInteger(input));
+DecodingResult Decoder::tryDecode(const std::string &data,
+		const Schema &schema) noexcept {
+	return tryDecode(data.data(), data.size(), schema);
 }
 
 /**
-* @brief Reads an encoded integer from @a input.
+* @brief Decodes the given @a length characters of bencoded @a data guided by
+*        the given @a schema without throwing exceptions.
+*
+* See tryDecode(const std::string &, const Schema &) for more details.
 */
-std::string Decoder::readEncodedInteger(std::istream &input) const {
-	// See the description of decodeInteger() for the format and example.
-	std::string encodedInteger;
-	bool encodedIntegerReadCorrectly = readUntil(input, encodedInteger, 'e');
-	if (!encodedIntegerReadCorrectly) {
-		throw DecodingError("error during the decoding of an integer near '" +
-			encodedInteger + "'");
+DecodingResult Decoder::tryDecode(const char *data, std::size_t length,
+		const Schema &schema) noexcept {
+	Reader reader(data, length);
+	reader.setLimits(limits);
+	reader.setKeyOrderChecking(keyOrderChecking);
+	switch (reader.next()) {
+		case TokenType::EndOfInput:
+			return DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+				reader.offset());
+		case TokenType::Error:
+			return DecodingResult(reader.error(), reader.errorOffset());
+		default:
+			break;
 	}
 
-	return encodedInteger;
+	try {
+		DecodingResult mismatch;
+		auto decodedData = buildItem(reader, schema, mismatch);
+		if (!decodedData) {
+			if (mismatch.error() != DecodingErrorCode::None) {
+				return mismatch;
+			}
+			return DecodingResult(reader.error(), reader.errorOffset());
+		} else if (reader.offset() != length) {
+			return DecodingResult(DecodingErrorCode::UndecodedCharacters,
+				reader.offset());
+		}
+		return DecodingResult(std::move(decodedData));
+	} catch (const std::bad_alloc &) {
+		return DecodingResult(DecodingErrorCode::OutOfMemory, reader.offset());
+	}
 }
 
 /**
-* @brief Decodes the given encoded integer.
+* @brief Sets limits of resources that a single decoding may use.
 */
-std::unique_ptr<BInteger> Decoder::decodeEncodedInteger(
-		const std::string &encodedInteger) const {
-	// See the description of decodeInteger() for the format and example.
-	std::regex integerRegex("i([-+]?(0|[1-9][0-9]*))e");
-	std::smatch match;
-	bool valid = std::regex_match(encodedInteger, match, integerRegex);
-	if (!valid) {
-		throw DecodingError("encountered an encoded integer of invalid format: '" +
-			encodedInteger + "'");
-	}
+void Decoder::setLimits(const DecoderLimits &limits) {
+	this->limits = limits;
+}
 
-	BInteger::ValueType integerValue;
-	strToNum(match[1].str(), integerValue);
-	return BInteger::create(integerValue);
+/**
+* @brief Returns the limits of resources that a single decoding may use.
+*/
+const DecoderLimits &Decoder::getLimits() const {
+	return limits;
 }
 
 /**
-* @brief Decodes a list from @a input.
+* @brief Sets whether to check that keys in every dictionary are sorted and
+*        unique.
 *
-* @par Format
-* @code
-* l<bencoded values>e
-* @endcode
+* The <a
+* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">specification</a>
+* requires the keys to be sorted as raw strings, but by default, the decoder
+* accepts them in any order. When enabled, a dictionary with unsorted or
+* duplicate keys is reported as an error.
+*/
+void Decoder::setKeyOrderChecking(bool enabled) {
+	keyOrderChecking = enabled;
+}
+
+/**
+* @brief Sets whether tryDecode() records spans of all decoded items
+*        (including dictionary keys) in the input.
 *
-* @par Example
-* @code
-* l4:spam4:eggse represents a list containing two strings "spam" and "eggs"
-* @endcode
+* By default, no spans are recorded.
 */
-std::unique_ptr<BList> Decoder::decodeList(std::istream &input) {
-	readExpectedChar(input, 'l');
-	auto bList = decodeListItemsIntoList(input);
-	readExpectedChar(input, 'e');
-	return bList;
+void Decoder::setSpanRecording(bool enabled) {
+	spanRecording = enabled;
 }
 
 /**
-* @brief Decodes items from @a input, appends them to a list, and returns that
-*        list.
+* @brief Makes tryDecode() record spans of values of the given dictionary
+*        @a keys, in dictionaries at any depth.
+*
+* For example, when @a keys is <tt>{"info"}</tt>, the span of the @c info
+* dictionary of a torrent file is recorded. It is cheaper than recording spans
+* of all the items (see setSpanRecording()). Pass an empty vector to stop
+* recording them.
 */
-std::unique_ptr<BList> Decoder::decodeListItemsIntoList(std::istream &input) {
-	auto bList = BList::create();
-	while (input && input.peek() != 'e') {
-		bList->push_back(decode(input));
+void Decoder::setSpanRecordingKeys(const std::vector<std::string> &keys) {
+	spanRecordingKeys = keys;
+}
+
+/**
+* @brief Sets whether tryDecode() computes infohashes of torrent files.
+*
+* When enabled, the BitTorrent v1 infohash (SHA-1) and v2 infohash (SHA-256)
+* of the value of the @c info key in the top-level dictionary are computed
+* while the data are decoded, from the original input characters (see
+* DecodingResult::infoHashV1() and DecodingResult::infoHashV2()). No
+* infohashes are computed when the value is not a dictionary. When the key is
+* duplicated (see setKeyOrderChecking()), the value kept in the decoded
+* dictionary, i.e. the last one, is hashed. By default, no infohashes are
+* computed.
+*/
+void Decoder::setInfoHashComputation(bool enabled) {
+	infoHashComputation = enabled;
+}
+
+/**
+* @brief Makes the decoder use the given @a table of interned dictionary keys.
+*
+* Decoded keys that are in the table (or that are added to an adaptive table)
+* are shared by all the decoded dictionaries instead of being allocated again
+* for each of them. Pass @c nullptr to stop interning (the default).
+*
+* The table may be shared by several decoders, including decoders running in
+* different threads. When spans of all the items are recorded (see
+* setSpanRecording()), the keys are not interned because every key needs its
+* own span.
+*/
+void Decoder::setKeyInterning(std::shared_ptr<KeyInternTable> table) {
+	keyInternTable = std::move(table);
+}
+
+/**
+* @brief Returns the table of interned dictionary keys (@c nullptr when keys
+*        are not interned).
+*/
+std::shared_ptr<KeyInternTable> Decoder::getKeyInterning() const {
+	return keyInternTable;
+}
+
+/**
+* @brief Reads the characters of a single encoded item from @a input and
+*        appends them to @a data.
+*
+* The item is only delimited, not decoded: its lists and dictionaries are
+* counted and its strings are read according to their lengths. No character
+* after the item is read. When a character cannot be a part of the item or
+* when @a input ends, the reading stops and the error is reported by the
+* decoding of @a data. The limits (see setLimits()) are checked so that no
+* more characters are read than the decoding could accept.
+*/
+void Decoder::readEncodedItem(std::istream &input, std::string &data) const {
+	const int eof = std::char_traits<char>::eof();
+	auto readChar = [&]() {
+		int c = input.get();
+		if (c != eof) {
+			data += static_cast<char>(c);
+		}
+		return c;
+	};
+
+	std::size_t depth = 0;
+	std::size_t totalStringLength = 0;
+	while (data.size() <= limits.maxInputLength) {
+		int c = readChar();
+		if (c == 'd' || c == 'l') {
+			++depth;
+			continue;
+		} else if (c == 'e' && depth > 0) {
+			--depth;
+		} else if (c == 'i') {
+			do {
+				c = readChar();
+			} while ((isDigit(c) || c == '-' || c == '+') &&
+				data.size() <= limits.maxInputLength);
+			if (c != 'e') {
+				return;
+			}
+		} else if (isDigit(c)) {
+			std::size_t length = 0;
+			bool overflow = false;
+			for (; isDigit(c) && data.size() <= limits.maxInputLength;
+					c = readChar()) {
+				auto digit = static_cast<std::size_t>(c - '0');
+				overflow = overflow || length >
+					(std::numeric_limits<std::size_t>::max() - digit) / 10;
+				length = length * 10 + digit;
+			}
+			if (c != ':' || overflow || length > limits.maxStringLength ||
+					length > limits.maxTotalStringLength - totalStringLength ||
+					data.size() > limits.maxInputLength) {
+				return;
+			}
+			totalStringLength += length;
+			if (!appendFromStream(input, data, std::min(length,
+					limits.maxInputLength - data.size() + 1))) {
+				return;
+			}
+		} else {
+			return;
+		}
+
+		if (depth == 0) {
+			return;
+		}
 	}
-	return bList;
 }
 
 /**
-* @brief Decodes a string from @a input.
+* @brief Reads a single item from @a reader and builds its tree.
+*
+* Lists and dictionaries are built without recursion, so deeply nested input
+* cannot exhaust the stack.
 *
-* @par Format
-* @code
-* <string length encoded in base ten ASCII>:<string data>
-* @endcode
+* When @a sourceMap is not @c nullptr, spans of the built items are recorded
+* into it (all of them or only values of selected keys, depending on the
+* options). When @a infoHashing is not @c nullptr, the input characters of the
+* value of the @c info key in the top-level dictionary are hashed as they are
+* read. When @a tokenRead is @c true, the first token of the item has already
+* been read by @a reader.
 *
-* @par Example
-* @code
-* 4:test represents the string "test"
-* @endcode
+* @return The built item, or @c nullptr when @a reader fails or the input
+*         ends before an item.
 */
-std::unique_ptr<BString> Decoder::decodeString(std::istream &input) const {
-	std::string::size_type stringLength(readStringLength(input));
-	readExpectedChar(input, ':');
-	std::string str(readStringOfGivenLength(input, stringLength));
-	return BString::create(str);
+std::unique_ptr<BItem> Decoder::buildItem(Reader &reader,
+		SourceMap *sourceMap, InfoHashing *infoHashing, bool tokenRead) const {
+	// Currently open lists and dictionaries.
+	struct OpenItem {
+		std::unique_ptr<BItem> item;
+		BList *bList;
+		BDictionary *bDictionary;
+		std::shared_ptr<BString> key;
+		std::size_t begin;
+	};
+	std::vector<OpenItem> openItems;
+
+	for (;;) {
+		if (infoHashing && infoHashing->isActive()) {
+			infoHashing->update(reader.offset());
+		}
+
+		std::unique_ptr<BItem> item;
+		std::size_t begin = 0;
+		TokenType token = tokenRead ? reader.tokenType() : reader.next();
+		tokenRead = false;
+		if (infoHashing && openItems.size() == 1 &&
+				openItems.front().bDictionary && !reader.isKey() &&
+				token != TokenType::End && token != TokenType::Error &&
+				openItems.front().key->value() == "info") {
+			if (token == TokenType::DictBegin) {
+				infoHashing->start(reader.tokenBegin());
+			} else {
+				infoHashing->discard();
+			}
+		}
+		switch (token) {
+			case TokenType::DictBegin: {
+				auto bDictionary = BDictionary::create();
+				auto bDictionaryPtr = bDictionary.get();
+				openItems.push_back(OpenItem{std::move(bDictionary), nullptr,
+					bDictionaryPtr, nullptr, reader.tokenBegin()});
+				continue;
+			}
+			case TokenType::ListBegin: {
+				auto bList = BList::create();
+				auto bListPtr = bList.get();
+				openItems.push_back(OpenItem{std::move(bList), bListPtr,
+					nullptr, nullptr, reader.tokenBegin()});
+				continue;
+			}
+			case TokenType::String:
+				if (reader.isKey()) {
+					openItems.back().key = createKey(reader.stringData(),
+						reader.stringLength(), sourceMap && spanRecording);
+					if (sourceMap && spanRecording) {
+						sourceMap->add(*openItems.back().key,
+							reader.tokenBegin(), reader.offset());
+					}
+					continue;
+				}
+				item = BString::create(reader.string());
+				begin = reader.tokenBegin();
+				break;
+			case TokenType::Integer:
+				item = BInteger::create(reader.integer());
+				begin = reader.tokenBegin();
+				break;
+			case TokenType::End:
+				item = std::move(openItems.back().item);
+				begin = openItems.back().begin;
+				openItems.pop_back();
+				break;
+			case TokenType::EndOfInput:
+			case TokenType::Error:
+			default:
+				return nullptr;
+		}
+
+		if (sourceMap && (spanRecording || (!openItems.empty() &&
+				openItems.back().bDictionary &&
+				isSpanRecordingKey(*openItems.back().key)))) {
+			sourceMap->add(*item, begin, reader.offset());
+		}
+		if (infoHashing && infoHashing->isActive() && openItems.size() == 1) {
+			infoHashing->finish(reader.offset());
+		}
+		if (openItems.empty()) {
+			return item;
+		}
+		auto &parent = openItems.back();
+		if (parent.bDictionary) {
+			auto &value = (*parent.bDictionary)[parent.key];
+			if (value && sourceMap) {
+				// A duplicate key. The previous value is destroyed and the
+				// dictionary keeps the previous key, so the current key is
+				// destroyed too.
+				sourceMap->remove(*value);
+				sourceMap->remove(*parent.key);
+			}
+			value = std::move(item);
+		} else {
+			parent.bList->push_back(std::move(item));
+		}
+	}
 }
 
 /**
-* @brief Reads the string length from @a input, validates it, and returns it.
+* @brief Builds the item whose first token has just been read by @a reader
+*        as described by @a schema.
+*
+* The recursion depth is bounded by the depth of @a schema; items of type
+* Schema::Type::Any are built by the non-recursive buildItem().
+*
+* @return The built item, or @c nullptr when @a reader fails or when the item
+*         does not match @a schema (then, @a mismatch describes the reason).
 */
-std::string::size_type Decoder::readStringLength(std::istream &input) const {
-	std::string stringLengthInASCII;
-	bool stringLengthInASCIIReadCorrectly = readUpTo(input, stringLengthInASCII, ':');
-	if (!stringLengthInASCIIReadCorrectly) {
-		throw DecodingError("error during the decoding of a string near '" +
-			stringLengthInASCII + "'");
+std::unique_ptr<BItem> Decoder::buildItem(Reader &reader,
+		const Schema &schema, DecodingResult &mismatch) const {
+	TokenType expectedToken;
+	switch (schema.getType()) {
+		case Schema::Type::Integer:
+			expectedToken = TokenType::Integer;
+			break;
+		case Schema::Type::String:
+			expectedToken = TokenType::String;
+			break;
+		case Schema::Type::List:
+			expectedToken = TokenType::ListBegin;
+			break;
+		case Schema::Type::Dictionary:
+			expectedToken = TokenType::DictBegin;
+			break;
+		case Schema::Type::Any:
+		default:
+			return buildItem(reader, nullptr, nullptr, true);
+	}
+	if (reader.tokenType() != expectedToken) {
+		mismatch = DecodingResult(DecodingErrorCode::UnexpectedType,
+			reader.tokenBegin());
+		return nullptr;
 	}
 
-	std::string::size_type stringLength;
-	bool stringLengthIsValid = strToNum(stringLengthInASCII, stringLength);
-	if (!stringLengthIsValid) {
-		throw DecodingError("invalid string length: '" + stringLengthInASCII + "'");
+	if (expectedToken == TokenType::Integer) {
+		return BInteger::create(reader.integer());
+	} else if (expectedToken == TokenType::String) {
+		return BString::create(reader.string());
+	} else if (expectedToken == TokenType::ListBegin) {
+		auto bList = BList::create();
+		for (;;) {
+			switch (reader.next()) {
+				case TokenType::End:
+					return std::unique_ptr<BItem>(std::move(bList));
+				case TokenType::Error:
+					return nullptr;
+				default:
+					break;
+			}
+			auto item = buildItem(reader, schema.getItems(), mismatch);
+			if (!item) {
+				return nullptr;
+			}
+			bList->push_back(std::move(item));
+		}
 	}
 
-	return stringLength;
+	auto bDictionary = BDictionary::create();
+	const auto &fields = schema.getFields();
+	std::vector<bool> foundRequiredFields(
+		schema.getNumOfRequiredFields() > 0 ? fields.size() : 0);
+	std::size_t numOfFoundRequiredFields = 0;
+	std::size_t nextField = 0;
+	for (;;) {
+		switch (reader.next()) {
+			case TokenType::End:
+				if (numOfFoundRequiredFields != schema.getNumOfRequiredFields()) {
+					mismatch = DecodingResult(DecodingErrorCode::MissingKey,
+						reader.tokenBegin());
+					return nullptr;
+				}
+				return std::unique_ptr<BItem>(std::move(bDictionary));
+			case TokenType::Error:
+				return nullptr;
+			default:
+				break;
+		}
+		std::size_t field = schema.findField(reader.stringData(),
+			reader.stringLength(), nextField);
+		if (reader.next() == TokenType::Error) {
+			return nullptr;
+		}
+		if (field == fields.size()) {
+			if (!reader.skip()) {
+				return nullptr;
+			}
+			continue;
+		}
+
+		auto value = buildItem(reader, *fields[field].schema, mismatch);
+		if (!value) {
+			return nullptr;
+		}
+		const auto &key = fields[field].key;
+		(*bDictionary)[createKey(key.data(), key.size(), false)] =
+			std::move(value);
+		if (fields[field].required && !foundRequiredFields[field]) {
+			foundRequiredFields[field] = true;
+			++numOfFoundRequiredFields;
+		}
+		nextField = field + 1;
+	}
 }
 
 /**
-* @brief Reads a string of the given @a length from @a input and returns it.
+* @brief Constructs a hashing of the info dictionary in the given @a input.
+*/
+Decoder::InfoHashing::InfoHashing(const char *input): input(input) {}
+
+/**
+* @brief Checks if the info dictionary is being hashed.
+*/
+bool Decoder::InfoHashing::isActive() const {
+	return active;
+}
+
+/**
+* @brief Starts hashing of the info dictionary beginning at the given @a
+*        offset.
+*
+* The infohashes of a previous info dictionary are discarded because the
+* value of a duplicate key replaces the previous value.
+*/
+void Decoder::InfoHashing::start(std::size_t offset) {
+	discard();
+	sha1 = Sha1();
+	sha256 = Sha256();
+	active = true;
+	hashedUpTo = offset;
+}
+
+/**
+* @brief Discards the infohashes of a previous info dictionary.
+*
+* Used when the value of the @c info key is not a dictionary, so there is no
+* info dictionary to be hashed.
+*/
+void Decoder::InfoHashing::discard() {
+	v1.clear();
+	v2.clear();
+	active = false;
+}
+
+/**
+* @brief Hashes the input characters up to the given @a offset.
+*/
+void Decoder::InfoHashing::update(std::size_t offset) {
+	sha1.update(input + hashedUpTo, offset - hashedUpTo);
+	sha256.update(input + hashedUpTo, offset - hashedUpTo);
+	hashedUpTo = offset;
+}
+
+/**
+* @brief Finishes hashing of the info dictionary ending right before the
+*        given @a offset.
+*/
+void Decoder::InfoHashing::finish(std::size_t offset) {
+	update(offset);
+	v1 = sha1.finish();
+	v2 = sha256.finish();
+	active = false;
+}
+
+/**
+* @brief Checks if spans of values of @a key should be recorded.
+*/
+bool Decoder::isSpanRecordingKey(const BString &key) const {
+	return std::find(spanRecordingKeys.begin(), spanRecordingKeys.end(),
+		key.value()) != spanRecordingKeys.end();
+}
+
+/**
+* @brief Creates a dictionary key from the given @a length characters of @a
+*        data.
+*
+* The key is interned when interning is enabled and @a needsOwnKey is @c
+* false.
 */
-std::string Decoder::readStringOfGivenLength(std::istream &input,
-		std::string::size_type length) const {
-	std::string str(length, char());
-	input.read(&str[0], length);
-	std::string::size_type numOfReadChars(input.gcount());
-	if (numOfReadChars != length) {
-		throw DecodingError("expected a string containing " + std::to_string(length) +
-			" characters, but read only " + std::to_string(numOfReadChars) +
-			" characters");
+std::shared_ptr<BString> Decoder::createKey(const char *data,
+		std::size_t length, bool needsOwnKey) const {
+	if (keyInternTable && !needsOwnKey) {
+		return keyInternTable->intern(data, length);
 	}
-	return str;
+	return BString::create(std::string(data, length));
 }
 
 /**
-* @brief Throws DecodingError if @a input has not been completely read.
+* @brief Throws an exception corresponding to the failed @a result.
 */
-void Decoder::validateInputDoesNotContainUndecodedCharacters(std::istream &input) {
-	if (input.peek() != std::char_traits<char>::eof()) {
-		throw DecodingError("input contains undecoded characters");
+void Decoder::throwDecodingError(const DecodingResult &result) const {
+	if (isLimitError(result.error())) {
+		throw DecodingLimitExceeded(result.message());
 	}
+	throw DecodingError(result.message());
 }
 
 /**
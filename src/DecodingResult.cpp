@@ -0,0 +1,194 @@
+/**
+* @file      DecodingResult.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the DecodingResult class.
+*/
+
+#include "DecodingResult.h"
+
+#include <utility>
+
+namespace bencoding {
+
+/**
+* @brief Returns a description of the given @a error.
+*/
+const char *getErrorDescription(DecodingErrorCode error) noexcept {
+	switch (error) {
+		case DecodingErrorCode::None:
+			return "no error";
+		case DecodingErrorCode::UnexpectedEndOfInput:
+			return "unexpected end of input";
+		case DecodingErrorCode::UnexpectedCharacter:
+			return "unexpected character";
+		case DecodingErrorCode::InvalidInteger:
+			return "encountered an encoded integer of invalid format";
+		case DecodingErrorCode::IntegerOutOfRange:
+			return "integer is out of range";
+		case DecodingErrorCode::InvalidStringLength:
+			return "invalid string length";
+		case DecodingErrorCode::NonStringKey:
+			return "found a dictionary key that is not a bencoded string";
+		case DecodingErrorCode::UnsortedKeys:
+			return "dictionary keys are not sorted";
+		case DecodingErrorCode::DuplicateKey:
+			return "duplicate dictionary key";
+		case DecodingErrorCode::UnexpectedType:
+			return "item of unexpected type";
+		case DecodingErrorCode::MissingKey:
+			return "missing required dictionary key";
+		case DecodingErrorCode::InvalidValue:
+			return "invalid value";
+		case DecodingErrorCode::UndecodedCharacters:
+			return "input contains undecoded characters";
+		case DecodingErrorCode::DepthLimitExceeded:
+			return "nesting depth exceeds the limit";
+		case DecodingErrorCode::InputLengthLimitExceeded:
+			return "input length exceeds the limit";
+		case DecodingErrorCode::NumOfItemsLimitExceeded:
+			return "number of items exceeds the limit";
+		case DecodingErrorCode::StringLengthLimitExceeded:
+			return "string length exceeds the limit";
+		case DecodingErrorCode::TotalStringLengthLimitExceeded:
+			return "total string length exceeds the limit";
+		case DecodingErrorCode::OutOfMemory:
+			return "out of memory";
+		default:
+			return "unknown error";
+	}
+}
+
+/**
+* @brief Checks if @a error means that a limit from DecoderLimits was
+*        exceeded.
+*/
+bool isLimitError(DecodingErrorCode error) noexcept {
+	return error == DecodingErrorCode::DepthLimitExceeded ||
+		error == DecodingErrorCode::InputLengthLimitExceeded ||
+		error == DecodingErrorCode::NumOfItemsLimitExceeded ||
+		error == DecodingErrorCode::StringLengthLimitExceeded ||
+		error == DecodingErrorCode::TotalStringLengthLimitExceeded;
+}
+
+/**
+* @brief Constructs a successful result without data.
+*/
+DecodingResult::DecodingResult() noexcept = default;
+
+/**
+* @brief Constructs a successful result holding the given decoded @a data.
+*/
+DecodingResult::DecodingResult(std::unique_ptr<BItem> data) noexcept:
+	decodedData(std::move(data)) {}
+
+/**
+* @brief Constructs a successful result holding the given decoded @a data,
+*        spans of the decoded items in the input, and infohashes.
+*/
+DecodingResult::DecodingResult(std::unique_ptr<BItem> data,
+		SourceMap sourceMap, std::string infoHashV1,
+		std::string infoHashV2) noexcept:
+	decodedData(std::move(data)), spans(std::move(sourceMap)),
+	v1InfoHash(std::move(infoHashV1)), v2InfoHash(std::move(infoHashV2)) {}
+
+/**
+* @brief Constructs a failed result.
+*
+* @param[in] error Reason of the failure.
+* @param[in] offset Offset of the input character at which the decoding
+*                   failed.
+*/
+DecodingResult::DecodingResult(DecodingErrorCode error,
+		std::size_t offset) noexcept:
+	errorCode(error), errorOffset(offset) {}
+
+/**
+* @brief Checks if the decoding succeeded.
+*/
+bool DecodingResult::ok() const noexcept {
+	return errorCode == DecodingErrorCode::None;
+}
+
+/**
+* @brief Checks if the decoding succeeded.
+*/
+DecodingResult::operator bool() const noexcept {
+	return ok();
+}
+
+/**
+* @brief Returns the reason of the failure (DecodingErrorCode::None on
+*        success).
+*/
+DecodingErrorCode DecodingResult::error() const noexcept {
+	return errorCode;
+}
+
+/**
+* @brief Returns the offset of the input character at which the decoding
+*        failed.
+*/
+std::size_t DecodingResult::offset() const noexcept {
+	return errorOffset;
+}
+
+/**
+* @brief Returns a description of the failure, including the offset.
+*/
+std::string DecodingResult::message() const {
+	if (ok()) {
+		return getErrorDescription(errorCode);
+	}
+	return getErrorDescription(errorCode) + std::string(" at offset ") +
+		std::to_string(errorOffset);
+}
+
+/**
+* @brief Returns the decoded data (@c nullptr on failure).
+*
+* The result keeps the ownership of the data.
+*/
+BItem *DecodingResult::data() const noexcept {
+	return decodedData.get();
+}
+
+/**
+* @brief Passes the ownership of the decoded data to the caller.
+*/
+std::unique_ptr<BItem> DecodingResult::releaseData() noexcept {
+	return std::move(decodedData);
+}
+
+/**
+* @brief Returns spans of the decoded items in the input.
+*
+* The map is empty unless recording of spans has been enabled in the decoder.
+*/
+const SourceMap &DecodingResult::sourceMap() const noexcept {
+	return spans;
+}
+
+/**
+* @brief Returns the BitTorrent v1 infohash (20 raw bytes of the SHA-1 hash of
+*        the info dictionary).
+*
+* The infohash is empty unless its computation has been enabled in the
+* decoder and the decoded data are a dictionary whose @c info key has a
+* dictionary value.
+*/
+const std::string &DecodingResult::infoHashV1() const noexcept {
+	return v1InfoHash;
+}
+
+/**
+* @brief Returns the BitTorrent v2 infohash (32 raw bytes of the SHA-256 hash
+*        of the info dictionary).
+*
+* See infoHashV1() for more details.
+*/
+const std::string &DecodingResult::infoHashV2() const noexcept {
+	return v2InfoHash;
+}
+
+} // namespace bencoding
@@ -0,0 +1,272 @@
+/**
+* @file      DocumentStream.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the DocumentStream class.
+*/
+
+#include "DocumentStream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Decoder.h"
+#include "Reader.h"
+#include "ThreadPool.h"
+
+namespace bencoding {
+
+namespace {
+
+/// Minimal number of characters read from a stream at once.
+const std::size_t READ_SIZE = 64 * 1024;
+
+/// Number of documents per thread that are decoded ahead at once.
+const std::size_t DOCUMENTS_PER_THREAD = 16;
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a stream of documents in the given @a length characters
+*        of @a data or in @a input (when it is not @c nullptr).
+*/
+DocumentStream::DocumentStream(const char *data, std::size_t length,
+		std::istream *input): data(data), length(length), input(input) {
+	decoders.push_back(Decoder::create());
+}
+
+/**
+* @brief Creates a stream of documents in the given @a data.
+*
+* The data are not copied, so they have to outlive the stream.
+*/
+std::unique_ptr<DocumentStream> DocumentStream::create(
+		const std::string &data) {
+	return create(data.data(), data.size());
+}
+
+/**
+* @brief Creates a stream of documents in the given @a length characters of
+*        @a data.
+*
+* The data are not copied, so they have to outlive the stream. This makes it
+* possible to decode documents directly from a memory-mapped file.
+*/
+std::unique_ptr<DocumentStream> DocumentStream::create(const char *data,
+		std::size_t length) {
+	return std::unique_ptr<DocumentStream>(
+		new DocumentStream(data, length, nullptr));
+}
+
+/**
+* @brief Creates a stream of documents read from the given @a input.
+*
+* The input is read in blocks, so characters after the last document may be
+* read from it. It has to outlive the stream.
+*/
+std::unique_ptr<DocumentStream> DocumentStream::create(std::istream &input) {
+	return std::unique_ptr<DocumentStream>(
+		new DocumentStream(nullptr, 0, &input));
+}
+
+/**
+* @brief Destructs the stream.
+*/
+DocumentStream::~DocumentStream() = default;
+
+/**
+* @brief Makes the decoding of every document use the options of the given
+*        @a decoder.
+*
+* All the options are copied (limits, checking of the order of keys,
+* recording of spans, and computation of infohashes). The limits apply to
+* every document separately.
+*/
+void DocumentStream::setDecoderOptions(const Decoder &decoder) {
+	for (auto &threadDecoder : decoders) {
+		*threadDecoder = decoder;
+	}
+}
+
+/**
+* @brief Sets the number of threads used for the decoding.
+*
+* @param[in] numOfThreads Number of threads. When it is one (the default),
+*                         every document is decoded by the thread calling
+*                         next(). When it is zero, the number of hardware
+*                         threads is used.
+*
+* When more threads are used, next() decodes several upcoming documents in
+* parallel and returns the other ones from the following calls.
+*/
+void DocumentStream::setNumOfThreads(std::size_t numOfThreads) {
+	threadPool = numOfThreads == 1 ? nullptr : ThreadPool::create(numOfThreads);
+	decoders.resize(1);
+	for (std::size_t i = 1; i < this->numOfThreads(); ++i) {
+		decoders.push_back(std::unique_ptr<Decoder>(new Decoder(*decoders[0])));
+	}
+}
+
+/**
+* @brief Returns the number of threads used for the decoding.
+*/
+std::size_t DocumentStream::numOfThreads() const {
+	return threadPool ? threadPool->numOfThreads() : 1;
+}
+
+/**
+* @brief Checks if there is a document to be returned by next().
+*
+* When the input is a stream, it may be read.
+*/
+bool DocumentStream::hasNext() {
+	if (!decodedDocuments.empty()) {
+		return true;
+	} else if (failed) {
+		return false;
+	}
+	return pos < length || readMore();
+}
+
+/**
+* @brief Decodes and returns the next document.
+*
+* @return The decoded document, or the reason why it cannot be decoded. After
+*         a failure, hasNext() returns @c false and further calls return the
+*         same failure. When there is no document left, the failure is
+*         DecodingErrorCode::UnexpectedEndOfInput.
+*/
+DecodingResult DocumentStream::next() {
+	if (decodedDocuments.empty() && threadPool && !failed) {
+		decodeAhead();
+	}
+	if (decodedDocuments.empty()) {
+		return decodeNext();
+	}
+
+	auto document = std::move(decodedDocuments.front());
+	decodedDocuments.pop_front();
+	if (!document.result) {
+		// The following documents have to be dropped.
+		decodedDocuments.clear();
+		pos = document.begin - dataOffset;
+	}
+	return finishDocument(std::move(document.result), document.begin);
+}
+
+/**
+* @brief Returns the offset of the next document in the input (i.e. the
+*        number of characters of the documents that have been returned by
+*        next()).
+*/
+std::size_t DocumentStream::offset() const {
+	return decodedDocuments.empty() ? dataOffset + pos :
+		decodedDocuments.front().begin;
+}
+
+/**
+* @brief Reads more characters from the input stream into the buffer.
+*
+* Characters of the already decoded documents are removed from the buffer.
+* The number of read characters grows with the size of the buffer, so a large
+* document is decoded only a few times before it is read completely.
+*
+* @return @c true if some characters have been read, @c false otherwise.
+*/
+bool DocumentStream::readMore() {
+	if (!input) {
+		return false;
+	}
+
+	buffer.erase(0, pos);
+	dataOffset += pos;
+	pos = 0;
+	std::size_t oldSize = buffer.size();
+	std::size_t readSize = std::max(READ_SIZE, oldSize);
+	buffer.resize(oldSize + readSize);
+	input->read(&buffer[oldSize], static_cast<std::streamsize>(readSize));
+	buffer.resize(oldSize + static_cast<std::size_t>(input->gcount()));
+	data = buffer.data();
+	length = buffer.size();
+	return length > oldSize;
+}
+
+/**
+* @brief Decodes the next document by the calling thread.
+*/
+DecodingResult DocumentStream::decodeNext() {
+	for (;;) {
+		std::size_t itemLength = 0;
+		auto result = decoders[0]->tryDecodePrefix(data + pos, length - pos,
+			itemLength);
+		if (!result && result.error() == DecodingErrorCode::UnexpectedEndOfInput &&
+				readMore()) {
+			continue;
+		}
+
+		std::size_t begin = dataOffset + pos;
+		if (result) {
+			pos += itemLength;
+		}
+		return finishDocument(std::move(result), begin);
+	}
+}
+
+/**
+* @brief Decodes several upcoming documents in parallel and stores them into
+*        @c decodedDocuments.
+*
+* The boundaries of the documents are found by Reader. When a document is
+* incomplete or invalid, the documents before it are decoded and it is left
+* to decodeNext().
+*/
+void DocumentStream::decodeAhead() {
+	if (length - pos < READ_SIZE) {
+		readMore();
+	}
+
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+	std::size_t maxNumOfDocuments = numOfThreads() * DOCUMENTS_PER_THREAD;
+	Reader reader(data + pos, length - pos);
+	while (ranges.size() < maxNumOfDocuments) {
+		std::size_t begin = reader.offset();
+		auto token = reader.next();
+		if (token == TokenType::EndOfInput || token == TokenType::Error ||
+				!reader.skip()) {
+			break;
+		}
+		ranges.emplace_back(pos + begin, pos + reader.offset());
+	}
+	if (ranges.empty()) {
+		return;
+	}
+
+	std::vector<DecodingResult> results(ranges.size());
+	threadPool->runWithThreadIndexes(ranges.size(),
+		[&](std::size_t i, std::size_t thread) {
+			results[i] = decoders[thread]->tryDecode(data + ranges[i].first,
+				ranges[i].second - ranges[i].first);
+		}
+	);
+	for (std::size_t i = 0; i < ranges.size(); ++i) {
+		decodedDocuments.push_back(DecodedDocument{std::move(results[i]),
+			dataOffset + ranges[i].first});
+	}
+	pos = ranges.back().second;
+}
+
+/**
+* @brief Returns the given @a result of decoding of the document at offset @a
+*        begin, with the offset of a failure counted from the beginning of the
+*        input.
+*/
+DecodingResult DocumentStream::finishDocument(DecodingResult result,
+		std::size_t begin) {
+	if (result) {
+		return result;
+	}
+	failed = true;
+	return DecodingResult(result.error(), begin + result.offset());
+}
+
+} // namespace bencoding
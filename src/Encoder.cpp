@@ -31,15 +31,27 @@ std::unique_ptr<Encoder> Encoder::create() {
 * @brief Encodes the given @a data and returns them.
 */
 std::string Encoder::encode(std::shared_ptr<BItem> data) {
+	std::string output;
+	encode(data, output);
+	return output;
+}
+
+/**
+* @brief Encodes the given @a data and appends them to @a output.
+*
+* This allows to reuse an already allocated buffer when encoding many items.
+*/
+void Encoder::encode(std::shared_ptr<BItem> data, std::string &output) {
+	encodedData.swap(output);
 	data->accept(this);
-	return encodedData;
+	encodedData.swap(output);
 }
 
 void Encoder::visit(BDictionary *bDictionary) {
-	// See the description of Decoder::decodeDictionary() for the format and
+	// See the description of Reader::beginContainer() for the format and
 	// example.
 	encodedData += "d";
-	for (auto item : *bDictionary) {
+	for (const auto &item : *bDictionary) {
 		item.first->accept(this);
 		item.second->accept(this);
 	}
@@ -47,28 +59,29 @@ void Encoder::visit(BDictionary *bDictionary) {
 }
 
 void Encoder::visit(BInteger *bInteger) {
-	// See the description of Decoder::decodeInteger() for the format and
+	// See the description of Reader::readInteger() for the format and
 	// example.
-	std::string encodedInteger("i" + std::to_string(bInteger->value()) + "e");
-	encodedData += encodedInteger;
+	encodedData += 'i';
+	encodedData += std::to_string(bInteger->value());
+	encodedData += 'e';
 }
 
 void Encoder::visit(BList *bList) {
-	// See the description of Decoder::decodeList() for the format and example.
+	// See the description of Reader::beginContainer() for the format and
+	// example.
 	encodedData += "l";
-	for (auto bItem : *bList) {
+	for (const auto &bItem : *bList) {
 		bItem->accept(this);
 	}
 	encodedData += "e";
 }
 
 void Encoder::visit(BString *bString) {
-	// See the description of Decoder::decodeString() for the format and
+	// See the description of Reader::readString() for the format and
 	// example.
-	std::string encodedString(
-		std::to_string(bString->length()) + ":" + bString->value()
-	);
-	encodedData += encodedString;
+	encodedData += std::to_string(bString->length());
+	encodedData += ':';
+	encodedData += bString->value();
 }
 
 /**
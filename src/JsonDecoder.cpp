@@ -0,0 +1,764 @@
+/**
+* @file      JsonDecoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the JsonDecoder class.
+*/
+
+#include "JsonDecoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "BDictionary.h"
+#include "BList.h"
+#include "BString.h"
+#include "Decoder.h"
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/// Marker of hex-encoded binary strings (see JsonEncoder).
+const char HEX_PREFIX[] = "hex:";
+
+/// Marker of base64-encoded binary strings (see JsonEncoder).
+const char BASE64_PREFIX[] = "base64:";
+
+/**
+* @brief Checks if @a str starts with @a prefix of the given @a length.
+*/
+bool startsWith(const std::string &str, const char *prefix,
+		std::size_t length) {
+	return str.size() >= length && str.compare(0, length, prefix) == 0;
+}
+
+/**
+* @brief Appends the UTF-8 encoding of @a codePoint to @a str.
+*/
+void appendAsUtf8(std::string &str, uint32_t codePoint) {
+	if (codePoint < 0x80) {
+		str += static_cast<char>(codePoint);
+	} else if (codePoint < 0x800) {
+		str += static_cast<char>(0xC0 | (codePoint >> 6));
+		str += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else if (codePoint < 0x10000) {
+		str += static_cast<char>(0xE0 | (codePoint >> 12));
+		str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else {
+		str += static_cast<char>(0xF0 | (codePoint >> 18));
+		str += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+
+} // anonymous namespace
+
+/**
+* @brief Receiver of the values decoded by JsonDecoder::decodeValues().
+*/
+class JsonDecoder::Output {
+public:
+	virtual ~Output() = default;
+
+	virtual void beginDictionary() = 0;
+	virtual void beginList() = 0;
+	virtual void addKey(const std::string &key) = 0;
+	virtual void addString(const std::string &str) = 0;
+	virtual void addInteger(BInteger::ValueType value) = 0;
+	virtual void end() = 0;
+};
+
+/**
+* @brief Output writing bencoded data into JsonDecoder::encodedData.
+*
+* Dictionary items are written in the input order. If the keys are not
+* sorted, the encoded items are reordered in place when the dictionary ends.
+*/
+class JsonDecoder::BencodeOutput: public JsonDecoder::Output {
+public:
+	explicit BencodeOutput(JsonDecoder &decoder);
+
+	virtual void beginDictionary() override;
+	virtual void beginList() override;
+	virtual void addKey(const std::string &key) override;
+	virtual void addString(const std::string &str) override;
+	virtual void addInteger(BInteger::ValueType value) override;
+	virtual void end() override;
+
+private:
+	/// Currently written list or dictionary.
+	struct OpenContainer {
+		/// Is it a dictionary?
+		bool isDictionary;
+
+		/// Index of the first item of the dictionary in
+		/// JsonDecoder::members.
+		std::size_t firstMember;
+
+		/// Are the keys of the dictionary written so far sorted?
+		bool sorted;
+	};
+
+private:
+	/// The decoder.
+	JsonDecoder &decoder;
+
+	/// Currently written lists and dictionaries.
+	std::vector<OpenContainer> openContainers;
+};
+
+/**
+* @brief Output building a tree of BItem instances.
+*/
+class JsonDecoder::ItemOutput: public JsonDecoder::Output {
+public:
+	explicit ItemOutput(const JsonDecoder &decoder);
+
+	std::unique_ptr<BItem> releaseItem();
+
+	virtual void beginDictionary() override;
+	virtual void beginList() override;
+	virtual void addKey(const std::string &key) override;
+	virtual void addString(const std::string &str) override;
+	virtual void addInteger(BInteger::ValueType value) override;
+	virtual void end() override;
+
+private:
+	/// Currently built list or dictionary.
+	struct OpenItem {
+		/// The built item.
+		std::unique_ptr<BItem> item;
+
+		/// The item when it is a list.
+		BList *bList;
+
+		/// The item when it is a dictionary.
+		BDictionary *bDictionary;
+
+		/// Value of the last key of the dictionary.
+		std::shared_ptr<BItem> *value;
+	};
+
+private:
+	void add(std::unique_ptr<BItem> item);
+
+private:
+	/// The decoder.
+	const JsonDecoder &decoder;
+
+	/// Currently built lists and dictionaries.
+	std::vector<OpenItem> openItems;
+
+	/// The built item.
+	std::unique_ptr<BItem> builtItem;
+};
+
+/**
+* @brief Constructs an output into the encoded data of @a decoder.
+*/
+JsonDecoder::BencodeOutput::BencodeOutput(JsonDecoder &decoder):
+	decoder(decoder) {}
+
+void JsonDecoder::BencodeOutput::beginDictionary() {
+	decoder.encodedData += 'd';
+	openContainers.push_back(OpenContainer{true, decoder.members.size(), true});
+}
+
+void JsonDecoder::BencodeOutput::beginList() {
+	decoder.encodedData += 'l';
+	openContainers.push_back(OpenContainer{false, 0, true});
+}
+
+void JsonDecoder::BencodeOutput::addKey(const std::string &key) {
+	auto &dictionary = openContainers.back();
+	bool hasMembers = decoder.members.size() > dictionary.firstMember;
+	if (hasMembers) {
+		decoder.members.back().end = decoder.encodedData.size();
+	}
+
+	Member member;
+	member.begin = decoder.encodedData.size();
+	decoder.writeString(key);
+	member.keyEnd = decoder.encodedData.size();
+	member.keyBegin = member.keyEnd - key.size();
+	member.end = member.keyEnd;
+	if (hasMembers && decoder.compareKeys(decoder.members.back(), member) >= 0) {
+		dictionary.sorted = false;
+	}
+	decoder.members.push_back(member);
+}
+
+void JsonDecoder::BencodeOutput::addString(const std::string &str) {
+	decoder.writeString(str);
+}
+
+void JsonDecoder::BencodeOutput::addInteger(BInteger::ValueType value) {
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH];
+	char *formattedEnd = formatted + sizeof(formatted);
+	decoder.encodedData += 'i';
+	decoder.encodedData.append(formatInteger(formattedEnd, value),
+		formattedEnd);
+	decoder.encodedData += 'e';
+}
+
+void JsonDecoder::BencodeOutput::end() {
+	auto container = openContainers.back();
+	openContainers.pop_back();
+	if (container.isDictionary &&
+			decoder.members.size() > container.firstMember) {
+		decoder.members.back().end = decoder.encodedData.size();
+		if (!container.sorted && decoder.keySorting) {
+			decoder.sortMembers(container.firstMember);
+		}
+		decoder.members.resize(container.firstMember);
+	}
+	decoder.encodedData += 'e';
+}
+
+/**
+* @brief Constructs an output building items with the options of @a decoder.
+*/
+JsonDecoder::ItemOutput::ItemOutput(const JsonDecoder &decoder):
+	decoder(decoder) {}
+
+/**
+* @brief Returns the built item.
+*/
+std::unique_ptr<BItem> JsonDecoder::ItemOutput::releaseItem() {
+	return std::move(builtItem);
+}
+
+void JsonDecoder::ItemOutput::beginDictionary() {
+	auto bDictionary = BDictionary::create();
+	auto bDictionaryPtr = bDictionary.get();
+	openItems.push_back(OpenItem{std::move(bDictionary), nullptr,
+		bDictionaryPtr, nullptr});
+}
+
+void JsonDecoder::ItemOutput::beginList() {
+	auto bList = BList::create();
+	auto bListPtr = bList.get();
+	openItems.push_back(OpenItem{std::move(bList), bListPtr, nullptr,
+		nullptr});
+}
+
+/**
+* @brief Adds the given @a key to the current dictionary.
+*
+* When key sorting is disabled, the value of a duplicate key replaces the
+* previous value (bencoded data with such keys are decoded in the same way).
+*/
+void JsonDecoder::ItemOutput::addKey(const std::string &key) {
+	auto &dictionary = openItems.back();
+	dictionary.value = &(*dictionary.bDictionary)[BString::create(key)];
+	if (*dictionary.value && decoder.keySorting) {
+		decoder.throwError("duplicate key '" + key + "'");
+	}
+}
+
+void JsonDecoder::ItemOutput::addString(const std::string &str) {
+	add(BString::create(str));
+}
+
+void JsonDecoder::ItemOutput::addInteger(BInteger::ValueType value) {
+	add(BInteger::create(value));
+}
+
+void JsonDecoder::ItemOutput::end() {
+	auto item = std::move(openItems.back().item);
+	openItems.pop_back();
+	add(std::move(item));
+}
+
+/**
+* @brief Adds the given complete @a item to the current list or dictionary.
+*/
+void JsonDecoder::ItemOutput::add(std::unique_ptr<BItem> item) {
+	if (openItems.empty()) {
+		builtItem = std::move(item);
+		return;
+	}
+
+	auto &parent = openItems.back();
+	if (parent.bDictionary) {
+		*parent.value = std::move(item);
+	} else {
+		parent.bList->push_back(std::move(item));
+	}
+}
+
+/**
+* @brief Constructs a decoder.
+*/
+JsonDecoder::JsonDecoder() = default;
+
+/**
+* @brief Creates a new decoder.
+*/
+std::unique_ptr<JsonDecoder> JsonDecoder::create() {
+	return std::unique_ptr<JsonDecoder>(new JsonDecoder());
+}
+
+/**
+* @brief Decodes the given @a json and returns the corresponding bencoded
+*        data.
+*
+* The whole input has to be a single JSON value (surrounding whitespace is
+* allowed). Otherwise, DecodingError is thrown. When the nesting depth exceeds
+* the limit set by setMaxDepth(), DecodingLimitExceeded is thrown.
+*/
+std::string JsonDecoder::decodeIntoBencode(const std::string &json) {
+	encodedData.clear();
+	members.clear();
+	BencodeOutput output(*this);
+	decodeInput(json, output);
+
+	std::string result;
+	result.swap(encodedData);
+	return result;
+}
+
+/**
+* @brief Decodes the given @a json and returns the corresponding data.
+*
+* The items are built directly from the input. The result is the same as
+* decoding the output of decodeIntoBencode(). See decodeIntoBencode() for
+* more details.
+*/
+std::unique_ptr<BItem> JsonDecoder::decode(const std::string &json) {
+	ItemOutput output(*this);
+	decodeInput(json, output);
+	return output.releaseItem();
+}
+
+/**
+* @brief Enables or disables decoding of strings marked as binary.
+*
+* When enabled, strings that start with @c "hex:" or @c "base64:" are
+* converted into the bytes they represent (without the marker). Such strings
+* that are not valid hex or base64 cause DecodingError. By default, the
+* decoding is disabled.
+*/
+void JsonDecoder::setBinaryDecoding(bool enabled) {
+	binaryDecoding = enabled;
+}
+
+/**
+* @brief Enables or disables sorting of dictionary keys.
+*
+* When enabled, the keys are sorted and a duplicate key causes DecodingError.
+* When disabled, decodeIntoBencode() keeps the keys in the order from the
+* input, which may result in data that do not conform to the specification.
+* The option affects only this encoded output: decode() returns a BDictionary,
+* which always keeps its keys sorted, so the option only makes it keep the
+* last value of a duplicate key instead of throwing. By default, the sorting
+* is enabled.
+*/
+void JsonDecoder::setKeySorting(bool enabled) {
+	keySorting = enabled;
+}
+
+/**
+* @brief Sets the maximal nesting depth of objects and arrays.
+*
+* When the input is nested deeper, DecodingLimitExceeded is thrown. By
+* default, the depth is not limited (as in DecoderLimits).
+*/
+void JsonDecoder::setMaxDepth(std::size_t depth) {
+	maxDepth = depth;
+}
+
+/**
+* @brief Decodes the whole given @a json into @a output.
+*/
+void JsonDecoder::decodeInput(const std::string &json, Output &output) {
+	begin = json.data();
+	pos = begin;
+	end = begin + json.size();
+	openContainers.clear();
+
+	skipWhitespace();
+	decodeValues(output);
+	skipWhitespace();
+	if (pos != end) {
+		throwError("input contains undecoded characters");
+	}
+}
+
+/**
+* @brief Decodes a value starting at the current position, including all the
+*        values nested in it.
+*
+* Instead of recursion, the currently decoded objects and arrays are kept in
+* @c openContainers.
+*/
+void JsonDecoder::decodeValues(Output &output) {
+	for (;;) {
+		if (pos == end) {
+			throwError("unexpected end of input");
+		}
+
+		switch (*pos) {
+			case '{':
+			case '[': {
+				if (openContainers.size() >= maxDepth) {
+					throw DecodingLimitExceeded("nesting depth limit exceeded "
+						"at offset " + std::to_string(pos - begin));
+				}
+				char container = *pos++;
+				bool isObject = container == '{';
+				if (isObject) {
+					output.beginDictionary();
+				} else {
+					output.beginList();
+				}
+				skipWhitespace();
+				if (pos != end && *pos == (isObject ? '}' : ']')) {
+					++pos;
+					output.end();
+					break;
+				}
+				openContainers += container;
+				if (isObject) {
+					readKey(output);
+				}
+				skipWhitespace();
+				continue;
+			}
+			case '"':
+				readString(stringBuffer);
+				output.addString(stringBuffer);
+				break;
+			case 't':
+				readLiteral("true");
+				output.addInteger(1);
+				break;
+			case 'f':
+				readLiteral("false");
+				output.addInteger(0);
+				break;
+			case 'n':
+				throwError("null cannot be represented in bencoded data");
+			default:
+				output.addInteger(readNumber());
+				break;
+		}
+
+		// A value has been decoded, so close the containers that end after it.
+		for (;;) {
+			if (openContainers.empty()) {
+				return;
+			}
+			skipWhitespace();
+			if (pos != end && *pos == ',') {
+				++pos;
+				if (openContainers.back() == '{') {
+					readKey(output);
+				}
+				skipWhitespace();
+				break;
+			}
+			readExpectedChar(openContainers.back() == '{' ? '}' : ']');
+			openContainers.pop_back();
+			output.end();
+		}
+	}
+}
+
+/**
+* @brief Reads a key of an object and the following colon.
+*/
+void JsonDecoder::readKey(Output &output) {
+	skipWhitespace();
+	if (pos == end || *pos != '"') {
+		throwError("expected a string key");
+	}
+	readString(stringBuffer);
+	output.addKey(stringBuffer);
+	skipWhitespace();
+	readExpectedChar(':');
+}
+
+/**
+* @brief Reads an integral number and returns its value.
+*/
+BInteger::ValueType JsonDecoder::readNumber() {
+	const char *numberBegin = pos;
+	bool negative = false;
+	if (*pos == '-') {
+		negative = true;
+		++pos;
+	}
+
+	if (pos == end || *pos < '0' || *pos > '9') {
+		throwError("unexpected character");
+	}
+	uint64_t magnitude = 0;
+	const uint64_t maxMagnitude = negative ?
+		static_cast<uint64_t>(INT64_MAX) + 1 : static_cast<uint64_t>(INT64_MAX);
+	if (*pos == '0') {
+		// JSON does not allow leading zeros.
+		++pos;
+	} else {
+		while (pos != end && *pos >= '0' && *pos <= '9') {
+			auto digit = static_cast<uint64_t>(*pos - '0');
+			if (magnitude > (maxMagnitude - digit) / 10) {
+				throwError("integer is out of range");
+			}
+			magnitude = magnitude * 10 + digit;
+			++pos;
+		}
+	}
+
+	if (pos != end && (*pos == '.' || *pos == 'e' || *pos == 'E')) {
+		pos = numberBegin;
+		throwError("numbers with a fraction or an exponent cannot be "
+			"represented in bencoded data");
+	}
+
+	if (negative && magnitude != 0) {
+		// Computed in this way so that INT64_MIN does not overflow.
+		return -static_cast<int64_t>(magnitude - 1) - 1;
+	}
+	return static_cast<int64_t>(magnitude);
+}
+
+/**
+* @brief Reads the given @a literal.
+*/
+void JsonDecoder::readLiteral(const char *literal) {
+	std::size_t length = std::strlen(literal);
+	if (static_cast<std::size_t>(end - pos) < length ||
+			std::memcmp(pos, literal, length) != 0) {
+		throwError("unexpected character");
+	}
+	pos += length;
+}
+
+/**
+* @brief Reads a string starting at the current position into @a str.
+*
+* Escape sequences are replaced with the characters they represent. When
+* binary decoding is enabled, strings marked as binary are converted into the
+* bytes they represent.
+*/
+void JsonDecoder::readString(std::string &str) {
+	readExpectedChar('"');
+	str.clear();
+	for (;;) {
+		const char *runEnd = findCharToEscapeInJson(pos, end);
+		str.append(pos, runEnd);
+		pos = runEnd;
+		if (pos == end) {
+			throwError("unterminated string");
+		} else if (*pos == '"') {
+			++pos;
+			break;
+		} else if (*pos == '\\') {
+			readEscapeSequence(str);
+		} else {
+			throwError("unescaped control character in a string");
+		}
+	}
+
+	if (!binaryDecoding) {
+		return;
+	}
+
+	bool valid = true;
+	if (startsWith(str, HEX_PREFIX, sizeof(HEX_PREFIX) - 1)) {
+		binaryBuffer.clear();
+		valid = appendFromHex(binaryBuffer,
+			str.data() + sizeof(HEX_PREFIX) - 1,
+			str.size() - (sizeof(HEX_PREFIX) - 1));
+		str.swap(binaryBuffer);
+	} else if (startsWith(str, BASE64_PREFIX, sizeof(BASE64_PREFIX) - 1)) {
+		binaryBuffer.clear();
+		valid = appendFromBase64(binaryBuffer,
+			str.data() + sizeof(BASE64_PREFIX) - 1,
+			str.size() - (sizeof(BASE64_PREFIX) - 1));
+		str.swap(binaryBuffer);
+	}
+	if (!valid) {
+		throwError("invalid binary string");
+	}
+}
+
+/**
+* @brief Reads an escape sequence starting at the current position and appends
+*        the character it represents to @a str.
+*/
+void JsonDecoder::readEscapeSequence(std::string &str) {
+	readExpectedChar('\\');
+	if (pos == end) {
+		throwError("unterminated string");
+	}
+
+	switch (*pos++) {
+		case '"': str += '"'; return;
+		case '\\': str += '\\'; return;
+		case '/': str += '/'; return;
+		case 'b': str += '\b'; return;
+		case 'f': str += '\f'; return;
+		case 'n': str += '\n'; return;
+		case 'r': str += '\r'; return;
+		case 't': str += '\t'; return;
+		case 'u': break;
+		default:
+			--pos;
+			throwError("invalid escape sequence");
+	}
+
+	uint32_t codePoint = readHexQuad();
+	if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+		// A high surrogate has to be followed by a low surrogate.
+		if (end - pos < 2 || pos[0] != '\\' || pos[1] != 'u') {
+			throwError("unpaired surrogate");
+		}
+		pos += 2;
+		uint32_t lowSurrogate = readHexQuad();
+		if (lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+			throwError("unpaired surrogate");
+		}
+		codePoint = 0x10000 + ((codePoint - 0xD800) << 10) +
+			(lowSurrogate - 0xDC00);
+	} else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+		throwError("unpaired surrogate");
+	}
+	appendAsUtf8(str, codePoint);
+}
+
+/**
+* @brief Reads four hexadecimal digits and returns their value.
+*/
+unsigned JsonDecoder::readHexQuad() {
+	std::string value;
+	if (end - pos < 4 || !appendFromHex(value, pos, 4)) {
+		throwError("invalid escape sequence");
+	}
+	pos += 4;
+	return (static_cast<unsigned char>(value[0]) << 8) |
+		static_cast<unsigned char>(value[1]);
+}
+
+/**
+* @brief Skips whitespace at the current position.
+*/
+void JsonDecoder::skipWhitespace() {
+	while (pos != end &&
+			(*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+		++pos;
+	}
+}
+
+/**
+* @brief Reads @a expectedChar at the current position.
+*/
+void JsonDecoder::readExpectedChar(char expectedChar) {
+	if (pos == end || *pos != expectedChar) {
+		throwError(std::string("expected '") + expectedChar + "'");
+	}
+	++pos;
+}
+
+/**
+* @brief Throws DecodingError with the given message and the current position.
+*/
+void JsonDecoder::throwError(const std::string &what) const {
+	throw DecodingError(what + " at offset " + std::to_string(pos - begin));
+}
+
+/**
+* @brief Writes the given string.
+*/
+void JsonDecoder::writeString(const std::string &str) {
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH];
+	char *formattedEnd = formatted + sizeof(formatted);
+	char *formattedBegin = formatInteger(formattedEnd,
+		static_cast<int64_t>(str.size()));
+	encodedData.append(formattedBegin, formattedEnd);
+	encodedData += ':';
+	encodedData += str;
+}
+
+/**
+* @brief Sorts the encoded dictionary items starting at @a firstMember by their
+*        keys.
+*
+* Throws DecodingError if two keys are equal.
+*/
+void JsonDecoder::sortMembers(std::size_t firstMember) {
+	auto first = members.begin() + static_cast<std::ptrdiff_t>(firstMember);
+	std::size_t regionBegin = first->begin;
+	std::size_t regionEnd = members.back().end;
+
+	std::stable_sort(first, members.end(),
+		[this](const Member &lhs, const Member &rhs) {
+			return compareKeys(lhs, rhs) < 0;
+		}
+	);
+	for (auto i = first; i + 1 != members.end(); ++i) {
+		if (compareKeys(*i, *(i + 1)) == 0) {
+			throwError("duplicate key '" +
+				encodedData.substr(i->keyBegin, i->keyEnd - i->keyBegin) + "'");
+		}
+	}
+
+	sortBuffer.assign(encodedData, regionBegin, regionEnd - regionBegin);
+	std::size_t offset = regionBegin;
+	for (auto i = first; i != members.end(); ++i) {
+		std::size_t size = i->end - i->begin;
+		std::memcpy(&encodedData[offset], &sortBuffer[i->begin - regionBegin],
+			size);
+		offset += size;
+	}
+}
+
+/**
+* @brief Compares the keys of the given dictionary items in the same way as
+*        @c std::string::compare().
+*/
+int JsonDecoder::compareKeys(const Member &lhs, const Member &rhs) const {
+	std::size_t lhsLength = lhs.keyEnd - lhs.keyBegin;
+	std::size_t rhsLength = rhs.keyEnd - rhs.keyBegin;
+	int result = std::memcmp(encodedData.data() + lhs.keyBegin,
+		encodedData.data() + rhs.keyBegin, std::min(lhsLength, rhsLength));
+	if (result != 0) {
+		return result;
+	}
+	return lhsLength < rhsLength ? -1 : (lhsLength > rhsLength ? 1 : 0);
+}
+
+/**
+* @brief Converts the given @a json into bencoded data and returns them.
+*
+* This function can be handy if you just want to convert data without
+* explicitly creating a decoder and calling @c decodeIntoBencode() on it.
+*
+* See JsonDecoder::decodeIntoBencode() for more details.
+*/
+std::string convertJsonToBencode(const std::string &json) {
+	auto decoder = JsonDecoder::create();
+	return decoder->decodeIntoBencode(json);
+}
+
+/**
+* @brief Decodes the given @a json and returns the corresponding data.
+*
+* This function can be handy if you just want to decode JSON without
+* explicitly creating a decoder and calling @c decode() on it.
+*
+* See JsonDecoder::decode() for more details.
+*/
+std::unique_ptr<BItem> decodeJson(const std::string &json) {
+	auto decoder = JsonDecoder::create();
+	return decoder->decode(json);
+}
+
+} // namespace bencoding
@@ -0,0 +1,226 @@
+/**
+* @file      JsonEncoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the JsonEncoder class.
+*/
+
+#include "JsonEncoder.h"
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Returns the escape sequence for @a c, which has to be escaped.
+*/
+const char *getEscapeSequence(unsigned char c) {
+	static const char *const SHORT_ESCAPES[] = {
+		"\\u0000", "\\u0001", "\\u0002", "\\u0003",
+		"\\u0004", "\\u0005", "\\u0006", "\\u0007",
+		"\\b", "\\t", "\\n", "\\u000b",
+		"\\f", "\\r", "\\u000e", "\\u000f",
+		"\\u0010", "\\u0011", "\\u0012", "\\u0013",
+		"\\u0014", "\\u0015", "\\u0016", "\\u0017",
+		"\\u0018", "\\u0019", "\\u001a", "\\u001b",
+		"\\u001c", "\\u001d", "\\u001e", "\\u001f"
+	};
+
+	if (c < 0x20) {
+		return SHORT_ESCAPES[c];
+	} else if (c == '"') {
+		return "\\\"";
+	}
+	return "\\\\";
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs an encoder emitting binary strings in the given encoding.
+*/
+JsonEncoder::JsonEncoder(BinaryEncoding binaryEncoding) {
+	setBinaryEncoding(binaryEncoding);
+}
+
+/**
+* @brief Creates a new encoder.
+*
+* @param[in] binaryEncoding Encoding of strings that are not valid UTF-8.
+*/
+std::unique_ptr<JsonEncoder> JsonEncoder::create(
+		BinaryEncoding binaryEncoding) {
+	return std::unique_ptr<JsonEncoder>(new JsonEncoder(binaryEncoding));
+}
+
+/**
+* @brief Encodes the given @a data into JSON and returns them.
+*/
+std::string JsonEncoder::encode(std::shared_ptr<BItem> data) {
+	std::string output;
+	encode(data, output);
+	return output;
+}
+
+/**
+* @brief Encodes the given @a data into JSON and appends them to @a output.
+*
+* This allows to reuse an already allocated buffer when encoding many items.
+*/
+void JsonEncoder::encode(std::shared_ptr<BItem> data, std::string &output) {
+	encodedData.swap(output);
+	data->accept(this);
+	encodedData.swap(output);
+}
+
+/**
+* @brief Sets the encoding of binary strings.
+*
+* It also sets the marker of binary strings to the default one for the
+* encoding (@c "hex:" or @c "base64:").
+*/
+void JsonEncoder::setBinaryEncoding(BinaryEncoding binaryEncoding) {
+	this->binaryEncoding = binaryEncoding;
+	binaryPrefix = binaryEncoding == BinaryEncoding::Hex ? "hex:" : "base64:";
+}
+
+/**
+* @brief Sets the marker prefixed to binary strings.
+*
+* An empty prefix makes binary strings indistinguishable from text strings.
+*/
+void JsonEncoder::setBinaryPrefix(const std::string &prefix) {
+	binaryPrefix = prefix;
+}
+
+/**
+* @brief Enables or disables emitting of valid UTF-8 strings as text.
+*
+* When disabled, all strings are emitted in the binary encoding.
+*/
+void JsonEncoder::setUtf8Detection(bool enabled) {
+	utf8Detection = enabled;
+}
+
+void JsonEncoder::visit(BDictionary *bDictionary) {
+	encodedData += '{';
+	bool putComma = false;
+	for (const auto &item : *bDictionary) {
+		if (putComma) {
+			encodedData += ',';
+		}
+		encodeString(item.first->value());
+		encodedData += ':';
+		item.second->accept(this);
+		putComma = true;
+	}
+	encodedData += '}';
+}
+
+void JsonEncoder::visit(BInteger *bInteger) {
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH];
+	char *end = formatted + sizeof(formatted);
+	char *begin = formatInteger(end, bInteger->value());
+	encodedData.append(begin, end);
+}
+
+void JsonEncoder::visit(BList *bList) {
+	encodedData += '[';
+	bool putComma = false;
+	for (const auto &bItem : *bList) {
+		if (putComma) {
+			encodedData += ',';
+		}
+		bItem->accept(this);
+		putComma = true;
+	}
+	encodedData += ']';
+}
+
+void JsonEncoder::visit(BString *bString) {
+	encodeString(bString->value());
+}
+
+/**
+* @brief Encodes @a str either as text or in the binary encoding.
+*/
+void JsonEncoder::encodeString(const std::string &str) {
+	encodedData += '"';
+	if (isEmittedAsText(str)) {
+		encodeText(str.data(), str.size());
+	} else {
+		encodedData += binaryPrefix;
+		encodeBinary(str.data(), str.size());
+	}
+	encodedData += '"';
+}
+
+/**
+* @brief Checks if @a str is emitted as text (as opposed to the binary
+*        encoding).
+*/
+bool JsonEncoder::isEmittedAsText(const std::string &str) const {
+	if (!utf8Detection) {
+		return false;
+	}
+	if (!binaryPrefix.empty() &&
+			str.compare(0, binaryPrefix.size(), binaryPrefix) == 0) {
+		// It would be mistaken for a binary string.
+		return false;
+	}
+	return isValidUtf8(str.data(), str.size());
+}
+
+/**
+* @brief Encodes the given valid UTF-8 text, escaping characters that cannot
+*        appear in a JSON string.
+*
+* Runs of characters that do not need escaping are found eight bytes at a time
+* and copied in bulk.
+*/
+void JsonEncoder::encodeText(const char *data, std::size_t length) {
+	const char *end = data + length;
+	const char *runBegin = data;
+	for (;;) {
+		const char *p = findCharToEscapeInJson(runBegin, end);
+		encodedData.append(runBegin, static_cast<std::size_t>(p - runBegin));
+		if (p == end) {
+			break;
+		}
+		encodedData += getEscapeSequence(static_cast<unsigned char>(*p));
+		runBegin = p + 1;
+	}
+}
+
+/**
+* @brief Encodes the given binary data in the selected binary encoding.
+*/
+void JsonEncoder::encodeBinary(const char *data, std::size_t length) {
+	if (binaryEncoding == BinaryEncoding::Hex) {
+		appendAsHex(encodedData, data, length);
+	} else {
+		appendAsBase64(encodedData, data, length);
+	}
+}
+
+/**
+* @brief Encodes the given @a data into JSON and returns them.
+*
+* This function can be handy if you just want to encode data into JSON without
+* explicitly creating an encoder and calling @c encode() on it.
+*
+* See JsonEncoder::encode() for more details.
+*/
+std::string encodeAsJson(std::shared_ptr<BItem> data,
+		BinaryEncoding binaryEncoding) {
+	auto encoder = JsonEncoder::create(binaryEncoding);
+	return encoder->encode(data);
+}
+
+} // namespace bencoding
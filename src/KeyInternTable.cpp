@@ -0,0 +1,192 @@
+/**
+* @file      KeyInternTable.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the KeyInternTable class.
+*/
+
+#include "KeyInternTable.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Returns the FNV-1a hash of the given key.
+*/
+std::size_t hashKey(const char *data, std::size_t length) {
+	std::uint64_t hash = 14695981039346656037u;
+	for (std::size_t i = 0; i < length; ++i) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 1099511628211u;
+	}
+	return hash;
+}
+
+/**
+* @brief Creates a new (not interned) key.
+*/
+std::shared_ptr<BString> createKey(const char *data, std::size_t length) {
+	return BString::create(std::string(data, length));
+}
+
+} // anonymous namespace
+
+// Static constants.
+const std::size_t KeyInternTable::DEFAULT_MAX_NUM_OF_KEYS;
+const std::size_t KeyInternTable::MAX_KEY_LENGTH;
+
+/**
+* @brief Constructs an empty table for at most @a maxNumOfKeys keys.
+*/
+KeyInternTable::KeyInternTable(std::size_t maxNumOfKeys, bool adaptive):
+		maxNumOfKeys(maxNumOfKeys), adaptive(adaptive) {
+	std::size_t numOfSlots = 1;
+	while (numOfSlots < 2 * maxNumOfKeys) {
+		numOfSlots *= 2;
+	}
+	slots.resize(numOfSlots);
+}
+
+/**
+* @brief Creates an adaptive table that holds at most @a maxNumOfKeys keys.
+*
+* Keys are added as they are decoded, so the table adapts to the keys that
+* are the most frequent at the beginning of the decoded data. Once the table
+* is full, it does not change.
+*/
+std::unique_ptr<KeyInternTable> KeyInternTable::create(
+		std::size_t maxNumOfKeys) {
+	return std::unique_ptr<KeyInternTable>(
+		new KeyInternTable(maxNumOfKeys, true));
+}
+
+/**
+* @brief Creates a fixed table holding the given @a keys.
+*
+* Other keys are never added to the table.
+*/
+std::unique_ptr<KeyInternTable> KeyInternTable::create(
+		const std::vector<std::string> &keys) {
+	std::unique_ptr<KeyInternTable> table(
+		new KeyInternTable(keys.size(), false));
+	for (const auto &key : keys) {
+		std::size_t hash = hashKey(key.data(), key.size());
+		std::size_t slot;
+		if (!table->find(key.data(), key.size(), hash, slot)) {
+			table->add(key.data(), key.size(), hash, slot);
+		}
+	}
+	return table;
+}
+
+/**
+* @brief Creates a fixed table holding the keys of the messages of the
+*        BitTorrent DHT protocol (KRPC) and of its common extensions.
+*/
+std::unique_ptr<KeyInternTable> KeyInternTable::createForKrpc() {
+	return create({
+		// Messages (BEP 5).
+		"a", "e", "q", "r", "t", "v", "y",
+		// Arguments and return values (BEP 5).
+		"id", "implied_port", "info_hash", "nodes", "port", "target", "token",
+		"values",
+		// IPv6 (BEP 32) and read-only nodes (BEP 43).
+		"nodes6", "want", "ro",
+		// Storing arbitrary data (BEP 44).
+		"cas", "k", "salt", "seq", "sig",
+		// Infohash indexing (BEP 51).
+		"interval", "num", "samples",
+		// External IP (BEP 42).
+		"ip"
+	});
+}
+
+/**
+* @brief Returns the interned string equal to @a key.
+*
+* See intern(const char *, std::size_t) for more details.
+*/
+std::shared_ptr<BString> KeyInternTable::intern(const std::string &key) {
+	return intern(key.data(), key.size());
+}
+
+/**
+* @brief Returns the interned string equal to the given @a length characters
+*        of @a data.
+*
+* When the key is not in the table and it cannot be added to it (a fixed
+* table, a full adaptive table, or a too long key), a new string is returned.
+*/
+std::shared_ptr<BString> KeyInternTable::intern(const char *data,
+		std::size_t length) {
+	std::size_t hash = hashKey(data, length);
+	std::size_t slot;
+	if (!adaptive) {
+		auto key = find(data, length, hash, slot);
+		return key ? key : createKey(data, length);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto key = find(data, length, hash, slot);
+		if (key) {
+			return key;
+		} else if (numOfKeys < maxNumOfKeys && length <= MAX_KEY_LENGTH) {
+			return add(data, length, hash, slot);
+		}
+	}
+	return createKey(data, length);
+}
+
+/**
+* @brief Returns the number of keys in the table.
+*/
+std::size_t KeyInternTable::size() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return numOfKeys;
+}
+
+/**
+* @brief Checks if the table adds decoded keys.
+*/
+bool KeyInternTable::isAdaptive() const {
+	return adaptive;
+}
+
+/**
+* @brief Returns the key equal to the given @a length characters of @a data
+*        with the given @a hash (@c nullptr when there is no such key).
+*
+* When there is no such key, @a slot is set to the slot into which the key
+* may be added.
+*/
+std::shared_ptr<BString> KeyInternTable::find(const char *data,
+		std::size_t length, std::size_t hash, std::size_t &slot) const {
+	std::size_t mask = slots.size() - 1;
+	for (slot = hash & mask; slots[slot].key; slot = (slot + 1) & mask) {
+		const auto &key = slots[slot].key->value();
+		if (slots[slot].hash == hash && key.size() == length &&
+				std::memcmp(key.data(), data, length) == 0) {
+			return slots[slot].key;
+		}
+	}
+	return nullptr;
+}
+
+/**
+* @brief Adds the given key with the given @a hash into the given empty
+*        @a slot and returns it.
+*/
+std::shared_ptr<BString> KeyInternTable::add(const char *data,
+		std::size_t length, std::size_t hash, std::size_t slot) {
+	slots[slot].hash = hash;
+	slots[slot].key = createKey(data, length);
+	++numOfKeys;
+	return slots[slot].key;
+}
+
+} // namespace bencoding
@@ -0,0 +1,744 @@
+/**
+* @file      Krpc.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of decoding and encoding of KRPC messages.
+*/
+
+#include "Krpc.h"
+
+#include <cstring>
+
+#include "Reader.h"
+
+namespace bencoding {
+
+namespace {
+
+/// Length of node IDs and infohashes.
+const std::size_t NODE_ID_LENGTH = 20;
+
+/// Maximal value of a port.
+const BInteger::ValueType MAX_PORT = 65535;
+
+/**
+* @brief Checks if the given @a length characters of @a data are equal to the
+*        given @a key (a string literal).
+*/
+template<std::size_t N>
+bool equals(const char *data, std::size_t length, const char (&key)[N]) {
+	return length == N - 1 && std::memcmp(data, key, N - 1) == 0;
+}
+
+/**
+* @brief Returns the method with the given @a name.
+*/
+KrpcMethod getMethod(const KrpcBytes &name) {
+	if (equals(name.data, name.length, "ping")) {
+		return KrpcMethod::Ping;
+	} else if (equals(name.data, name.length, "find_node")) {
+		return KrpcMethod::FindNode;
+	} else if (equals(name.data, name.length, "get_peers")) {
+		return KrpcMethod::GetPeers;
+	} else if (equals(name.data, name.length, "announce_peer")) {
+		return KrpcMethod::AnnouncePeer;
+	}
+	return KrpcMethod::Other;
+}
+
+/**
+* @brief Returns the name of the given @a method (empty for
+*        KrpcMethod::Other).
+*/
+KrpcBytes getMethodName(KrpcMethod method) {
+	switch (method) {
+		case KrpcMethod::Ping:
+			return KrpcBytes("ping", 4);
+		case KrpcMethod::FindNode:
+			return KrpcBytes("find_node", 9);
+		case KrpcMethod::GetPeers:
+			return KrpcBytes("get_peers", 9);
+		case KrpcMethod::AnnouncePeer:
+			return KrpcBytes("announce_peer", 13);
+		case KrpcMethod::Other:
+		default:
+			return KrpcBytes("", 0);
+	}
+}
+
+/**
+* @brief Decoder of a single KRPC message.
+*
+* Reads the message token by token and stores views of the values of the
+* known keys into the message. Values of other keys are skipped.
+*/
+class KrpcParser {
+public:
+	KrpcParser(const char *data, std::size_t length, KrpcMessage &message,
+		const DecoderLimits &limits) noexcept;
+
+	DecodingResult parse();
+
+private:
+	bool parseArguments();
+	bool parseValues();
+	bool parseError();
+	bool readType();
+	bool readString(KrpcBytes &bytes);
+	bool readNodeId(KrpcBytes &bytes);
+	bool readInteger(BInteger::ValueType &value);
+	bool skipValue();
+	bool expect(TokenType expected);
+	bool checkRequiredKeys(std::size_t endOffset);
+	bool fail(DecodingErrorCode error, std::size_t offset);
+	bool failAtReaderError();
+
+private:
+	/// Reader of the message.
+	Reader reader;
+
+	/// Length of the message.
+	std::size_t length;
+
+	/// The decoded message.
+	KrpcMessage &message;
+
+	/// Reason of a failure.
+	DecodingResult result;
+
+	/// Has the type of the message been read?
+	bool hasType = false;
+
+	/// Has the dictionary of arguments been read?
+	bool hasArguments = false;
+
+	/// Has the dictionary of return values been read?
+	bool hasReturnValues = false;
+
+	/// Has the error been read?
+	bool hasError = false;
+
+	/// Has the port been read?
+	bool hasPort = false;
+};
+
+/**
+* @brief Constructs a decoder of the given @a length characters of @a data
+*        into @a message.
+*/
+KrpcParser::KrpcParser(const char *data, std::size_t length,
+		KrpcMessage &message, const DecoderLimits &limits) noexcept:
+		reader(data, length), length(length), message(message) {
+	reader.setLimits(limits);
+}
+
+/**
+* @brief Decodes the message.
+*/
+DecodingResult KrpcParser::parse() {
+	message.clear();
+	if (!expect(TokenType::DictBegin)) {
+		return std::move(result);
+	}
+
+	for (;;) {
+		TokenType type = reader.next();
+		if (type == TokenType::End) {
+			break;
+		} else if (type == TokenType::Error) {
+			failAtReaderError();
+			return std::move(result);
+		}
+
+		const char *key = reader.stringData();
+		std::size_t keyLength = reader.stringLength();
+		bool ok;
+		if (equals(key, keyLength, "a")) {
+			hasArguments = true;
+			ok = parseArguments();
+		} else if (equals(key, keyLength, "e")) {
+			ok = parseError();
+		} else if (equals(key, keyLength, "ip")) {
+			ok = readString(message.externalIp);
+		} else if (equals(key, keyLength, "q")) {
+			ok = readString(message.methodName);
+		} else if (equals(key, keyLength, "r")) {
+			hasReturnValues = true;
+			ok = parseArguments();
+		} else if (equals(key, keyLength, "ro")) {
+			BInteger::ValueType readOnly = 0;
+			ok = readInteger(readOnly);
+			message.readOnly = readOnly != 0;
+		} else if (equals(key, keyLength, "t")) {
+			ok = readString(message.transactionId);
+		} else if (equals(key, keyLength, "v")) {
+			ok = readString(message.version);
+		} else if (equals(key, keyLength, "y")) {
+			ok = readType();
+		} else {
+			ok = skipValue();
+		}
+		if (!ok) {
+			return std::move(result);
+		}
+	}
+
+	if (reader.offset() != length) {
+		return DecodingResult(DecodingErrorCode::UndecodedCharacters,
+			reader.offset());
+	} else if (!checkRequiredKeys(reader.tokenBegin())) {
+		return std::move(result);
+	}
+	return DecodingResult();
+}
+
+/**
+* @brief Decodes the dictionary of arguments of a query or of return values of
+*        a response.
+*/
+bool KrpcParser::parseArguments() {
+	if (!expect(TokenType::DictBegin)) {
+		return false;
+	}
+
+	for (;;) {
+		TokenType type = reader.next();
+		if (type == TokenType::End) {
+			return true;
+		} else if (type == TokenType::Error) {
+			return failAtReaderError();
+		}
+
+		const char *key = reader.stringData();
+		std::size_t keyLength = reader.stringLength();
+		bool ok;
+		if (equals(key, keyLength, "id")) {
+			ok = readNodeId(message.id);
+		} else if (equals(key, keyLength, "implied_port")) {
+			BInteger::ValueType impliedPort = 0;
+			ok = readInteger(impliedPort);
+			message.impliedPort = impliedPort != 0;
+		} else if (equals(key, keyLength, "info_hash")) {
+			ok = readNodeId(message.infoHash);
+		} else if (equals(key, keyLength, "nodes")) {
+			ok = readString(message.nodes);
+		} else if (equals(key, keyLength, "nodes6")) {
+			ok = readString(message.nodes6);
+		} else if (equals(key, keyLength, "port")) {
+			BInteger::ValueType port = 0;
+			ok = readInteger(port);
+			if (ok && (port < 0 || port > MAX_PORT)) {
+				ok = fail(DecodingErrorCode::IntegerOutOfRange,
+					reader.tokenBegin());
+			}
+			message.port = static_cast<std::uint16_t>(port);
+			hasPort = ok;
+		} else if (equals(key, keyLength, "target")) {
+			ok = readNodeId(message.target);
+		} else if (equals(key, keyLength, "token")) {
+			ok = readString(message.token);
+		} else if (equals(key, keyLength, "values")) {
+			ok = parseValues();
+		} else {
+			ok = skipValue();
+		}
+		if (!ok) {
+			return false;
+		}
+	}
+}
+
+/**
+* @brief Decodes the list of peers returned by @c get_peers.
+*/
+bool KrpcParser::parseValues() {
+	if (!expect(TokenType::ListBegin)) {
+		return false;
+	}
+
+	message.numOfValues = 0;
+	for (;;) {
+		switch (reader.next()) {
+			case TokenType::End:
+				return true;
+			case TokenType::String:
+				if (message.numOfValues == KrpcMessage::MAX_NUM_OF_VALUES) {
+					return fail(DecodingErrorCode::InvalidValue,
+						reader.tokenBegin());
+				}
+				message.values[message.numOfValues++] = KrpcBytes(
+					reader.stringData(), reader.stringLength());
+				break;
+			case TokenType::Error:
+				return failAtReaderError();
+			default:
+				return fail(DecodingErrorCode::UnexpectedType,
+					reader.tokenBegin());
+		}
+	}
+}
+
+/**
+* @brief Decodes the list with the code and the message of an error.
+*/
+bool KrpcParser::parseError() {
+	hasError = true;
+	return expect(TokenType::ListBegin) &&
+		readInteger(message.errorCode) &&
+		readString(message.errorMessage) &&
+		expect(TokenType::End);
+}
+
+/**
+* @brief Decodes the type of the message.
+*/
+bool KrpcParser::readType() {
+	KrpcBytes type;
+	if (!readString(type)) {
+		return false;
+	} else if (equals(type.data, type.length, "q")) {
+		message.type = KrpcMessageType::Query;
+	} else if (equals(type.data, type.length, "r")) {
+		message.type = KrpcMessageType::Response;
+	} else if (equals(type.data, type.length, "e")) {
+		message.type = KrpcMessageType::Error;
+	} else {
+		return fail(DecodingErrorCode::InvalidValue, reader.tokenBegin());
+	}
+	hasType = true;
+	return true;
+}
+
+/**
+* @brief Reads a string into @a bytes.
+*/
+bool KrpcParser::readString(KrpcBytes &bytes) {
+	if (!expect(TokenType::String)) {
+		return false;
+	}
+	bytes = KrpcBytes(reader.stringData(), reader.stringLength());
+	return true;
+}
+
+/**
+* @brief Reads a node ID or an infohash into @a bytes.
+*/
+bool KrpcParser::readNodeId(KrpcBytes &bytes) {
+	if (!readString(bytes)) {
+		return false;
+	} else if (bytes.length != NODE_ID_LENGTH) {
+		return fail(DecodingErrorCode::InvalidValue, reader.tokenBegin());
+	}
+	return true;
+}
+
+/**
+* @brief Reads an integer into @a value.
+*/
+bool KrpcParser::readInteger(BInteger::ValueType &value) {
+	if (!expect(TokenType::Integer)) {
+		return false;
+	}
+	value = reader.integer();
+	return true;
+}
+
+/**
+* @brief Skips the value of the current key.
+*/
+bool KrpcParser::skipValue() {
+	reader.next();
+	return reader.skip() || failAtReaderError();
+}
+
+/**
+* @brief Reads the next token and checks that it is of the @a expected type.
+*/
+bool KrpcParser::expect(TokenType expected) {
+	TokenType type = reader.next();
+	if (type == expected) {
+		return true;
+	} else if (type == TokenType::Error) {
+		return failAtReaderError();
+	} else if (type == TokenType::EndOfInput) {
+		return fail(DecodingErrorCode::UnexpectedEndOfInput, reader.offset());
+	}
+	return fail(DecodingErrorCode::UnexpectedType, reader.tokenBegin());
+}
+
+/**
+* @brief Checks that the message contains all the keys required by its type
+*        and method and resolves the method.
+*
+* Missing keys are reported at @a endOffset (the end of the message).
+*/
+bool KrpcParser::checkRequiredKeys(std::size_t endOffset) {
+	if (!hasType || !message.transactionId.present()) {
+		return fail(DecodingErrorCode::MissingKey, endOffset);
+	}
+
+	switch (message.type) {
+		case KrpcMessageType::Query:
+			if (!message.methodName.present() || !hasArguments ||
+					!message.id.present()) {
+				return fail(DecodingErrorCode::MissingKey, endOffset);
+			}
+			message.method = getMethod(message.methodName);
+			if ((message.method == KrpcMethod::FindNode &&
+						!message.target.present()) ||
+					(message.method == KrpcMethod::GetPeers &&
+						!message.infoHash.present()) ||
+					(message.method == KrpcMethod::AnnouncePeer &&
+						(!message.infoHash.present() ||
+							!message.token.present() || !hasPort))) {
+				return fail(DecodingErrorCode::MissingKey, endOffset);
+			}
+			return true;
+		case KrpcMessageType::Response:
+			return (hasReturnValues && message.id.present()) ||
+				fail(DecodingErrorCode::MissingKey, endOffset);
+		case KrpcMessageType::Error:
+		default:
+			return hasError || fail(DecodingErrorCode::MissingKey, endOffset);
+	}
+}
+
+/**
+* @brief Stores the given @a error at the given @a offset as the result.
+*
+* @return Always @c false.
+*/
+bool KrpcParser::fail(DecodingErrorCode error, std::size_t offset) {
+	result = DecodingResult(error, offset);
+	return false;
+}
+
+/**
+* @brief Stores the error of the reader as the result.
+*
+* @return Always @c false.
+*/
+bool KrpcParser::failAtReaderError() {
+	return fail(reader.error(), reader.errorOffset());
+}
+
+/**
+* @brief Writer of bencoded data into a buffer of a fixed size.
+*
+* Counts all the written characters, including those that do not fit into
+* the buffer.
+*/
+class BufferWriter {
+public:
+	BufferWriter(char *buffer, std::size_t size) noexcept:
+		buffer(buffer), size(size) {}
+
+	/**
+	* @brief Writes the given character.
+	*/
+	void put(char c) noexcept {
+		if (length < size) {
+			buffer[length] = c;
+		}
+		++length;
+	}
+
+	/**
+	* @brief Writes the given @a count characters of @a data.
+	*/
+	void put(const char *data, std::size_t count) noexcept {
+		if (count > 0 && length <= size && count <= size - length) {
+			std::memcpy(buffer + length, data, count);
+		}
+		length += count;
+	}
+
+	/**
+	* @brief Writes the given string.
+	*/
+	void putString(const KrpcBytes &bytes) noexcept {
+		putNumber(bytes.length);
+		put(':');
+		put(bytes.data, bytes.length);
+	}
+
+	/**
+	* @brief Writes the given @a key (a string literal).
+	*/
+	template<std::size_t N>
+	void putKey(const char (&key)[N]) noexcept {
+		putString(KrpcBytes(key, N - 1));
+	}
+
+	/**
+	* @brief Writes the given integer.
+	*/
+	void putInteger(BInteger::ValueType value) noexcept {
+		put('i');
+		if (value < 0) {
+			put('-');
+			// Computed in unsigned arithmetic to handle the minimal value.
+			putNumber(0 - static_cast<std::uint64_t>(value));
+		} else {
+			putNumber(static_cast<std::uint64_t>(value));
+		}
+		put('e');
+	}
+
+	/**
+	* @brief Returns the number of written characters.
+	*/
+	std::size_t written() const noexcept {
+		return length;
+	}
+
+private:
+	/**
+	* @brief Writes the given number in decimal.
+	*/
+	void putNumber(std::uint64_t number) noexcept {
+		char digits[20];
+		std::size_t i = sizeof(digits);
+		do {
+			digits[--i] = static_cast<char>('0' + number % 10);
+			number /= 10;
+		} while (number != 0);
+		put(digits + i, sizeof(digits) - i);
+	}
+
+private:
+	/// The buffer.
+	char *buffer;
+
+	/// Size of the buffer.
+	std::size_t size;
+
+	/// Number of written characters.
+	std::size_t length = 0;
+};
+
+/**
+* @brief Writes the dictionary of arguments or return values of the given
+*        @a message.
+*/
+void writeArguments(BufferWriter &writer, const KrpcMessage &message) {
+	writer.put('d');
+	if (message.id.present()) {
+		writer.putKey("id");
+		writer.putString(message.id);
+	}
+	if (message.impliedPort) {
+		writer.putKey("implied_port");
+		writer.putInteger(1);
+	}
+	if (message.infoHash.present()) {
+		writer.putKey("info_hash");
+		writer.putString(message.infoHash);
+	}
+	if (message.nodes.present()) {
+		writer.putKey("nodes");
+		writer.putString(message.nodes);
+	}
+	if (message.nodes6.present()) {
+		writer.putKey("nodes6");
+		writer.putString(message.nodes6);
+	}
+	if (message.type == KrpcMessageType::Query &&
+			message.method == KrpcMethod::AnnouncePeer) {
+		writer.putKey("port");
+		writer.putInteger(message.port);
+	}
+	if (message.target.present()) {
+		writer.putKey("target");
+		writer.putString(message.target);
+	}
+	if (message.token.present()) {
+		writer.putKey("token");
+		writer.putString(message.token);
+	}
+	if (message.numOfValues > 0) {
+		writer.putKey("values");
+		writer.put('l');
+		for (std::size_t i = 0; i < message.numOfValues; ++i) {
+			writer.putString(message.values[i]);
+		}
+		writer.put('e');
+	}
+	writer.put('e');
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a view of the given @a length characters of @a data.
+*/
+KrpcBytes::KrpcBytes(const char *data, std::size_t length) noexcept:
+	data(data), length(length) {}
+
+/**
+* @brief Checks if the string is present in the message.
+*/
+bool KrpcBytes::present() const noexcept {
+	return data != nullptr;
+}
+
+/**
+* @brief Returns a copy of the viewed string.
+*/
+std::string KrpcBytes::string() const {
+	return present() ? std::string(data, length) : std::string();
+}
+
+// Static constants.
+const std::size_t KrpcMessage::MAX_NUM_OF_VALUES;
+
+/**
+* @brief Resets all the members to their default values.
+*
+* Views in @c values beyond @c numOfValues are not reset, so clearing is
+* cheaper than assigning a default-constructed message.
+*/
+void KrpcMessage::clear() noexcept {
+	type = KrpcMessageType::Query;
+	transactionId = KrpcBytes();
+	version = KrpcBytes();
+	externalIp = KrpcBytes();
+	readOnly = false;
+	method = KrpcMethod::Other;
+	methodName = KrpcBytes();
+	id = KrpcBytes();
+	target = KrpcBytes();
+	infoHash = KrpcBytes();
+	token = KrpcBytes();
+	nodes = KrpcBytes();
+	nodes6 = KrpcBytes();
+	port = 0;
+	impliedPort = false;
+	numOfValues = 0;
+	errorCode = 0;
+	errorMessage = KrpcBytes();
+}
+
+/**
+* @brief Decodes the given @a length characters of @a data (a datagram) into
+*        @a message.
+*
+* @return Successful result (without data) or the reason of the failure.
+*
+* The message is read by Reader, so the grammar and @a limits are checked in
+* the same way as by Decoder. Moreover, the message has to be a dictionary
+* with the keys required by BEP 5 for its type and method. Besides the errors
+* reported by Reader, the following ones may occur:
+*  - DecodingErrorCode::UnexpectedType when a known key has a value of another
+*    type than expected,
+*  - DecodingErrorCode::InvalidValue when a node ID or an infohash is not 20
+*    bytes long, when the type is not @c q, @c r, or @c e, or when there are
+*    more than KrpcMessage::MAX_NUM_OF_VALUES peers,
+*  - DecodingErrorCode::IntegerOutOfRange when the port is not between 0 and
+*    65535,
+*  - DecodingErrorCode::MissingKey when a required key is missing (reported at
+*    the end of the message).
+*
+* Unknown keys are skipped. In case of a failure, @a message may be filled only
+* partially. The members of @a message point into @a data, so @a data have to
+* outlive them.
+*/
+DecodingResult decodeKrpc(const char *data, std::size_t length,
+		KrpcMessage &message, const DecoderLimits &limits) {
+	return KrpcParser(data, length, message, limits).parse();
+}
+
+/**
+* @brief Decodes the given @a data (a datagram) into @a message.
+*
+* See decodeKrpc(const char *, std::size_t, KrpcMessage &, const
+* DecoderLimits &) for more details.
+*/
+DecodingResult decodeKrpc(const std::string &data, KrpcMessage &message,
+		const DecoderLimits &limits) {
+	return decodeKrpc(data.data(), data.size(), message, limits);
+}
+
+/**
+* @brief Encodes the given @a message into the given @a buffer of the given
+*        @a size.
+*
+* @return Length of the encoded message. When it is greater than @a size, the
+*         message did not fit into the buffer and the contents of the buffer
+*         are unspecified. Hence, the length needed for a message can be
+*         obtained by passing a @c nullptr buffer of size 0.
+*
+* Only the members relevant to the type of the message are written (e.g.
+* arguments for queries and the error for errors). Of the arguments and return
+* values, the present strings, @c values when @c numOfValues is non-zero, @c
+* implied_port when @c impliedPort is set, and @c port for @c announce_peer
+* queries are written. The name of the method is taken from @c methodName
+* when it is present and from @c method otherwise.
+*
+* No memory is allocated and nothing is copied but the encoded message.
+*/
+std::size_t encodeKrpc(const KrpcMessage &message, char *buffer,
+		std::size_t size) noexcept {
+	BufferWriter writer(buffer, size);
+	writer.put('d');
+	if (message.type == KrpcMessageType::Query) {
+		writer.putKey("a");
+		writeArguments(writer, message);
+	} else if (message.type == KrpcMessageType::Error) {
+		writer.putKey("e");
+		writer.put('l');
+		writer.putInteger(message.errorCode);
+		writer.putString(message.errorMessage);
+		writer.put('e');
+	}
+	if (message.externalIp.present()) {
+		writer.putKey("ip");
+		writer.putString(message.externalIp);
+	}
+	if (message.type == KrpcMessageType::Query) {
+		writer.putKey("q");
+		writer.putString(message.methodName.present() ?
+			message.methodName : getMethodName(message.method));
+	} else if (message.type == KrpcMessageType::Response) {
+		writer.putKey("r");
+		writeArguments(writer, message);
+	}
+	if (message.readOnly) {
+		writer.putKey("ro");
+		writer.putInteger(1);
+	}
+	writer.putKey("t");
+	writer.putString(message.transactionId);
+	if (message.version.present()) {
+		writer.putKey("v");
+		writer.putString(message.version);
+	}
+	writer.putKey("y");
+	switch (message.type) {
+		case KrpcMessageType::Query:
+			writer.putKey("q");
+			break;
+		case KrpcMessageType::Response:
+			writer.putKey("r");
+			break;
+		case KrpcMessageType::Error:
+		default:
+			writer.putKey("e");
+			break;
+	}
+	writer.put('e');
+	return writer.written();
+}
+
+/**
+* @brief Encodes the given @a message into a string.
+*
+* See encodeKrpc(const KrpcMessage &, char *, std::size_t) for more details.
+*/
+std::string encodeKrpc(const KrpcMessage &message) {
+	std::string data(encodeKrpc(message, nullptr, 0), '\0');
+	encodeKrpc(message, &data[0], data.size());
+	return data;
+}
+
+} // namespace bencoding
@@ -0,0 +1,436 @@
+/**
+* @file      ParallelDecoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the ParallelDecoder class.
+*/
+
+#include "ParallelDecoder.h"
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <tuple>
+
+#include "BDictionary.h"
+#include "BList.h"
+#include "BString.h"
+#include "Decoder.h"
+#include "KeyInternTable.h"
+#include "Reader.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/// Minimal size of data (in bytes) whose decoding is split between threads.
+const std::size_t MIN_SIZE_FOR_PARALLEL_DECODING = 64 * 1024;
+
+/// Number of items per thread (items larger than the size of the data divided
+/// by the number of items are split when they are lists or dictionaries).
+const std::size_t ITEMS_PER_THREAD = 4;
+
+/// Maximal number of split lists and dictionaries (it bounds the time of the
+/// pre-scan of deeply nested data).
+const std::size_t MAX_NUM_OF_SPLIT_ITEMS = 256;
+
+/// Value of Slot::part for items that are decoded as a whole.
+const std::size_t NO_PART = std::numeric_limits<std::size_t>::max();
+
+/**
+* @brief Moves @a pos past the item that starts at @a pos in the given @a
+*        length characters of @a data without decoding the item.
+*
+* Only the structure of the item is checked. The full check is done when the
+* item is decoded.
+*
+* @return @c false if the structure is malformed, @c true otherwise.
+*/
+bool skipItem(const char *data, std::size_t length, std::size_t &pos) {
+	std::size_t depth = 0;
+	do {
+		if (pos >= length) {
+			return false;
+		}
+		char c = data[pos];
+		if (c == 'i') {
+			auto end = static_cast<const char *>(
+				std::memchr(data + pos, 'e', length - pos));
+			if (!end) {
+				return false;
+			}
+			pos = static_cast<std::size_t>(end - data) + 1;
+		} else if (isDigit(c)) {
+			std::size_t stringLength = 0;
+			while (pos < length && isDigit(data[pos])) {
+				stringLength = stringLength * 10 +
+					static_cast<std::size_t>(data[pos] - '0');
+				if (stringLength > length) {
+					return false;
+				}
+				++pos;
+			}
+			if (pos >= length || data[pos] != ':' ||
+					stringLength > length - pos - 1) {
+				return false;
+			}
+			pos += 1 + stringLength;
+		} else if (c == 'l' || c == 'd') {
+			++depth;
+			++pos;
+		} else if (c == 'e' && depth > 0) {
+			--depth;
+			++pos;
+		} else {
+			return false;
+		}
+	} while (depth > 0);
+	return true;
+}
+
+/**
+* @brief An item of a split list or dictionary.
+*/
+struct Slot {
+	/// Offset of the key (dictionaries only).
+	std::size_t keyBegin;
+
+	/// Offset past the key (dictionaries only).
+	std::size_t keyEnd;
+
+	/// Offset of the item.
+	std::size_t begin;
+
+	/// Offset past the item.
+	std::size_t end;
+
+	/// Index of the part into which the item has been split (@c NO_PART when
+	/// the item is decoded as a whole).
+	std::size_t part;
+};
+
+/**
+* @brief A split list or dictionary.
+*/
+struct Part {
+	/// Is it a dictionary?
+	bool isDict;
+
+	/// Its items.
+	std::vector<Slot> slots;
+};
+
+/**
+* @brief Splits bencoded data into parts whose items can be decoded
+*        independently.
+*/
+class Splitter {
+public:
+	explicit Splitter(const std::string &data);
+
+	bool split(std::size_t numOfItems);
+	const std::vector<Part> &getParts() const;
+
+private:
+	bool scanPart(std::size_t partIndex, std::size_t begin, std::size_t &end);
+
+private:
+	/// Split data.
+	const std::string &data;
+
+	/// Size of items that are split when they are lists or dictionaries.
+	std::size_t minSizeToSplit = 0;
+
+	/// Parts (the first one is the top-level item).
+	std::vector<Part> parts;
+
+	/// Lists and dictionaries to be split: their sizes, parts, and slots.
+	std::priority_queue<std::tuple<std::size_t, std::size_t, std::size_t>>
+		candidates;
+};
+
+/**
+* @brief Constructs a splitter of the given @a data.
+*/
+Splitter::Splitter(const std::string &data): data(data) {}
+
+/**
+* @brief Splits the top-level list or dictionary and then its largest nested
+*        lists and dictionaries so that there are enough items of similar
+*        sizes to be decoded (@a numOfItems).
+*
+* @return @c false if the structure of the data is malformed, @c true
+*         otherwise.
+*/
+bool Splitter::split(std::size_t numOfItems) {
+	minSizeToSplit = data.size() / numOfItems;
+	parts.push_back(Part{data[0] == 'd', std::vector<Slot>()});
+	std::size_t end;
+	if (!scanPart(0, 0, end) || end != data.size()) {
+		return false;
+	}
+
+	while (!candidates.empty() && parts.size() < MAX_NUM_OF_SPLIT_ITEMS) {
+		std::size_t partIndex = std::get<1>(candidates.top());
+		std::size_t slotIndex = std::get<2>(candidates.top());
+		candidates.pop();
+		std::size_t begin = parts[partIndex].slots[slotIndex].begin;
+		parts[partIndex].slots[slotIndex].part = parts.size();
+		parts.push_back(Part{data[begin] == 'd', std::vector<Slot>()});
+		if (!scanPart(parts.size() - 1, begin, end)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Returns the found parts (the first one is the top-level item).
+*/
+const std::vector<Part> &Splitter::getParts() const {
+	return parts;
+}
+
+/**
+* @brief Finds the items of the part with the given index, whose list or
+*        dictionary starts at @a begin.
+*
+* @param[in] partIndex Index of the part.
+* @param[in] begin Offset of the list or dictionary.
+* @param[out] end Offset past the list or dictionary.
+*/
+bool Splitter::scanPart(std::size_t partIndex, std::size_t begin,
+		std::size_t &end) {
+	bool isDict = parts[partIndex].isDict;
+	std::vector<Slot> slots;
+	std::size_t pos = begin + 1;
+	while (pos < data.size() && data[pos] != 'e') {
+		Slot slot{pos, pos, pos, pos, NO_PART};
+		if (isDict) {
+			if (!isDigit(data[pos]) || !skipItem(data.data(), data.size(), pos)) {
+				return false;
+			}
+			slot.keyEnd = pos;
+			slot.begin = pos;
+		}
+		if (!skipItem(data.data(), data.size(), pos)) {
+			return false;
+		}
+		slot.end = pos;
+		std::size_t size = slot.end - slot.begin;
+		if (size > minSizeToSplit &&
+				(data[slot.begin] == 'l' || data[slot.begin] == 'd')) {
+			candidates.emplace(size, partIndex, slots.size());
+		}
+		slots.push_back(slot);
+	}
+	if (pos >= data.size()) {
+		return false;
+	}
+	end = pos + 1;
+	parts[partIndex].slots = std::move(slots);
+	return true;
+}
+
+/**
+* @brief Appends the items of the given part that are decoded as a whole to
+*        @a items (depth first, in the order of the data).
+*/
+void collectItems(const std::vector<Part> &parts, std::size_t partIndex,
+		std::vector<const Slot *> &items) {
+	for (const auto &slot : parts[partIndex].slots) {
+		if (slot.part == NO_PART) {
+			items.push_back(&slot);
+		} else {
+			collectItems(parts, slot.part, items);
+		}
+	}
+}
+
+/**
+* @brief Builds the list or dictionary of the given part from the decoded
+*        items.
+*
+* @param[in] data Decoded data.
+* @param[in] parts Parts of the data.
+* @param[in] partIndex Index of the part to be built.
+* @param[in] items Items decoded as a whole (in the order of collectItems()).
+* @param[in,out] nextItem Index of the next item to be used from @a items.
+* @param[in] keyInternTable Table of interned keys (@c nullptr when keys are
+*                           not interned).
+*
+* @return The built item, or @c nullptr when a key is invalid.
+*/
+std::unique_ptr<BItem> buildPart(const std::string &data,
+		const std::vector<Part> &parts, std::size_t partIndex,
+		std::vector<std::unique_ptr<BItem>> &items, std::size_t &nextItem,
+		KeyInternTable *keyInternTable) {
+	const auto &part = parts[partIndex];
+	std::unique_ptr<BList> bList;
+	std::unique_ptr<BDictionary> bDictionary;
+	if (part.isDict) {
+		bDictionary = BDictionary::create();
+	} else {
+		bList = BList::create();
+	}
+	for (const auto &slot : part.slots) {
+		std::unique_ptr<BItem> item;
+		if (slot.part == NO_PART) {
+			item = std::move(items[nextItem++]);
+		} else {
+			item = buildPart(data, parts, slot.part, items, nextItem,
+				keyInternTable);
+			if (!item) {
+				return nullptr;
+			}
+		}
+
+		if (!part.isDict) {
+			bList->push_back(std::move(item));
+			continue;
+		}
+		Reader reader(data.data() + slot.keyBegin, slot.keyEnd - slot.keyBegin);
+		if (reader.next() != TokenType::String) {
+			return nullptr;
+		}
+		std::shared_ptr<BString> key(keyInternTable ?
+			keyInternTable->intern(reader.stringData(), reader.stringLength()) :
+			BString::create(reader.string()));
+		(*bDictionary)[key] = std::move(item);
+	}
+	if (part.isDict) {
+		return std::unique_ptr<BItem>(std::move(bDictionary));
+	}
+	return std::unique_ptr<BItem>(std::move(bList));
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a decoder using the given thread pool.
+*/
+ParallelDecoder::ParallelDecoder(std::unique_ptr<ThreadPool> threadPool):
+		threadPool(std::move(threadPool)) {
+	for (std::size_t i = 0; i < this->threadPool->numOfThreads(); ++i) {
+		decoders.push_back(Decoder::create());
+	}
+}
+
+/**
+* @brief Destructs the decoder.
+*/
+ParallelDecoder::~ParallelDecoder() = default;
+
+/**
+* @brief Creates a new decoder.
+*
+* @param[in] numOfThreads Number of threads to be used. When it is zero, the
+*                         number of hardware threads is used.
+*/
+std::unique_ptr<ParallelDecoder> ParallelDecoder::create(
+		std::size_t numOfThreads) {
+	return std::unique_ptr<ParallelDecoder>(
+		new ParallelDecoder(ThreadPool::create(numOfThreads)));
+}
+
+/**
+* @brief Returns the number of threads used for the decoding.
+*/
+std::size_t ParallelDecoder::numOfThreads() const {
+	return threadPool->numOfThreads();
+}
+
+/**
+* @brief Makes the decoding use the options of the given @a decoder.
+*
+* All the options are copied, like in BatchDecoder::setDecoderOptions(). The
+* limits and key order checking apply to the data as a whole: the data are
+* validated by a single thread with these options before they are decoded in
+* parallel. Later changes of @a decoder do not affect this decoder.
+*/
+void ParallelDecoder::setDecoderOptions(const Decoder &decoder) {
+	for (auto &threadDecoder : decoders) {
+		*threadDecoder = decoder;
+	}
+	keyInternTable = decoder.getKeyInterning();
+	wholeDataValidation = true;
+}
+
+/**
+* @brief Decodes the given bencoded @a data and returns them.
+*
+* The result is the same as the result of Decoder::decode() with the options
+* set by setDecoderOptions(), including the thrown DecodingError when @a data
+* are not valid.
+*/
+std::unique_ptr<BItem> ParallelDecoder::decode(const std::string &data) {
+	if (numOfThreads() == 1 || data.size() < MIN_SIZE_FOR_PARALLEL_DECODING ||
+			(data[0] != 'l' && data[0] != 'd')) {
+		return decoders[0]->decode(data);
+	}
+
+	// Items decoded separately stay within the limits whenever the whole
+	// data do, but only the whole data show whether the limits are exceeded
+	// and whether the keys of the split dictionaries are sorted.
+	if (wholeDataValidation && !decoders[0]->validate(data)) {
+		return decoders[0]->decode(data);
+	}
+
+	Splitter splitter(data);
+	if (!splitter.split(numOfThreads() * ITEMS_PER_THREAD)) {
+		return decoders[0]->decode(data);
+	}
+	const auto &parts = splitter.getParts();
+	std::vector<const Slot *> slots;
+	collectItems(parts, 0, slots);
+
+	// Decode the items in parallel. When an item is invalid, decode the whole
+	// data again by a single thread to get the same error as Decoder.
+	std::vector<std::unique_ptr<BItem>> items(slots.size());
+	std::atomic<bool> failed(false);
+	threadPool->runWithThreadIndexes(slots.size(),
+		[&](std::size_t i, std::size_t thread) {
+			if (failed) {
+				return;
+			}
+			auto result = decoders[thread]->tryDecode(
+				data.data() + slots[i]->begin, slots[i]->end - slots[i]->begin);
+			if (!result) {
+				failed = true;
+				return;
+			}
+			items[i] = result.releaseData();
+		}
+	);
+	if (failed) {
+		return decoders[0]->decode(data);
+	}
+
+	std::size_t nextItem = 0;
+	auto decodedData = buildPart(data, parts, 0, items, nextItem,
+		keyInternTable.get());
+	if (!decodedData) {
+		return decoders[0]->decode(data);
+	}
+	return decodedData;
+}
+
+/**
+* @brief Decodes the given bencoded @a data by using @a numOfThreads threads
+*        and returns them.
+*
+* This function can be handy if you just want to decode data without
+* explicitly creating a decoder and calling @c decode() on it.
+*
+* See ParallelDecoder::decode() for more details.
+*/
+std::unique_ptr<BItem> decodeInParallel(const std::string &data,
+		std::size_t numOfThreads) {
+	auto decoder = ParallelDecoder::create(numOfThreads);
+	return decoder->decode(data);
+}
+
+} // namespace bencoding
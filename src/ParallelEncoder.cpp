@@ -0,0 +1,318 @@
+/**
+* @file      ParallelEncoder.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the ParallelEncoder class.
+*/
+
+#include "ParallelEncoder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BItemVisitor.h"
+#include "BList.h"
+#include "BString.h"
+#include "Encoder.h"
+#include "ThreadPool.h"
+
+namespace bencoding {
+
+namespace {
+
+/// Minimal size of data (in bytes) whose encoding is split between threads.
+const std::size_t MIN_SIZE_FOR_PARALLEL_ENCODING = 64 * 1024;
+
+/// Number of chunks per thread (more chunks mean better load balancing).
+const std::size_t CHUNKS_PER_THREAD = 4;
+
+/**
+* @brief Returns the number of characters needed to write @a n in base ten.
+*/
+std::size_t numOfDigits(unsigned long long n) {
+	std::size_t digits = 1;
+	while (n >= 10) {
+		n /= 10;
+		++digits;
+	}
+	return digits;
+}
+
+/**
+* @brief Computes the size of encoded data without encoding them.
+*/
+class EncodedSizeCalculator: private BItemVisitor {
+public:
+	std::size_t getEncodedSize(const std::shared_ptr<BItem> &data) {
+		size = 0;
+		data->accept(this);
+		return size;
+	}
+
+private:
+	virtual void visit(BDictionary *bDictionary) override {
+		size += 2; // "d" and "e"
+		for (const auto &item : *bDictionary) {
+			item.first->accept(this);
+			item.second->accept(this);
+		}
+	}
+
+	virtual void visit(BInteger *bInteger) override {
+		auto value = bInteger->value();
+		auto magnitude = static_cast<unsigned long long>(value);
+		if (value < 0) {
+			magnitude = 0 - magnitude;
+			size += 1; // "-"
+		}
+		size += 2 + numOfDigits(magnitude); // "i", digits, and "e"
+	}
+
+	virtual void visit(BList *bList) override {
+		size += 2; // "l" and "e"
+		for (const auto &bItem : *bList) {
+			bItem->accept(this);
+		}
+	}
+
+	virtual void visit(BString *bString) override {
+		auto length = bString->length();
+		size += numOfDigits(length) + 1 + length; // length, ":", and value
+	}
+
+private:
+	/// Size of the data visited so far.
+	std::size_t size = 0;
+};
+
+/**
+* @brief A part of the encoded data.
+*
+* It is either an item to be encoded or an already encoded literal (such as
+* the "l" that starts a list).
+*/
+struct Segment {
+	/// Item to be encoded (@c nullptr for literals).
+	std::shared_ptr<BItem> item;
+
+	/// Already encoded data (for literals).
+	std::string literal;
+
+	/// Size of the encoded segment.
+	std::size_t size;
+};
+
+/**
+* @brief Returns the number of children of @a segment if it is a list or
+*        dictionary, and zero otherwise.
+*/
+std::size_t numOfChildren(const Segment &segment) {
+	if (!segment.item) {
+		return 0;
+	} else if (auto bList = std::dynamic_pointer_cast<BList>(segment.item)) {
+		return bList->size();
+	} else if (auto bDictionary =
+			std::dynamic_pointer_cast<BDictionary>(segment.item)) {
+		return bDictionary->size();
+	}
+	return 0;
+}
+
+/**
+* @brief Creates a literal segment.
+*/
+Segment makeLiteral(std::string literal) {
+	return Segment{nullptr, literal, literal.size()};
+}
+
+/**
+* @brief Replaces the list or dictionary in @a segments at @a index by
+*        segments of its children.
+*/
+void expandSegment(std::vector<Segment> &segments, std::size_t index) {
+	std::vector<Segment> children;
+	auto item = segments[index].item;
+	if (auto bList = std::dynamic_pointer_cast<BList>(item)) {
+		children.reserve(bList->size() + 2);
+		children.push_back(makeLiteral("l"));
+		for (const auto &bItem : *bList) {
+			children.push_back(Segment{bItem, std::string(), 0});
+		}
+	} else if (auto bDictionary = std::dynamic_pointer_cast<BDictionary>(item)) {
+		children.reserve(2 * bDictionary->size() + 2);
+		children.push_back(makeLiteral("d"));
+		for (const auto &item : *bDictionary) {
+			children.push_back(Segment{item.first, std::string(), 0});
+			children.push_back(Segment{item.second, std::string(), 0});
+		}
+	}
+	children.push_back(makeLiteral("e"));
+
+	segments.erase(segments.begin() + index);
+	segments.insert(segments.begin() + index,
+		children.begin(), children.end());
+}
+
+/**
+* @brief Splits @a data into at least @a minNumOfSegments segments (if
+*        possible) by repeatedly expanding the list or dictionary with the most
+*        children.
+*/
+std::vector<Segment> splitIntoSegments(std::shared_ptr<BItem> data,
+		std::size_t minNumOfSegments) {
+	std::vector<Segment> segments{Segment{data, std::string(), 0}};
+	while (segments.size() < minNumOfSegments) {
+		std::size_t maxNumOfChildren = 0;
+		std::size_t maxIndex = 0;
+		for (std::size_t i = 0; i < segments.size(); ++i) {
+			std::size_t n = numOfChildren(segments[i]);
+			if (n > maxNumOfChildren) {
+				maxNumOfChildren = n;
+				maxIndex = i;
+			}
+		}
+		if (maxNumOfChildren < 2) {
+			// There is nothing left to split.
+			break;
+		}
+		expandSegment(segments, maxIndex);
+	}
+	return segments;
+}
+
+/**
+* @brief Splits @a segments into at most @a maxNumOfChunks consecutive chunks
+*        of roughly the same size.
+*
+* @return Indexes of the first segments of the chunks, followed by the number
+*         of segments.
+*/
+std::vector<std::size_t> splitIntoChunks(const std::vector<Segment> &segments,
+		std::size_t totalSize, std::size_t maxNumOfChunks) {
+	std::vector<std::size_t> chunkBegins{0};
+	std::size_t accumulatedSize = 0;
+	for (std::size_t i = 0; i < segments.size(); ++i) {
+		accumulatedSize += segments[i].size;
+		std::size_t chunkEnd = totalSize / maxNumOfChunks * chunkBegins.size();
+		if (accumulatedSize >= chunkEnd && chunkBegins.size() < maxNumOfChunks &&
+				i + 1 < segments.size()) {
+			chunkBegins.push_back(i + 1);
+		}
+	}
+	chunkBegins.push_back(segments.size());
+	return chunkBegins;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs an encoder using the given thread pool.
+*/
+ParallelEncoder::ParallelEncoder(std::unique_ptr<ThreadPool> threadPool):
+	threadPool(std::move(threadPool)) {}
+
+/**
+* @brief Destructs the encoder.
+*/
+ParallelEncoder::~ParallelEncoder() = default;
+
+/**
+* @brief Creates a new encoder.
+*
+* @param[in] numOfThreads Number of threads to be used. When it is zero, the
+*                         number of hardware threads is used.
+*/
+std::unique_ptr<ParallelEncoder> ParallelEncoder::create(
+		std::size_t numOfThreads) {
+	return std::unique_ptr<ParallelEncoder>(
+		new ParallelEncoder(ThreadPool::create(numOfThreads)));
+}
+
+/**
+* @brief Returns the number of threads used for the encoding.
+*/
+std::size_t ParallelEncoder::numOfThreads() const {
+	return threadPool->numOfThreads();
+}
+
+/**
+* @brief Encodes the given @a data and returns them.
+*
+* The result is the same as the result of Encoder::encode().
+*/
+std::string ParallelEncoder::encode(std::shared_ptr<BItem> data) {
+	std::size_t numOfChunks = numOfThreads() * CHUNKS_PER_THREAD;
+	auto segments = splitIntoSegments(data, numOfChunks);
+	if (numOfThreads() == 1 || segments.size() == 1) {
+		return Encoder::create()->encode(data);
+	}
+
+	// Compute the sizes of the segments in parallel.
+	std::size_t segmentsPerTask = (segments.size() + numOfChunks - 1) / numOfChunks;
+	threadPool->run(numOfChunks, [&](std::size_t task) {
+		EncodedSizeCalculator calculator;
+		std::size_t end = std::min(segments.size(), (task + 1) * segmentsPerTask);
+		for (std::size_t i = task * segmentsPerTask; i < end; ++i) {
+			if (segments[i].item) {
+				segments[i].size = calculator.getEncodedSize(segments[i].item);
+			}
+		}
+	});
+	std::size_t totalSize = 0;
+	for (const auto &segment : segments) {
+		totalSize += segment.size;
+	}
+	if (totalSize < MIN_SIZE_FOR_PARALLEL_ENCODING) {
+		return Encoder::create()->encode(data);
+	}
+
+	// Encode the chunks in parallel, each into its own buffer, and copy them
+	// into the result at their precomputed offsets.
+	auto chunkBegins = splitIntoChunks(segments, totalSize, numOfChunks);
+	std::vector<std::size_t> chunkOffsets(chunkBegins.size(), 0);
+	for (std::size_t i = 1; i < chunkBegins.size(); ++i) {
+		chunkOffsets[i] = chunkOffsets[i - 1];
+		for (std::size_t j = chunkBegins[i - 1]; j < chunkBegins[i]; ++j) {
+			chunkOffsets[i] += segments[j].size;
+		}
+	}
+	std::string encodedData(totalSize, char());
+	threadPool->run(chunkBegins.size() - 1, [&](std::size_t chunk) {
+		std::string encodedChunk;
+		encodedChunk.reserve(chunkOffsets[chunk + 1] - chunkOffsets[chunk]);
+		auto encoder = Encoder::create();
+		for (std::size_t i = chunkBegins[chunk]; i < chunkBegins[chunk + 1]; ++i) {
+			if (segments[i].item) {
+				encoder->encode(segments[i].item, encodedChunk);
+			} else {
+				encodedChunk += segments[i].literal;
+			}
+		}
+		assert(encodedChunk.size() ==
+			chunkOffsets[chunk + 1] - chunkOffsets[chunk]);
+		std::memcpy(&encodedData[chunkOffsets[chunk]], encodedChunk.data(),
+			encodedChunk.size());
+	});
+	return encodedData;
+}
+
+/**
+* @brief Encodes the given @a data by using @a numOfThreads threads and returns
+*        them.
+*
+* This function can be handy if you just want to encode data without explicitly
+* creating an encoder and calling @c encode() on it.
+*
+* See ParallelEncoder::encode() for more details.
+*/
+std::string encodeInParallel(std::shared_ptr<BItem> data,
+		std::size_t numOfThreads) {
+	auto encoder = ParallelEncoder::create(numOfThreads);
+	return encoder->encode(data);
+}
+
+} // namespace bencoding
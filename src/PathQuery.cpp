@@ -0,0 +1,407 @@
+/**
+* @file      PathQuery.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the PathQuery class.
+*/
+
+#include "PathQuery.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "Decoder.h"
+#include "Reader.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Parses @a component as a list index.
+*
+* @return @c true if @a component is a decimal number without leading zeros
+*         that fits into @a index, @c false otherwise.
+*/
+bool parseIndex(const std::string &component, std::size_t &index) {
+	if (component.empty() || (component[0] == '0' && component.size() > 1)) {
+		return false;
+	}
+	index = 0;
+	for (char c : component) {
+		if (c < '0' || c > '9') {
+			return false;
+		}
+		auto digit = static_cast<std::size_t>(c - '0');
+		if (index > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+			return false;
+		}
+		index = index * 10 + digit;
+	}
+	return true;
+}
+
+/**
+* @brief Replaces escape sequences in the given path @a component.
+*/
+std::string unescapeComponent(const std::string &component) {
+	std::string key;
+	for (std::size_t i = 0; i < component.size(); ++i) {
+		if (component[i] == '~' && i + 1 < component.size() &&
+				(component[i + 1] == '0' || component[i + 1] == '1')) {
+			key += component[i + 1] == '0' ? '~' : '/';
+			++i;
+		} else {
+			key += component[i];
+		}
+	}
+	return key;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Checks if the viewed item exists.
+*/
+bool BItemView::found() const noexcept {
+	return type != Type::None;
+}
+
+/**
+* @brief Returns a copy of the viewed characters.
+*
+* For a string, it is its contents. For a list or a dictionary, it is its
+* encoded form. For other items, the returned string is empty.
+*/
+std::string BItemView::string() const {
+	return data ? std::string(data, length) : std::string();
+}
+
+/**
+* @brief Walks through bencoded data and records items on the paths of a
+*        query.
+*
+* Only items on the paths are visited recursively, so the recursion depth is
+* bounded by the number of components of the longest path. Other items are
+* skipped by Reader without recursion.
+*/
+class PathQuery::Walker {
+public:
+	Walker(const PathQuery &query, const char *input, Reader &reader,
+		std::vector<BItemView> &values);
+
+	bool visit(std::size_t nodeIndex);
+	bool isFinished() const;
+
+private:
+	bool visitItems(const Node &node, bool isDict);
+	std::size_t findChildPosition(const Node &node) const;
+	std::size_t findChild(const Node &node, std::size_t index) const;
+
+private:
+	/// Compiled paths.
+	const std::vector<Node> &nodes;
+
+	/// Start of the input.
+	const char *input;
+
+	/// Reader of the input.
+	Reader &reader;
+
+	/// Found items.
+	std::vector<BItemView> &values;
+
+	/// Number of paths that have not been found yet.
+	std::size_t numOfRemainingPaths;
+};
+
+/**
+* @brief Constructs a walker storing the items on the paths of @a query that
+*        are read by @a reader from @a input into @a values.
+*/
+PathQuery::Walker::Walker(const PathQuery &query, const char *input,
+		Reader &reader, std::vector<BItemView> &values):
+	nodes(query.nodes), input(input), reader(reader), values(values),
+	numOfRemainingPaths(query.numOfPaths) {}
+
+/**
+* @brief Visits the item whose first token has just been read by the reader
+*        and that is at the place of the given node.
+*
+* @return @c false if the reading failed or all the paths have been found,
+*         @c true otherwise.
+*/
+bool PathQuery::Walker::visit(std::size_t nodeIndex) {
+	const Node &node = nodes[nodeIndex];
+	std::size_t begin = reader.tokenBegin();
+	BItemView view;
+	view.offset = begin;
+	switch (reader.tokenType()) {
+		case TokenType::Integer:
+			view.type = BItemView::Type::Integer;
+			view.integer = reader.integer();
+			break;
+		case TokenType::String:
+			view.type = BItemView::Type::String;
+			view.data = reader.stringData();
+			view.length = reader.stringLength();
+			break;
+		case TokenType::DictBegin:
+		case TokenType::ListBegin: {
+			bool isDict = reader.tokenType() == TokenType::DictBegin;
+			view.type = isDict ? BItemView::Type::Dictionary :
+				BItemView::Type::List;
+			bool read = node.children.empty() ? reader.skip() :
+				visitItems(node, isDict);
+			if (!read) {
+				return false;
+			}
+			view.data = input + begin;
+			view.length = reader.offset() - begin;
+			break;
+		}
+		case TokenType::End:
+		case TokenType::EndOfInput:
+		case TokenType::Error:
+		default:
+			return false;
+	}
+
+	if (node.paths.empty() || values[node.paths.front()].found()) {
+		return true;
+	}
+	for (auto pathIndex : node.paths) {
+		values[pathIndex] = view;
+	}
+	numOfRemainingPaths -= node.paths.size();
+	return !isFinished();
+}
+
+/**
+* @brief Checks if all the paths have been found.
+*/
+bool PathQuery::Walker::isFinished() const {
+	return numOfRemainingPaths == 0;
+}
+
+/**
+* @brief Visits items of the list or dictionary (when @a isDict is @c true)
+*        at the place of the given @a node.
+*
+* Items that are not at the place of any child of @a node are skipped. In a
+* dictionary, only the first occurrence of a duplicate key is visited, so a
+* path never continues into the value of a later occurrence.
+*/
+bool PathQuery::Walker::visitItems(const Node &node, bool isDict) {
+	// Positions of the children whose keys have already occurred. Nodes rarely
+	// have more than 64 children, so a vector is allocated only for them.
+	std::uint64_t visitedChildren = 0;
+	std::vector<bool> moreVisitedChildren;
+	for (std::size_t index = 0; ; ++index) {
+		switch (reader.next()) {
+			case TokenType::End:
+				return true;
+			case TokenType::Error:
+				return false;
+			default:
+				break;
+		}
+
+		std::size_t child = nodes.size();
+		if (isDict) {
+			std::size_t position = findChildPosition(node);
+			if (position < 64 && (visitedChildren >> position & 1) == 0) {
+				visitedChildren |= std::uint64_t(1) << position;
+				child = node.children[position];
+			} else if (position >= 64 && position < node.children.size()) {
+				moreVisitedChildren.resize(node.children.size() - 64);
+				if (!moreVisitedChildren[position - 64]) {
+					moreVisitedChildren[position - 64] = true;
+					child = node.children[position];
+				}
+			}
+			if (reader.next() == TokenType::Error) {
+				return false;
+			}
+		} else {
+			child = findChild(node, index);
+		}
+		bool read = child < nodes.size() ? visit(child) : reader.skip();
+		if (!read) {
+			return false;
+		}
+	}
+}
+
+/**
+* @brief Returns the position in the children of @a node of the child whose
+*        key is the current key of the reader (the number of children when
+*        there is no such child).
+*/
+std::size_t PathQuery::Walker::findChildPosition(const Node &node) const {
+	for (std::size_t i = 0; i < node.children.size(); ++i) {
+		const auto &key = nodes[node.children[i]].key;
+		if (key.size() == reader.stringLength() &&
+				std::memcmp(key.data(), reader.stringData(), key.size()) == 0) {
+			return i;
+		}
+	}
+	return node.children.size();
+}
+
+/**
+* @brief Returns the child of @a node with the given list @a index (the
+*        number of nodes when there is no such child).
+*/
+std::size_t PathQuery::Walker::findChild(const Node &node,
+		std::size_t index) const {
+	for (auto child : node.children) {
+		if (nodes[child].isIndex && nodes[child].index == index) {
+			return child;
+		}
+	}
+	return nodes.size();
+}
+
+/**
+* @brief Compiles the given @a paths.
+*/
+PathQuery::PathQuery(const std::vector<std::string> &paths):
+		numOfPaths(paths.size()), nodes(1) {
+	for (std::size_t i = 0; i < paths.size(); ++i) {
+		addPath(paths[i], i);
+	}
+}
+
+/**
+* @brief Creates a query compiled from the given @a paths.
+*
+* The found items are stored in the order of @a paths.
+*/
+std::unique_ptr<PathQuery> PathQuery::create(
+		const std::vector<std::string> &paths) {
+	return std::unique_ptr<PathQuery>(new PathQuery(paths));
+}
+
+/**
+* @brief Returns the number of paths in the query.
+*/
+std::size_t PathQuery::getNumOfPaths() const {
+	return numOfPaths;
+}
+
+/**
+* @brief Extracts items on the paths of the query from the given bencoded
+*        @a data.
+*
+* @param[in] data Bencoded data.
+* @param[out] values For every path, the view of the found item (in the order
+*                    of the paths given to create()). Paths that are not found
+*                    are represented by views whose @c found() returns @c
+*                    false. The views point into @a data.
+*
+* @return Successful result (without data) or the reason of the failure when
+*         @a data are not valid. In the latter case, @a values may contain
+*         items found before the failure.
+*
+* The memory of @a values is reused, so no memory is allocated when the same
+* vector is passed repeatedly.
+*/
+DecodingResult PathQuery::extract(const std::string &data,
+		std::vector<BItemView> &values) const {
+	return extract(data.data(), data.size(), values);
+}
+
+/**
+* @brief Extracts items on the paths of the query from the given @a length
+*        characters of bencoded @a data.
+*
+* See extract(const std::string &, std::vector<BItemView> &) for more details.
+*/
+DecodingResult PathQuery::extract(const char *data, std::size_t length,
+		std::vector<BItemView> &values) const {
+	values.assign(numOfPaths, BItemView());
+
+	Reader reader(data, length);
+	Walker walker(*this, data, reader, values);
+	switch (reader.next()) {
+		case TokenType::EndOfInput:
+			return DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+				reader.offset());
+		case TokenType::Error:
+			return DecodingResult(reader.error(), reader.errorOffset());
+		default:
+			break;
+	}
+
+	if (!walker.visit(0) && !walker.isFinished()) {
+		return DecodingResult(reader.error(), reader.errorOffset());
+	} else if (!walker.isFinished() && reader.offset() != length) {
+		return DecodingResult(DecodingErrorCode::UndecodedCharacters,
+			reader.offset());
+	}
+	return DecodingResult();
+}
+
+/**
+* @brief Adds the given @a path with the given index to the trie.
+*/
+void PathQuery::addPath(const std::string &path, std::size_t pathIndex) {
+	std::size_t node = 0;
+	if (!path.empty()) {
+		std::size_t componentBegin = 0;
+		for (;;) {
+			std::size_t componentEnd = path.find('/', componentBegin);
+			node = addComponent(node, unescapeComponent(
+				path.substr(componentBegin, componentEnd - componentBegin)));
+			if (componentEnd == std::string::npos) {
+				break;
+			}
+			componentBegin = componentEnd + 1;
+		}
+	}
+	nodes[node].paths.push_back(pathIndex);
+}
+
+/**
+* @brief Returns the child of the given @a parent node with the given @a key,
+*        adding it when it does not exist.
+*/
+std::size_t PathQuery::addComponent(std::size_t parent,
+		const std::string &key) {
+	for (auto child : nodes[parent].children) {
+		if (nodes[child].key == key) {
+			return child;
+		}
+	}
+
+	Node node;
+	node.key = key;
+	node.index = 0;
+	node.isIndex = parseIndex(key, node.index);
+	nodes.push_back(node);
+	nodes[parent].children.push_back(nodes.size() - 1);
+	return nodes.size() - 1;
+}
+
+/**
+* @brief Extracts items on the given @a paths from the given bencoded @a data.
+*
+* This function provides an easier way of extracting items without the need
+* of explicitly creating a PathQuery instance. When many inputs are
+* processed, create the query once and reuse it instead.
+*
+* @throws DecodingError When @a data are not valid.
+*/
+std::vector<BItemView> extract(const std::string &data,
+		const std::vector<std::string> &paths) {
+	std::vector<BItemView> values;
+	auto result = PathQuery::create(paths)->extract(data, values);
+	if (!result) {
+		throw DecodingError(result.message());
+	}
+	return values;
+}
+
+} // namespace bencoding
@@ -7,6 +7,10 @@
 
 #include "PrettyPrinter.h"
 
+#include <cstring>
+#include <limits>
+#include <sstream>
+
 #include "BDictionary.h"
 #include "BInteger.h"
 #include "BList.h"
@@ -15,6 +19,16 @@
 
 namespace bencoding {
 
+namespace {
+
+/// Value of a limit meaning that there is no limit.
+const std::size_t NO_LIMIT = std::numeric_limits<std::size_t>::max();
+
+/// Marker of elided content (a horizontal ellipsis encoded in UTF-8).
+const char ELLIPSIS[] = "\xe2\x80\xa6";
+
+} // anonymous namespace
+
 /**
 * @brief Constructs a printer.
 */
@@ -35,33 +49,150 @@ std::unique_ptr<PrettyPrinter> PrettyPrinter::create() {
 */
 std::string PrettyPrinter::getPrettyRepr(std::shared_ptr<BItem> data,
 		const std::string &indent) {
-	prettyRepr.clear();
+	std::ostringstream prettyRepr;
+	printPrettyRepr(data, prettyRepr, indent);
+	return prettyRepr.str();
+}
+
+/**
+* @brief Writes a pretty representation of @a data into @a output.
+*
+* @param[in] data Data to write a pretty representation for.
+* @param[out] output Stream into which the representation is written.
+* @param[in] indent A single level of indentation.
+*
+* The representation is the same as the one returned by getPrettyRepr(), but
+* it is never stored in memory as a whole.
+*/
+void PrettyPrinter::printPrettyRepr(std::shared_ptr<BItem> data,
+		std::ostream &output, const std::string &indent) {
+	this->output = &output;
 	indentLevel = indent;
-	currentIndent.clear();
+	indentTable.clear();
+	currentIndentLevel = 0;
 	data->accept(this);
-	return prettyRepr;
+	this->output = nullptr;
+}
+
+/**
+* @brief Sets the maximal number of bytes shown from every string.
+*
+* Longer strings are cut and followed by a marker with their length, such as
+* <tt>"abcd…(1048576 bytes)"</tt>. The cut-off part is neither escaped nor
+* copied. By default, there is no limit.
+*/
+void PrettyPrinter::setMaxStringLength(std::size_t maxStringLength) {
+	this->maxStringLength = maxStringLength;
+}
+
+/**
+* @brief Sets the maximal number of items shown from every list and
+*        dictionary.
+*
+* The remaining items are replaced with a marker with their number, such as
+* <tt>…(49990 more items)</tt>. By default, there is no limit.
+*/
+void PrettyPrinter::setMaxNumOfItems(std::size_t maxNumOfItems) {
+	this->maxNumOfItems = maxNumOfItems;
+}
+
+/**
+* @brief Sets the maximal depth of lists and dictionaries whose items are
+*        shown.
+*
+* Non-empty lists and dictionaries nested deeper are summarized by the number
+* of their items, such as <tt>[…(3 items)]</tt>. The top-level item has depth
+* zero. By default, there is no limit.
+*/
+void PrettyPrinter::setMaxDepth(std::size_t maxDepth) {
+	this->maxDepth = maxDepth;
+}
+
+/**
+* @brief Removes all the limits set by setMaxStringLength(),
+*        setMaxNumOfItems(), and setMaxDepth().
+*/
+void PrettyPrinter::removeLimits() {
+	maxStringLength = NO_LIMIT;
+	maxNumOfItems = NO_LIMIT;
+	maxDepth = NO_LIMIT;
+}
+
+/**
+* @brief Writes the given character.
+*/
+void PrettyPrinter::write(char c) {
+	output->put(c);
+}
+
+/**
+* @brief Writes @a length characters stored in @a data.
+*/
+void PrettyPrinter::write(const char *data, std::size_t length) {
+	output->write(data, static_cast<std::streamsize>(length));
 }
 
 /**
-* @brief Stores the current indentation into @c prettyRepr.
+* @brief Writes the given number.
+*/
+void PrettyPrinter::write(std::size_t n) {
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH];
+	char *end = formatted + sizeof(formatted);
+	char *begin = formatInteger(end, static_cast<int64_t>(n));
+	write(begin, static_cast<std::size_t>(end - begin));
+}
+
+/**
+* @brief Writes @a length characters stored in @a data with a backslash put
+*        before every quote.
+*
+* The parts between quotes are written in bulk.
+*/
+void PrettyPrinter::writeEscaped(const char *data, std::size_t length) {
+	const char *runBegin = data;
+	const char *end = data + length;
+	while (const char *quote = static_cast<const char *>(
+			std::memchr(runBegin, '"', static_cast<std::size_t>(end - runBegin)))) {
+		write(runBegin, static_cast<std::size_t>(quote - runBegin));
+		write(R"(\")", 2);
+		runBegin = quote + 1;
+	}
+	write(runBegin, static_cast<std::size_t>(end - runBegin));
+}
+
+/**
+* @brief Writes a marker of elided content, such as <tt>…(10 bytes)</tt>.
+*/
+void PrettyPrinter::writeElisionMarker(std::size_t count, const char *unit) {
+	write(ELLIPSIS, sizeof(ELLIPSIS) - 1);
+	write('(');
+	write(count);
+	write(unit, std::strlen(unit));
+	write(')');
+}
+
+/**
+* @brief Writes the current indentation.
 */
 void PrettyPrinter::storeCurrentIndent() {
-	prettyRepr += currentIndent;
+	write(indentTable.data(), currentIndentLevel * indentLevel.size());
 }
 
 /**
 * @brief Increases the current indentation by a single level.
 */
 void PrettyPrinter::increaseIndentLevel() {
-	currentIndent += indentLevel;
+	++currentIndentLevel;
+	if (indentTable.size() < currentIndentLevel * indentLevel.size()) {
+		indentTable += indentLevel;
+	}
 }
 
 /**
 * @brief Decreases the current indentation by a single level.
 */
 void PrettyPrinter::decreaseIndentLevel() {
-	currentIndent = currentIndent.substr(0,
-		currentIndent.size() - indentLevel.size());
+	--currentIndentLevel;
 }
 
 void PrettyPrinter::visit(BDictionary *bDictionary) {
@@ -74,25 +205,43 @@ void PrettyPrinter::visit(BDictionary *bDictionary) {
 	//        ...
 	//    }
 	//
-	prettyRepr += "{\n";
+	// When the dictionary is too deep, only the number of its items is shown:
+	//
+	//     {…(N items)}
+	//
+	if (currentIndentLevel >= maxDepth && !bDictionary->empty()) {
+		write('{');
+		writeElisionMarker(bDictionary->size(), " items");
+		write('}');
+		return;
+	}
+
+	write("{\n", 2);
 	increaseIndentLevel();
 	bool putComma = false;
+	std::size_t numOfShownItems = 0;
 	for (auto &item : *bDictionary) {
 		if (putComma) {
-			prettyRepr += ",\n";
+			write(",\n", 2);
 		}
 		storeCurrentIndent();
+		if (numOfShownItems == maxNumOfItems) {
+			writeElisionMarker(bDictionary->size() - numOfShownItems,
+				" more items");
+			break;
+		}
 		item.first->accept(this);
-		prettyRepr += ": ";
+		write(": ", 2);
 		item.second->accept(this);
 		putComma = true;
+		++numOfShownItems;
 	}
 	if (!bDictionary->empty()) {
-		prettyRepr += "\n";
+		write('\n');
 	}
 	decreaseIndentLevel();
 	storeCurrentIndent();
-	prettyRepr += "}";
+	write('}');
 }
 
 void PrettyPrinter::visit(BInteger *bInteger) {
@@ -101,7 +250,10 @@ void PrettyPrinter::visit(BInteger *bInteger) {
 	//
 	//     int
 	//
-	prettyRepr += std::to_string(bInteger->value());
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH];
+	char *end = formatted + sizeof(formatted);
+	char *begin = formatInteger(end, bInteger->value());
+	write(begin, static_cast<std::size_t>(end - begin));
 }
 
 void PrettyPrinter::visit(BList *bList) {
@@ -114,23 +266,40 @@ void PrettyPrinter::visit(BList *bList) {
 	//         ...
 	//     ]
 	//
-	prettyRepr += "[\n";
+	// When the list is too deep, only the number of its items is shown:
+	//
+	//     […(N items)]
+	//
+	if (currentIndentLevel >= maxDepth && !bList->empty()) {
+		write('[');
+		writeElisionMarker(bList->size(), " items");
+		write(']');
+		return;
+	}
+
+	write("[\n", 2);
 	increaseIndentLevel();
 	bool putComma = false;
-	for (auto bItem : *bList) {
+	std::size_t numOfShownItems = 0;
+	for (const auto &bItem : *bList) {
 		if (putComma) {
-			prettyRepr += ",\n";
+			write(",\n", 2);
 		}
 		storeCurrentIndent();
+		if (numOfShownItems == maxNumOfItems) {
+			writeElisionMarker(bList->size() - numOfShownItems, " more items");
+			break;
+		}
 		bItem->accept(this);
 		putComma = true;
+		++numOfShownItems;
 	}
 	if (!bList->empty()) {
-		prettyRepr += "\n";
+		write('\n');
 	}
 	decreaseIndentLevel();
 	storeCurrentIndent();
-	prettyRepr += "]";
+	write(']');
 }
 
 void PrettyPrinter::visit(BString *bString) {
@@ -140,14 +309,27 @@ void PrettyPrinter::visit(BString *bString) {
 	//     "string"
 	//
 	// We have to put a backslash before quotes, i.e. replace " with \".
-	prettyRepr += '"' + replace(bString->value(), '"', std::string(R"(\")")) + '"';
+	//
+	// When the string is too long, only its beginning is shown:
+	//
+	//     "beginning…(N bytes)"
+	//
+	const auto &value = bString->value();
+	write('"');
+	if (value.size() > maxStringLength) {
+		writeEscaped(value.data(), maxStringLength);
+		writeElisionMarker(value.size(), " bytes");
+	} else {
+		writeEscaped(value.data(), value.size());
+	}
+	write('"');
 }
 
 /**
 * @brief Returns a pretty representation of @a data.
 *
 * This function can be handy if you just want to pretty-print data without
-* explicitly creating a pretty printer and calling @c encode() on it.
+* explicitly creating a pretty printer and calling @c getPrettyRepr() on it.
 *
 * See PrettyPrinter::getPrettyRepr() for more details.
 */
@@ -157,4 +339,18 @@ std::string getPrettyRepr(std::shared_ptr<BItem> data,
 	return prettyPrinter->getPrettyRepr(data, indent);
 }
 
+/**
+* @brief Writes a pretty representation of @a data into @a output.
+*
+* This function can be handy if you just want to pretty-print data without
+* explicitly creating a pretty printer and calling @c printPrettyRepr() on it.
+*
+* See PrettyPrinter::printPrettyRepr() for more details.
+*/
+void printPrettyRepr(std::shared_ptr<BItem> data, std::ostream &output,
+		const std::string &indent) {
+	auto prettyPrinter = PrettyPrinter::create();
+	prettyPrinter->printPrettyRepr(data, output, indent);
+}
+
 } // namespace bencoding
@@ -0,0 +1,517 @@
+/**
+* @file      Reader.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the Reader class.
+*/
+
+#include "Reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include "Utils.h"
+
+// Limits are always checked. The checks can be compiled out only to measure
+// their overhead (see bench/decoder_limits.cpp).
+#ifdef BENCODING_WITHOUT_LIMIT_CHECKS
+#define BENCODING_LIMIT_EXCEEDED(condition) false
+#else
+#define BENCODING_LIMIT_EXCEEDED(condition) (condition)
+#endif
+
+namespace bencoding {
+
+/**
+* @brief Constructs a reader of the given @a length characters of @a data.
+*/
+Reader::Reader(const char *data, std::size_t length) noexcept:
+	begin(data), pos(data), end(data + length), inputLength(length) {}
+
+/**
+* @brief Constructs a reader of the given @a data.
+*/
+Reader::Reader(const std::string &data) noexcept:
+	Reader(data.data(), data.size()) {}
+
+/**
+* @brief Sets limits of resources that the reading may use.
+*
+* It has to be called before the first call of next().
+*/
+void Reader::setLimits(const DecoderLimits &limits) noexcept {
+	this->limits = limits;
+	end = begin + std::min(inputLength, limits.maxInputLength);
+}
+
+/**
+* @brief Sets whether to check that keys in every dictionary are sorted (as
+*        raw strings) and unique.
+*
+* When enabled, DecodingErrorCode::UnsortedKeys or
+* DecodingErrorCode::DuplicateKey is reported at the offending key. By
+* default, the key order is not checked. It has to be called before the first
+* call of next().
+*/
+void Reader::setKeyOrderChecking(bool enabled) noexcept {
+	keyOrderChecking = enabled;
+}
+
+/**
+* @brief Reads the next token and returns its type.
+*/
+TokenType Reader::next() noexcept {
+	if (type == TokenType::Error) {
+		return type;
+	}
+
+	currentIsKey = false;
+	currentTokenBegin = offset();
+	if (pos == end) {
+		if (currentDepth == 0 && end == begin + inputLength) {
+			return type = TokenType::EndOfInput;
+		}
+		return failAtEndOfInput();
+	}
+
+	if (expectingKey) {
+		if (*pos == 'e') {
+			return endContainer();
+		} else if (!isDigit(*pos)) {
+			return fail(DecodingErrorCode::NonStringKey, pos);
+		}
+		currentIsKey = true;
+		return readString();
+	}
+
+	switch (*pos) {
+		case 'd':
+			return beginContainer(true);
+		case 'l':
+			return beginContainer(false);
+		case 'i':
+			return readInteger();
+		case 'e':
+			// A dictionary item without a value is caught here as well
+			// because a key is not expected.
+			if (currentDepth == 0 || isInDict()) {
+				return fail(DecodingErrorCode::UnexpectedCharacter, pos);
+			}
+			return endContainer();
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			return readString();
+		default:
+			return fail(DecodingErrorCode::UnexpectedCharacter, pos);
+	}
+}
+
+/**
+* @brief Skips the rest of the current item.
+*
+* When the current token begins a list or a dictionary, all the tokens up to
+* and including its end are read. Otherwise, nothing is read.
+*
+* @return @c false if the input is invalid, @c true otherwise.
+*/
+bool Reader::skip() noexcept {
+	if (type == TokenType::Error) {
+		return false;
+	} else if (type != TokenType::DictBegin && type != TokenType::ListBegin) {
+		return true;
+	}
+
+	std::size_t outerDepth = currentDepth - 1;
+	while (next() != TokenType::Error) {
+		if (type == TokenType::End && currentDepth == outerDepth) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+* @brief Returns the type of the current token.
+*/
+TokenType Reader::tokenType() const noexcept {
+	return type;
+}
+
+/**
+* @brief Returns the offset of the first character of the current token.
+*/
+std::size_t Reader::tokenBegin() const noexcept {
+	return currentTokenBegin;
+}
+
+/**
+* @brief Returns the value of the current integer token.
+*/
+BInteger::ValueType Reader::integer() const noexcept {
+	return integerValue;
+}
+
+/**
+* @brief Returns the first character of the current string token.
+*
+* The string is not terminated by a null character (see stringLength()).
+*/
+const char *Reader::stringData() const noexcept {
+	return stringBegin;
+}
+
+/**
+* @brief Returns the length of the current string token.
+*/
+std::size_t Reader::stringLength() const noexcept {
+	return stringSize;
+}
+
+/**
+* @brief Returns a copy of the current string token.
+*/
+std::string Reader::string() const {
+	return std::string(stringBegin, stringSize);
+}
+
+/**
+* @brief Checks if the current string token is a dictionary key.
+*/
+bool Reader::isKey() const noexcept {
+	return currentIsKey;
+}
+
+/**
+* @brief Returns the offset right after the current token.
+*/
+std::size_t Reader::offset() const noexcept {
+	return static_cast<std::size_t>(pos - begin);
+}
+
+/**
+* @brief Returns the number of currently open lists and dictionaries.
+*/
+std::size_t Reader::depth() const noexcept {
+	return currentDepth;
+}
+
+/**
+* @brief Checks if the innermost open item is a dictionary.
+*/
+bool Reader::isInDict() const noexcept {
+	if (currentDepth == 0) {
+		return false;
+	}
+	std::size_t level = currentDepth - 1;
+	if (level < INLINE_DEPTH) {
+		return (inlineStack[level / 64] >> (level % 64)) & 1;
+	}
+	return overflowStack.back();
+}
+
+/**
+* @brief Returns the reason of the failure (DecodingErrorCode::None if the
+*        input has been valid so far).
+*/
+DecodingErrorCode Reader::error() const noexcept {
+	return errorCode;
+}
+
+/**
+* @brief Returns the offset of the input character at which the reading
+*        failed.
+*/
+std::size_t Reader::errorOffset() const noexcept {
+	return errorPos;
+}
+
+/**
+* @brief Reads an integer token.
+*
+* @par Format
+* @code
+* i<integer encoded in base ten ASCII>e
+* @endcode
+*
+* @par Example
+* @code
+* i3e represents the integer 3
+* @endcode
+*
+* Moreover, only the significant digits should be used, one cannot pad the
+* integer with zeroes, such as @c i04e (see the <a
+* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">
+* specification</a>).
+*/
+TokenType Reader::readInteger() noexcept {
+	if (BENCODING_LIMIT_EXCEEDED(++numOfItems > limits.maxNumOfItems)) {
+		return fail(DecodingErrorCode::NumOfItemsLimitExceeded, pos);
+	}
+
+	const char *p = pos + 1;
+	bool negative = false;
+	if (p != end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		++p;
+	}
+	if (p == end) {
+		return failAtEndOfInput();
+	} else if (!isDigit(*p)) {
+		return fail(DecodingErrorCode::InvalidInteger, p);
+	}
+
+	uint64_t magnitude = 0;
+	if (*p == '0') {
+		// No padding with zeros.
+		++p;
+	} else {
+		// The magnitude of the minimal value is greater by one than the
+		// magnitude of the maximal value. The limits are chosen so that
+		// there is no division in the loop.
+		const uint64_t maxMagnitudeDiv10 = static_cast<uint64_t>(
+			std::numeric_limits<int64_t>::max()) / 10;
+		const uint64_t maxLastDigit = negative ? 8 : 7;
+		while (p != end && isDigit(*p)) {
+			auto digit = static_cast<uint64_t>(*p - '0');
+			if (magnitude > maxMagnitudeDiv10 ||
+					(magnitude == maxMagnitudeDiv10 && digit > maxLastDigit)) {
+				return fail(DecodingErrorCode::IntegerOutOfRange, p);
+			}
+			magnitude = magnitude * 10 + digit;
+			++p;
+		}
+	}
+	if (p == end) {
+		return failAtEndOfInput();
+	} else if (*p != 'e') {
+		return fail(DecodingErrorCode::InvalidInteger, p);
+	}
+
+	if (negative && magnitude != 0) {
+		// Computed this way to avoid overflowing for the minimal value.
+		integerValue = -static_cast<int64_t>(magnitude - 1) - 1;
+	} else {
+		integerValue = static_cast<int64_t>(magnitude);
+	}
+	pos = p + 1;
+	finishValue();
+	return type = TokenType::Integer;
+}
+
+/**
+* @brief Reads a string token.
+*
+* @par Format
+* @code
+* <string length encoded in base ten ASCII>:<string data>
+* @endcode
+*
+* @par Example
+* @code
+* 4:test represents the string "test"
+* @endcode
+*/
+TokenType Reader::readString() noexcept {
+	if (BENCODING_LIMIT_EXCEEDED(++numOfItems > limits.maxNumOfItems)) {
+		return fail(DecodingErrorCode::NumOfItemsLimitExceeded, pos);
+	}
+
+	const char *p = pos;
+	std::size_t length = 0;
+	const std::size_t maxLength = std::numeric_limits<std::size_t>::max();
+	while (p != end && isDigit(*p)) {
+		auto digit = static_cast<std::size_t>(*p - '0');
+		if (length > (maxLength - digit) / 10) {
+			return fail(DecodingErrorCode::InvalidStringLength, pos);
+		}
+		length = length * 10 + digit;
+		++p;
+	}
+	if (p == end) {
+		return failAtEndOfInput();
+	} else if (*p != ':') {
+		return fail(DecodingErrorCode::InvalidStringLength, p);
+	}
+	++p;
+
+	if (BENCODING_LIMIT_EXCEEDED(length > limits.maxStringLength)) {
+		return fail(DecodingErrorCode::StringLengthLimitExceeded, pos);
+	} else if (BENCODING_LIMIT_EXCEEDED(
+			length > limits.maxTotalStringLength - totalStringLength)) {
+		return fail(DecodingErrorCode::TotalStringLengthLimitExceeded, pos);
+	} else if (length > static_cast<std::size_t>(end - p)) {
+		return failAtEndOfInput();
+	}
+
+	totalStringLength += length;
+	stringBegin = p;
+	stringSize = length;
+	if (currentIsKey) {
+		if (keyOrderChecking) {
+			auto error = checkKeyOrder();
+			if (error != DecodingErrorCode::None) {
+				return fail(error, pos);
+			}
+		}
+		pos = p + length;
+		expectingKey = false;
+	} else {
+		pos = p + length;
+		finishValue();
+	}
+	return type = TokenType::String;
+}
+
+/**
+* @brief Reads the beginning of a dictionary (when @a isDict is @c true) or a
+*        list.
+*
+* @par Format
+* @code
+* d<bencoded string><bencoded element>e
+* l<bencoded values>e
+* @endcode
+*
+* @par Example
+* @code
+* d3:cow3:moo4:spam4:eggse represents the dictionary {"cow": "moo", "spam": "eggs"}
+* d4:spaml1:a1:bee represents the dictionary {"spam": ["a", "b"]}
+* l4:spam4:eggse represents a list containing two strings "spam" and "eggs"
+* @endcode
+*
+* The keys of a dictionary must be bencoded strings. The values may be any
+* bencoded type, including integers, strings, lists, and other dictionaries.
+* According to the <a
+* href="https://wiki.theory.org/BitTorrentSpecification#Bencoding">specification</a>,
+* the keys must be sorted, which is checked only when key order checking is
+* enabled.
+*/
+TokenType Reader::beginContainer(bool isDict) noexcept {
+	if (BENCODING_LIMIT_EXCEEDED(++numOfItems > limits.maxNumOfItems)) {
+		return fail(DecodingErrorCode::NumOfItemsLimitExceeded, pos);
+	} else if (BENCODING_LIMIT_EXCEEDED(currentDepth >= limits.maxDepth)) {
+		return fail(DecodingErrorCode::DepthLimitExceeded, pos);
+	}
+
+	std::size_t level = currentDepth;
+	if (level < INLINE_DEPTH) {
+		uint64_t mask = static_cast<uint64_t>(1) << (level % 64);
+		if (isDict) {
+			inlineStack[level / 64] |= mask;
+		} else {
+			inlineStack[level / 64] &= ~mask;
+		}
+	} else {
+		try {
+			overflowStack.push_back(isDict);
+		} catch (const std::bad_alloc &) {
+			return fail(DecodingErrorCode::OutOfMemory, pos);
+		}
+	}
+
+	if (isDict && keyOrderChecking) {
+		try {
+			lastKey(level) = KeyRef{nullptr, 0};
+		} catch (const std::bad_alloc &) {
+			return fail(DecodingErrorCode::OutOfMemory, pos);
+		}
+	}
+
+	++currentDepth;
+	++pos;
+	expectingKey = isDict;
+	return type = isDict ? TokenType::DictBegin : TokenType::ListBegin;
+}
+
+/**
+* @brief Reads the end of a dictionary or a list.
+*/
+TokenType Reader::endContainer() noexcept {
+	--currentDepth;
+	if (currentDepth >= INLINE_DEPTH) {
+		overflowStack.pop_back();
+	}
+	++pos;
+	finishValue();
+	return type = TokenType::End;
+}
+
+/**
+* @brief Checks that the current key is greater than the previous key in the
+*        innermost dictionary and remembers it.
+*
+* @return DecodingErrorCode::None if the key is in order, the error otherwise.
+*/
+DecodingErrorCode Reader::checkKeyOrder() noexcept {
+	KeyRef &previous = lastKey(currentDepth - 1);
+	if (previous.data) {
+		int result = std::memcmp(previous.data, stringBegin,
+			std::min(previous.length, stringSize));
+		if (result == 0 && previous.length == stringSize) {
+			return DecodingErrorCode::DuplicateKey;
+		} else if (result > 0 || (result == 0 && previous.length > stringSize)) {
+			return DecodingErrorCode::UnsortedKeys;
+		}
+	}
+	previous = KeyRef{stringBegin, stringSize};
+	return DecodingErrorCode::None;
+}
+
+/**
+* @brief Returns the last key read in the dictionary at the given nesting
+*        @a level.
+*
+* Memory for levels above @c INLINE_KEY_DEPTH is allocated on demand, so
+* @c std::bad_alloc may be thrown for a level that has not been used yet.
+*/
+Reader::KeyRef &Reader::lastKey(std::size_t level) {
+	if (level < INLINE_KEY_DEPTH) {
+		return inlineKeys[level];
+	}
+	std::size_t index = level - INLINE_KEY_DEPTH;
+	if (index >= overflowKeys.size()) {
+		overflowKeys.resize(index + 1);
+	}
+	return overflowKeys[index];
+}
+
+/**
+* @brief Records the given @a error at the position @a at and returns
+*        TokenType::Error.
+*/
+TokenType Reader::fail(DecodingErrorCode error, const char *at) noexcept {
+	errorCode = error;
+	errorPos = static_cast<std::size_t>(at - begin);
+	return type = TokenType::Error;
+}
+
+/**
+* @brief Records that the input ended in the middle of an item.
+*
+* When the input has been cut by DecoderLimits::maxInputLength, the limit is
+* reported instead.
+*/
+TokenType Reader::failAtEndOfInput() noexcept {
+	return fail(end == begin + inputLength ?
+		DecodingErrorCode::UnexpectedEndOfInput :
+		DecodingErrorCode::InputLengthLimitExceeded, end);
+}
+
+/**
+* @brief Updates the state after a value has been completely read.
+*/
+void Reader::finishValue() noexcept {
+	expectingKey = isInDict();
+}
+
+} // namespace bencoding
@@ -0,0 +1,138 @@
+/**
+* @file      Schema.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the Schema class.
+*/
+
+#include "Schema.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "Utils.h"
+
+namespace bencoding {
+
+/**
+* @brief Constructs a declared dictionary @a key whose value is described by
+*        the given @a schema.
+*/
+Schema::Field::Field(std::string key, std::shared_ptr<const Schema> schema,
+		bool required):
+	key(std::move(key)), schema(std::move(schema)), required(required) {}
+
+/**
+* @brief Constructs a schema of an item of the given @a type.
+*/
+Schema::Schema(Type type): type(type) {}
+
+/**
+* @brief Creates a schema of an item of any type.
+*
+* The item is decoded whole, including all its nested items.
+*/
+std::unique_ptr<Schema> Schema::any() {
+	return std::unique_ptr<Schema>(new Schema(Type::Any));
+}
+
+/**
+* @brief Creates a schema of an integer.
+*/
+std::unique_ptr<Schema> Schema::integer() {
+	return std::unique_ptr<Schema>(new Schema(Type::Integer));
+}
+
+/**
+* @brief Creates a schema of a string.
+*/
+std::unique_ptr<Schema> Schema::string() {
+	return std::unique_ptr<Schema>(new Schema(Type::String));
+}
+
+/**
+* @brief Creates a schema of a list whose items are described by the given
+*        schema.
+*/
+std::unique_ptr<Schema> Schema::list(std::shared_ptr<const Schema> items) {
+	assert(items && "the schema of the items has to be given");
+
+	std::unique_ptr<Schema> schema(new Schema(Type::List));
+	schema->items = std::move(items);
+	return schema;
+}
+
+/**
+* @brief Creates a schema of a dictionary with the given declared keys.
+*
+* Values of keys that are not declared are skipped when decoding. Declared
+* keys that are not required may be missing.
+*/
+std::unique_ptr<Schema> Schema::dictionary(std::vector<Field> fields) {
+	std::unique_ptr<Schema> schema(new Schema(Type::Dictionary));
+	std::sort(fields.begin(), fields.end(),
+		[](const Field &a, const Field &b) { return a.key < b.key; });
+	for (const auto &field : fields) {
+		assert(field.schema && "the schema of the value has to be given");
+		if (field.required) {
+			++schema->numOfRequiredFields;
+		}
+	}
+	schema->fields = std::move(fields);
+	return schema;
+}
+
+/**
+* @brief Returns the type of the described item.
+*/
+Schema::Type Schema::getType() const {
+	return type;
+}
+
+/**
+* @brief Returns the schema of items of the described list.
+*
+* @par Preconditions
+*  - the type is Type::List
+*/
+const Schema &Schema::getItems() const {
+	assert(type == Type::List && "the schema does not describe a list");
+
+	return *items;
+}
+
+/**
+* @brief Returns the declared keys of the described dictionary, sorted by the
+*        keys.
+*/
+const std::vector<Schema::Field> &Schema::getFields() const {
+	return fields;
+}
+
+/**
+* @brief Returns the index of the declared field with the given @a key (the
+*        number of fields when there is no such field).
+*
+* @param[in] key Dictionary key (not terminated by a null character).
+* @param[in] length Length of @a key.
+* @param[in] firstField Index of the field at which the search starts (it
+*                       wraps around).
+*/
+std::size_t Schema::findField(const char *key, std::size_t length,
+		std::size_t firstField) const {
+	return bencoding::findField(fields.data(), fields.size(), firstField, key,
+		length, [](const Field &field) {
+			return std::make_pair(field.key.data(), field.key.size());
+		});
+}
+
+/**
+* @brief Returns the number of declared keys of the described dictionary
+*        that are required.
+*/
+std::size_t Schema::getNumOfRequiredFields() const {
+	return numOfRequiredFields;
+}
+
+} // namespace bencoding
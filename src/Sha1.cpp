@@ -0,0 +1,150 @@
+/**
+* @file      Sha1.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the Sha1 class.
+*/
+
+#include "Sha1.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Rotates @a x left by @a n bits.
+*/
+inline uint32_t rotateLeft(uint32_t x, unsigned n) {
+	return (x << n) | (x >> (32 - n));
+}
+
+} // anonymous namespace
+
+// Definition of the constant (its declaration is in the header).
+const std::size_t Sha1::DIGEST_SIZE;
+
+/**
+* @brief Constructs a hasher of empty data.
+*/
+Sha1::Sha1() noexcept:
+	state{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0} {}
+
+/**
+* @brief Adds the given @a length bytes of @a data to the hashed data.
+*/
+void Sha1::update(const char *data, std::size_t length) noexcept {
+	auto bytes = reinterpret_cast<const unsigned char *>(data);
+	this->length += length;
+
+	if (bufferSize > 0) {
+		std::size_t count = std::min(length, sizeof(buffer) - bufferSize);
+		std::memcpy(buffer + bufferSize, bytes, count);
+		bufferSize += count;
+		bytes += count;
+		length -= count;
+		if (bufferSize < sizeof(buffer)) {
+			return;
+		}
+		processBlock(buffer);
+		bufferSize = 0;
+	}
+
+	for (; length >= sizeof(buffer); bytes += 64, length -= 64) {
+		processBlock(bytes);
+	}
+
+	std::memcpy(buffer, bytes, length);
+	bufferSize = length;
+}
+
+/**
+* @brief Adds the given @a data to the hashed data.
+*/
+void Sha1::update(const std::string &data) noexcept {
+	update(data.data(), data.size());
+}
+
+/**
+* @brief Returns the digest (#DIGEST_SIZE raw bytes) of the hashed data.
+*
+* The hasher must not be used after that.
+*/
+std::string Sha1::finish() {
+	uint64_t bitLength = length * 8;
+	static const char padding[64] = {'\x80'};
+	update(padding, 1 + (119 - bufferSize) % 64);
+	char encodedLength[8];
+	for (int i = 0; i < 8; ++i) {
+		encodedLength[i] = static_cast<char>(bitLength >> (56 - 8 * i));
+	}
+	update(encodedLength, sizeof(encodedLength));
+
+	std::string digest(DIGEST_SIZE, '\0');
+	for (std::size_t i = 0; i < DIGEST_SIZE; ++i) {
+		digest[i] = static_cast<char>(state[i / 4] >> (24 - 8 * (i % 4)));
+	}
+	return digest;
+}
+
+/**
+* @brief Returns the digest of the given @a data.
+*/
+std::string Sha1::hash(const std::string &data) {
+	Sha1 sha1;
+	sha1.update(data);
+	return sha1.finish();
+}
+
+/**
+* @brief Updates the state by the given 64-byte @a block.
+*/
+void Sha1::processBlock(const unsigned char *block) noexcept {
+	uint32_t w[80];
+	for (int i = 0; i < 16; ++i) {
+		w[i] = loadBigEndian32(block + 4 * i);
+	}
+	for (int i = 16; i < 80; ++i) {
+		w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+	}
+
+	uint32_t a = state[0];
+	uint32_t b = state[1];
+	uint32_t c = state[2];
+	uint32_t d = state[3];
+	uint32_t e = state[4];
+	for (int i = 0; i < 80; ++i) {
+		uint32_t f, k;
+		if (i < 20) {
+			f = (b & c) | (~b & d);
+			k = 0x5A827999;
+		} else if (i < 40) {
+			f = b ^ c ^ d;
+			k = 0x6ED9EBA1;
+		} else if (i < 60) {
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8F1BBCDC;
+		} else {
+			f = b ^ c ^ d;
+			k = 0xCA62C1D6;
+		}
+		uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+		e = d;
+		d = c;
+		c = rotateLeft(b, 30);
+		b = a;
+		a = temp;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
+
+} // namespace bencoding
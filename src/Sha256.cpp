@@ -0,0 +1,172 @@
+/**
+* @file      Sha256.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the Sha256 class.
+*/
+
+#include "Sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/// Round constants.
+const uint32_t K[64] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1,
+	0x923F82A4, 0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+	0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786,
+	0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147,
+	0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+	0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+	0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A,
+	0x5B9CCA4F, 0x682E6FF3, 0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+	0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/**
+* @brief Rotates @a x right by @a n bits.
+*/
+inline uint32_t rotateRight(uint32_t x, unsigned n) {
+	return (x >> n) | (x << (32 - n));
+}
+
+} // anonymous namespace
+
+// Definition of the constant (its declaration is in the header).
+const std::size_t Sha256::DIGEST_SIZE;
+
+/**
+* @brief Constructs a hasher of empty data.
+*/
+Sha256::Sha256() noexcept:
+	state{0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F,
+		0x9B05688C, 0x1F83D9AB, 0x5BE0CD19} {}
+
+/**
+* @brief Adds the given @a length bytes of @a data to the hashed data.
+*/
+void Sha256::update(const char *data, std::size_t length) noexcept {
+	auto bytes = reinterpret_cast<const unsigned char *>(data);
+	this->length += length;
+
+	if (bufferSize > 0) {
+		std::size_t count = std::min(length, sizeof(buffer) - bufferSize);
+		std::memcpy(buffer + bufferSize, bytes, count);
+		bufferSize += count;
+		bytes += count;
+		length -= count;
+		if (bufferSize < sizeof(buffer)) {
+			return;
+		}
+		processBlock(buffer);
+		bufferSize = 0;
+	}
+
+	for (; length >= sizeof(buffer); bytes += 64, length -= 64) {
+		processBlock(bytes);
+	}
+
+	std::memcpy(buffer, bytes, length);
+	bufferSize = length;
+}
+
+/**
+* @brief Adds the given @a data to the hashed data.
+*/
+void Sha256::update(const std::string &data) noexcept {
+	update(data.data(), data.size());
+}
+
+/**
+* @brief Returns the digest (#DIGEST_SIZE raw bytes) of the hashed data.
+*
+* The hasher must not be used after that.
+*/
+std::string Sha256::finish() {
+	uint64_t bitLength = length * 8;
+	static const char padding[64] = {'\x80'};
+	update(padding, 1 + (119 - bufferSize) % 64);
+	char encodedLength[8];
+	for (int i = 0; i < 8; ++i) {
+		encodedLength[i] = static_cast<char>(bitLength >> (56 - 8 * i));
+	}
+	update(encodedLength, sizeof(encodedLength));
+
+	std::string digest(DIGEST_SIZE, '\0');
+	for (std::size_t i = 0; i < DIGEST_SIZE; ++i) {
+		digest[i] = static_cast<char>(state[i / 4] >> (24 - 8 * (i % 4)));
+	}
+	return digest;
+}
+
+/**
+* @brief Returns the digest of the given @a data.
+*/
+std::string Sha256::hash(const std::string &data) {
+	Sha256 sha256;
+	sha256.update(data);
+	return sha256.finish();
+}
+
+/**
+* @brief Updates the state by the given 64-byte @a block.
+*/
+void Sha256::processBlock(const unsigned char *block) noexcept {
+	uint32_t w[64];
+	for (int i = 0; i < 16; ++i) {
+		w[i] = loadBigEndian32(block + 4 * i);
+	}
+	for (int i = 16; i < 64; ++i) {
+		uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^
+			(w[i - 15] >> 3);
+		uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^
+			(w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	uint32_t a = state[0];
+	uint32_t b = state[1];
+	uint32_t c = state[2];
+	uint32_t d = state[3];
+	uint32_t e = state[4];
+	uint32_t f = state[5];
+	uint32_t g = state[6];
+	uint32_t h = state[7];
+	for (int i = 0; i < 64; ++i) {
+		uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^
+			rotateRight(e, 25);
+		uint32_t ch = (e & f) ^ (~e & g);
+		uint32_t temp1 = h + s1 + ch + K[i] + w[i];
+		uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^
+			rotateRight(a, 22);
+		uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+		uint32_t temp2 = s0 + maj;
+		h = g;
+		g = f;
+		f = e;
+		e = d + temp1;
+		d = c;
+		c = b;
+		b = a;
+		a = temp1 + temp2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+} // namespace bencoding
@@ -0,0 +1,133 @@
+/**
+* @file      SourceMap.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the SourceMap class.
+*/
+
+#include "SourceMap.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BItemVisitor.h"
+#include "BList.h"
+#include "BString.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Visitor collecting the items directly inside lists and dictionaries
+*        (including dictionary keys).
+*/
+class NestedItemsCollector: public BItemVisitor {
+public:
+	explicit NestedItemsCollector(std::vector<BItem *> &items): items(items) {}
+
+	virtual void visit(BDictionary *bDictionary) override {
+		for (const auto &item : *bDictionary) {
+			items.push_back(item.first.get());
+			if (item.second) {
+				items.push_back(item.second.get());
+			}
+		}
+	}
+
+	virtual void visit(BInteger *) override {}
+
+	virtual void visit(BList *bList) override {
+		for (const auto &item : *bList) {
+			if (item) {
+				items.push_back(item.get());
+			}
+		}
+	}
+
+	virtual void visit(BString *) override {}
+
+private:
+	/// Collected items.
+	std::vector<BItem *> &items;
+};
+
+} // anonymous namespace
+
+/**
+* @brief Returns the number of characters in the span.
+*/
+std::size_t SourceSpan::length() const noexcept {
+	return end - begin;
+}
+
+/**
+* @brief Records that @a item was decoded from the characters in
+*        <tt>[begin, end)</tt>.
+*/
+void SourceMap::add(const BItem &item, std::size_t begin, std::size_t end) {
+	SourceSpan span;
+	span.begin = begin;
+	span.end = end;
+	spans[&item] = span;
+}
+
+/**
+* @brief Removes the spans of @a item and of all the items inside it.
+*
+* This has to be done before the item is destroyed because another item may
+* later be allocated at the same address. Nested items are visited without
+* recursion.
+*/
+void SourceMap::remove(BItem &item) {
+	if (spans.empty()) {
+		return;
+	}
+
+	std::vector<BItem *> items(1, &item);
+	NestedItemsCollector collector(items);
+	while (!items.empty()) {
+		BItem *current = items.back();
+		items.pop_back();
+		spans.erase(current);
+		current->accept(&collector);
+	}
+}
+
+/**
+* @brief Checks if the span of @a item has been recorded.
+*/
+bool SourceMap::contains(const BItem &item) const {
+	return spans.find(&item) != spans.end();
+}
+
+/**
+* @brief Returns the span of @a item.
+*
+* @throws std::out_of_range When the span of @a item has not been recorded.
+*/
+SourceSpan SourceMap::getSpan(const BItem &item) const {
+	auto i = spans.find(&item);
+	if (i == spans.end()) {
+		throw std::out_of_range("no span has been recorded for the item");
+	}
+	return i->second;
+}
+
+/**
+* @brief Returns the number of recorded spans.
+*/
+std::size_t SourceMap::size() const {
+	return spans.size();
+}
+
+/**
+* @brief Checks if no span has been recorded.
+*/
+bool SourceMap::empty() const {
+	return spans.empty();
+}
+
+} // namespace bencoding
@@ -0,0 +1,259 @@
+/**
+* @file      ThreadPool.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the ThreadPool class.
+*/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Returns a range of tasks packed into a single integer.
+*/
+std::uint64_t packRange(std::size_t begin, std::size_t end) {
+	return (std::uint64_t{begin} << 32) | end;
+}
+
+/**
+* @brief Returns the first task of a packed range.
+*/
+std::size_t rangeBegin(std::uint64_t range) {
+	return range >> 32;
+}
+
+/**
+* @brief Returns the end of a packed range.
+*/
+std::size_t rangeEnd(std::uint64_t range) {
+	return range & 0xffffffff;
+}
+
+} // anonymous namespace
+
+// Static constants.
+const std::size_t ThreadPool::MAX_TASKS_PER_BATCH;
+
+/**
+* @brief Constructs a pool with the given number of threads (including the
+*        thread calling run()).
+*/
+ThreadPool::ThreadPool(std::size_t numOfThreads):
+		ranges(new std::atomic<PackedRange>[numOfThreads]) {
+	for (std::size_t i = 0; i < numOfThreads; ++i) {
+		ranges[i] = packRange(0, 0);
+	}
+	for (std::size_t i = 1; i < numOfThreads; ++i) {
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+/**
+* @brief Creates a new pool.
+*
+* @param[in] numOfThreads Number of threads to be used. When it is zero, the
+*                         number of hardware threads is used.
+*/
+std::unique_ptr<ThreadPool> ThreadPool::create(std::size_t numOfThreads) {
+	if (numOfThreads == 0) {
+		numOfThreads = std::thread::hardware_concurrency();
+	}
+	if (numOfThreads == 0) {
+		// The number of hardware threads is not computable or well defined.
+		numOfThreads = 1;
+	}
+	return std::unique_ptr<ThreadPool>(new ThreadPool(numOfThreads));
+}
+
+/**
+* @brief Stops and joins all the worker threads.
+*/
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	batchStarted.notify_all();
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+/**
+* @brief Returns the number of threads used by the pool (including the thread
+*        calling run()).
+*/
+std::size_t ThreadPool::numOfThreads() const {
+	return workers.size() + 1;
+}
+
+/**
+* @brief Runs @a task for every index from <tt>[0, numOfTasks)</tt> and waits
+*        until all of them finish.
+*
+* The tasks are run in an unspecified order and in parallel. If a task throws
+* an exception, the remaining tasks are still run and the first exception
+* that reaches the pool is rethrown from this function.
+*
+* @a task must not call run() of the same pool.
+*/
+void ThreadPool::run(std::size_t numOfTasks, const Task &task) {
+	runWithThreadIndexes(numOfTasks, [&task](std::size_t taskIndex,
+			std::size_t) {
+		task(taskIndex);
+	});
+}
+
+/**
+* @brief Runs @a task for every index from <tt>[0, numOfTasks)</tt> and waits
+*        until all of them finish, passing it also the index of the thread
+*        that runs it.
+*
+* No two tasks with the same thread index run at the same time, so the index
+* can be used to select per-thread state (e.g. a buffer that is reused by all
+* the tasks run by the thread). The calling thread has index zero. Otherwise,
+* it behaves like run().
+*/
+void ThreadPool::runWithThreadIndexes(std::size_t numOfTasks,
+		const ThreadTask &task) {
+	std::lock_guard<std::mutex> runLock(runMutex);
+	exception = nullptr;
+	for (std::size_t first = 0; first < numOfTasks;
+			first += MAX_TASKS_PER_BATCH) {
+		runBatch(first, std::min(numOfTasks - first, MAX_TASKS_PER_BATCH),
+			task);
+	}
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+/**
+* @brief Runs a single batch of @a numOfTasks tasks, starting with the task
+*        with index @a firstTask.
+*
+* Every thread gets an equally long range of the tasks.
+*/
+void ThreadPool::runBatch(std::size_t firstTask, std::size_t numOfTasks,
+		const ThreadTask &task) {
+	std::unique_lock<std::mutex> lock(mutex);
+	auto n = numOfThreads();
+	for (std::size_t i = 0; i < n; ++i) {
+		ranges[i] = packRange(numOfTasks * i / n, numOfTasks * (i + 1) / n);
+	}
+	currentTask = &task;
+	this->firstTask = firstTask;
+	numOfUnfinishedTasks = numOfTasks;
+	++batchId;
+	batchStarted.notify_all();
+
+	runTasksOfCurrentBatch(lock, 0);
+	batchFinished.wait(lock, [this]() {
+		return numOfUnfinishedTasks == 0 && numOfActiveThreads == 0;
+	});
+	currentTask = nullptr;
+}
+
+/**
+* @brief Runs tasks of the current batch in the thread with the given index
+*        until there is no task left.
+*
+* @a lock has to be locked. It is unlocked when tasks are running.
+*/
+void ThreadPool::runTasksOfCurrentBatch(std::unique_lock<std::mutex> &lock,
+		std::size_t threadIndex) {
+	if (!currentTask) {
+		return;
+	}
+	const ThreadTask &task = *currentTask;
+	std::size_t first = firstTask;
+	++numOfActiveThreads;
+	lock.unlock();
+
+	std::size_t numOfFinishedTasks = 0;
+	std::exception_ptr taskException;
+	std::size_t taskIndex;
+	while (takeTask(threadIndex, taskIndex)) {
+		try {
+			task(first + taskIndex, threadIndex);
+		} catch (...) {
+			if (!taskException) {
+				taskException = std::current_exception();
+			}
+		}
+		++numOfFinishedTasks;
+	}
+
+	lock.lock();
+	if (taskException && !exception) {
+		exception = taskException;
+	}
+	numOfUnfinishedTasks -= numOfFinishedTasks;
+	if (--numOfActiveThreads == 0) {
+		batchFinished.notify_all();
+	}
+}
+
+/**
+* @brief Takes a task of the current batch for the thread with the given
+*        index.
+*
+* The task is taken from the beginning of the range of the thread. When the
+* range is empty, the second half of the range of another thread is stolen.
+*
+* @return @c false if there is no task left, @c true otherwise.
+*/
+bool ThreadPool::takeTask(std::size_t threadIndex, std::size_t &taskIndex) {
+	auto &ownRange = ranges[threadIndex];
+	auto range = ownRange.load();
+	while (rangeBegin(range) < rangeEnd(range)) {
+		if (ownRange.compare_exchange_weak(range,
+				packRange(rangeBegin(range) + 1, rangeEnd(range)))) {
+			taskIndex = rangeBegin(range);
+			return true;
+		}
+	}
+
+	auto n = numOfThreads();
+	for (std::size_t i = 1; i < n; ++i) {
+		auto &victimRange = ranges[(threadIndex + i) % n];
+		range = victimRange.load();
+		while (rangeBegin(range) < rangeEnd(range)) {
+			auto middle = rangeBegin(range) +
+				(rangeEnd(range) - rangeBegin(range)) / 2;
+			if (victimRange.compare_exchange_weak(range,
+					packRange(rangeBegin(range), middle))) {
+				// The own range is empty, so no other thread modifies it.
+				ownRange = packRange(middle + 1, rangeEnd(range));
+				taskIndex = middle;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+* @brief Main function of worker threads.
+*/
+void ThreadPool::workerLoop(std::size_t threadIndex) {
+	std::size_t lastBatchId = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		batchStarted.wait(lock, [this, &lastBatchId]() {
+			return stopping || batchId != lastBatchId;
+		});
+		if (stopping) {
+			return;
+		}
+		lastBatchId = batchId;
+		runTasksOfCurrentBatch(lock, threadIndex);
+	}
+}
+
+} // namespace bencoding
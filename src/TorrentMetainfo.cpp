@@ -0,0 +1,339 @@
+/**
+* @file      TorrentMetainfo.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the TorrentMetainfo class.
+*/
+
+#include "TorrentMetainfo.h"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "BString.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Returns the value of the given @a key in @a dict (@c nullptr when
+*        there is no such key).
+*
+* A pointer to the stored value is returned so that no reference counts are
+* changed.
+*/
+const std::shared_ptr<BItem> *findValue(const BDictionary &dict,
+		const char *key) {
+	for (const auto &item : dict) {
+		if (item.first->value() == key) {
+			return &item.second;
+		}
+	}
+	return nullptr;
+}
+
+/**
+* @brief Returns the value of the given @a key in @a dict, which has to be of
+*        type @a T.
+*
+* @param[in] dict Dictionary.
+* @param[in] key Key whose value is returned.
+* @param[in] where Description of @a dict for error messages.
+*
+* @throws InvalidMetainfoError When there is no such key or when its value is
+*                              of another type.
+*/
+template<typename T>
+std::shared_ptr<T> getRequired(const BDictionary &dict, const char *key,
+		const char *where) {
+	auto value = findValue(dict, key);
+	if (!value || !*value) {
+		throw InvalidMetainfoError(
+			std::string("missing key \"") + key + "\" in " + where
+		);
+	}
+	auto typedValue = (*value)->as<T>();
+	if (!typedValue) {
+		throw InvalidMetainfoError(
+			std::string("key \"") + key + "\" in " + where +
+				" has a value of unexpected type"
+		);
+	}
+	return typedValue;
+}
+
+/**
+* @brief Returns @a total increased by the given file @a length.
+*
+* @throws InvalidMetainfoError When @a length is negative or when the sum
+*                              overflows.
+*/
+BInteger::ValueType addLength(BInteger::ValueType total,
+		BInteger::ValueType length) {
+	if (length < 0) {
+		throw InvalidMetainfoError("file length is negative");
+	} else if (total > std::numeric_limits<BInteger::ValueType>::max() -
+			length) {
+		throw InvalidMetainfoError("total length of files is out of range");
+	}
+	return total + length;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs the exception with the given message.
+*
+* @param[in] what Message to be returned by @c what().
+*/
+InvalidMetainfoError::InvalidMetainfoError(const std::string &what):
+	std::runtime_error(what) {}
+
+// Static constants.
+const std::size_t TorrentMetainfo::PIECE_HASH_SIZE;
+
+/**
+* @brief Constructs an iterator pointing to the file with the given @a index.
+*/
+TorrentMetainfo::FileRange::const_iterator::const_iterator(
+	const TorrentMetainfo *metainfo, std::size_t index):
+		metainfo(metainfo), index(index) {}
+
+/**
+* @brief Returns the current file.
+*/
+TorrentMetainfo::File TorrentMetainfo::FileRange::const_iterator::operator*()
+		const {
+	return metainfo->fileEntries[index];
+}
+
+/**
+* @brief Moves to the next file.
+*/
+TorrentMetainfo::FileRange::const_iterator &
+		TorrentMetainfo::FileRange::const_iterator::operator++() {
+	++index;
+	return *this;
+}
+
+/**
+* @brief Checks if both iterators point to the same file.
+*/
+bool TorrentMetainfo::FileRange::const_iterator::operator==(
+		const const_iterator &other) const {
+	return index == other.index;
+}
+
+/**
+* @brief Checks if the iterators point to different files.
+*/
+bool TorrentMetainfo::FileRange::const_iterator::operator!=(
+		const const_iterator &other) const {
+	return !(*this == other);
+}
+
+/**
+* @brief Constructs a range of the files of the given torrent.
+*/
+TorrentMetainfo::FileRange::FileRange(const TorrentMetainfo *metainfo):
+	metainfo(metainfo) {}
+
+/**
+* @brief Returns the number of files.
+*/
+std::size_t TorrentMetainfo::FileRange::size() const {
+	return metainfo->fileEntries.size();
+}
+
+/**
+* @brief Returns an iterator to the first file.
+*/
+TorrentMetainfo::FileRange::const_iterator
+		TorrentMetainfo::FileRange::begin() const {
+	return const_iterator(metainfo, 0);
+}
+
+/**
+* @brief Returns an iterator past the last file.
+*/
+TorrentMetainfo::FileRange::const_iterator
+		TorrentMetainfo::FileRange::end() const {
+	return const_iterator(metainfo, size());
+}
+
+/**
+* @brief Validates the given @a torrent and constructs a view of it.
+*
+* @throws InvalidMetainfoError When the torrent is not valid.
+*/
+TorrentMetainfo::TorrentMetainfo(std::shared_ptr<BDictionary> torrent):
+		torrent(std::move(torrent)) {
+	info = getRequired<BDictionary>(*this->torrent, "info", "the torrent");
+	const char *where = "the info dictionary";
+	nameValue = &getRequired<BString>(*info, "name", where)->value();
+	pieceLengthValue = getRequired<BInteger>(
+		*info, "piece length", where)->value();
+	if (pieceLengthValue <= 0) {
+		throw InvalidMetainfoError("piece length is not positive");
+	}
+	pieces = &getRequired<BString>(*info, "pieces", where)->value();
+	if (pieces->size() % PIECE_HASH_SIZE != 0) {
+		throw InvalidMetainfoError(
+			"length of pieces is not a multiple of the hash size"
+		);
+	}
+
+	if (findValue(*info, "files")) {
+		fileList = getRequired<BList>(*info, "files", where);
+		for (const auto &item : *fileList) {
+			auto file = item ? item->as<BDictionary>() : nullptr;
+			if (!file) {
+				throw InvalidMetainfoError("file is not a dictionary");
+			}
+			totalLengthValue = addLength(totalLengthValue,
+				getRequired<BInteger>(*file, "length", "a file")->value());
+			auto path = getRequired<BList>(*file, "path", "a file");
+			if (path->empty()) {
+				throw InvalidMetainfoError("path of a file is empty");
+			}
+			for (const auto &component : *path) {
+				if (!component || !component->as<BString>()) {
+					throw InvalidMetainfoError(
+						"path of a file contains an item that is not a string"
+					);
+				}
+			}
+		}
+	} else {
+		totalLengthValue = addLength(0,
+			getRequired<BInteger>(*info, "length", where)->value());
+	}
+
+	auto expectedPieceCount = totalLengthValue / pieceLengthValue +
+		(totalLengthValue % pieceLengthValue != 0 ? 1 : 0);
+	if (static_cast<std::uint64_t>(expectedPieceCount) != pieceCount()) {
+		throw InvalidMetainfoError(
+			"number of pieces does not match the total length of files"
+		);
+	}
+}
+
+/**
+* @brief Records the length, offset, and path of every file.
+*
+* The files have been validated by the constructor.
+*/
+void TorrentMetainfo::recordFiles() const {
+	if (!fileList) {
+		fileEntries.push_back(File{totalLengthValue, 0, nullptr});
+		return;
+	}
+
+	fileEntries.reserve(fileList->size());
+	BInteger::ValueType offset = 0;
+	for (const auto &item : *fileList) {
+		const auto &file = static_cast<const BDictionary &>(*item);
+		auto length = static_cast<const BInteger &>(
+			**findValue(file, "length")).value();
+		const auto &path = static_cast<const BList &>(**findValue(file, "path"));
+		fileEntries.push_back(File{length, offset, &path});
+		offset += length;
+	}
+}
+
+/**
+* @brief Creates a view of the given decoded @a torrent.
+*
+* @throws InvalidMetainfoError When @a torrent is not a valid torrent file.
+*
+* The following structure is required (see <a
+* href="http://bittorrent.org/beps/bep_0003.html">BEP 3</a>): an @c info
+* dictionary with a string @c name, a positive integer @c piece @c length, a
+* string @c pieces of 20-byte hashes, and either an integer @c length or a
+* list @c files of dictionaries with an integer @c length and a non-empty list
+* @c path of strings. Lengths must not be negative and the number of pieces has
+* to match the total length. Other keys are ignored.
+*/
+std::unique_ptr<TorrentMetainfo> TorrentMetainfo::create(
+		std::shared_ptr<BItem> torrent) {
+	auto dict = torrent ? torrent->as<BDictionary>() : nullptr;
+	if (!dict) {
+		throw InvalidMetainfoError("torrent is not a dictionary");
+	}
+	return std::unique_ptr<TorrentMetainfo>(
+		new TorrentMetainfo(std::move(dict)));
+}
+
+/**
+* @brief Returns the name of the torrent (the file name in single-file
+*        torrents, the directory name in multi-file torrents).
+*/
+const std::string &TorrentMetainfo::name() const {
+	return *nameValue;
+}
+
+/**
+* @brief Returns the length of a piece (in bytes).
+*/
+BInteger::ValueType TorrentMetainfo::pieceLength() const {
+	return pieceLengthValue;
+}
+
+/**
+* @brief Returns the sum of the lengths of all the files (in bytes).
+*/
+BInteger::ValueType TorrentMetainfo::totalLength() const {
+	return totalLengthValue;
+}
+
+/**
+* @brief Returns the number of pieces.
+*/
+std::size_t TorrentMetainfo::pieceCount() const {
+	return pieces->size() / PIECE_HASH_SIZE;
+}
+
+/**
+* @brief Returns the SHA-1 hash of the piece with the given @a index.
+*
+* @return Pointer to the @c PIECE_HASH_SIZE bytes of the hash inside the @c
+*         pieces string (not terminated by a null character).
+*
+* @par Preconditions
+*  - <tt>index < pieceCount()</tt>
+*/
+const char *TorrentMetainfo::pieceHash(std::size_t index) const {
+	assert(index < pieceCount() && "piece index out of range");
+
+	return pieces->data() + index * PIECE_HASH_SIZE;
+}
+
+/**
+* @brief Checks if the torrent has a single file (there is no @c files key).
+*/
+bool TorrentMetainfo::isSingleFile() const {
+	return !fileList;
+}
+
+/**
+* @brief Returns the range of the files of the torrent.
+*
+* The files are recorded when this function is called for the first time, so
+* torrents whose files are never asked for do not pay for them.
+*/
+TorrentMetainfo::FileRange TorrentMetainfo::files() const {
+	std::call_once(fileEntriesFlag, [this]() { recordFiles(); });
+	return FileRange(this);
+}
+
+/**
+* @brief Returns the @c info dictionary.
+*/
+std::shared_ptr<BDictionary> TorrentMetainfo::infoDictionary() const {
+	return info;
+}
+
+} // namespace bencoding
@@ -0,0 +1,468 @@
+/**
+* @file      TorrentV2Index.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the TorrentV2Index class.
+*/
+
+#include "TorrentV2Index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "Reader.h"
+#include "Utils.h"
+
+namespace bencoding {
+
+namespace {
+
+/**
+* @brief Checks if the current string token of @a reader is equal to the
+*        given @a key (a string literal).
+*/
+template<std::size_t N>
+bool isKey(const Reader &reader, const char (&key)[N]) {
+	return reader.stringLength() == N - 1 &&
+		std::memcmp(reader.stringData(), key, N - 1) == 0;
+}
+
+/**
+* @brief Returns the first eight bytes of the given Merkle @a root as a
+*        big-endian number.
+*/
+std::uint64_t getRootPrefix(const char *root) {
+	auto bytes = reinterpret_cast<const unsigned char *>(root);
+	return (static_cast<std::uint64_t>(loadBigEndian32(bytes)) << 32) |
+		loadBigEndian32(bytes + 4);
+}
+
+/**
+* @brief Checks if the Merkle root @a a with the given @a aPrefix is smaller
+*        than the Merkle root @a b with the given @a bPrefix.
+*/
+bool isSmallerRoot(std::uint64_t aPrefix, const char *a,
+		std::uint64_t bPrefix, const char *b) {
+	const std::size_t prefixSize = sizeof(aPrefix);
+	return aPrefix != bPrefix ? aPrefix < bPrefix :
+		std::memcmp(a + prefixSize, b + prefixSize,
+			TorrentV2Index::HASH_SIZE - prefixSize) < 0;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Builder of the index from an encoded torrent.
+*/
+class TorrentV2Index::Parser {
+public:
+	Parser(TorrentV2Index &index, const char *data, std::size_t length);
+
+	void parse();
+
+private:
+	void parseInfo();
+	void parseFileTree();
+	void parseFileProperties(std::size_t node);
+	void parsePieceLayers();
+	void skipValue();
+	BInteger::ValueType readInteger();
+	void expect(TokenType expected);
+	[[noreturn]] void failAtReaderError() const;
+	[[noreturn]] void fail(const std::string &message) const;
+
+private:
+	/// The built index.
+	TorrentV2Index &index;
+
+	/// Reader of the torrent.
+	Reader reader;
+
+	/// Length of the torrent.
+	std::size_t length;
+
+	/// Piece layers read so far.
+	std::vector<RootLayer> layers;
+};
+
+/**
+* @brief Constructs a builder of the given @a index from the given @a length
+*        characters of @a data.
+*/
+TorrentV2Index::Parser::Parser(TorrentV2Index &index, const char *data,
+	std::size_t length): index(index), reader(data, length), length(length) {}
+
+/**
+* @brief Reads the whole torrent into the index.
+*/
+void TorrentV2Index::Parser::parse() {
+	expect(TokenType::DictBegin);
+	bool hasInfo = false;
+	for (TokenType type; (type = reader.next()) != TokenType::End; ) {
+		if (type == TokenType::Error) {
+			failAtReaderError();
+		} else if (isKey(reader, "info")) {
+			parseInfo();
+			hasInfo = true;
+		} else if (isKey(reader, "piece layers")) {
+			parsePieceLayers();
+		} else {
+			skipValue();
+		}
+	}
+	if (reader.offset() != length) {
+		fail(DecodingResult(DecodingErrorCode::UndecodedCharacters,
+			reader.offset()).message());
+	} else if (!hasInfo) {
+		fail("missing key \"info\" in the torrent");
+	}
+	index.setPieceLayers(std::move(layers));
+}
+
+/**
+* @brief Reads the @c info dictionary.
+*/
+void TorrentV2Index::Parser::parseInfo() {
+	expect(TokenType::DictBegin);
+	bool hasFileTree = false;
+	BInteger::ValueType metaVersion = 0;
+	for (TokenType type; (type = reader.next()) != TokenType::End; ) {
+		if (type == TokenType::Error) {
+			failAtReaderError();
+		} else if (isKey(reader, "file tree")) {
+			parseFileTree();
+			hasFileTree = true;
+		} else if (isKey(reader, "meta version")) {
+			metaVersion = readInteger();
+		} else if (isKey(reader, "piece length")) {
+			index.pieceLengthValue = readInteger();
+		} else {
+			skipValue();
+		}
+	}
+	if (metaVersion != 2) {
+		fail("meta version is not 2");
+	} else if (index.pieceLengthValue <= 0) {
+		fail("piece length is missing or not positive");
+	} else if (!hasFileTree) {
+		fail("missing key \"file tree\" in the info dictionary");
+	}
+}
+
+/**
+* @brief Reads the @c file @c tree dictionary.
+*
+* Directories are tracked by an explicit stack, so arbitrarily deep trees
+* are read without recursion.
+*/
+void TorrentV2Index::Parser::parseFileTree() {
+	expect(TokenType::DictBegin);
+	// For every open dictionary, the index of its name (NO_PARENT for the
+	// file tree itself).
+	std::vector<std::size_t> openNodes(1, NO_PARENT);
+	while (!openNodes.empty()) {
+		TokenType type = reader.next();
+		if (type == TokenType::End) {
+			openNodes.pop_back();
+			continue;
+		} else if (type == TokenType::Error) {
+			failAtReaderError();
+		}
+
+		if (reader.stringLength() == 0) {
+			// The properties of the file named by the open dictionary.
+			if (openNodes.back() == NO_PARENT) {
+				fail("file tree contains a file without a name");
+			}
+			parseFileProperties(openNodes.back());
+			continue;
+		}
+
+		index.nodes.push_back(Node{reader.stringData(), reader.stringLength(),
+			openNodes.back()});
+		expect(TokenType::DictBegin);
+		openNodes.push_back(index.nodes.size() - 1);
+	}
+}
+
+/**
+* @brief Reads the properties of the file with the given name @a node.
+*/
+void TorrentV2Index::Parser::parseFileProperties(std::size_t node) {
+	expect(TokenType::DictBegin);
+	File file{node, -1, nullptr};
+	for (TokenType type; (type = reader.next()) != TokenType::End; ) {
+		if (type == TokenType::Error) {
+			failAtReaderError();
+		} else if (isKey(reader, "length")) {
+			file.length = readInteger();
+			if (file.length < 0) {
+				fail("file length is negative");
+			}
+		} else if (isKey(reader, "pieces root")) {
+			expect(TokenType::String);
+			if (reader.stringLength() != HASH_SIZE) {
+				fail("pieces root is not 32 bytes long");
+			}
+			file.piecesRoot = reader.stringData();
+		} else {
+			skipValue();
+		}
+	}
+	if (file.length < 0) {
+		fail("missing key \"length\" of a file");
+	} else if (file.length > 0 && !file.piecesRoot) {
+		fail("missing key \"pieces root\" of a non-empty file");
+	}
+	index.fileList.push_back(file);
+}
+
+/**
+* @brief Reads the @c piece @c layers dictionary.
+*/
+void TorrentV2Index::Parser::parsePieceLayers() {
+	expect(TokenType::DictBegin);
+	for (TokenType type; (type = reader.next()) != TokenType::End; ) {
+		if (type == TokenType::Error) {
+			failAtReaderError();
+		} else if (reader.stringLength() != HASH_SIZE) {
+			fail("key of piece layers is not 32 bytes long");
+		}
+
+		const char *root = reader.stringData();
+		expect(TokenType::String);
+		if (reader.stringLength() % HASH_SIZE != 0) {
+			fail("length of a piece layer is not a multiple of 32");
+		}
+		layers.push_back(RootLayer{getRootPrefix(root), root,
+			PieceLayer{reader.stringData(), reader.stringLength() / HASH_SIZE}});
+	}
+}
+
+/**
+* @brief Skips the value of the current key.
+*/
+void TorrentV2Index::Parser::skipValue() {
+	TokenType type = reader.next();
+	if (type == TokenType::EndOfInput) {
+		fail(DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+			reader.offset()).message());
+	} else if (!reader.skip()) {
+		failAtReaderError();
+	}
+}
+
+/**
+* @brief Reads an integer.
+*/
+BInteger::ValueType TorrentV2Index::Parser::readInteger() {
+	expect(TokenType::Integer);
+	return reader.integer();
+}
+
+/**
+* @brief Reads the next token and checks that it is of the @a expected type.
+*/
+void TorrentV2Index::Parser::expect(TokenType expected) {
+	TokenType type = reader.next();
+	if (type == TokenType::Error) {
+		failAtReaderError();
+	} else if (type == TokenType::EndOfInput) {
+		fail(DecodingResult(DecodingErrorCode::UnexpectedEndOfInput,
+			reader.offset()).message());
+	} else if (type != expected) {
+		fail(DecodingResult(DecodingErrorCode::UnexpectedType,
+			reader.tokenBegin()).message());
+	}
+}
+
+/**
+* @brief Throws an exception describing the error of the reader.
+*/
+void TorrentV2Index::Parser::failAtReaderError() const {
+	fail(DecodingResult(reader.error(), reader.errorOffset()).message());
+}
+
+/**
+* @brief Throws an exception with the given @a message.
+*/
+void TorrentV2Index::Parser::fail(const std::string &message) const {
+	throw InvalidMetainfoError(message);
+}
+
+// Static constants.
+const std::size_t TorrentV2Index::HASH_SIZE;
+const std::size_t TorrentV2Index::NO_PARENT;
+
+/**
+* @brief Checks if the layer has been found.
+*/
+bool TorrentV2Index::PieceLayer::found() const {
+	return hashes != nullptr;
+}
+
+/**
+* @brief Returns the hash with the given @a index (@c HASH_SIZE bytes).
+*
+* @par Preconditions
+*  - <tt>index < numOfHashes</tt>
+*/
+const char *TorrentV2Index::PieceLayer::hash(std::size_t index) const {
+	assert(index < numOfHashes && "hash index out of range");
+
+	return hashes + index * HASH_SIZE;
+}
+
+/**
+* @brief Constructs an empty index.
+*/
+TorrentV2Index::TorrentV2Index() = default;
+
+/**
+* @brief Creates an index of the given encoded torrent.
+*
+* See create(const char *, std::size_t) for more details.
+*/
+std::unique_ptr<TorrentV2Index> TorrentV2Index::create(
+		const std::string &data) {
+	return create(data.data(), data.size());
+}
+
+/**
+* @brief Creates an index of the given @a length characters of an encoded
+*        torrent.
+*
+* @throws InvalidMetainfoError When the data are not valid or when the
+*                              torrent is not a valid v2 torrent.
+*
+* Besides the grammar, the following is checked: the @c info dictionary has
+* @c meta @c version 2, a positive @c piece @c length, and a @c file @c tree;
+* every file has a non-negative @c length and, unless it is empty, a 32-byte
+* @c pieces @c root; keys of @c piece @c layers are 32 bytes long and their
+* values consist of 32-byte hashes. Other keys are skipped. The index points
+* into @a data, so @a data have to outlive it.
+*/
+std::unique_ptr<TorrentV2Index> TorrentV2Index::create(const char *data,
+		std::size_t length) {
+	std::unique_ptr<TorrentV2Index> index(new TorrentV2Index());
+	Parser(*index, data, length).parse();
+	return index;
+}
+
+/**
+* @brief Returns the length of a piece (in bytes).
+*/
+BInteger::ValueType TorrentV2Index::pieceLength() const {
+	return pieceLengthValue;
+}
+
+/**
+* @brief Returns all the files in the order in which they appear in the file
+*        tree (sorted by their paths).
+*/
+const std::vector<TorrentV2Index::File> &TorrentV2Index::files() const {
+	return fileList;
+}
+
+/**
+* @brief Returns the name with the given @a index.
+*
+* @par Preconditions
+*  - @a index is a valid index of a name (e.g. File::node or Node::parent
+*    other than @c NO_PARENT)
+*/
+const TorrentV2Index::Node &TorrentV2Index::node(std::size_t index) const {
+	assert(index < nodes.size() && "node index out of range");
+
+	return nodes[index];
+}
+
+/**
+* @brief Returns the path of the given @a file, whose components are
+*        separated by @a separator.
+*/
+std::string TorrentV2Index::path(const File &file, char separator) const {
+	std::vector<const Node *> components;
+	for (std::size_t i = file.node; i != NO_PARENT; i = nodes[i].parent) {
+		components.push_back(&nodes[i]);
+	}
+
+	std::string path;
+	for (auto it = components.rbegin(); it != components.rend(); ++it) {
+		if (!path.empty()) {
+			path += separator;
+		}
+		path.append((*it)->name, (*it)->nameLength);
+	}
+	return path;
+}
+
+/**
+* @brief Returns the number of piece layers.
+*/
+std::size_t TorrentV2Index::numOfPieceLayers() const {
+	return pieceLayers.size();
+}
+
+/**
+* @brief Returns the piece layer of the file with the given Merkle root
+*        (@c HASH_SIZE bytes).
+*
+* When there is no such layer, the returned layer is not found() (e.g. for
+* files that are not larger than a piece, which have no layers).
+*/
+TorrentV2Index::PieceLayer TorrentV2Index::pieceLayer(
+		const char *piecesRoot) const {
+	RootLayer searched{getRootPrefix(piecesRoot), piecesRoot,
+		PieceLayer{nullptr, 0}};
+	auto it = std::lower_bound(pieceLayers.begin(), pieceLayers.end(),
+		searched, isSmallerLayer);
+	if (it == pieceLayers.end() || isSmallerLayer(searched, *it)) {
+		return PieceLayer{nullptr, 0};
+	}
+	return it->layer;
+}
+
+/**
+* @brief Returns the piece layer of the given @a file.
+*
+* See pieceLayer(const char *) for more details.
+*/
+TorrentV2Index::PieceLayer TorrentV2Index::pieceLayer(const File &file) const {
+	return file.piecesRoot ? pieceLayer(file.piecesRoot) :
+		PieceLayer{nullptr, 0};
+}
+
+/**
+* @brief Checks if the root of layer @a a is smaller than the root of layer @a
+*        b.
+*/
+bool TorrentV2Index::isSmallerLayer(const RootLayer &a, const RootLayer &b) {
+	return isSmallerRoot(a.prefix, a.root, b.prefix, b.root);
+}
+
+/**
+* @brief Sorts the given @a layers by their roots and stores them.
+*
+* When a root is in @a layers more than once, its last layer is used.
+*/
+void TorrentV2Index::setPieceLayers(std::vector<RootLayer> layers) {
+	std::stable_sort(layers.begin(), layers.end(), isSmallerLayer);
+
+	// The sort is stable, so the last of equal roots is the last one given.
+	std::size_t numOfLayers = 0;
+	for (const auto &layer : layers) {
+		if (numOfLayers > 0 && !isSmallerLayer(layers[numOfLayers - 1], layer)) {
+			layers[numOfLayers - 1] = layer;
+		} else {
+			layers[numOfLayers++] = layer;
+		}
+	}
+	layers.resize(numOfLayers);
+	pieceLayers = std::move(layers);
+}
+
+} // namespace bencoding
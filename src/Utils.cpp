@@ -7,8 +7,111 @@
 
 #include "Utils.h"
 
+#include <cstring>
+
 namespace bencoding {
 
+namespace {
+
+/// A byte with the value one in every byte of a 64b word.
+const uint64_t ONES = 0x0101010101010101ULL;
+
+/// Mask of the highest bit of every byte in a 64b word.
+const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+/**
+* @brief Loads eight bytes starting at @a p into a word.
+*/
+uint64_t loadWord(const unsigned char *p) {
+	uint64_t word;
+	std::memcpy(&word, p, sizeof(word));
+	return word;
+}
+
+/**
+* @brief Returns the value of the given hexadecimal digit, or -1 if @a c is not
+*        a hexadecimal digit.
+*/
+int getHexDigitValue(char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	} else if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+/**
+* @brief Returns the value of the given base64 digit, or -1 if @a c is not a
+*        base64 digit.
+*/
+int getBase64DigitValue(char c) {
+	if (c >= 'A' && c <= 'Z') {
+		return c - 'A';
+	} else if (c >= 'a' && c <= 'z') {
+		return c - 'a' + 26;
+	} else if (c >= '0' && c <= '9') {
+		return c - '0' + 52;
+	} else if (c == '+') {
+		return 62;
+	} else if (c == '/') {
+		return 63;
+	}
+	return -1;
+}
+
+/**
+* @brief Checks if any byte of @a word is zero.
+*/
+bool hasZeroByte(uint64_t word) {
+	return ((word - ONES) & ~word & HIGH_BITS) != 0;
+}
+
+/**
+* @brief Checks if any byte of @a word is a character that has to be escaped
+*        in a JSON string.
+*
+* These are control characters (below 0x20), quotes, and backslashes. Bytes
+* above 0x7F are not reported.
+*/
+bool hasCharToEscapeInJson(uint64_t word) {
+	bool hasControlChar = ((word - ONES * 0x20) & ~word & HIGH_BITS) != 0;
+	return hasControlChar || hasZeroByte(word ^ (ONES * '"')) ||
+		hasZeroByte(word ^ (ONES * '\\'));
+}
+
+} // anonymous namespace
+
+/**
+* @brief Formats @a value in base ten into the buffer ending at @a end and
+*        returns a pointer to the first character of the formatted value.
+*
+* The buffer has to have room for at least @c MAX_FORMATTED_INTEGER_LENGTH
+* characters before @a end. No terminating null character is written. This is
+* a faster, allocation-free alternative to @c std::to_string().
+*/
+char *formatInteger(char *end, int64_t value) {
+	// Work with the unsigned magnitude so that the minimal value can be
+	// formatted without overflowing.
+	bool negative = value < 0;
+	auto magnitude = static_cast<uint64_t>(value);
+	if (negative) {
+		magnitude = 0 - magnitude;
+	}
+
+	char *p = end;
+	do {
+		*--p = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (negative) {
+		*--p = '-';
+	}
+	return p;
+}
+
 /**
 * @brief Reads data from the given @a stream up to @a sentinel, which is left
 *        in @a stream.
@@ -65,14 +168,232 @@ bool readUntil(std::istream &stream, std::string &readData, char last) {
 std::string replace(const std::string &str, char what,
 		const std::string &withWhat) {
 	std::string result;
-	for (auto c : str) {
-		if (c == what) {
-			result += withWhat;
+	result.reserve(str.size());
+	std::string::size_type runBegin = 0;
+	for (auto pos = str.find(what); pos != std::string::npos;
+			pos = str.find(what, runBegin)) {
+		result.append(str, runBegin, pos - runBegin);
+		result += withWhat;
+		runBegin = pos + 1;
+	}
+	result.append(str, runBegin, std::string::npos);
+	return result;
+}
+
+/**
+* @brief Checks if the given @a length bytes stored in @a data form a valid
+*        UTF-8 sequence.
+*
+* Overlong encodings, surrogates, and code points above U+10FFFF are
+* considered invalid. Runs of ASCII characters are checked eight bytes at a
+* time.
+*/
+bool isValidUtf8(const char *data, std::size_t length) {
+	auto p = reinterpret_cast<const unsigned char *>(data);
+	auto end = p + length;
+	while (p != end) {
+		if (end - p >= 8 && (loadWord(p) & HIGH_BITS) == 0) {
+			p += 8;
+			continue;
+		}
+
+		unsigned char c = *p;
+		if (c < 0x80) {
+			++p;
+			continue;
+		}
+
+		std::size_t numOfContinuationBytes;
+		uint32_t codePoint;
+		uint32_t minCodePoint;
+		if ((c & 0xE0) == 0xC0) {
+			numOfContinuationBytes = 1;
+			codePoint = c & 0x1F;
+			minCodePoint = 0x80;
+		} else if ((c & 0xF0) == 0xE0) {
+			numOfContinuationBytes = 2;
+			codePoint = c & 0x0F;
+			minCodePoint = 0x800;
+		} else if ((c & 0xF8) == 0xF0) {
+			numOfContinuationBytes = 3;
+			codePoint = c & 0x07;
+			minCodePoint = 0x10000;
 		} else {
-			result += c;
+			return false;
+		}
+
+		if (static_cast<std::size_t>(end - p) <= numOfContinuationBytes) {
+			return false;
+		}
+		for (std::size_t i = 1; i <= numOfContinuationBytes; ++i) {
+			if ((p[i] & 0xC0) != 0x80) {
+				return false;
+			}
+			codePoint = (codePoint << 6) | (p[i] & 0x3F);
+		}
+		if (codePoint < minCodePoint || codePoint > 0x10FFFF ||
+				(codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+			return false;
 		}
+		p += numOfContinuationBytes + 1;
 	}
-	return result;
+	return true;
+}
+
+/**
+* @brief Returns a pointer to the first character in <tt>[begin, end)</tt> that
+*        has to be escaped in a JSON string, or @a end if there is no such
+*        character.
+*
+* These are control characters (below 0x20), quotes, and backslashes. The
+* characters are checked eight at a time.
+*/
+const char *findCharToEscapeInJson(const char *begin, const char *end) {
+	auto p = reinterpret_cast<const unsigned char *>(begin);
+	auto e = reinterpret_cast<const unsigned char *>(end);
+	while (e - p >= 8 && !hasCharToEscapeInJson(loadWord(p))) {
+		p += 8;
+	}
+	for (; p != e; ++p) {
+		if (*p < 0x20 || *p == '"' || *p == '\\') {
+			break;
+		}
+	}
+	return reinterpret_cast<const char *>(p);
+}
+
+/**
+* @brief Appends the hexadecimal representation of the given @a length bytes
+*        stored in @a data to @a output.
+*
+* Every byte is represented by two lowercase hexadecimal digits. The output is
+* resized only once.
+*/
+void appendAsHex(std::string &output, const char *data, std::size_t length) {
+	static const char DIGITS[] = "0123456789abcdef";
+
+	auto originalSize = output.size();
+	output.resize(originalSize + 2 * length);
+	char *out = &output[0] + originalSize;
+	auto in = reinterpret_cast<const unsigned char *>(data);
+	for (std::size_t i = 0; i < length; ++i) {
+		out[2 * i] = DIGITS[in[i] >> 4];
+		out[2 * i + 1] = DIGITS[in[i] & 0x0F];
+	}
+}
+
+/**
+* @brief Appends the base64 representation (RFC 4648, with padding) of the
+*        given @a length bytes stored in @a data to @a output.
+*
+* The output is resized only once.
+*/
+void appendAsBase64(std::string &output, const char *data, std::size_t length) {
+	static const char ALPHABET[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	auto originalSize = output.size();
+	output.resize(originalSize + (length + 2) / 3 * 4);
+	char *out = &output[0] + originalSize;
+	auto in = reinterpret_cast<const unsigned char *>(data);
+
+	// Whole groups of three bytes.
+	std::size_t i = 0;
+	for (; i + 3 <= length; i += 3) {
+		uint32_t group = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) |
+			in[i + 2];
+		*out++ = ALPHABET[(group >> 18) & 0x3F];
+		*out++ = ALPHABET[(group >> 12) & 0x3F];
+		*out++ = ALPHABET[(group >> 6) & 0x3F];
+		*out++ = ALPHABET[group & 0x3F];
+	}
+
+	// The remaining one or two bytes.
+	if (i < length) {
+		uint32_t group = uint32_t(in[i]) << 16;
+		if (i + 1 < length) {
+			group |= uint32_t(in[i + 1]) << 8;
+		}
+		*out++ = ALPHABET[(group >> 18) & 0x3F];
+		*out++ = ALPHABET[(group >> 12) & 0x3F];
+		*out++ = i + 1 < length ? ALPHABET[(group >> 6) & 0x3F] : '=';
+		*out++ = '=';
+	}
+}
+
+/**
+* @brief Decodes the hexadecimal representation of bytes stored in the given
+*        @a length characters of @a data and appends the bytes to @a output.
+*
+* Both lowercase and uppercase digits are accepted.
+*
+* @return @c true if the representation is valid, @c false otherwise. When the
+*         representation is invalid, the contents of @a output are unspecified.
+*/
+bool appendFromHex(std::string &output, const char *data, std::size_t length) {
+	if (length % 2 != 0) {
+		return false;
+	}
+
+	auto originalSize = output.size();
+	output.resize(originalSize + length / 2);
+	char *out = &output[0] + originalSize;
+	for (std::size_t i = 0; i < length; i += 2) {
+		int high = getHexDigitValue(data[i]);
+		int low = getHexDigitValue(data[i + 1]);
+		if (high < 0 || low < 0) {
+			return false;
+		}
+		*out++ = static_cast<char>((high << 4) | low);
+	}
+	return true;
+}
+
+/**
+* @brief Decodes the base64 representation (RFC 4648, with padding) of bytes
+*        stored in the given @a length characters of @a data and appends the
+*        bytes to @a output.
+*
+* @return @c true if the representation is valid, @c false otherwise. When the
+*         representation is invalid, the contents of @a output are unspecified.
+*/
+bool appendFromBase64(std::string &output, const char *data,
+		std::size_t length) {
+	if (length % 4 != 0) {
+		return false;
+	}
+
+	std::size_t padding = 0;
+	if (length > 0 && data[length - 1] == '=') {
+		++padding;
+		if (data[length - 2] == '=') {
+			++padding;
+		}
+	}
+
+	auto originalSize = output.size();
+	output.resize(originalSize + length / 4 * 3 - padding);
+	char *out = &output[0] + originalSize;
+	for (std::size_t i = 0; i < length; i += 4) {
+		bool lastGroup = i + 4 == length;
+		std::size_t numOfSextets = lastGroup ? 4 - padding : 4;
+		uint32_t group = 0;
+		for (std::size_t j = 0; j < 4; ++j) {
+			int value = j < numOfSextets ? getBase64DigitValue(data[i + j]) : 0;
+			if (value < 0) {
+				return false;
+			}
+			group = (group << 6) | static_cast<uint32_t>(value);
+		}
+		*out++ = static_cast<char>(group >> 16);
+		if (numOfSextets > 2) {
+			*out++ = static_cast<char>(group >> 8);
+		}
+		if (numOfSextets > 3) {
+			*out++ = static_cast<char>(group);
+		}
+	}
+	return true;
 }
 
 } // namespace bencoding
@@ -0,0 +1,257 @@
+/**
+* @file      Writer.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Implementation of the Writer class.
+*/
+
+#include "Writer.h"
+
+#include <cassert>
+
+#include "Utils.h"
+
+namespace bencoding {
+
+/**
+* @brief Constructs a writer writing into @a output or, when @a output is @c
+*        nullptr, into an internal buffer.
+*/
+Writer::Writer(std::ostream *output): output(output) {}
+
+/**
+* @brief Creates a new writer that writes into an internal buffer.
+*
+* The written data can be obtained by calling encodedData().
+*/
+std::unique_ptr<Writer> Writer::create() {
+	return std::unique_ptr<Writer>(new Writer(nullptr));
+}
+
+/**
+* @brief Creates a new writer that writes into @a output.
+*
+* The writer does not take ownership of @a output, which has to exist for the
+* whole lifetime of the writer.
+*/
+std::unique_ptr<Writer> Writer::create(std::ostream &output) {
+	return std::unique_ptr<Writer>(new Writer(&output));
+}
+
+/**
+* @brief Begins a dictionary.
+*
+* Write its items by alternately calling key() and a value function. Finish
+* the dictionary by calling end().
+*/
+Writer &Writer::beginDict() {
+	// See the description of Reader::beginContainer() for the format and
+	// example.
+	beginValue();
+	write('d');
+	frames.push_back(Frame{true, false, false, std::string()});
+	return *this;
+}
+
+/**
+* @brief Begins a list.
+*
+* Write its items by calling value functions. Finish the list by calling end().
+*/
+Writer &Writer::beginList() {
+	// See the description of Reader::beginContainer() for the format and
+	// example.
+	beginValue();
+	write('l');
+	frames.push_back(Frame{false, false, false, std::string()});
+	return *this;
+}
+
+/**
+* @brief Writes a key of the currently open dictionary.
+*/
+Writer &Writer::key(const std::string &key) {
+	return this->key(key.data(), key.size());
+}
+
+/**
+* @brief Writes a key of the given @a length stored in @a data.
+*
+* In debug builds, the key has to be greater than the previously written key
+* of the currently open dictionary.
+*/
+Writer &Writer::key(const char *data, std::size_t length) {
+	assert(!frames.empty() && frames.back().isDict &&
+		"a key can be written only into a dictionary");
+	assert(!frames.back().expectsValue &&
+		"the value of the previous key has not been written");
+
+#ifndef NDEBUG
+	Frame &frame = frames.back();
+	std::string key(data, length);
+	assert((!frame.hasKey || frame.lastKey < key) &&
+		"dictionary keys have to be sorted and unique");
+	frame.hasKey = true;
+	frame.lastKey.swap(key);
+#endif
+
+	writeStringWithLength(data, length);
+	frames.back().expectsValue = true;
+	return *this;
+}
+
+/**
+* @brief Ends the currently open list or dictionary.
+*/
+Writer &Writer::end() {
+	assert(!frames.empty() && "there is no list or dictionary to end");
+	assert(!frames.back().expectsValue &&
+		"the value of the last key has not been written");
+
+	write('e');
+	frames.pop_back();
+	if (frames.empty()) {
+		complete = true;
+	}
+	return *this;
+}
+
+/**
+* @brief Writes an integer.
+*/
+Writer &Writer::integer(BInteger::ValueType value) {
+	// See the description of Reader::readInteger() for the format and
+	// example.
+	beginValue();
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH + 2];
+	char *end = formatted + sizeof(formatted);
+	*--end = 'e';
+	char *begin = formatInteger(end, value);
+	*--begin = 'i';
+	write(begin, static_cast<std::size_t>(formatted + sizeof(formatted) - begin));
+	if (frames.empty()) {
+		complete = true;
+	}
+	return *this;
+}
+
+/**
+* @brief Writes a string.
+*/
+Writer &Writer::string(const std::string &value) {
+	return string(value.data(), value.size());
+}
+
+/**
+* @brief Writes a string of the given @a length stored in @a data.
+*
+* The string may contain arbitrary bytes, including null characters.
+*/
+Writer &Writer::string(const char *data, std::size_t length) {
+	beginValue();
+	writeStringWithLength(data, length);
+	if (frames.empty()) {
+		complete = true;
+	}
+	return *this;
+}
+
+/**
+* @brief Writes an already encoded value.
+*
+* @a encodedValue has to be a single complete bencoded value. It is copied into
+* the output as is.
+*/
+Writer &Writer::raw(const std::string &encodedValue) {
+	beginValue();
+	write(encodedValue.data(), encodedValue.size());
+	if (frames.empty()) {
+		complete = true;
+	}
+	return *this;
+}
+
+/**
+* @brief Returns the data written so far.
+*
+* When the writer writes into a stream, the returned string is always empty.
+*/
+const std::string &Writer::encodedData() const {
+	return buffer;
+}
+
+/**
+* @brief Checks if a complete top-level value has been written.
+*
+* @return @c true if the top-level value is complete (i.e. all lists and
+*         dictionaries have been ended), @c false otherwise.
+*/
+bool Writer::isComplete() const {
+	return complete;
+}
+
+/**
+* @brief Resets the writer so it can write another value.
+*
+* The internal buffer is cleared but its capacity is kept, so reusing a writer
+* avoids repeated allocations.
+*/
+void Writer::clear() {
+	buffer.clear();
+	frames.clear();
+	complete = false;
+}
+
+/**
+* @brief Writes the given character.
+*/
+void Writer::write(char c) {
+	if (output) {
+		output->put(c);
+	} else {
+		buffer += c;
+	}
+}
+
+/**
+* @brief Writes @a length characters stored in @a data.
+*/
+void Writer::write(const char *data, std::size_t length) {
+	if (output) {
+		output->write(data, static_cast<std::streamsize>(length));
+	} else {
+		buffer.append(data, length);
+	}
+}
+
+/**
+* @brief Writes a string prefixed with its length.
+*/
+void Writer::writeStringWithLength(const char *data, std::size_t length) {
+	// See the description of Reader::readString() for the format and
+	// example.
+	char formatted[MAX_FORMATTED_INTEGER_LENGTH + 1];
+	char *end = formatted + sizeof(formatted);
+	*--end = ':';
+	char *begin = formatInteger(end, static_cast<int64_t>(length));
+	write(begin, static_cast<std::size_t>(formatted + sizeof(formatted) - begin));
+	write(data, length);
+}
+
+/**
+* @brief Checks that a value can be written at the current position and marks
+*        the value of the last key as written.
+*/
+void Writer::beginValue() {
+	assert(!complete && "a complete value has already been written");
+	if (frames.empty()) {
+		return;
+	}
+
+	Frame &frame = frames.back();
+	assert((!frame.isDict || frame.expectsValue) &&
+		"a dictionary value has to be preceded by a key");
+	frame.expectsValue = false;
+}
+
+} // namespace bencoding
@@ -0,0 +1,129 @@
+/**
+* @file      BatchDecoderTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the BatchDecoder class.
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BatchDecoder.h"
+#include "Decoder.h"
+#include "Encoder.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class BatchDecoderTests: public Test {
+protected:
+	BatchDecoderTests(): decoder(BatchDecoder::create(4)) {}
+
+protected:
+	std::unique_ptr<BatchDecoder> decoder;
+};
+
+TEST_F(BatchDecoderTests,
+NumOfThreadsReturnsRequestedNumberOfThreads) {
+	EXPECT_EQ(4, decoder->numOfThreads());
+}
+
+TEST_F(BatchDecoderTests,
+DecodeReturnsResultsInOrderOfDocuments) {
+	std::vector<std::string> documents;
+	for (int i = 0; i < 1000; ++i) {
+		documents.push_back("li" + std::to_string(i) + "e4:teste");
+	}
+
+	auto results = decoder->decode(documents);
+
+	ASSERT_EQ(documents.size(), results.size());
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		ASSERT_TRUE(results[i].ok());
+		EXPECT_EQ(documents[i], encode(std::shared_ptr<BItem>(
+			results[i].releaseData())));
+	}
+}
+
+TEST_F(BatchDecoderTests,
+InvalidDocumentsAreReportedInTheirOwnResults) {
+	std::vector<std::string> documents{"i1e", "i1", "le", "x", "i2ei3e"};
+
+	auto results = decoder->decode(documents);
+
+	EXPECT_TRUE(results[0].ok());
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, results[1].error());
+	EXPECT_TRUE(results[2].ok());
+	EXPECT_EQ(DecodingErrorCode::UnexpectedCharacter, results[3].error());
+	EXPECT_EQ(DecodingErrorCode::UndecodedCharacters, results[4].error());
+	EXPECT_EQ(3u, results[4].offset());
+}
+
+TEST_F(BatchDecoderTests,
+DecodeOfEmptyBatchReturnsNoResults) {
+	EXPECT_TRUE(decoder->decode(std::vector<std::string>()).empty());
+}
+
+TEST_F(BatchDecoderTests,
+DecodeOfDocumentsGivenByPointerDecodesOnlyGivenNumberOfDocuments) {
+	std::vector<std::string> documents{"i1e", "i2e", "x"};
+
+	auto results = decoder->decode(documents.data(), 2);
+
+	ASSERT_EQ(2u, results.size());
+	EXPECT_TRUE(results[1].ok());
+}
+
+TEST_F(BatchDecoderTests,
+DecodeCanBeCalledRepeatedly) {
+	std::vector<std::string> documents(100, "i1e");
+
+	for (int i = 0; i < 10; ++i) {
+		auto results = decoder->decode(documents);
+		ASSERT_EQ(documents.size(), results.size());
+		EXPECT_TRUE(results.back().ok());
+	}
+}
+
+TEST_F(BatchDecoderTests,
+OptionsOfGivenDecoderAreUsedForEveryDocument) {
+	auto options = Decoder::create();
+	DecoderLimits limits;
+	limits.maxDepth = 2;
+	options->setLimits(limits);
+	options->setKeyOrderChecking(true);
+	options->setInfoHashComputation(true);
+	decoder->setDecoderOptions(*options);
+	std::vector<std::string> documents{"l1:ae", "llleee", "d1:bi1e1:ai2ee",
+		"d4:infod1:ai1eee"};
+
+	auto results = decoder->decode(documents);
+
+	EXPECT_TRUE(results[0].ok());
+	EXPECT_EQ(DecodingErrorCode::DepthLimitExceeded, results[1].error());
+	EXPECT_EQ(DecodingErrorCode::UnsortedKeys, results[2].error());
+	EXPECT_EQ(20u, results[3].infoHashV1().size());
+}
+
+//
+// decodeBatch()
+//
+
+TEST_F(BatchDecoderTests,
+DecodeBatchWithoutExplicitDecoderCreationDecodesDocuments) {
+	std::vector<std::string> documents{"i1e", "x", "li2ee"};
+
+	auto results = decodeBatch(documents, 2);
+
+	ASSERT_EQ(3u, results.size());
+	EXPECT_TRUE(results[0].ok());
+	EXPECT_FALSE(results[1].ok());
+	EXPECT_TRUE(results[2].ok());
+}
+
+} // namespace tests
+} // namespace bencoding
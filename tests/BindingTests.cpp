@@ -0,0 +1,452 @@
+/**
+* @file      BindingTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for decoding of bencoded data directly into C++ types.
+*/
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BInteger.h"
+#include "Binding.h"
+#include "Encoder.h"
+
+namespace bencoding {
+namespace tests {
+
+/// A bound struct.
+struct File {
+	std::int64_t length = 0;
+	std::vector<std::string> path;
+};
+
+/// A bound struct with a member of another bound struct.
+struct Info {
+	std::vector<File> files;
+	std::string name;
+	std::uint32_t pieceLength = 0;
+};
+
+/// A bound struct with an unbound member.
+struct Torrent {
+	std::string announce;
+	Info info;
+	std::string comment = "unbound";
+};
+
+/// A bound struct with members of various integral types.
+struct Integers {
+	std::int8_t small = 0;
+	std::uint64_t large = 0;
+	int plain = 0;
+};
+
+/// A bound struct with a member that may be missing.
+struct Reply {
+	std::string transactionId;
+	std::unique_ptr<std::string> token;
+	std::string type;
+};
+
+} // namespace tests
+} // namespace bencoding
+
+BENCODING_BIND(bencoding::tests::File,
+	BENCODING_FIELD(length, "length"),
+	BENCODING_FIELD(path, "path")
+)
+
+BENCODING_BIND(bencoding::tests::Info,
+	BENCODING_FIELD(files, "files"),
+	BENCODING_FIELD(name, "name"),
+	BENCODING_FIELD(pieceLength, "piece length")
+)
+
+BENCODING_BIND(bencoding::tests::Torrent,
+	BENCODING_FIELD(announce, "announce"),
+	BENCODING_FIELD(info, "info")
+)
+
+BENCODING_BIND(bencoding::tests::Integers,
+	BENCODING_FIELD(small, "s"),
+	BENCODING_FIELD(large, "l"),
+	BENCODING_FIELD(plain, "")
+)
+
+BENCODING_BIND(bencoding::tests::Reply,
+	BENCODING_FIELD(transactionId, "t"),
+	BENCODING_FIELD(type, "y"),
+	BENCODING_FIELD(token, "token")
+)
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class BindingTests: public Test {};
+
+//
+// Values.
+//
+
+TEST_F(BindingTests,
+IntegerIsDecodedIntoIntegralType) {
+	int value = 0;
+
+	ASSERT_TRUE(decodeInto("i-42e", value).ok());
+
+	EXPECT_EQ(-42, value);
+}
+
+TEST_F(BindingTests,
+StringIsDecodedIntoStdString) {
+	std::string value;
+
+	ASSERT_TRUE(decodeInto(std::string("3:a\0b", 5), value).ok());
+
+	EXPECT_EQ(std::string("a\0b", 3), value);
+}
+
+TEST_F(BindingTests,
+ListIsDecodedIntoVectorReplacingItsContents) {
+	std::vector<int> value{7, 8, 9, 10};
+
+	ASSERT_TRUE(decodeInto("li1ei2ee", value).ok());
+
+	EXPECT_EQ(std::vector<int>({1, 2}), value);
+}
+
+TEST_F(BindingTests,
+NestedListsAreDecodedIntoNestedVectors) {
+	std::vector<std::vector<std::string>> value;
+
+	ASSERT_TRUE(decodeInto("ll1:ael1:b1:cee", value).ok());
+
+	ASSERT_EQ(2u, value.size());
+	EXPECT_EQ(std::vector<std::string>({"a"}), value[0]);
+	EXPECT_EQ(std::vector<std::string>({"b", "c"}), value[1]);
+}
+
+TEST_F(BindingTests,
+DictionaryIsDecodedIntoMapWithLastValueOfDuplicateKey) {
+	std::map<std::string, int> value{{"x", 1}};
+
+	ASSERT_TRUE(decodeInto("d1:ai1e1:bi2e1:ai3ee", value).ok());
+
+	EXPECT_EQ((std::map<std::string, int>{{"a", 3}, {"b", 2}}), value);
+}
+
+TEST_F(BindingTests,
+DictionaryIsDecodedIntoUnorderedMap) {
+	std::unordered_map<std::string, std::string> value;
+
+	ASSERT_TRUE(decodeInto("d1:b1:x1:a1:ye", value).ok());
+
+	EXPECT_EQ((std::unordered_map<std::string, std::string>{
+		{"a", "y"}, {"b", "x"}}), value);
+}
+
+TEST_F(BindingTests,
+ListIsDecodedIntoTuple) {
+	std::tuple<std::string, int> value;
+
+	ASSERT_TRUE(decodeInto("l1:ai1ee", value).ok());
+
+	EXPECT_EQ(std::make_tuple(std::string("a"), 1), value);
+}
+
+TEST_F(BindingTests,
+ListWithOtherNumberOfItemsThanTupleIsReported) {
+	std::tuple<std::string, int> value;
+
+	auto shorter = decodeInto("l1:ae", value);
+	auto longer = decodeInto("l1:ai1ei2ee", value);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedType, shorter.error());
+	EXPECT_EQ(4u, shorter.offset());
+	EXPECT_EQ(DecodingErrorCode::UnexpectedType, longer.error());
+	EXPECT_EQ(7u, longer.offset());
+}
+
+TEST_F(BindingTests,
+ValueIsDecodedIntoNewlyAllocatedUniquePtr) {
+	std::unique_ptr<int> value;
+
+	ASSERT_TRUE(decodeInto("i5e", value).ok());
+
+	ASSERT_TRUE(value != nullptr);
+	EXPECT_EQ(5, *value);
+}
+
+//
+// Structs.
+//
+
+TEST_F(BindingTests,
+DictionaryIsDecodedIntoBoundStruct) {
+	std::string data("d8:announce3:url4:infod5:filesld6:lengthi10e4:pathl1:a"
+		"1:beed6:lengthi20e4:pathl1:ceee4:name4:test12:piece lengthi16eee");
+
+	auto torrent = decodeAs<Torrent>(data);
+
+	EXPECT_EQ("url", torrent.announce);
+	EXPECT_EQ("test", torrent.info.name);
+	EXPECT_EQ(16u, torrent.info.pieceLength);
+	ASSERT_EQ(2u, torrent.info.files.size());
+	EXPECT_EQ(10, torrent.info.files[0].length);
+	EXPECT_EQ(std::vector<std::string>({"a", "b"}), torrent.info.files[0].path);
+	EXPECT_EQ(20, torrent.info.files[1].length);
+	EXPECT_EQ("unbound", torrent.comment);
+}
+
+TEST_F(BindingTests,
+KeysInAnyOrderAreDecoded) {
+	std::string data("d12:piece lengthi16e4:name4:test5:fileslee");
+
+	auto info = decodeAs<Info>(data);
+
+	EXPECT_EQ("test", info.name);
+	EXPECT_EQ(16u, info.pieceLength);
+}
+
+TEST_F(BindingTests,
+UnknownKeysAreSkipped) {
+	std::string data("d1:ali1ed1:xi1eee4:name4:test5:otheri5e"
+		"12:piece_lengthi8e12:piece lengthi16ee");
+
+	auto info = decodeAs<Info>(data);
+
+	EXPECT_EQ("test", info.name);
+	EXPECT_EQ(16u, info.pieceLength);
+}
+
+TEST_F(BindingTests,
+MissingKeysKeepValuesOfMembers) {
+	Info info;
+	info.name = "original";
+
+	ASSERT_TRUE(decodeInto("d12:piece lengthi16ee", info).ok());
+
+	EXPECT_EQ("original", info.name);
+	EXPECT_EQ(16u, info.pieceLength);
+}
+
+TEST_F(BindingTests,
+LastValueOfDuplicateKeyIsUsedInStruct) {
+	auto file = decodeAs<File>("d6:lengthi1e4:pathl1:ae6:lengthi2ee");
+
+	EXPECT_EQ(2, file.length);
+}
+
+TEST_F(BindingTests,
+KeysWithSameLengthAndFirstCharacterAreDistinguished) {
+	// "s" and "l" have the same length; "" has no first character.
+	auto integers = decodeAs<Integers>("d0:i3e1:li4e1:si5e1:ti6ee");
+
+	EXPECT_EQ(5, integers.small);
+	EXPECT_EQ(4u, integers.large);
+	EXPECT_EQ(3, integers.plain);
+}
+
+//
+// Errors.
+//
+
+TEST_F(BindingTests,
+ItemOfUnexpectedTypeIsReportedWithItsOffset) {
+	Info info;
+
+	auto result = decodeInto("d4:namei1ee", info);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedType, result.error());
+	EXPECT_EQ(7u, result.offset());
+}
+
+TEST_F(BindingTests,
+IntegerThatDoesNotFitIntoMemberIsReported) {
+	Integers integers;
+
+	EXPECT_EQ(DecodingErrorCode::IntegerOutOfRange,
+		decodeInto("d1:si128ee", integers).error());
+	EXPECT_EQ(DecodingErrorCode::IntegerOutOfRange,
+		decodeInto("d1:si-129ee", integers).error());
+	EXPECT_EQ(DecodingErrorCode::IntegerOutOfRange,
+		decodeInto("d1:li-1ee", integers).error());
+	EXPECT_TRUE(decodeInto("d1:si-128e1:li9223372036854775807ee",
+		integers).ok());
+}
+
+TEST_F(BindingTests,
+InvalidInputIsReportedWithOffset) {
+	File file;
+
+	auto result = decodeInto("d6:lengthi1x", file);
+
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, result.error());
+	EXPECT_EQ(11u, result.offset());
+}
+
+TEST_F(BindingTests,
+InvalidInputInSkippedValueIsReported) {
+	File file;
+
+	auto result = decodeInto("d5:otherli1e", file);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, result.error());
+}
+
+TEST_F(BindingTests,
+EmptyInputIsReported) {
+	File file;
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput,
+		decodeInto("", file).error());
+}
+
+TEST_F(BindingTests,
+TrailingCharactersAreReported) {
+	int value = 0;
+
+	auto result = decodeInto("i1ei2e", value);
+
+	EXPECT_EQ(DecodingErrorCode::UndecodedCharacters, result.error());
+	EXPECT_EQ(3u, result.offset());
+}
+
+TEST_F(BindingTests,
+LimitsAreChecked) {
+	DecoderLimits limits;
+	limits.maxDepth = 1;
+	Torrent torrent;
+
+	auto result = decodeInto("d4:infod4:name1:aee", torrent, limits);
+
+	EXPECT_EQ(DecodingErrorCode::DepthLimitExceeded, result.error());
+}
+
+TEST_F(BindingTests,
+DecodeAsThrowsForInvalidInput) {
+	EXPECT_THROW(decodeAs<File>("d4:pathi1ee"), DecodingError);
+}
+
+//
+// Encoding.
+//
+
+TEST_F(BindingTests,
+IntegersAreEncoded) {
+	EXPECT_EQ("i-5e", encode(-5));
+	EXPECT_EQ("i255e", encode(std::uint8_t{255}));
+	EXPECT_EQ("i18446744073709551615e",
+		encode(std::numeric_limits<std::uint64_t>::max()));
+}
+
+TEST_F(BindingTests,
+StringsAreEncoded) {
+	const char *cString = "abc";
+
+	EXPECT_EQ(std::string("3:a\0b", 5), encode(std::string("a\0b", 3)));
+	EXPECT_EQ("3:abc", encode(cString));
+}
+
+TEST_F(BindingTests,
+VectorsAndTuplesAreEncodedAsLists) {
+	std::vector<std::vector<int>> lists{{1, 2}, {}};
+	auto tuple = std::make_tuple(std::string("get"), 1, std::vector<int>{2});
+
+	EXPECT_EQ("lli1ei2eelee", encode(lists));
+	EXPECT_EQ("l3:geti1eli2eee", encode(tuple));
+}
+
+TEST_F(BindingTests,
+MapIsEncodedAsDictionaryInItsOrder) {
+	std::map<std::string, int> map{{"b", 2}, {"a", 1}, {"ab", 3}};
+
+	EXPECT_EQ("d1:ai1e2:abi3e1:bi2ee", encode(map));
+}
+
+TEST_F(BindingTests,
+UnorderedMapIsEncodedAsDictionaryWithSortedKeys) {
+	std::unordered_map<std::string, int> map;
+	for (int i = 0; i < 20; ++i) {
+		map[std::string(1, static_cast<char>('t' - i))] = i;
+	}
+	map["\xff"] = 20;
+
+	std::string encoded = encode(map);
+
+	EXPECT_EQ(0u, encoded.find("d1:ai19e1:bi18e"));
+	EXPECT_EQ("1:ti0e1:\xffi20ee", encoded.substr(encoded.size() - 14));
+}
+
+TEST_F(BindingTests,
+NullValuesOfMapAreOmitted) {
+	std::map<std::string, std::unique_ptr<int>> map;
+	map["a"].reset(new int(1));
+	map["b"];
+
+	EXPECT_EQ("d1:ai1ee", encode(map));
+}
+
+TEST_F(BindingTests,
+BoundStructIsEncodedWithSortedKeys) {
+	Reply reply;
+	reply.transactionId = "aa";
+	reply.type = "r";
+	reply.token.reset(new std::string("xyz"));
+
+	EXPECT_EQ("d1:t2:aa5:token3:xyz1:y1:re", encode(reply));
+}
+
+TEST_F(BindingTests,
+NullMembersOfBoundStructAreOmitted) {
+	Reply reply;
+	reply.transactionId = "aa";
+	reply.type = "r";
+
+	EXPECT_EQ("d1:t2:aa1:y1:re", encode(reply));
+}
+
+TEST_F(BindingTests,
+EncodedStructCanBeDecodedBack) {
+	Torrent torrent;
+	torrent.announce = "url";
+	torrent.info.name = "test";
+	torrent.info.pieceLength = 16;
+	torrent.info.files.resize(1);
+	torrent.info.files[0].length = 10;
+	torrent.info.files[0].path = {"a", "b"};
+
+	auto decoded = decodeAs<Torrent>(encode(torrent));
+
+	EXPECT_EQ(encode(torrent), encode(decoded));
+	EXPECT_EQ("test", decoded.info.name);
+}
+
+TEST_F(BindingTests,
+ValueIsEncodedDirectlyIntoStream) {
+	std::ostringstream output;
+
+	encode(std::vector<int>{1, 2}, output);
+
+	EXPECT_EQ("li1ei2ee", output.str());
+}
+
+TEST_F(BindingTests,
+ItemsAreStillEncodedByEncoder) {
+	EXPECT_EQ("i1e", encode(BInteger::create(1)));
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,134 @@
+/**
+* @file      CompactListTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the CompactList class.
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BString.h"
+#include "CompactList.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class CompactListTests: public Test {};
+
+TEST_F(CompactListTests,
+EmptyViewHasNoRecords) {
+	CompactPeers peers;
+
+	EXPECT_EQ(0u, peers.size());
+	EXPECT_TRUE(peers.empty());
+	EXPECT_TRUE(peers.begin() == peers.end());
+}
+
+TEST_F(CompactListTests,
+Ipv4PeersAreIteratedOverStringStorage) {
+	auto peersString = BString::create(
+		std::string("\x7f\x00\x00\x01\x1a\xe1\xc0\xa8\x01\x02\x00\x50", 12));
+	CompactPeers peers(*peersString);
+
+	std::vector<Ipv4Endpoint> endpoints(peers.begin(), peers.end());
+
+	ASSERT_EQ(2u, peers.size());
+	ASSERT_EQ(2u, endpoints.size());
+	EXPECT_EQ(0x7f000001u, endpoints[0].address);
+	EXPECT_EQ(6881, endpoints[0].port);
+	EXPECT_EQ("192.168.1.2:80", endpoints[1].toString());
+	EXPECT_EQ("127.0.0.1:6881", peers[0].toString());
+}
+
+TEST_F(CompactListTests,
+TrailingBytesAreIgnored) {
+	std::string data("\x01\x02\x03\x04\x00\x01\x05", 7);
+	CompactPeers peers(data.data(), data.size());
+
+	EXPECT_EQ(1u, peers.size());
+	EXPECT_FALSE(peers.isWellFormed());
+	EXPECT_EQ(1, std::distance(peers.begin(), peers.end()));
+}
+
+TEST_F(CompactListTests,
+BulkConversionOfIpv4PeersMatchesIteration) {
+	std::string data;
+	for (int i = 0; i < 101; ++i) {
+		data += std::string(1, static_cast<char>(i)) + "\x80\xff" +
+			std::string(1, static_cast<char>(255 - i)) + "\xc8" +
+			std::string(1, static_cast<char>(i * 3));
+	}
+	CompactPeers peers(data.data(), data.size());
+	std::vector<Ipv4Endpoint> endpoints(peers.size());
+
+	ASSERT_EQ(101u, peers.copyTo(endpoints.data()));
+
+	std::size_t i = 0;
+	for (auto peer : peers) {
+		EXPECT_EQ(peer.address, endpoints[i].address) << i;
+		EXPECT_EQ(peer.port, endpoints[i].port) << i;
+		++i;
+	}
+}
+
+TEST_F(CompactListTests,
+Ipv6PeersAreConverted) {
+	std::string data("\x20\x01\x0d\xb8" + std::string(11, '\0') +
+		std::string("\x01\x1a\xe1"));
+	CompactPeers6 peers(data.data(), data.size());
+	std::vector<Ipv6Endpoint> endpoints(peers.size());
+
+	peers.copyTo(endpoints.data());
+
+	ASSERT_EQ(1u, peers.size());
+	EXPECT_EQ(6881, endpoints[0].port);
+	EXPECT_EQ(0x20, endpoints[0].address[0]);
+	EXPECT_EQ("[2001:db8:0:0:0:0:0:1]:6881", peers[0].toString());
+}
+
+TEST_F(CompactListTests,
+NodesPointToTheirIdsInString) {
+	std::string data(std::string(20, 'a') +
+		std::string("\x0a\x00\x00\x01\x00\x50", 6) + std::string(20, 'b') +
+		std::string("\x0a\x00\x00\x02\x00\x51", 6));
+	CompactNodes nodes(data.data(), data.size());
+	std::vector<DhtNode> converted(nodes.size());
+
+	nodes.copyTo(converted.data());
+
+	ASSERT_EQ(2u, nodes.size());
+	EXPECT_EQ(data.data() + 26, nodes[1].id);
+	EXPECT_EQ("10.0.0.2:81", nodes[1].endpoint.toString());
+	EXPECT_EQ(data.data(), converted[0].id);
+	EXPECT_EQ(80, converted[0].endpoint.port);
+}
+
+TEST_F(CompactListTests,
+Ipv6NodesAreConverted) {
+	std::string data(std::string(20, 'n') + std::string(15, '\0') +
+		std::string("\x01\x00\x50", 3));
+	CompactNodes6 nodes(data.data(), data.size());
+
+	ASSERT_EQ(1u, nodes.size());
+	EXPECT_EQ(data.data(), nodes[0].id);
+	EXPECT_EQ("[0:0:0:0:0:0:0:1]:80", nodes[0].endpoint.toString());
+}
+
+TEST_F(CompactListTests,
+ViewCanBeCreatedFromKrpcString) {
+	std::string data(std::string(20, 'a') +
+		std::string("\x0a\x00\x00\x01\x00\x50", 6));
+	KrpcBytes bytes(data.data(), data.size());
+
+	CompactNodes nodes(bytes);
+
+	EXPECT_EQ(1u, nodes.size());
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -5,6 +5,9 @@
 * @brief     Tests for the Decoder class.
 */
 
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <sstream>
 
@@ -15,7 +18,13 @@
 #include "BList.h"
 #include "BString.h"
 #include "Decoder.h"
+#include "Encoder.h"
+#include "KeyInternTable.h"
+#include "Schema.h"
+#include "Sha1.h"
+#include "Sha256.h"
 #include "TestUtils.h"
+#include "Utils.h"
 
 namespace bencoding {
 namespace tests {
@@ -346,6 +355,715 @@ DecodeThrowsDecodingErrorWhenStringHasNotEnoughCharacters) {
 	EXPECT_THROW(decoder->decode("3:aa"), DecodingError);
 }
 
+TEST_F(DecoderTests,
+DecodeThrowsDecodingErrorWithoutAllocatingStringWhenStringLengthIsHuge) {
+	// If the memory for the string was allocated up front, the decoding would
+	// fail on std::bad_alloc (or take a very long time).
+	EXPECT_THROW(decoder->decode("999999999999999:aa"), DecodingError);
+}
+
+TEST_F(DecoderTests,
+StringLongerThanBufferedDataIsCorrectlyDecodedFromStream) {
+	std::string str(200000, 'x');
+	ChunkedStreamBuf buf("200000:" + str, 4096);
+	std::istream input(&buf);
+	std::shared_ptr<BItem> bItem(decoder->decode(input));
+
+	ADD_SCOPED_TRACE;
+	assertDecodedAs<BString>(bItem);
+	EXPECT_EQ(str, bItem->as<BString>()->value());
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingErrorWhenStringHasNotEnoughCharactersInStream) {
+	ChunkedStreamBuf buf("999999999999:" + std::string(100000, 'x'), 4096);
+	std::istream input(&buf);
+
+	EXPECT_THROW(decoder->decode(input), DecodingError);
+}
+
+TEST_F(DecoderTests,
+StringNotLongerThanMaxStringLengthIsDecoded) {
+	DecoderLimits limits;
+	limits.maxStringLength = 4;
+	decoder->setLimits(limits);
+
+	EXPECT_NO_THROW(decoder->decode("4:test"));
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingErrorWhenStringIsLongerThanMaxStringLength) {
+	DecoderLimits limits;
+	limits.maxStringLength = 3;
+	decoder->setLimits(limits);
+
+	EXPECT_THROW(decoder->decode("4:test"), DecodingLimitExceeded);
+}
+
+//
+// Decoding without exceptions.
+//
+
+TEST_F(DecoderTests,
+TryDecodeReturnsDecodedData) {
+	auto result = decoder->tryDecode("d1:ali1e4:testee");
+
+	ASSERT_TRUE(result.ok());
+	std::shared_ptr<BItem> bItem(result.releaseData());
+	ADD_SCOPED_TRACE;
+	assertDecodedAs<BDictionary>(bItem);
+	auto bList = (*bItem->as<BDictionary>())[BString::create("a")]->as<BList>();
+	ASSERT_TRUE(bList);
+	EXPECT_EQ(2u, bList->size());
+}
+
+TEST_F(DecoderTests,
+TryDecodeReturnsErrorAndOffsetForInvalidInput) {
+	auto result = decoder->tryDecode("li1ei2xe");
+
+	EXPECT_FALSE(result.ok());
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, result.error());
+	EXPECT_EQ(6u, result.offset());
+}
+
+TEST_F(DecoderTests,
+TryDecodeReturnsErrorForEmptyInput) {
+	auto result = decoder->tryDecode("");
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, result.error());
+}
+
+TEST_F(DecoderTests,
+TryDecodeReturnsErrorWhenInputIsNotCompletelyRead) {
+	auto result = decoder->tryDecode("i1ei2e");
+
+	EXPECT_EQ(DecodingErrorCode::UndecodedCharacters, result.error());
+	EXPECT_EQ(3u, result.offset());
+}
+
+TEST_F(DecoderTests,
+TryDecodePrefixDecodesFirstItemAndReturnsItsLength) {
+	std::string data("li1eei2ex");
+	std::size_t itemLength = 0;
+
+	auto result = decoder->tryDecodePrefix(data.data(), data.size(),
+		itemLength);
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_EQ(5u, itemLength);
+}
+
+TEST_F(DecoderTests,
+TryDecodePrefixReturnsErrorForIncompleteItem) {
+	std::string data("li1e");
+	std::size_t itemLength = 0;
+
+	auto result = decoder->tryDecodePrefix(data.data(), data.size(),
+		itemLength);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, result.error());
+	EXPECT_EQ(4u, result.offset());
+}
+
+TEST_F(DecoderTests,
+TryDecodeReturnsErrorWhenLimitIsExceeded) {
+	DecoderLimits limits;
+	limits.maxDepth = 1;
+	decoder->setLimits(limits);
+
+	auto result = decoder->tryDecode("llee");
+
+	EXPECT_EQ(DecodingErrorCode::DepthLimitExceeded, result.error());
+	EXPECT_EQ(1u, result.offset());
+}
+
+TEST_F(DecoderTests,
+TryDecodeDecodesDeeplyNestedListsWithoutRecursion) {
+	std::size_t depth = 100000;
+	auto result = decoder->tryDecode(std::string(depth, 'l') +
+		std::string(depth, 'e'));
+
+	EXPECT_TRUE(result.ok());
+	// Destroy the nested lists one by one to prevent a deep recursion.
+	std::shared_ptr<BItem> bItem(result.releaseData());
+	while (bItem && !bItem->as<BList>()->empty()) {
+		std::shared_ptr<BItem> inner = bItem->as<BList>()->front();
+		bItem->as<BList>()->pop_back();
+		bItem = inner;
+	}
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingErrorWithMessageContainingOffset) {
+	try {
+		decoder->decode("li1ex");
+		FAIL() << "expected DecodingError";
+	} catch (const DecodingError &ex) {
+		EXPECT_EQ("unexpected character at offset 4", std::string(ex.what()));
+	}
+}
+
+//
+// Validation.
+//
+
+TEST_F(DecoderTests,
+ValidateAcceptsValidInput) {
+	auto result = decoder->validate("d1:ali1e4:teste1:bd1:ci-2eee");
+
+	EXPECT_TRUE(result.ok());
+	EXPECT_EQ(nullptr, result.data());
+}
+
+TEST_F(DecoderTests,
+ValidateReportsSameErrorsAsTryDecode) {
+	const char *inputs[] = {"", "l", "i01e", "d1:ai1e", "di1ei2ee",
+		"4:abc", "i1ei2e", "le1:x"};
+
+	for (const auto &input : inputs) {
+		SCOPED_TRACE(input);
+		auto validationResult = decoder->validate(input);
+		auto decodingResult = decoder->tryDecode(input);
+
+		EXPECT_FALSE(validationResult.ok());
+		EXPECT_EQ(decodingResult.error(), validationResult.error());
+		EXPECT_EQ(decodingResult.offset(), validationResult.offset());
+	}
+}
+
+TEST_F(DecoderTests,
+ValidateChecksLimits) {
+	DecoderLimits limits;
+	limits.maxNumOfItems = 2;
+	decoder->setLimits(limits);
+
+	auto result = decoder->validate("li1ei2ee");
+
+	EXPECT_EQ(DecodingErrorCode::NumOfItemsLimitExceeded, result.error());
+}
+
+//
+// Key order.
+//
+
+TEST_F(DecoderTests,
+KeyOrderIsNotCheckedByDefault) {
+	EXPECT_TRUE(decoder->validate("d1:bi1e1:ai2ee").ok());
+	EXPECT_TRUE(decoder->tryDecode("d1:bi1e1:ai2ee").ok());
+}
+
+TEST_F(DecoderTests,
+ValidateReportsUnsortedKeysWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+
+	auto result = decoder->validate("d1:bi1e1:ai2ee");
+
+	EXPECT_EQ(DecodingErrorCode::UnsortedKeys, result.error());
+	EXPECT_EQ(7u, result.offset());
+}
+
+TEST_F(DecoderTests,
+ValidateReportsDuplicateKeyWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+
+	auto result = decoder->validate("d1:ai1e1:ai2ee");
+
+	EXPECT_EQ(DecodingErrorCode::DuplicateKey, result.error());
+	EXPECT_EQ(7u, result.offset());
+}
+
+TEST_F(DecoderTests,
+ValidateAcceptsSortedKeysOfNestedDictionariesWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+
+	auto result = decoder->validate("d1:ad1:xi1e1:yi2ee1:bd1:ai3eee");
+
+	EXPECT_TRUE(result.ok());
+}
+
+TEST_F(DecoderTests,
+TryDecodeReportsUnsortedKeysWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+
+	auto result = decoder->tryDecode("d2:abi1e1:ai2ee");
+
+	EXPECT_EQ(DecodingErrorCode::UnsortedKeys, result.error());
+}
+
+TEST_F(DecoderTests,
+DecodeFromStreamThrowsForUnsortedKeysWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+	std::istringstream input("d1:bi1e1:ai2ee");
+
+	EXPECT_THROW(decoder->decode(input), DecodingError);
+}
+
+TEST_F(DecoderTests,
+DecodeFromStreamThrowsForDuplicateKeyWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+	std::istringstream input("d1:ai1e1:ai2ee");
+
+	EXPECT_THROW(decoder->decode(input), DecodingError);
+}
+
+TEST_F(DecoderTests,
+DecodeFromStreamAcceptsSortedKeysWhenKeyOrderIsChecked) {
+	decoder->setKeyOrderChecking(true);
+	std::istringstream input("d1:ai1e2:aai2e1:bi3ee");
+
+	EXPECT_NO_THROW(decoder->decode(input));
+}
+
+//
+// Spans.
+//
+
+TEST_F(DecoderTests,
+NoSpansAreRecordedByDefault) {
+	auto result = decoder->tryDecode("li1ee");
+
+	EXPECT_TRUE(result.sourceMap().empty());
+}
+
+TEST_F(DecoderTests,
+SpansOfAllItemsAreRecordedWhenEnabled) {
+	decoder->setSpanRecording(true);
+	std::string data("d1:ali1e4:testee");
+
+	auto result = decoder->tryDecode(data);
+
+	ASSERT_TRUE(result.ok());
+	const auto &sourceMap = result.sourceMap();
+	std::shared_ptr<BItem> bItem(result.releaseData());
+	auto bDictionary = bItem->as<BDictionary>();
+	auto key = bDictionary->begin()->first;
+	auto bList = bDictionary->begin()->second->as<BList>();
+	EXPECT_EQ(5u, sourceMap.size());
+	EXPECT_EQ(data.size(), sourceMap.getSpan(*bDictionary).end);
+	EXPECT_EQ(1u, sourceMap.getSpan(*key).begin);
+	EXPECT_EQ(4u, sourceMap.getSpan(*key).end);
+	EXPECT_EQ(4u, sourceMap.getSpan(*bList).begin);
+	EXPECT_EQ(15u, sourceMap.getSpan(*bList).end);
+	EXPECT_EQ(8u, sourceMap.getSpan(*bList->back()).begin);
+	EXPECT_EQ(14u, sourceMap.getSpan(*bList->back()).end);
+}
+
+TEST_F(DecoderTests,
+SpansOfReplacedValuesOfDuplicateKeysAreRemoved) {
+	decoder->setSpanRecording(true);
+	// Without key order checking, the last value of a duplicate key is kept.
+	std::string data("d1:ald1:bi1eee1:ai2ee");
+
+	auto result = decoder->tryDecode(data);
+
+	ASSERT_TRUE(result.ok());
+	const auto &sourceMap = result.sourceMap();
+	std::shared_ptr<BItem> bItem(result.releaseData());
+	auto bDictionary = bItem->as<BDictionary>();
+	auto key = bDictionary->begin()->first;
+	auto value = bDictionary->begin()->second;
+	// The dictionary, the kept key, and the kept value.
+	EXPECT_EQ(3u, sourceMap.size());
+	EXPECT_EQ(1u, sourceMap.getSpan(*key).begin);
+	EXPECT_EQ(17u, sourceMap.getSpan(*value).begin);
+	EXPECT_EQ(20u, sourceMap.getSpan(*value).end);
+}
+
+TEST_F(DecoderTests,
+SpansOfValuesOfSelectedKeysAreRecordedWhenEnabled) {
+	decoder->setSpanRecordingKeys({"info"});
+	// Not in the canonical form (the keys are not sorted).
+	std::string data("d4:infod4:namei1e3:abci2ee1:xd4:infoi3eee");
+
+	auto result = decoder->tryDecode(data);
+
+	ASSERT_TRUE(result.ok());
+	const auto &sourceMap = result.sourceMap();
+	std::shared_ptr<BItem> bItem(result.releaseData());
+	auto bDictionary = bItem->as<BDictionary>();
+	auto info = (*bDictionary)[BString::create("info")];
+	auto nestedInfo = (*(*bDictionary)[BString::create("x")]->as<BDictionary>())[
+		BString::create("info")];
+	EXPECT_EQ(2u, sourceMap.size());
+	auto span = sourceMap.getSpan(*info);
+	EXPECT_EQ("d4:namei1e3:abci2ee", data.substr(span.begin, span.length()));
+	EXPECT_EQ("i3e", data.substr(sourceMap.getSpan(*nestedInfo).begin,
+		sourceMap.getSpan(*nestedInfo).length()));
+	EXPECT_FALSE(sourceMap.contains(*bDictionary));
+}
+
+//
+// Infohashes.
+//
+
+TEST_F(DecoderTests,
+NoInfohashesAreComputedByDefault) {
+	auto result = decoder->tryDecode("d4:infod4:name1:xee");
+
+	EXPECT_TRUE(result.infoHashV1().empty());
+	EXPECT_TRUE(result.infoHashV2().empty());
+}
+
+TEST_F(DecoderTests,
+InfohashesOfInfoDictionaryAreComputedWhenEnabled) {
+	decoder->setInfoHashComputation(true);
+
+	auto result = decoder->tryDecode(
+		"d8:announce3:url4:infod6:lengthi1e4:name1:xe1:zi1ee");
+
+	ASSERT_TRUE(result.ok());
+	std::string v1;
+	appendAsHex(v1, result.infoHashV1().data(), result.infoHashV1().size());
+	EXPECT_EQ("607361303e836d09e97091ea3a6fc0ae34cb1ebd", v1);
+	std::string v2;
+	appendAsHex(v2, result.infoHashV2().data(), result.infoHashV2().size());
+	EXPECT_EQ("10792069979ff01361b5b8794864d56ec5a721b35ae00557277eac1c9fa4ef80",
+		v2);
+}
+
+TEST_F(DecoderTests,
+InfohashIsComputedFromOriginalInputEvenWhenItIsNotCanonical) {
+	decoder->setInfoHashComputation(true);
+	std::string info("d4:name1:x6:lengthi1ee");
+
+	auto result = decoder->tryDecode("d4:info" + info + "e");
+
+	EXPECT_EQ(Sha1::hash(info), result.infoHashV1());
+	EXPECT_EQ(Sha256::hash(info), result.infoHashV2());
+}
+
+TEST_F(DecoderTests,
+InfohashIsComputedOnlyForInfoKeyInTopLevelDictionary) {
+	decoder->setInfoHashComputation(true);
+
+	auto result = decoder->tryDecode("d1:ad4:infoi1eee");
+
+	EXPECT_TRUE(result.infoHashV1().empty());
+}
+
+TEST_F(DecoderTests,
+InfohashIsNotComputedWhenInfoIsNotDictionary) {
+	decoder->setInfoHashComputation(true);
+
+	auto result = decoder->tryDecode("d4:infoli1e1:xe1:zi1ee");
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_TRUE(result.infoHashV1().empty());
+	EXPECT_TRUE(result.infoHashV2().empty());
+}
+
+TEST_F(DecoderTests,
+InfohashOfLastInfoDictionaryIsComputedWhenInfoKeyIsDuplicated) {
+	decoder->setInfoHashComputation(true);
+	std::string last("d4:name1:ye");
+
+	auto result = decoder->tryDecode("d4:infod4:name1:xe4:info" + last + "e");
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_EQ(Sha1::hash(last), result.infoHashV1());
+	EXPECT_EQ(Sha256::hash(last), result.infoHashV2());
+}
+
+TEST_F(DecoderTests,
+NoInfohashIsComputedWhenLastValueOfDuplicatedInfoKeyIsNotDictionary) {
+	decoder->setInfoHashComputation(true);
+
+	auto result = decoder->tryDecode("d4:infod4:name1:xe4:infoi1ee");
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_TRUE(result.infoHashV1().empty());
+	EXPECT_TRUE(result.infoHashV2().empty());
+}
+
+//
+// Schema-guided decoding.
+//
+
+TEST_F(DecoderTests,
+OnlyKeysDeclaredInSchemaAreDecoded) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::integer()},
+		{"c", Schema::dictionary({{"x", Schema::string()}})}
+	}));
+
+	auto result = decoder->tryDecode(
+		"d1:ai1e1:bli1ei2ee1:cd1:x1:y1:zi3eee", *schema);
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_EQ("d1:ai1e1:cd1:x1:yee", encode(result.releaseData()));
+}
+
+TEST_F(DecoderTests,
+ListItemsAreDecodedBySchemaOfItems) {
+	std::shared_ptr<Schema> schema(Schema::list(
+		Schema::dictionary({{"a", Schema::integer()}})));
+
+	auto result = decoder->tryDecode("ld1:ai1e1:bi2eed1:ai3eee", *schema);
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_EQ("ld1:ai1eed1:ai3eee", encode(result.releaseData()));
+}
+
+TEST_F(DecoderTests,
+ItemOfAnyTypeIsDecodedWhole) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::any()}
+	}));
+
+	auto result = decoder->tryDecode("d1:ald1:bi1eeee", *schema);
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_EQ("d1:ald1:bi1eeee", encode(result.releaseData()));
+}
+
+TEST_F(DecoderTests,
+ItemOfOtherTypeThanInSchemaIsReportedWithItsOffset) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::list(Schema::integer())}
+	}));
+
+	auto result = decoder->tryDecode("d1:ali1e1:xee", *schema);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedType, result.error());
+	EXPECT_EQ(8u, result.offset());
+}
+
+TEST_F(DecoderTests,
+MissingRequiredKeyIsReportedAtEndOfDictionary) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::integer(), true},
+		{"b", Schema::integer(), true},
+		{"c", Schema::integer()}
+	}));
+
+	auto result = decoder->tryDecode("d1:ai1e1:ai2ee", *schema);
+
+	EXPECT_EQ(DecodingErrorCode::MissingKey, result.error());
+	EXPECT_EQ(13u, result.offset());
+	EXPECT_TRUE(decoder->tryDecode("d1:bi1e1:ai2ee", *schema).ok());
+}
+
+TEST_F(DecoderTests,
+LastValueOfDuplicateKeyIsUsedWithSchema) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::integer()}
+	}));
+
+	auto result = decoder->tryDecode("d1:ai1e1:ai2ee", *schema);
+
+	ASSERT_TRUE(result.ok());
+	EXPECT_EQ("d1:ai2ee", encode(result.releaseData()));
+}
+
+TEST_F(DecoderTests,
+SkippedValuesAreCheckedWithSchema) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::integer()}
+	}));
+
+	auto invalid = decoder->tryDecode("d1:bli1xee1:ai1ee", *schema);
+	auto trailing = decoder->tryDecode("d1:ai1eei1e", *schema);
+
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, invalid.error());
+	EXPECT_EQ(DecodingErrorCode::UndecodedCharacters, trailing.error());
+}
+
+TEST_F(DecoderTests,
+LimitsAndKeyOrderApplyToSkippedValuesWithSchema) {
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"a", Schema::integer()}
+	}));
+	DecoderLimits limits;
+	limits.maxDepth = 2;
+	decoder->setLimits(limits);
+	auto deep = decoder->tryDecode("d1:ai1e1:bllleee", *schema);
+	decoder->setLimits(DecoderLimits());
+	decoder->setKeyOrderChecking(true);
+	auto unsorted = decoder->tryDecode("d1:ai1e1:bd1:yi1e1:xi1eee", *schema);
+
+	EXPECT_EQ(DecodingErrorCode::DepthLimitExceeded, deep.error());
+	EXPECT_EQ(DecodingErrorCode::UnsortedKeys, unsorted.error());
+}
+
+TEST_F(DecoderTests,
+DecodeWithSchemaThrowsForMismatchingData) {
+	std::shared_ptr<Schema> schema(Schema::integer());
+
+	EXPECT_THROW(decoder->decode("1:a", *schema), DecodingError);
+	EXPECT_THROW(decoder->decode("", *schema), DecodingError);
+}
+
+//
+// Key interning.
+//
+
+TEST_F(DecoderTests,
+KeysAreNotSharedBetweenDictionariesByDefault) {
+	std::shared_ptr<BItem> first(decoder->decode("d1:ai1ee"));
+	std::shared_ptr<BItem> second(decoder->decode("d1:ai2ee"));
+
+	EXPECT_NE(first->as<BDictionary>()->begin()->first,
+		second->as<BDictionary>()->begin()->first);
+}
+
+TEST_F(DecoderTests,
+InternedKeysAreSharedBetweenDecodedDictionaries) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::createForKrpc());
+	decoder->setKeyInterning(table);
+
+	std::shared_ptr<BItem> first(decoder->decode("d1:ti1e1:zi1ee"));
+	std::shared_ptr<BItem> second(decoder->decode("ld1:ti2e1:zi2eee"));
+
+	auto firstDict = first->as<BDictionary>();
+	auto secondDict = second->as<BList>()->front()->as<BDictionary>();
+	EXPECT_EQ(table->intern("t"), firstDict->begin()->first);
+	EXPECT_EQ(table->intern("t"), secondDict->begin()->first);
+	EXPECT_NE(std::next(firstDict->begin())->first,
+		std::next(secondDict->begin())->first);
+	EXPECT_EQ("z", std::next(secondDict->begin())->first->value());
+	EXPECT_EQ(2, (*secondDict)[BString::create("t")]->as<BInteger>()->value());
+}
+
+TEST_F(DecoderTests,
+KeysAreInternedWhenDecodingFromStream) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::create());
+	decoder->setKeyInterning(table);
+	std::istringstream input("d1:ai1eed1:ai2ee");
+
+	std::shared_ptr<BItem> first(decoder->decode(input));
+	std::shared_ptr<BItem> second(decoder->decode(input));
+
+	EXPECT_EQ(first->as<BDictionary>()->begin()->first,
+		second->as<BDictionary>()->begin()->first);
+}
+
+TEST_F(DecoderTests,
+KeysAreInternedWhenDecodingWithSchema) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::createForKrpc());
+	decoder->setKeyInterning(table);
+	std::shared_ptr<Schema> schema(Schema::dictionary({
+		{"t", Schema::string()}
+	}));
+
+	std::shared_ptr<BItem> bItem(decoder->decode("d1:t2:aae", *schema));
+
+	EXPECT_EQ(table->intern("t"), bItem->as<BDictionary>()->begin()->first);
+}
+
+TEST_F(DecoderTests,
+KeysAreNotInternedWhenSpansOfAllItemsAreRecorded) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::createForKrpc());
+	decoder->setKeyInterning(table);
+	decoder->setSpanRecording(true);
+
+	auto result = decoder->tryDecode("d1:ti1ee");
+
+	ASSERT_TRUE(result.ok());
+	std::shared_ptr<BItem> bItem(result.releaseData());
+	auto key = bItem->as<BDictionary>()->begin()->first;
+	EXPECT_NE(table->intern("t"), key);
+	EXPECT_EQ(1u, result.sourceMap().getSpan(*key).begin);
+}
+
+TEST_F(DecoderTests,
+KeyInterningCanBeDisabled) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::createForKrpc());
+	decoder->setKeyInterning(table);
+	decoder->setKeyInterning(nullptr);
+
+	std::shared_ptr<BItem> bItem(decoder->decode("d1:ti1ee"));
+
+	EXPECT_NE(table->intern("t"), bItem->as<BDictionary>()->begin()->first);
+}
+
+//
+// Limits.
+//
+
+TEST_F(DecoderTests,
+NothingIsLimitedByDefault) {
+	const auto &limits = decoder->getLimits();
+
+	EXPECT_EQ(std::numeric_limits<std::size_t>::max(), limits.maxDepth);
+	EXPECT_EQ(std::numeric_limits<std::size_t>::max(), limits.maxInputLength);
+	EXPECT_EQ(std::numeric_limits<std::size_t>::max(), limits.maxNumOfItems);
+	EXPECT_EQ(std::numeric_limits<std::size_t>::max(), limits.maxStringLength);
+	EXPECT_EQ(std::numeric_limits<std::size_t>::max(),
+		limits.maxTotalStringLength);
+}
+
+TEST_F(DecoderTests,
+DataWithinLimitsAreDecoded) {
+	DecoderLimits limits;
+	limits.maxDepth = 2;
+	limits.maxInputLength = 16;
+	limits.maxNumOfItems = 5;
+	limits.maxStringLength = 4;
+	limits.maxTotalStringLength = 5;
+	decoder->setLimits(limits);
+
+	EXPECT_NO_THROW(decoder->decode("d1:ali4e4:testee"));
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingLimitExceededWhenDepthIsExceeded) {
+	DecoderLimits limits;
+	limits.maxDepth = 2;
+	decoder->setLimits(limits);
+
+	EXPECT_THROW(decoder->decode("llleee"), DecodingLimitExceeded);
+	EXPECT_THROW(decoder->decode("d1:ad1:ad1:ai0eeee"), DecodingLimitExceeded);
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingLimitExceededWhenInputLengthIsExceeded) {
+	DecoderLimits limits;
+	limits.maxInputLength = 4;
+	decoder->setLimits(limits);
+
+	EXPECT_THROW(decoder->decode("i123e"), DecodingLimitExceeded);
+	EXPECT_THROW(decoder->decode("4:test"), DecodingLimitExceeded);
+	EXPECT_THROW(decoder->decode("li1ee"), DecodingLimitExceeded);
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingLimitExceededWhenNumOfItemsIsExceeded) {
+	DecoderLimits limits;
+	limits.maxNumOfItems = 3;
+	decoder->setLimits(limits);
+
+	EXPECT_THROW(decoder->decode("li1ei2ei3ee"), DecodingLimitExceeded);
+	EXPECT_THROW(decoder->decode("d1:ai1e1:bi2ee"), DecodingLimitExceeded);
+}
+
+TEST_F(DecoderTests,
+DecodeThrowsDecodingLimitExceededWhenTotalStringLengthIsExceeded) {
+	DecoderLimits limits;
+	limits.maxTotalStringLength = 5;
+	decoder->setLimits(limits);
+
+	EXPECT_THROW(decoder->decode("l3:abc3:defe"), DecodingLimitExceeded);
+}
+
+TEST_F(DecoderTests,
+DecodingLimitExceededIsDecodingError) {
+	DecoderLimits limits;
+	limits.maxNumOfItems = 0;
+	decoder->setLimits(limits);
+
+	EXPECT_THROW(decoder->decode("i1e"), DecodingError);
+}
+
+TEST_F(DecoderTests,
+LimitsApplyToEachDecodingSeparately) {
+	DecoderLimits limits;
+	limits.maxNumOfItems = 1;
+	decoder->setLimits(limits);
+
+	EXPECT_NO_THROW(decoder->decode("i1e"));
+	EXPECT_NO_THROW(decoder->decode("i2e"));
+}
+
 //
 // Other.
 //
@@ -410,6 +1128,55 @@ DecodeForStreamDoesNotReadCharactersPassFirstDecodedItem) {
 	ASSERT_EQ('e', input.get());
 }
 
+TEST_F(DecoderTests,
+DecodeForStreamDoesNotReadCharactersPastNestedItem) {
+	std::istringstream input("d1:al3:xyzi-1eee4:rest");
+	std::shared_ptr<BItem> bItem(decoder->decode(input));
+
+	ADD_SCOPED_TRACE;
+	assertDecodedAs<BDictionary>(bItem);
+	std::string rest;
+	input >> rest;
+	EXPECT_EQ("4:rest", rest);
+}
+
+TEST_F(DecoderTests,
+DecodeForStreamReportsSameErrorsAsDecodeForString) {
+	DecoderLimits limits;
+	limits.maxDepth = 3;
+	limits.maxStringLength = 5;
+	limits.maxTotalStringLength = 8;
+	limits.maxNumOfItems = 10;
+	limits.maxInputLength = 40;
+	decoder->setLimits(limits);
+	decoder->setKeyOrderChecking(true);
+	const char *inputs[] = {
+		"", "$", "e", "i", "i1", "i01e", "i-0e", "i+1e", "i1x", "ie",
+		"99999999999999999999999:a", "01:a", "3:ab", "6:abcdef", "li1e",
+		"llllee", "d1:bi1e1:ai2ee", "d1:ai1e1:ai2ee", "di1ei2ee", "d1:ae",
+		"l5:abcde5:abcdee", "li1ei2ei3ei4ei5ei6ei7ei8ei9ei10ee",
+		"l1:a1:b1:c1:d1:e1:f1:g1:h1:i1:j1:ke", "i0e"
+	};
+
+	for (const char *input : inputs) {
+		SCOPED_TRACE(input);
+		std::string fromString;
+		try {
+			decoder->decode(std::string(input));
+		} catch (const DecodingError &ex) {
+			fromString = ex.what();
+		}
+		std::string fromStream;
+		std::istringstream stream(input);
+		try {
+			decoder->decode(stream);
+		} catch (const DecodingError &ex) {
+			fromStream = ex.what();
+		}
+		EXPECT_EQ(fromString, fromStream);
+	}
+}
+
 TEST_F(DecoderTests,
 DecodeFunctionForStringWorksAsCreatingDecoderAndCallingDecode) {
 	std::string input("i0e");
@@ -0,0 +1,66 @@
+/**
+* @file      DecodingResultTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the DecodingResult class.
+*/
+
+#include <gtest/gtest.h>
+
+#include "BInteger.h"
+#include "DecodingResult.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class DecodingResultTests: public Test {};
+
+TEST_F(DecodingResultTests,
+ResultWithDataIsSuccessful) {
+	DecodingResult result(BInteger::create(1));
+
+	EXPECT_TRUE(result.ok());
+	EXPECT_TRUE(static_cast<bool>(result));
+	EXPECT_EQ(DecodingErrorCode::None, result.error());
+	EXPECT_NE(nullptr, result.data());
+}
+
+TEST_F(DecodingResultTests,
+ReleaseDataPassesOwnershipOfData) {
+	DecodingResult result(BInteger::create(1));
+
+	auto data = result.releaseData();
+
+	EXPECT_NE(nullptr, data);
+	EXPECT_EQ(nullptr, result.data());
+}
+
+TEST_F(DecodingResultTests,
+ResultWithErrorIsNotSuccessful) {
+	DecodingResult result(DecodingErrorCode::InvalidInteger, 5);
+
+	EXPECT_FALSE(result.ok());
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, result.error());
+	EXPECT_EQ(5u, result.offset());
+	EXPECT_EQ(nullptr, result.data());
+}
+
+TEST_F(DecodingResultTests,
+MessageContainsDescriptionAndOffset) {
+	DecodingResult result(DecodingErrorCode::UnexpectedEndOfInput, 42);
+
+	EXPECT_EQ("unexpected end of input at offset 42", result.message());
+}
+
+TEST_F(DecodingResultTests,
+IsLimitErrorReturnsTrueOnlyForLimitErrors) {
+	EXPECT_TRUE(isLimitError(DecodingErrorCode::DepthLimitExceeded));
+	EXPECT_TRUE(isLimitError(DecodingErrorCode::InputLengthLimitExceeded));
+	EXPECT_FALSE(isLimitError(DecodingErrorCode::None));
+	EXPECT_FALSE(isLimitError(DecodingErrorCode::InvalidInteger));
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,212 @@
+/**
+* @file      DocumentStreamTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the DocumentStream class.
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Decoder.h"
+#include "DocumentStream.h"
+#include "Encoder.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class DocumentStreamTests: public Test {
+protected:
+	static std::string createDocuments(std::size_t numOfDocuments);
+	static std::vector<std::string> readAll(DocumentStream &documents);
+};
+
+/**
+* @brief Returns the given number of concatenated documents of various sizes.
+*/
+std::string DocumentStreamTests::createDocuments(std::size_t numOfDocuments) {
+	std::string data;
+	for (std::size_t i = 0; i < numOfDocuments; ++i) {
+		std::string value(i % 7 == 0 ? 1000 : i % 30, 'x');
+		data += "d1:ai" + std::to_string(i) + "e1:b" +
+			std::to_string(value.size()) + ":" + value + "e";
+	}
+	return data;
+}
+
+/**
+* @brief Returns all the valid documents from @a documents (encoded) and an
+*        empty string for the first invalid document.
+*/
+std::vector<std::string> DocumentStreamTests::readAll(
+		DocumentStream &documents) {
+	std::vector<std::string> encodedDocuments;
+	while (documents.hasNext()) {
+		auto result = documents.next();
+		encodedDocuments.push_back(result ?
+			encode(std::shared_ptr<BItem>(result.releaseData())) : "");
+	}
+	return encodedDocuments;
+}
+
+TEST_F(DocumentStreamTests,
+DocumentsInMemoryAreReturnedOneByOne) {
+	std::string data("i1e4:testli2ee");
+	auto documents = DocumentStream::create(data);
+
+	EXPECT_EQ(std::vector<std::string>({"i1e", "4:test", "li2ee"}),
+		readAll(*documents));
+}
+
+TEST_F(DocumentStreamTests,
+DocumentsInStreamAreReturnedOneByOne) {
+	std::istringstream input("i1e4:testli2ee");
+	auto documents = DocumentStream::create(input);
+
+	EXPECT_EQ(std::vector<std::string>({"i1e", "4:test", "li2ee"}),
+		readAll(*documents));
+}
+
+TEST_F(DocumentStreamTests,
+EmptyInputHasNoDocuments) {
+	std::string data;
+	std::istringstream input;
+
+	EXPECT_FALSE(DocumentStream::create(data)->hasNext());
+	EXPECT_FALSE(DocumentStream::create(input)->hasNext());
+}
+
+TEST_F(DocumentStreamTests,
+NextReturnsErrorWhenThereIsNoDocumentLeft) {
+	std::string data("i1e");
+	auto documents = DocumentStream::create(data);
+	documents->next();
+
+	auto result = documents->next();
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, result.error());
+	EXPECT_EQ(3u, result.offset());
+}
+
+TEST_F(DocumentStreamTests,
+ManyDocumentsInStreamSpanningSeveralReadBlocksAreReturned) {
+	std::string data(createDocuments(2000));
+	data += "300000:" + std::string(300000, 'x');
+	std::istringstream input(data);
+	auto documents = DocumentStream::create(input);
+
+	auto encodedDocuments = readAll(*documents);
+
+	ASSERT_EQ(2001u, encodedDocuments.size());
+	std::string concatenatedDocuments;
+	for (const auto &document : encodedDocuments) {
+		concatenatedDocuments += document;
+	}
+	EXPECT_EQ(data, concatenatedDocuments);
+}
+
+TEST_F(DocumentStreamTests,
+OffsetReturnsOffsetOfNextDocument) {
+	std::string data("i1e4:test");
+	auto documents = DocumentStream::create(data);
+
+	EXPECT_EQ(0u, documents->offset());
+	documents->next();
+	EXPECT_EQ(3u, documents->offset());
+	documents->next();
+	EXPECT_EQ(9u, documents->offset());
+}
+
+TEST_F(DocumentStreamTests,
+InvalidDocumentEndsStreamAndItsErrorHasOffsetInInput) {
+	std::istringstream input("i1ei2eli3xe");
+	auto documents = DocumentStream::create(input);
+	documents->next();
+	documents->next();
+
+	auto result = documents->next();
+
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, result.error());
+	EXPECT_EQ(9u, result.offset());
+	EXPECT_FALSE(documents->hasNext());
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, documents->next().error());
+	EXPECT_EQ(6u, documents->offset());
+}
+
+TEST_F(DocumentStreamTests,
+IncompleteLastDocumentIsReported) {
+	std::istringstream input("i1eli2e");
+	auto documents = DocumentStream::create(input);
+	documents->next();
+
+	auto result = documents->next();
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, result.error());
+	EXPECT_EQ(7u, result.offset());
+}
+
+TEST_F(DocumentStreamTests,
+OptionsOfGivenDecoderApplyToEveryDocument) {
+	auto decoder = Decoder::create();
+	DecoderLimits limits;
+	limits.maxInputLength = 5;
+	decoder->setLimits(limits);
+	std::string data("i12ei34e4:abcd");
+	auto documents = DocumentStream::create(data);
+	documents->setDecoderOptions(*decoder);
+
+	EXPECT_TRUE(documents->next().ok());
+	EXPECT_TRUE(documents->next().ok());
+	EXPECT_EQ(DecodingErrorCode::InputLengthLimitExceeded,
+		documents->next().error());
+}
+
+//
+// Parallel decoding.
+//
+
+TEST_F(DocumentStreamTests,
+DocumentsDecodedInParallelAreReturnedInOrder) {
+	std::string data(createDocuments(2000));
+	std::istringstream input(data);
+	auto documentsInMemory = DocumentStream::create(data);
+	documentsInMemory->setNumOfThreads(4);
+	auto documentsInStream = DocumentStream::create(input);
+	documentsInStream->setNumOfThreads(3);
+	auto expectedDocuments = readAll(*DocumentStream::create(data));
+
+	EXPECT_EQ(4u, documentsInMemory->numOfThreads());
+	EXPECT_EQ(expectedDocuments, readAll(*documentsInMemory));
+	EXPECT_EQ(expectedDocuments, readAll(*documentsInStream));
+}
+
+TEST_F(DocumentStreamTests,
+InvalidDocumentEndsStreamWhenDecodingInParallel) {
+	std::string data(createDocuments(100));
+	std::size_t invalidOffset = data.size();
+	data += "d1:bi1e1:ai2ee" + createDocuments(100);
+	auto decoder = Decoder::create();
+	decoder->setKeyOrderChecking(true);
+	auto documents = DocumentStream::create(data);
+	documents->setDecoderOptions(*decoder);
+	documents->setNumOfThreads(4);
+
+	for (std::size_t i = 0; i < 100; ++i) {
+		ASSERT_TRUE(documents->next().ok());
+	}
+	EXPECT_EQ(invalidOffset, documents->offset());
+	auto result = documents->next();
+
+	EXPECT_EQ(DecodingErrorCode::UnsortedKeys, result.error());
+	EXPECT_EQ(invalidOffset + 7, result.offset());
+	EXPECT_FALSE(documents->hasNext());
+	EXPECT_EQ(invalidOffset, documents->offset());
+}
+
+} // namespace tests
+} // namespace bencoding
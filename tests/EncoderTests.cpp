@@ -121,6 +121,25 @@ NonemptyStringIsCorrectlyEncoded) {
 // Other.
 //
 
+TEST_F(EncoderTests,
+EncodeCalledRepeatedlyReturnsOnlyNewlyEncodedData) {
+	std::shared_ptr<BItem> data1(BInteger::create(1));
+	std::shared_ptr<BItem> data2(BInteger::create(2));
+
+	encoder->encode(data1);
+	EXPECT_EQ("i2e", encoder->encode(data2));
+}
+
+TEST_F(EncoderTests,
+EncodeWithOutputAppendsEncodedDataToOutput) {
+	std::shared_ptr<BItem> data(BString::create("test"));
+	std::string output("i1e");
+
+	encoder->encode(data, output);
+
+	EXPECT_EQ("i1e4:test", output);
+}
+
 TEST_F(EncoderTests,
 EncodeFunctionWorksAsCreatingEncoderAndCallingEncode) {
 	std::shared_ptr<BItem> data(BInteger::create(0));
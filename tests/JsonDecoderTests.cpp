@@ -0,0 +1,328 @@
+/**
+* @file      JsonDecoderTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the JsonDecoder class.
+*/
+
+#include <gtest/gtest.h>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include "JsonDecoder.h"
+#include "JsonEncoder.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class JsonDecoderTests: public Test {
+protected:
+	JsonDecoderTests(): decoder(JsonDecoder::create()) {}
+
+protected:
+	std::unique_ptr<JsonDecoder> decoder;
+};
+
+//
+// Object decoding.
+//
+
+TEST_F(JsonDecoderTests,
+EmptyObjectIsDecodedIntoEmptyDictionary) {
+	EXPECT_EQ("de", decoder->decodeIntoBencode("{}"));
+}
+
+TEST_F(JsonDecoderTests,
+ObjectWithSortedKeysIsDecodedIntoDictionary) {
+	EXPECT_EQ("d1:ai1e1:b1:ce",
+		decoder->decodeIntoBencode(R"({"a": 1, "b": "c"})"));
+}
+
+TEST_F(JsonDecoderTests,
+KeysOfObjectAreSortedByDefault) {
+	EXPECT_EQ("d1:ai1e2:aali1ei2ee1:bd1:xi0e1:yi0eee",
+		decoder->decodeIntoBencode(
+			R"({"b": {"y": 0, "x": 0}, "aa": [1, 2], "a": 1})"));
+}
+
+TEST_F(JsonDecoderTests,
+KeysOfObjectAreKeptInInputOrderWhenSortingIsDisabled) {
+	decoder->setKeySorting(false);
+
+	EXPECT_EQ("d1:bi1e1:ai2ee",
+		decoder->decodeIntoBencode(R"({"b": 1, "a": 2})"));
+}
+
+TEST_F(JsonDecoderTests,
+ObjectWithDuplicateKeyCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(R"({"b": 1, "a": 2, "b": 3})"),
+		DecodingError);
+	EXPECT_THROW(decoder->decodeIntoBencode(R"({"a": 1, "a": 2})"),
+		DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+ObjectWithNonStringKeyCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(R"({1: 2})"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+ObjectWithTrailingCommaCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(R"({"a": 1,})"), DecodingError);
+}
+
+//
+// Array decoding.
+//
+
+TEST_F(JsonDecoderTests,
+EmptyArrayIsDecodedIntoEmptyList) {
+	EXPECT_EQ("le", decoder->decodeIntoBencode("[ ]"));
+}
+
+TEST_F(JsonDecoderTests,
+ArrayIsDecodedIntoList) {
+	EXPECT_EQ("li1e1:ali2eee", decoder->decodeIntoBencode(R"([1, "a", [2]])"));
+}
+
+TEST_F(JsonDecoderTests,
+UnterminatedArrayCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("[1, 2"), DecodingError);
+}
+
+//
+// Number decoding.
+//
+
+TEST_F(JsonDecoderTests,
+IntegralNumbersAreDecodedIntoIntegers) {
+	EXPECT_EQ("i0e", decoder->decodeIntoBencode("0"));
+	EXPECT_EQ("i-15e", decoder->decodeIntoBencode("-15"));
+	EXPECT_EQ("i9223372036854775807e",
+		decoder->decodeIntoBencode("9223372036854775807"));
+	EXPECT_EQ("i-9223372036854775808e",
+		decoder->decodeIntoBencode("-9223372036854775808"));
+}
+
+TEST_F(JsonDecoderTests,
+NegativeZeroIsDecodedIntoZero) {
+	EXPECT_EQ("i0e", decoder->decodeIntoBencode("-0"));
+}
+
+TEST_F(JsonDecoderTests,
+NumberOutOfRangeCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("9223372036854775808"),
+		DecodingError);
+	EXPECT_THROW(decoder->decodeIntoBencode("-9223372036854775809"),
+		DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+NumberWithFractionOrExponentCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("1.5"), DecodingError);
+	EXPECT_THROW(decoder->decodeIntoBencode("1e3"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+NumberWithLeadingZeroCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("01"), DecodingError);
+}
+
+//
+// Literal decoding.
+//
+
+TEST_F(JsonDecoderTests,
+BooleansAreDecodedIntoIntegers) {
+	EXPECT_EQ("li1ei0ee", decoder->decodeIntoBencode("[true, false]"));
+}
+
+TEST_F(JsonDecoderTests,
+NullCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("null"), DecodingError);
+}
+
+//
+// String decoding.
+//
+
+TEST_F(JsonDecoderTests,
+StringIsDecodedIntoString) {
+	EXPECT_EQ("4:test", decoder->decodeIntoBencode(R"("test")"));
+}
+
+TEST_F(JsonDecoderTests,
+EscapeSequencesInStringAreDecoded) {
+	EXPECT_EQ("8:\"\\/\b\f\n\r\t",
+		decoder->decodeIntoBencode(R"("\"\\\/\b\f\n\r\t")"));
+}
+
+TEST_F(JsonDecoderTests,
+UnicodeEscapeSequencesAreDecodedIntoUtf8) {
+	EXPECT_EQ(std::string("1:\x00", 3), decoder->decodeIntoBencode(R"("\u0000")"));
+	EXPECT_EQ("2:\xc5\x99", decoder->decodeIntoBencode(R"("ř")"));
+	EXPECT_EQ("3:\xe2\x82\xac", decoder->decodeIntoBencode(R"("€")"));
+	EXPECT_EQ("4:\xf0\x9f\x98\x80",
+		decoder->decodeIntoBencode(R"("😀")"));
+}
+
+TEST_F(JsonDecoderTests,
+UnpairedSurrogateCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(R"("\ud83d")"), DecodingError);
+	EXPECT_THROW(decoder->decodeIntoBencode(R"("\ude00")"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+InvalidEscapeSequenceCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(R"("\x")"), DecodingError);
+	EXPECT_THROW(decoder->decodeIntoBencode(R"("\u12")"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+StringWithUnescapedControlCharacterCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("\"a\nb\""), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+UnterminatedStringCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(R"("abc)"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+BinaryStringsAreKeptAsTheyAreByDefault) {
+	EXPECT_EQ("6:hex:ff", decoder->decodeIntoBencode(R"("hex:ff")"));
+}
+
+TEST_F(JsonDecoderTests,
+BinaryStringsAreDecodedWhenBinaryDecodingIsEnabled) {
+	decoder->setBinaryDecoding(true);
+
+	EXPECT_EQ("2:\xff\xfe", decoder->decodeIntoBencode(R"("hex:fffe")"));
+	EXPECT_EQ("2:\xff\xfe", decoder->decodeIntoBencode(R"("base64://4=")"));
+	EXPECT_EQ("d2:\xff\xfei1ee",
+		decoder->decodeIntoBencode(R"({"hex:fffe": 1})"));
+}
+
+TEST_F(JsonDecoderTests,
+InvalidBinaryStringCannotBeDecodedWhenBinaryDecodingIsEnabled) {
+	decoder->setBinaryDecoding(true);
+
+	EXPECT_THROW(decoder->decodeIntoBencode(R"("hex:xyz")"), DecodingError);
+}
+
+//
+// Other.
+//
+
+TEST_F(JsonDecoderTests,
+InputWithUndecodedCharactersCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode("1 2"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+EmptyInputCannotBeDecoded) {
+	EXPECT_THROW(decoder->decodeIntoBencode(" "), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+ErrorMessageContainsOffset) {
+	try {
+		decoder->decodeIntoBencode("[1, x]");
+		FAIL() << "expected DecodingError";
+	} catch (const DecodingError &ex) {
+		EXPECT_NE(std::string::npos,
+			std::string(ex.what()).find("at offset 4"));
+	}
+}
+
+TEST_F(JsonDecoderTests,
+DecodeReturnsDecodedData) {
+	std::shared_ptr<BItem> bItem(decoder->decode(R"({"b": 2, "a": "x"})"));
+
+	auto bDictionary = bItem->as<BDictionary>();
+	ASSERT_TRUE(bDictionary);
+	EXPECT_EQ(2, (*bDictionary)[BString::create("b")]->as<BInteger>()->value());
+}
+
+TEST_F(JsonDecoderTests,
+DecodeBuildsSameItemsAsDecodingOfConvertedData) {
+	std::string json(R"({"b": [1, -9223372036854775808, {}], "a": {"y": "s",)"
+		R"( "x": true}, "c": []})");
+
+	std::shared_ptr<BItem> bItem(decoder->decode(json));
+
+	EXPECT_EQ(decoder->decodeIntoBencode(json), encode(bItem));
+}
+
+TEST_F(JsonDecoderTests,
+DecodeThrowsExceptionOnDuplicateKey) {
+	EXPECT_THROW(decoder->decode(R"({"a": 1, "a": 2})"), DecodingError);
+}
+
+TEST_F(JsonDecoderTests,
+DecodeKeepsLastValueOfDuplicateKeyWhenSortingIsDisabled) {
+	decoder->setKeySorting(false);
+
+	std::shared_ptr<BItem> bItem(decoder->decode(R"({"a": 1, "a": 2})"));
+
+	auto bDictionary = bItem->as<BDictionary>();
+	ASSERT_EQ(1u, bDictionary->size());
+	EXPECT_EQ(2, (*bDictionary)[BString::create("a")]->as<BInteger>()->value());
+}
+
+TEST_F(JsonDecoderTests,
+DeeplyNestedInputIsDecodedWithoutRecursion) {
+	std::size_t depth = 100000;
+	std::string json(std::string(depth, '[') + std::string(depth, ']'));
+
+	EXPECT_EQ(std::string(depth, 'l') + std::string(depth, 'e'),
+		decoder->decodeIntoBencode(json));
+	// Destroy the nested lists one by one to prevent a deep recursion.
+	std::shared_ptr<BItem> bItem(decoder->decode(json));
+	while (bItem && !bItem->as<BList>()->empty()) {
+		std::shared_ptr<BItem> inner = bItem->as<BList>()->front();
+		bItem->as<BList>()->pop_back();
+		bItem = inner;
+	}
+}
+
+TEST_F(JsonDecoderTests,
+InputNestedDeeperThanMaxDepthCannotBeDecoded) {
+	decoder->setMaxDepth(2);
+
+	EXPECT_EQ("ld1:ai1eee", decoder->decodeIntoBencode(R"([{"a": 1}])"));
+	EXPECT_THROW(decoder->decodeIntoBencode(R"([{"a": []}])"),
+		DecodingLimitExceeded);
+	EXPECT_THROW(decoder->decode("[[[]]]"), DecodingLimitExceeded);
+}
+
+TEST_F(JsonDecoderTests,
+DataEncodedByJsonEncoderAreDecodedBackIntoOriginalData) {
+	const char rawData[] = "d3:bin3:\xff\x00\x01" "3:inti-1e4:text2:\"\ne";
+	std::string encodedData(rawData, sizeof(rawData) - 1);
+	auto json = encodeAsJson(bencoding::decode(encodedData));
+	decoder->setBinaryDecoding(true);
+
+	EXPECT_EQ(encodedData, decoder->decodeIntoBencode(json));
+}
+
+TEST_F(JsonDecoderTests,
+ConvertJsonToBencodeConvertsJson) {
+	EXPECT_EQ("li1ee", convertJsonToBencode("[1]"));
+}
+
+TEST_F(JsonDecoderTests,
+DecodeJsonDecodesJson) {
+	std::shared_ptr<BItem> bItem(decodeJson("[1]"));
+
+	EXPECT_TRUE(bItem->as<BList>());
+}
+
+} // namespace tests
+} // namespace bencoding
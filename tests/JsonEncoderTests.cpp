@@ -0,0 +1,186 @@
+/**
+* @file      JsonEncoderTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the JsonEncoder class.
+*/
+
+#include <gtest/gtest.h>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "JsonEncoder.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class JsonEncoderTests: public Test {
+protected:
+	JsonEncoderTests(): encoder(JsonEncoder::create()) {}
+
+protected:
+	std::unique_ptr<JsonEncoder> encoder;
+};
+
+//
+// Dictionary encoding.
+//
+
+TEST_F(JsonEncoderTests,
+EmptyDictionaryIsEncodedAsEmptyObject) {
+	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
+
+	EXPECT_EQ("{}", encoder->encode(bDictionary));
+}
+
+TEST_F(JsonEncoderTests,
+DictionaryWithTwoItemsIsEncodedAsObject) {
+	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
+	(*bDictionary)[BString::create("a")] = BInteger::create(1);
+	(*bDictionary)[BString::create("b")] = BString::create("c");
+
+	EXPECT_EQ(R"({"a":1,"b":"c"})", encoder->encode(bDictionary));
+}
+
+TEST_F(JsonEncoderTests,
+BinaryDictionaryKeyIsEncodedInBinaryEncoding) {
+	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
+	(*bDictionary)[BString::create("\xff")] = BInteger::create(1);
+	encoder->setBinaryEncoding(BinaryEncoding::Hex);
+
+	EXPECT_EQ(R"({"hex:ff":1})", encoder->encode(bDictionary));
+}
+
+//
+// Integer encoding.
+//
+
+TEST_F(JsonEncoderTests,
+IntegerIsEncodedAsNumber) {
+	std::shared_ptr<BItem> data(BInteger::create(-13));
+
+	EXPECT_EQ("-13", encoder->encode(data));
+}
+
+//
+// List encoding.
+//
+
+TEST_F(JsonEncoderTests,
+EmptyListIsEncodedAsEmptyArray) {
+	std::shared_ptr<BList> bList(BList::create());
+
+	EXPECT_EQ("[]", encoder->encode(bList));
+}
+
+TEST_F(JsonEncoderTests,
+ListWithTwoItemsIsEncodedAsArray) {
+	std::shared_ptr<BList> bList(BList::create({
+		BInteger::create(1), BList::create()
+	}));
+
+	EXPECT_EQ("[1,[]]", encoder->encode(bList));
+}
+
+//
+// String encoding.
+//
+
+TEST_F(JsonEncoderTests,
+TextStringIsEncodedAsJsonString) {
+	std::shared_ptr<BItem> data(BString::create("test"));
+
+	EXPECT_EQ(R"("test")", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+QuotesBackslashesAndControlCharactersAreEscaped) {
+	std::shared_ptr<BItem> data(BString::create(
+		std::string("a\"b\\c\n\t\x01\0d", 10)));
+
+	EXPECT_EQ(R"("a\"b\\c\n\t\u0001\u0000d")", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+CharactersToEscapeAreFoundInLongStrings) {
+	std::shared_ptr<BItem> data(BString::create(
+		"0123456789abcdef\"0123456789abcdef\n01234567"));
+
+	EXPECT_EQ(R"("0123456789abcdef\"0123456789abcdef\n01234567")",
+		encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+NonAsciiUtf8StringIsEncodedAsIs) {
+	std::shared_ptr<BItem> data(BString::create("p\xc5\x99\xc3\xadli\xc5\xa1"));
+
+	EXPECT_EQ("\"p\xc5\x99\xc3\xadli\xc5\xa1\"", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+BinaryStringIsEncodedInBase64ByDefault) {
+	std::shared_ptr<BItem> data(BString::create(std::string("\xff\x00\x01", 3)));
+
+	EXPECT_EQ(R"("base64:/wAB")", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+BinaryStringIsEncodedInHexWhenRequested) {
+	std::shared_ptr<BItem> data(BString::create(std::string("\xff\x00\x01", 3)));
+	encoder->setBinaryEncoding(BinaryEncoding::Hex);
+
+	EXPECT_EQ(R"("hex:ff0001")", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+BinaryPrefixCanBeChanged) {
+	std::shared_ptr<BItem> data(BString::create("\xff"));
+	encoder->setBinaryPrefix("");
+
+	EXPECT_EQ(R"("/w==")", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+TextStringStartingWithBinaryPrefixIsEncodedInBinaryEncoding) {
+	std::shared_ptr<BItem> data(BString::create("hex:a"));
+	encoder->setBinaryEncoding(BinaryEncoding::Hex);
+
+	EXPECT_EQ(R"("hex:6865783a61")", encoder->encode(data));
+}
+
+TEST_F(JsonEncoderTests,
+AllStringsAreEncodedInBinaryEncodingWhenUtf8DetectionIsDisabled) {
+	std::shared_ptr<BItem> data(BString::create("ab"));
+	encoder->setBinaryEncoding(BinaryEncoding::Hex);
+	encoder->setUtf8Detection(false);
+
+	EXPECT_EQ(R"("hex:6162")", encoder->encode(data));
+}
+
+//
+// Other.
+//
+
+TEST_F(JsonEncoderTests,
+EncodeWithOutputAppendsEncodedDataToOutput) {
+	std::shared_ptr<BItem> data(BInteger::create(1));
+	std::string output("[");
+
+	encoder->encode(data, output);
+
+	EXPECT_EQ("[1", output);
+}
+
+TEST_F(JsonEncoderTests,
+EncodeAsJsonFunctionWorksAsCreatingEncoderAndCallingEncode) {
+	std::shared_ptr<BItem> data(BString::create("\xff\xfe"));
+
+	EXPECT_EQ(R"("hex:fffe")", encodeAsJson(data, BinaryEncoding::Hex));
+}
+
+} // namespace tests
+} // namespace bencoding
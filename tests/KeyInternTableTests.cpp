@@ -0,0 +1,120 @@
+/**
+* @file      KeyInternTableTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the KeyInternTable class.
+*/
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "KeyInternTable.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class KeyInternTableTests: public Test {};
+
+TEST_F(KeyInternTableTests,
+FixedTableReturnsSameInstanceForKeyInTable) {
+	auto table = KeyInternTable::create(std::vector<std::string>{"id", "t"});
+
+	auto first = table->intern("id");
+	auto second = table->intern(std::string("idx").data(), 2);
+
+	EXPECT_EQ(first, second);
+	EXPECT_EQ("id", first->value());
+	EXPECT_EQ(2u, table->size());
+	EXPECT_FALSE(table->isAdaptive());
+}
+
+TEST_F(KeyInternTableTests,
+FixedTableReturnsNewInstancesForKeyNotInTable) {
+	auto table = KeyInternTable::create(std::vector<std::string>{"id"});
+
+	auto first = table->intern("token");
+	auto second = table->intern("token");
+
+	EXPECT_NE(first, second);
+	EXPECT_EQ("token", first->value());
+	EXPECT_EQ(1u, table->size());
+}
+
+TEST_F(KeyInternTableTests,
+FixedTableIgnoresDuplicateKeys) {
+	auto table = KeyInternTable::create(std::vector<std::string>{"a", "a"});
+
+	EXPECT_EQ(1u, table->size());
+}
+
+TEST_F(KeyInternTableTests,
+EmptyKeyCanBeInterned) {
+	auto table = KeyInternTable::create(std::vector<std::string>{""});
+
+	EXPECT_EQ(table->intern(""), table->intern(""));
+}
+
+TEST_F(KeyInternTableTests,
+KrpcTableContainsKeysOfKrpcMessages) {
+	auto table = KeyInternTable::createForKrpc();
+
+	EXPECT_EQ(table->intern("info_hash"), table->intern("info_hash"));
+	EXPECT_EQ(table->intern("y"), table->intern("y"));
+	EXPECT_FALSE(table->isAdaptive());
+}
+
+TEST_F(KeyInternTableTests,
+AdaptiveTableAddsKeysUntilItIsFull) {
+	auto table = KeyInternTable::create(2);
+
+	auto a = table->intern("a");
+	auto b = table->intern("b");
+	auto c = table->intern("c");
+
+	EXPECT_TRUE(table->isAdaptive());
+	EXPECT_EQ(2u, table->size());
+	EXPECT_EQ(a, table->intern("a"));
+	EXPECT_EQ(b, table->intern("b"));
+	EXPECT_NE(c, table->intern("c"));
+}
+
+TEST_F(KeyInternTableTests,
+AdaptiveTableDoesNotAddTooLongKeys) {
+	auto table = KeyInternTable::create();
+	std::string key(KeyInternTable::MAX_KEY_LENGTH + 1, 'k');
+
+	auto first = table->intern(key);
+
+	EXPECT_NE(first, table->intern(key));
+	EXPECT_EQ(key, first->value());
+	EXPECT_EQ(0u, table->size());
+}
+
+TEST_F(KeyInternTableTests,
+AdaptiveTableCanBeUsedByMultipleThreads) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::create());
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([table]() {
+			for (int j = 0; j < 1000; ++j) {
+				table->intern("key" + std::to_string(j % 100));
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(100u, table->size());
+	EXPECT_EQ(table->intern("key42"), table->intern("key42"));
+}
+
+} // namespace tests
+} // namespace bencoding
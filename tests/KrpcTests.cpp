@@ -0,0 +1,336 @@
+/**
+* @file      KrpcTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for decoding and encoding of KRPC messages.
+*/
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Krpc.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class KrpcTests: public Test {
+protected:
+	KrpcTests(): id(20, 'i'), infoHash(20, 'h') {}
+
+	/// Node ID used in the messages.
+	std::string id;
+
+	/// Infohash used in the messages.
+	std::string infoHash;
+
+	/// The decoded message.
+	KrpcMessage message;
+};
+
+//
+// Decoding.
+//
+
+TEST_F(KrpcTests,
+PingQueryIsDecoded) {
+	std::string data("d1:ad2:id20:" + id + "e1:q4:ping1:t2:aa1:y1:qe");
+
+	auto result = decodeKrpc(data, message);
+
+	ASSERT_TRUE(result.ok()) << result.message();
+	EXPECT_EQ(KrpcMessageType::Query, message.type);
+	EXPECT_EQ(KrpcMethod::Ping, message.method);
+	EXPECT_EQ("ping", message.methodName.string());
+	EXPECT_EQ("aa", message.transactionId.string());
+	EXPECT_EQ(id, message.id.string());
+	EXPECT_FALSE(message.target.present());
+	EXPECT_FALSE(message.version.present());
+}
+
+TEST_F(KrpcTests,
+DecodedStringsPointIntoData) {
+	std::string data("d1:ad2:id20:" + id + "e1:q4:ping1:t2:aa1:y1:qe");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(data.data() + 12, message.id.data);
+	EXPECT_EQ(20u, message.id.length);
+}
+
+TEST_F(KrpcTests,
+FindNodeQueryIsDecoded) {
+	std::string target(20, 't');
+	std::string data("d1:ad2:id20:" + id + "6:target20:" + target +
+		"e1:q9:find_node1:t2:aa1:v4:LT011:y1:qe");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(KrpcMethod::FindNode, message.method);
+	EXPECT_EQ(target, message.target.string());
+	EXPECT_EQ("LT01", message.version.string());
+}
+
+TEST_F(KrpcTests,
+AnnouncePeerQueryIsDecoded) {
+	std::string data("d1:ad2:id20:" + id + "12:implied_porti1e9:info_hash20:" +
+		infoHash + "4:porti6881e5:token5:aoeuse1:q13:announce_peer"
+		"1:t2:aa1:y1:qe");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(KrpcMethod::AnnouncePeer, message.method);
+	EXPECT_EQ(infoHash, message.infoHash.string());
+	EXPECT_EQ(6881, message.port);
+	EXPECT_TRUE(message.impliedPort);
+	EXPECT_EQ("aoeus", message.token.string());
+}
+
+TEST_F(KrpcTests,
+GetPeersResponseWithValuesIsDecoded) {
+	std::string data("d1:rd2:id20:" + id + "5:token2:tk6:valuesl6:aaaaaa"
+		"6:bbbbbbee1:t2:aa1:y1:re");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(KrpcMessageType::Response, message.type);
+	EXPECT_EQ(id, message.id.string());
+	EXPECT_EQ("tk", message.token.string());
+	ASSERT_EQ(2u, message.numOfValues);
+	EXPECT_EQ("aaaaaa", message.values[0].string());
+	EXPECT_EQ("bbbbbb", message.values[1].string());
+}
+
+TEST_F(KrpcTests,
+FindNodeResponseWithNodesIsDecoded) {
+	std::string nodes(52, 'n');
+	std::string data("d2:ip6:abcdef1:rd2:id20:" + id + "5:nodes52:" + nodes +
+		"e2:roi1e1:t2:aa1:y1:re");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(nodes, message.nodes.string());
+	EXPECT_EQ("abcdef", message.externalIp.string());
+	EXPECT_TRUE(message.readOnly);
+}
+
+TEST_F(KrpcTests,
+ErrorIsDecoded) {
+	std::string data("d1:eli201e23:A Generic Error Ocurrede1:t2:aa1:y1:ee");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(KrpcMessageType::Error, message.type);
+	EXPECT_EQ(201, message.errorCode);
+	EXPECT_EQ("A Generic Error Ocurred", message.errorMessage.string());
+}
+
+TEST_F(KrpcTests,
+UnknownKeysAndMethodsAreAccepted) {
+	std::string data("d1:ad2:id20:" + id + "4:wantl2:n4ee1:q6:sample"
+		"1:t2:aa1:xli1ee1:y1:qe");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(KrpcMethod::Other, message.method);
+	EXPECT_EQ("sample", message.methodName.string());
+}
+
+TEST_F(KrpcTests,
+ValuesOfUnknownKeysAreNotTakenForKeys) {
+	std::string data("d1:ad2:id20:" + id + "1:x6:targete1:q4:ping"
+		"1:t2:aa1:x1:y1:y1:qe");
+
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+
+	EXPECT_EQ(KrpcMessageType::Query, message.type);
+	EXPECT_FALSE(message.target.present());
+}
+
+TEST_F(KrpcTests,
+DecodingResetsPreviouslyDecodedMessage) {
+	std::string first("d1:rd2:id20:" + id + "6:valuesl6:aaaaaaee1:t2:aa"
+		"1:y1:re");
+	std::string second("d1:rd2:id20:" + id + "e1:t2:bb1:y1:re");
+
+	ASSERT_TRUE(decodeKrpc(first, message).ok());
+	ASSERT_TRUE(decodeKrpc(second, message).ok());
+
+	EXPECT_EQ(0u, message.numOfValues);
+	EXPECT_EQ("bb", message.transactionId.string());
+}
+
+TEST_F(KrpcTests,
+MissingTransactionIdIsReportedAtEndOfMessage) {
+	std::string data("d1:rd2:id20:" + id + "e1:y1:re");
+
+	auto result = decodeKrpc(data, message);
+
+	EXPECT_EQ(DecodingErrorCode::MissingKey, result.error());
+	EXPECT_EQ(data.size() - 1, result.offset());
+}
+
+TEST_F(KrpcTests,
+MissingArgumentOfMethodIsReported) {
+	std::string data("d1:ad2:id20:" + id + "e1:q9:get_peers1:t2:aa1:y1:qe");
+
+	auto result = decodeKrpc(data, message);
+
+	EXPECT_EQ(DecodingErrorCode::MissingKey, result.error());
+}
+
+TEST_F(KrpcTests,
+NodeIdOfInvalidLengthIsReported) {
+	std::string data("d1:rd2:id3:abce1:t2:aa1:y1:re");
+
+	auto result = decodeKrpc(data, message);
+
+	EXPECT_EQ(DecodingErrorCode::InvalidValue, result.error());
+	EXPECT_EQ(9u, result.offset());
+}
+
+TEST_F(KrpcTests,
+InvalidMessageTypeIsReported) {
+	std::string data("d1:t2:aa1:y1:xe");
+
+	auto result = decodeKrpc(data, message);
+
+	EXPECT_EQ(DecodingErrorCode::InvalidValue, result.error());
+	EXPECT_EQ(11u, result.offset());
+}
+
+TEST_F(KrpcTests,
+ValueOfUnexpectedTypeIsReported) {
+	std::string data("d1:ti1e1:y1:re");
+
+	auto result = decodeKrpc(data, message);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedType, result.error());
+	EXPECT_EQ(4u, result.offset());
+}
+
+TEST_F(KrpcTests,
+PortOutOfRangeIsReported) {
+	std::string data("d1:ad2:id20:" + id + "9:info_hash20:" + infoHash +
+		"4:porti65536e5:token2:tke1:q13:announce_peer1:t2:aa1:y1:qe");
+
+	auto result = decodeKrpc(data, message);
+
+	EXPECT_EQ(DecodingErrorCode::IntegerOutOfRange, result.error());
+}
+
+TEST_F(KrpcTests,
+MessageThatIsNotDictionaryIsReported) {
+	std::string list("li1ee");
+	std::string empty;
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedType,
+		decodeKrpc(list, message).error());
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput,
+		decodeKrpc(empty, message).error());
+}
+
+TEST_F(KrpcTests,
+MalformedMessageIsReported) {
+	std::string truncated("d1:t2:aa");
+	std::string trailing("d1:eli1e0:e1:t0:1:y1:eex");
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput,
+		decodeKrpc(truncated, message).error());
+	EXPECT_EQ(DecodingErrorCode::UndecodedCharacters,
+		decodeKrpc(trailing, message).error());
+}
+
+TEST_F(KrpcTests,
+LimitsAreApplied) {
+	std::string data("d1:rd2:id20:" + id + "e1:t2:aa1:y1:re");
+	DecoderLimits limits;
+	limits.maxStringLength = 10;
+
+	auto result = decodeKrpc(data, message, limits);
+
+	EXPECT_EQ(DecodingErrorCode::StringLengthLimitExceeded, result.error());
+}
+
+//
+// Encoding.
+//
+
+TEST_F(KrpcTests,
+PingResponseIsEncoded) {
+	message.type = KrpcMessageType::Response;
+	message.transactionId = KrpcBytes("aa", 2);
+	message.id = KrpcBytes(id.data(), id.size());
+
+	EXPECT_EQ("d1:rd2:id20:" + id + "e1:t2:aa1:y1:re", encodeKrpc(message));
+}
+
+TEST_F(KrpcTests,
+AnnouncePeerQueryIsEncodedWithMethodName) {
+	message.method = KrpcMethod::AnnouncePeer;
+	message.transactionId = KrpcBytes("aa", 2);
+	message.id = KrpcBytes(id.data(), id.size());
+	message.infoHash = KrpcBytes(infoHash.data(), infoHash.size());
+	message.port = 6881;
+	message.token = KrpcBytes("tk", 2);
+	message.version = KrpcBytes("LT01", 4);
+
+	EXPECT_EQ("d1:ad2:id20:" + id + "9:info_hash20:" + infoHash +
+		"4:porti6881e5:token2:tke1:q13:announce_peer1:t2:aa1:v4:LT01"
+		"1:y1:qe", encodeKrpc(message));
+}
+
+TEST_F(KrpcTests,
+GetPeersResponseIsEncodedWithValues) {
+	message.type = KrpcMessageType::Response;
+	message.transactionId = KrpcBytes("aa", 2);
+	message.id = KrpcBytes(id.data(), id.size());
+	message.token = KrpcBytes("tk", 2);
+	message.values[0] = KrpcBytes("aaaaaa", 6);
+	message.values[1] = KrpcBytes("bbbbbb", 6);
+	message.numOfValues = 2;
+
+	EXPECT_EQ("d1:rd2:id20:" + id + "5:token2:tk6:valuesl6:aaaaaa6:bbbbbbee"
+		"1:t2:aa1:y1:re", encodeKrpc(message));
+}
+
+TEST_F(KrpcTests,
+ErrorIsEncoded) {
+	message.type = KrpcMessageType::Error;
+	message.transactionId = KrpcBytes("aa", 2);
+	message.errorCode = -203;
+	message.errorMessage = KrpcBytes("Protocol Error", 14);
+
+	EXPECT_EQ("d1:eli-203e14:Protocol Errore1:t2:aa1:y1:ee",
+		encodeKrpc(message));
+}
+
+TEST_F(KrpcTests,
+EncodingReturnsNeededLengthWhenBufferIsTooSmall) {
+	message.type = KrpcMessageType::Response;
+	message.transactionId = KrpcBytes("aa", 2);
+	message.id = KrpcBytes(id.data(), id.size());
+	char buffer[10];
+
+	EXPECT_EQ(encodeKrpc(message).size(),
+		encodeKrpc(message, buffer, sizeof(buffer)));
+	EXPECT_EQ(encodeKrpc(message).size(), encodeKrpc(message, nullptr, 0));
+}
+
+TEST_F(KrpcTests,
+DecodedMessageIsEncodedBackIntoSameData) {
+	std::string data("d1:ad2:id20:" + id + "12:implied_porti1e9:info_hash20:" +
+		infoHash + "4:porti6881e5:token5:aoeuse2:ip6:abcdef"
+		"1:q13:announce_peer2:roi1e1:t2:aa1:v4:LT011:y1:qe");
+	ASSERT_TRUE(decodeKrpc(data, message).ok());
+	char buffer[512];
+
+	std::size_t length = encodeKrpc(message, buffer, sizeof(buffer));
+
+	EXPECT_EQ(data, std::string(buffer, length));
+}
+
+} // namespace tests
+} // namespace bencoding
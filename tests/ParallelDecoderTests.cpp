@@ -0,0 +1,266 @@
+/**
+* @file      ParallelDecoderTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the ParallelDecoder class.
+*/
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BDictionary.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include "KeyInternTable.h"
+#include "ParallelDecoder.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class ParallelDecoderTests: public Test {
+protected:
+	ParallelDecoderTests(): decoder(ParallelDecoder::create(4)) {}
+
+	static std::string createLargeList(std::size_t numOfItems);
+	static std::string createLargeDictionary(std::size_t numOfItems);
+	void assertDecodedInTheSameWayAsByDecoder(const std::string &data);
+	void assertErrorIsSameAsErrorOfDecoder(const std::string &data);
+	void assertErrorIsSameAsErrorOfDecoder(const std::string &data,
+		Decoder &options);
+
+protected:
+	std::unique_ptr<ParallelDecoder> decoder;
+};
+
+std::string ParallelDecoderTests::createLargeList(std::size_t numOfItems) {
+	std::string data("l");
+	for (std::size_t i = 0; i < numOfItems; ++i) {
+		std::string name("item " + std::to_string(i));
+		data += "d2:idi" + std::to_string(i) + "e4:listli1e" +
+			std::to_string(i % 50) + ":" + std::string(i % 50, 'x') +
+			"e4:name" + std::to_string(name.size()) + ":" + name + "e";
+	}
+	return data + "e";
+}
+
+std::string ParallelDecoderTests::createLargeDictionary(
+		std::size_t numOfItems) {
+	// The keys are not sorted.
+	std::string data("d");
+	for (std::size_t i = 0; i < numOfItems; ++i) {
+		data += "3:k" + std::to_string(i % 10) + std::to_string(i / 10 % 10) +
+			"li" + std::to_string(i) + "e3:abce";
+	}
+	return data + "e";
+}
+
+void ParallelDecoderTests::assertDecodedInTheSameWayAsByDecoder(
+		const std::string &data) {
+	auto expected = encode(std::shared_ptr<BItem>(decode(data)));
+	auto decodedData = decoder->decode(data);
+
+	ASSERT_TRUE(decodedData != nullptr);
+	EXPECT_EQ(expected, encode(std::shared_ptr<BItem>(std::move(decodedData))));
+}
+
+void ParallelDecoderTests::assertErrorIsSameAsErrorOfDecoder(
+		const std::string &data) {
+	std::string expectedError;
+	try {
+		decode(data);
+		FAIL() << "Decoder did not throw";
+	} catch (const DecodingError &ex) {
+		expectedError = ex.what();
+	}
+
+	try {
+		decoder->decode(data);
+		FAIL() << "ParallelDecoder did not throw";
+	} catch (const DecodingError &ex) {
+		EXPECT_EQ(expectedError, ex.what());
+	}
+}
+
+void ParallelDecoderTests::assertErrorIsSameAsErrorOfDecoder(
+		const std::string &data, Decoder &options) {
+	std::string expectedError;
+	try {
+		options.decode(data);
+		FAIL() << "Decoder did not throw";
+	} catch (const DecodingError &ex) {
+		expectedError = ex.what();
+	}
+
+	decoder->setDecoderOptions(options);
+	try {
+		decoder->decode(data);
+		FAIL() << "ParallelDecoder did not throw";
+	} catch (const DecodingError &ex) {
+		EXPECT_EQ(expectedError, ex.what());
+	}
+}
+
+TEST_F(ParallelDecoderTests,
+NumOfThreadsReturnsRequestedNumberOfThreads) {
+	EXPECT_EQ(4, decoder->numOfThreads());
+}
+
+TEST_F(ParallelDecoderTests,
+SmallDataAreDecodedInTheSameWayAsByDecoder) {
+	assertDecodedInTheSameWayAsByDecoder("d1:ali1ei2ee1:bi3ee");
+	assertDecodedInTheSameWayAsByDecoder("i5e");
+	assertDecodedInTheSameWayAsByDecoder("4:test");
+}
+
+TEST_F(ParallelDecoderTests,
+LargeListIsDecodedInTheSameWayAsByDecoder) {
+	assertDecodedInTheSameWayAsByDecoder(createLargeList(5000));
+}
+
+TEST_F(ParallelDecoderTests,
+LargeDictionaryIsDecodedInTheSameWayAsByDecoder) {
+	assertDecodedInTheSameWayAsByDecoder(createLargeDictionary(5000));
+}
+
+TEST_F(ParallelDecoderTests,
+KeysAreDecodedInTheSameWayAsByDecoder) {
+	// A length of a string may have leading zeros.
+	std::string data("d01:a" + createLargeList(5000) + "e");
+
+	assertDecodedInTheSameWayAsByDecoder(data);
+}
+
+TEST_F(ParallelDecoderTests,
+LargeListNestedInDictionaryIsDecodedInTheSameWayAsByDecoder) {
+	std::string data("d1:ai1e5:itemsd4:list" + createLargeList(5000) +
+		"e1:zlee");
+
+	assertDecodedInTheSameWayAsByDecoder(data);
+}
+
+TEST_F(ParallelDecoderTests,
+LargeDataWithSingleLargeStringAreDecodedInTheSameWayAsByDecoder) {
+	std::string data("l100000:" + std::string(100000, 'x') + "i1ee");
+
+	assertDecodedInTheSameWayAsByDecoder(data);
+}
+
+TEST_F(ParallelDecoderTests,
+LastValueOfDuplicateKeyIsUsedLikeByDecoder) {
+	std::string data("d1:a" + createLargeList(3000) + "1:ai1e1:b" +
+		createLargeList(3000) + "e");
+
+	assertDecodedInTheSameWayAsByDecoder(data);
+}
+
+TEST_F(ParallelDecoderTests,
+DecodeThrowsSameErrorAsDecoderForInvalidData) {
+	std::string largeList(createLargeList(5000));
+	std::string invalidItem(largeList);
+	invalidItem.replace(invalidItem.find("i4000e"), 6, "i40x0e");
+	std::string invalidStructure(largeList);
+	invalidStructure.replace(invalidStructure.find("4:name"), 6, "x:name");
+
+	assertErrorIsSameAsErrorOfDecoder(invalidItem);
+	assertErrorIsSameAsErrorOfDecoder(invalidStructure);
+	assertErrorIsSameAsErrorOfDecoder(largeList.substr(0,
+		largeList.size() - 1));
+	assertErrorIsSameAsErrorOfDecoder(largeList + "i1e");
+	assertErrorIsSameAsErrorOfDecoder("d" + largeList + "e");
+	assertErrorIsSameAsErrorOfDecoder("di1e" + largeList + "e");
+}
+
+//
+// Decoder options.
+//
+
+TEST_F(ParallelDecoderTests,
+DecodeThrowsSameErrorAsDecoderWhenLimitOfDecoderOptionsIsExceeded) {
+	auto options = Decoder::create();
+	DecoderLimits limits;
+	limits.maxNumOfItems = 1000;
+	options->setLimits(limits);
+
+	EXPECT_THROW(options->decode(createLargeList(5000)),
+		DecodingLimitExceeded);
+	assertErrorIsSameAsErrorOfDecoder(createLargeList(5000), *options);
+	assertErrorIsSameAsErrorOfDecoder(createLargeDictionary(5000), *options);
+}
+
+TEST_F(ParallelDecoderTests,
+DecodeUsesLimitsOfDecoderOptionsAlsoForSmallData) {
+	auto options = Decoder::create();
+	DecoderLimits limits;
+	limits.maxNumOfItems = 2;
+	options->setLimits(limits);
+	decoder->setDecoderOptions(*options);
+
+	EXPECT_THROW(decoder->decode("li1ei2ee"), DecodingLimitExceeded);
+}
+
+TEST_F(ParallelDecoderTests,
+DecodeDecodesDataWithinLimitsOfDecoderOptions) {
+	auto options = Decoder::create();
+	DecoderLimits limits;
+	limits.maxDepth = 3;
+	options->setLimits(limits);
+	decoder->setDecoderOptions(*options);
+
+	assertDecodedInTheSameWayAsByDecoder(createLargeList(5000));
+}
+
+TEST_F(ParallelDecoderTests,
+DecodeThrowsSameErrorAsDecoderWhenKeysOfSplitDictionaryAreNotSorted) {
+	auto options = Decoder::create();
+	options->setKeyOrderChecking(true);
+
+	assertErrorIsSameAsErrorOfDecoder(createLargeDictionary(5000), *options);
+}
+
+TEST_F(ParallelDecoderTests,
+KeysOfSplitDictionaryAreInternedWhenDecoderOptionsInternKeys) {
+	std::shared_ptr<KeyInternTable> table(KeyInternTable::create(
+		std::vector<std::string>{"k00"}));
+	auto options = Decoder::create();
+	options->setKeyInterning(table);
+	decoder->setDecoderOptions(*options);
+
+	std::shared_ptr<BItem> decodedData(
+		decoder->decode(createLargeDictionary(5000)));
+
+	auto bDictionary = decodedData->as<BDictionary>();
+	ASSERT_TRUE(bDictionary != nullptr);
+	EXPECT_EQ(table->intern("k00"), bDictionary->begin()->first);
+	EXPECT_NE(table->intern("k01"), std::next(bDictionary->begin())->first);
+}
+
+TEST_F(ParallelDecoderTests,
+LaterChangesOfDecoderOptionsDoNotAffectDecoding) {
+	auto options = Decoder::create();
+	decoder->setDecoderOptions(*options);
+	options->setKeyOrderChecking(true);
+
+	assertDecodedInTheSameWayAsByDecoder(createLargeDictionary(5000));
+}
+
+//
+// decodeInParallel()
+//
+
+TEST_F(ParallelDecoderTests,
+DecodeInParallelWithoutExplicitDecoderCreationDecodesData) {
+	std::string data(createLargeList(5000));
+
+	auto decodedData = decodeInParallel(data, 2);
+
+	EXPECT_EQ(data, encode(std::shared_ptr<BItem>(std::move(decodedData))));
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,94 @@
+/**
+* @file      ParallelEncoderTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the ParallelEncoder class.
+*/
+
+#include <gtest/gtest.h>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "Encoder.h"
+#include "ParallelEncoder.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class ParallelEncoderTests: public Test {
+protected:
+	ParallelEncoderTests(): encoder(ParallelEncoder::create(4)) {}
+
+	std::shared_ptr<BItem> createLargeData(std::size_t numOfItems);
+
+protected:
+	std::unique_ptr<ParallelEncoder> encoder;
+};
+
+std::shared_ptr<BItem> ParallelEncoderTests::createLargeData(
+		std::size_t numOfItems) {
+	auto bList = BList::create();
+	for (std::size_t i = 0; i < numOfItems; ++i) {
+		auto bDictionary = BDictionary::create();
+		(*bDictionary)[BString::create("id")] = BInteger::create(
+			static_cast<BInteger::ValueType>(i) - 500);
+		(*bDictionary)[BString::create("name")] = BString::create(
+			"item " + std::to_string(i));
+		(*bDictionary)[BString::create("list")] = BList::create({
+			BInteger::create(1), BString::create(std::string(i % 50, 'x'))
+		});
+		bList->push_back(std::move(bDictionary));
+	}
+	std::shared_ptr<BDictionary> data(BDictionary::create());
+	(*data)[BString::create("a")] = BInteger::create(1);
+	(*data)[BString::create("items")] = std::move(bList);
+	(*data)[BString::create("z")] = BList::create();
+	return data;
+}
+
+TEST_F(ParallelEncoderTests,
+NumOfThreadsReturnsRequestedNumberOfThreads) {
+	EXPECT_EQ(4, encoder->numOfThreads());
+}
+
+TEST_F(ParallelEncoderTests,
+IntegerIsEncodedInTheSameWayAsByEncoder) {
+	std::shared_ptr<BInteger> bInteger(BInteger::create(-13));
+
+	EXPECT_EQ("i-13e", encoder->encode(bInteger));
+}
+
+TEST_F(ParallelEncoderTests,
+SmallDataAreEncodedInTheSameWayAsByEncoder) {
+	auto data = createLargeData(10);
+
+	EXPECT_EQ(encode(data), encoder->encode(data));
+}
+
+TEST_F(ParallelEncoderTests,
+LargeDataAreEncodedInTheSameWayAsByEncoder) {
+	auto data = createLargeData(20000);
+
+	EXPECT_EQ(encode(data), encoder->encode(data));
+}
+
+TEST_F(ParallelEncoderTests,
+LargeDataAreEncodedInTheSameWayAsByEncoderWhenUsingSingleThread) {
+	auto data = createLargeData(20000);
+
+	EXPECT_EQ(encode(data), ParallelEncoder::create(1)->encode(data));
+}
+
+TEST_F(ParallelEncoderTests,
+EncodeInParallelFunctionWorksAsCreatingEncoderAndCallingEncode) {
+	auto data = createLargeData(20000);
+
+	EXPECT_EQ(encode(data), encodeInParallel(data, 3));
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,253 @@
+/**
+* @file      PathQueryTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the PathQuery class.
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Decoder.h"
+#include "PathQuery.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class PathQueryTests: public Test {
+protected:
+	/// Torrent-like data used in the tests.
+	const std::string torrent = "d8:announce3:url13:announce-listll2:t1"
+		"2:t2el2:t3ee4:infod6:lengthi100e4:name4:file12:piece lengthi16e"
+		"6:pieces4:xxxxee";
+
+	std::vector<BItemView> values;
+};
+
+TEST_F(PathQueryTests,
+ExtractReturnsValuesOfDictionaryKeys) {
+	auto query = PathQuery::create({"info/name", "info/piece length"});
+
+	auto result = query->extract(torrent, values);
+
+	ASSERT_TRUE(result.ok());
+	ASSERT_EQ(2u, values.size());
+	EXPECT_EQ(BItemView::Type::String, values[0].type);
+	EXPECT_EQ("file", values[0].string());
+	EXPECT_EQ(BItemView::Type::Integer, values[1].type);
+	EXPECT_EQ(16, values[1].integer);
+}
+
+TEST_F(PathQueryTests,
+ExtractReturnsValuesOfListIndexes) {
+	auto query = PathQuery::create({"announce-list/0/0", "announce-list/1/0",
+		"announce-list/0/1"});
+
+	ASSERT_TRUE(query->extract(torrent, values).ok());
+
+	EXPECT_EQ("t1", values[0].string());
+	EXPECT_EQ("t3", values[1].string());
+	EXPECT_EQ("t2", values[2].string());
+}
+
+TEST_F(PathQueryTests,
+ExtractReturnsEncodedListsAndDictionaries) {
+	auto query = PathQuery::create({"announce-list/0", "info"});
+
+	ASSERT_TRUE(query->extract(torrent, values).ok());
+
+	EXPECT_EQ(BItemView::Type::List, values[0].type);
+	EXPECT_EQ("l2:t12:t2e", values[0].string());
+	EXPECT_EQ(BItemView::Type::Dictionary, values[1].type);
+	EXPECT_EQ("d6:lengthi100e4:name4:file12:piece lengthi16e6:pieces4:xxxxe",
+		values[1].string());
+	EXPECT_EQ(torrent.find("d6:length"), values[1].offset);
+}
+
+TEST_F(PathQueryTests,
+ExtractReturnsContainerAndItsItemsAtTheSameTime) {
+	auto query = PathQuery::create({"info", "info/length"});
+
+	ASSERT_TRUE(query->extract(torrent, values).ok());
+
+	EXPECT_EQ(BItemView::Type::Dictionary, values[0].type);
+	EXPECT_EQ(100, values[1].integer);
+}
+
+TEST_F(PathQueryTests,
+EmptyPathSelectsWholeData) {
+	auto query = PathQuery::create({""});
+
+	ASSERT_TRUE(query->extract(torrent, values).ok());
+
+	EXPECT_EQ(torrent, values[0].string());
+}
+
+TEST_F(PathQueryTests,
+SamePathMayBeGivenMoreThanOnce) {
+	auto query = PathQuery::create({"announce", "announce"});
+
+	ASSERT_TRUE(query->extract(torrent, values).ok());
+
+	EXPECT_EQ("url", values[0].string());
+	EXPECT_EQ("url", values[1].string());
+}
+
+TEST_F(PathQueryTests,
+PathsThatAreNotFoundAreMarkedAsNotFound) {
+	auto query = PathQuery::create({"info/nonexisting", "announce-list/5",
+		"announce/0", "info/name"});
+
+	ASSERT_TRUE(query->extract(torrent, values).ok());
+
+	EXPECT_FALSE(values[0].found());
+	EXPECT_FALSE(values[1].found());
+	EXPECT_FALSE(values[2].found());
+	EXPECT_TRUE(values[3].found());
+}
+
+TEST_F(PathQueryTests,
+EscapedSlashAndTildeInKeysAreSupported) {
+	std::string data("d3:a/bi1e3:a~bi2ee");
+	auto query = PathQuery::create({"a~1b", "a~0b"});
+
+	ASSERT_TRUE(query->extract(data, values).ok());
+
+	EXPECT_EQ(1, values[0].integer);
+	EXPECT_EQ(2, values[1].integer);
+}
+
+TEST_F(PathQueryTests,
+IndexDoesNotMatchDictionaryKeyUnlessKeyIsSame) {
+	std::string data("d1:0i1e2:00i2ee");
+	auto query = PathQuery::create({"0", "00"});
+
+	ASSERT_TRUE(query->extract(data, values).ok());
+
+	EXPECT_EQ(1, values[0].integer);
+	EXPECT_EQ(2, values[1].integer);
+}
+
+TEST_F(PathQueryTests,
+FirstOccurrenceOfDuplicateKeyIsUsed) {
+	std::string data("d1:ai1e1:ai2ee");
+	auto query = PathQuery::create({"a"});
+
+	ASSERT_TRUE(query->extract(data, values).ok());
+
+	EXPECT_EQ(1, values[0].integer);
+}
+
+TEST_F(PathQueryTests,
+NestedPathsAreNotMatchedInValueOfLaterOccurrenceOfDuplicateKey) {
+	std::string data("d1:ad1:bi1ee1:ad1:bi2e1:ci3eee");
+	auto query = PathQuery::create({"a/b", "a/c"});
+
+	ASSERT_TRUE(query->extract(data, values).ok());
+
+	EXPECT_EQ(1, values[0].integer);
+	EXPECT_FALSE(values[1].found());
+}
+
+TEST_F(PathQueryTests,
+NestedPathsAreNotMatchedInValueOfLaterOccurrenceOfDuplicateKeyInDictionaryWithManyPaths) {
+	// More than 64 keys are on the paths from the root.
+	std::vector<std::string> paths;
+	for (std::size_t i = 0; i < 70; ++i) {
+		paths.push_back("k" + std::to_string(i) + "/c");
+	}
+	std::string data("d3:k69d1:bi1ee3:k69d1:ci2eee");
+	auto query = PathQuery::create(paths);
+
+	ASSERT_TRUE(query->extract(data, values).ok());
+
+	EXPECT_FALSE(values[69].found());
+}
+
+TEST_F(PathQueryTests,
+QueryCanBeReusedForMoreInputs) {
+	std::string data1("d1:ai1ee");
+	std::string data2("d1:bi1ee");
+	auto query = PathQuery::create({"a"});
+
+	ASSERT_TRUE(query->extract(data1, values).ok());
+	EXPECT_EQ(1, values[0].integer);
+	ASSERT_TRUE(query->extract(data2, values).ok());
+	EXPECT_FALSE(values[0].found());
+}
+
+TEST_F(PathQueryTests,
+ExtractionStopsWhenAllPathsAreFound) {
+	std::string data("d1:ai1e1:b");
+	auto query = PathQuery::create({"a"});
+
+	auto result = query->extract(data, values);
+
+	EXPECT_TRUE(result.ok());
+	EXPECT_EQ(1, values[0].integer);
+}
+
+TEST_F(PathQueryTests,
+ExtractReportsInvalidInput) {
+	std::string data("d1:ai1x1:bi1ee");
+	auto query = PathQuery::create({"b"});
+
+	auto result = query->extract(data, values);
+
+	EXPECT_EQ(DecodingErrorCode::InvalidInteger, result.error());
+	EXPECT_EQ(6u, result.offset());
+}
+
+TEST_F(PathQueryTests,
+ExtractReportsTrailingCharactersWhenNotAllPathsAreFound) {
+	std::string data("d1:ai1eei1e");
+	auto query = PathQuery::create({"b"});
+
+	auto result = query->extract(data, values);
+
+	EXPECT_EQ(DecodingErrorCode::UndecodedCharacters, result.error());
+}
+
+TEST_F(PathQueryTests,
+ExtractReportsEmptyInput) {
+	std::string data("");
+	auto query = PathQuery::create({"a"});
+
+	auto result = query->extract(data, values);
+
+	EXPECT_EQ(DecodingErrorCode::UnexpectedEndOfInput, result.error());
+}
+
+TEST_F(PathQueryTests,
+GetNumOfPathsReturnsNumberOfPaths) {
+	auto query = PathQuery::create({"a", "b/c", "a"});
+
+	EXPECT_EQ(3u, query->getNumOfPaths());
+}
+
+//
+// extract()
+//
+
+TEST_F(PathQueryTests,
+ExtractWithoutExplicitQueryCreationReturnsValues) {
+	auto values = extract(torrent, {"info/name", "announce-list/0/0"});
+
+	ASSERT_EQ(2u, values.size());
+	EXPECT_EQ("file", values[0].string());
+	EXPECT_EQ("t1", values[1].string());
+}
+
+TEST_F(PathQueryTests,
+ExtractWithoutExplicitQueryCreationThrowsForInvalidInput) {
+	std::string data("d1:ai1x");
+
+	EXPECT_THROW(extract(data, {"b"}), DecodingError);
+}
+
+} // namespace tests
+} // namespace bencoding
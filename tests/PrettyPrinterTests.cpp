@@ -5,6 +5,8 @@
 * @brief     Tests for the PrettyPrinter class.
 */
 
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include "BDictionary.h"
@@ -127,10 +129,122 @@ QuoteInsideStringIsPrefixedWithBackslash) {
 	EXPECT_EQ(R"("te\"st")", printer->getPrettyRepr(data));
 }
 
+TEST_F(PrettyPrinterTests,
+QuotesAtBeginningAndEndOfStringAreAlsoPrefixedWithBackslash) {
+	std::shared_ptr<BItem> data(BString::create("\"\"a\""));
+
+	EXPECT_EQ(R"("\"\"a\"")", printer->getPrettyRepr(data));
+}
+
+//
+// Limits.
+//
+
+TEST_F(PrettyPrinterTests,
+StringLongerThanMaxStringLengthIsCut) {
+	std::shared_ptr<BItem> data(BString::create("abc\"defgh"));
+	printer->setMaxStringLength(4);
+
+	EXPECT_EQ("\"abc\\\"\xe2\x80\xa6(9 bytes)\"", printer->getPrettyRepr(data));
+}
+
+TEST_F(PrettyPrinterTests,
+StringNotLongerThanMaxStringLengthIsNotCut) {
+	std::shared_ptr<BItem> data(BString::create("abcd"));
+	printer->setMaxStringLength(4);
+
+	EXPECT_EQ(R"("abcd")", printer->getPrettyRepr(data));
+}
+
+TEST_F(PrettyPrinterTests,
+ListItemsOverMaxNumOfItemsAreElided) {
+	std::shared_ptr<BList> bList(BList::create({
+		BInteger::create(1), BInteger::create(2), BInteger::create(3)
+	}));
+	printer->setMaxNumOfItems(1);
+
+	EXPECT_EQ("[\n    1,\n    \xe2\x80\xa6(2 more items)\n]",
+		printer->getPrettyRepr(bList));
+}
+
+TEST_F(PrettyPrinterTests,
+DictionaryItemsOverMaxNumOfItemsAreElided) {
+	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
+	(*bDictionary)[BString::create("a")] = BInteger::create(1);
+	(*bDictionary)[BString::create("b")] = BInteger::create(2);
+	printer->setMaxNumOfItems(0);
+
+	EXPECT_EQ("{\n    \xe2\x80\xa6(2 more items)\n}",
+		printer->getPrettyRepr(bDictionary));
+}
+
+TEST_F(PrettyPrinterTests,
+ListsAndDictionariesDeeperThanMaxDepthAreSummarized) {
+	std::shared_ptr<BDictionary> inner(BDictionary::create());
+	(*inner)[BString::create("a")] = BInteger::create(1);
+	std::shared_ptr<BList> bList(BList::create({
+		BList::create({BInteger::create(1), BInteger::create(2)}),
+		inner,
+		BList::create()
+	}));
+	printer->setMaxDepth(1);
+
+	EXPECT_EQ("[\n"
+		"    [\xe2\x80\xa6(2 items)],\n"
+		"    {\xe2\x80\xa6(1 items)},\n"
+		"    [\n    ]\n"
+		"]", printer->getPrettyRepr(bList));
+}
+
+TEST_F(PrettyPrinterTests,
+RemoveLimitsRemovesAllLimits) {
+	std::shared_ptr<BList> bList(BList::create({BString::create("abc")}));
+	printer->setMaxStringLength(1);
+	printer->setMaxNumOfItems(0);
+	printer->setMaxDepth(0);
+
+	printer->removeLimits();
+
+	EXPECT_EQ("[\n    \"abc\"\n]", printer->getPrettyRepr(bList));
+}
+
 //
 // Other.
 //
 
+TEST_F(PrettyPrinterTests,
+NestedItemsAreIndentedByGivenIndent) {
+	std::shared_ptr<BList> bList = BList::create({
+		BList::create({BList::create({BInteger::create(1)})}),
+		BInteger::create(2)
+	});
+
+	EXPECT_EQ("[\n\t[\n\t\t[\n\t\t\t1\n\t\t]\n\t],\n\t2\n]",
+		printer->getPrettyRepr(bList, "\t"));
+}
+
+TEST_F(PrettyPrinterTests,
+PrintPrettyReprWritesSameReprAsGetPrettyReprIntoStream) {
+	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
+	(*bDictionary)[BString::create("a")] = BList::create({BInteger::create(-1)});
+	(*bDictionary)[BString::create("b")] = BString::create("te\"st");
+	std::ostringstream output;
+
+	printer->printPrettyRepr(bDictionary, output);
+
+	EXPECT_EQ(printer->getPrettyRepr(bDictionary), output.str());
+}
+
+TEST_F(PrettyPrinterTests,
+PrintPrettyReprFunctionWorksAsCreatingPrettyPrinterAndCallingPrintPrettyRepr) {
+	std::shared_ptr<BItem> data(BInteger::create(1));
+	std::ostringstream output;
+
+	printPrettyRepr(data, output, "  ");
+
+	EXPECT_EQ("1", output.str());
+}
+
 TEST_F(PrettyPrinterTests,
 GetPrettyReprFunctionWorksAsCreatingPrettyPrinterAndCallingGetPrettyRepr) {
 	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
@@ -0,0 +1,334 @@
+/**
+* @file      ReaderTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the Reader class.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Reader.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class ReaderTests: public Test {
+protected:
+	/// Reads all tokens from @a reader and returns the error code (None when
+	/// the whole input is valid).
+	DecodingErrorCode readAll(Reader &reader) {
+		for (;;) {
+			switch (reader.next()) {
+				case TokenType::EndOfInput:
+					return DecodingErrorCode::None;
+				case TokenType::Error:
+					return reader.error();
+				default:
+					break;
+			}
+		}
+	}
+};
+
+//
+// Tokens.
+//
+
+TEST_F(ReaderTests,
+ReaderReturnsTokensOfDictionary) {
+	std::string data("d1:ai1e1:bl3:xyzee");
+	Reader reader(data);
+
+	ASSERT_EQ(TokenType::DictBegin, reader.next());
+	ASSERT_EQ(TokenType::String, reader.next());
+	EXPECT_TRUE(reader.isKey());
+	EXPECT_EQ("a", reader.string());
+	ASSERT_EQ(TokenType::Integer, reader.next());
+	EXPECT_EQ(1, reader.integer());
+	ASSERT_EQ(TokenType::String, reader.next());
+	EXPECT_TRUE(reader.isKey());
+	ASSERT_EQ(TokenType::ListBegin, reader.next());
+	EXPECT_EQ(2u, reader.depth());
+	ASSERT_EQ(TokenType::String, reader.next());
+	EXPECT_FALSE(reader.isKey());
+	EXPECT_EQ(std::string("xyz"),
+		std::string(reader.stringData(), reader.stringLength()));
+	ASSERT_EQ(TokenType::End, reader.next());
+	ASSERT_EQ(TokenType::End, reader.next());
+	EXPECT_EQ(0u, reader.depth());
+	EXPECT_EQ(TokenType::EndOfInput, reader.next());
+}
+
+TEST_F(ReaderTests,
+ReaderReturnsOffsetsOfTokens) {
+	std::string data("li10e4:teste");
+	Reader reader(data);
+
+	reader.next();
+	EXPECT_EQ(0u, reader.tokenBegin());
+	EXPECT_EQ(1u, reader.offset());
+	reader.next();
+	EXPECT_EQ(1u, reader.tokenBegin());
+	EXPECT_EQ(5u, reader.offset());
+	reader.next();
+	EXPECT_EQ(5u, reader.tokenBegin());
+	EXPECT_EQ(11u, reader.offset());
+}
+
+TEST_F(ReaderTests,
+ReaderReadsSeveralConsecutiveItems) {
+	std::string data("i1ei2e");
+	Reader reader(data);
+
+	EXPECT_EQ(TokenType::Integer, reader.next());
+	EXPECT_EQ(TokenType::Integer, reader.next());
+	EXPECT_EQ(2, reader.integer());
+	EXPECT_EQ(TokenType::EndOfInput, reader.next());
+}
+
+TEST_F(ReaderTests,
+ReaderReadsExtremeIntegers) {
+	std::string data("i9223372036854775807ei-9223372036854775808ei-0ei+5e");
+	Reader reader(data);
+
+	reader.next();
+	EXPECT_EQ(std::numeric_limits<int64_t>::max(), reader.integer());
+	reader.next();
+	EXPECT_EQ(std::numeric_limits<int64_t>::min(), reader.integer());
+	reader.next();
+	EXPECT_EQ(0, reader.integer());
+	reader.next();
+	EXPECT_EQ(5, reader.integer());
+}
+
+TEST_F(ReaderTests,
+ReaderReadsDeeplyNestedLists) {
+	std::size_t depth = 3 * Reader::INLINE_DEPTH;
+	std::string data(std::string(depth, 'l') + std::string(depth, 'e'));
+	Reader reader(data);
+
+	EXPECT_EQ(DecodingErrorCode::None, readAll(reader));
+}
+
+TEST_F(ReaderTests,
+ReaderReadsDictionariesNestedInListsNestedDeeply) {
+	std::string data;
+	for (std::size_t i = 0; i < Reader::INLINE_DEPTH + 10; ++i) {
+		data += "d1:al";
+	}
+	for (std::size_t i = 0; i < Reader::INLINE_DEPTH + 10; ++i) {
+		data += "ee";
+	}
+	Reader reader(data);
+
+	EXPECT_EQ(DecodingErrorCode::None, readAll(reader));
+}
+
+//
+// Skipping.
+//
+
+TEST_F(ReaderTests,
+SkipSkipsWholeList) {
+	std::string data("d1:ali1eli2eee1:bi3ee");
+	Reader reader(data);
+	reader.next();
+	reader.next();
+	reader.next();
+
+	ASSERT_TRUE(reader.skip());
+	ASSERT_EQ(TokenType::String, reader.next());
+	EXPECT_EQ("b", reader.string());
+}
+
+TEST_F(ReaderTests,
+SkipDoesNothingForInteger) {
+	std::string data("li1ei2ee");
+	Reader reader(data);
+	reader.next();
+	reader.next();
+
+	ASSERT_TRUE(reader.skip());
+	ASSERT_EQ(TokenType::Integer, reader.next());
+	EXPECT_EQ(2, reader.integer());
+}
+
+TEST_F(ReaderTests,
+SkipReturnsFalseForInvalidInput) {
+	std::string data("li1ex");
+	Reader reader(data);
+	reader.next();
+
+	EXPECT_FALSE(reader.skip());
+}
+
+//
+// Errors.
+//
+
+TEST_F(ReaderTests,
+ReaderReportsErrorsWithOffsets) {
+	struct {
+		const char *data;
+		DecodingErrorCode error;
+		std::size_t offset;
+	} testData[] = {
+		{"", DecodingErrorCode::None, 0},
+		{"l", DecodingErrorCode::UnexpectedEndOfInput, 1},
+		{"x", DecodingErrorCode::UnexpectedCharacter, 0},
+		{"e", DecodingErrorCode::UnexpectedCharacter, 0},
+		{"i12", DecodingErrorCode::UnexpectedEndOfInput, 3},
+		{"i1xe", DecodingErrorCode::InvalidInteger, 2},
+		{"i01e", DecodingErrorCode::InvalidInteger, 2},
+		{"ie", DecodingErrorCode::InvalidInteger, 1},
+		{"i-e", DecodingErrorCode::InvalidInteger, 2},
+		{"i 1e", DecodingErrorCode::InvalidInteger, 1},
+		{"i9223372036854775808e", DecodingErrorCode::IntegerOutOfRange, 19},
+		{"4:abc", DecodingErrorCode::UnexpectedEndOfInput, 5},
+		{"4x", DecodingErrorCode::InvalidStringLength, 1},
+		{"99999999999999999999999:", DecodingErrorCode::InvalidStringLength, 0},
+		{"di1ei2ee", DecodingErrorCode::NonStringKey, 1},
+		{"d1:ae", DecodingErrorCode::UnexpectedCharacter, 4},
+		{"l1:a", DecodingErrorCode::UnexpectedEndOfInput, 4},
+	};
+
+	for (const auto &test : testData) {
+		SCOPED_TRACE(test.data);
+		Reader reader(test.data, std::strlen(test.data));
+
+		EXPECT_EQ(test.error, readAll(reader));
+		EXPECT_EQ(test.offset, reader.errorOffset());
+	}
+}
+
+TEST_F(ReaderTests,
+ReaderKeepsReturningErrorAfterFailure) {
+	std::string data("xi1e");
+	Reader reader(data);
+	reader.next();
+
+	EXPECT_EQ(TokenType::Error, reader.next());
+}
+
+//
+// Key order.
+//
+
+TEST_F(ReaderTests,
+ReaderDoesNotCheckKeyOrderByDefault) {
+	std::string data("d1:bi1e1:bi2ee");
+	Reader reader(data);
+
+	EXPECT_EQ(DecodingErrorCode::None, readAll(reader));
+}
+
+TEST_F(ReaderTests,
+ReaderReportsKeysInWrongOrderWhenCheckingKeyOrder) {
+	struct {
+		const char *data;
+		DecodingErrorCode error;
+		std::size_t offset;
+	} testData[] = {
+		{"d1:ai1e1:bi2ee", DecodingErrorCode::None, 0},
+		{"d1:ai1e2:aai2ee", DecodingErrorCode::None, 0},
+		{"d1:bi1e1:ai2ee", DecodingErrorCode::UnsortedKeys, 7},
+		{"d2:aai1e1:ai2ee", DecodingErrorCode::UnsortedKeys, 8},
+		{"d1:ai1e1:ai2ee", DecodingErrorCode::DuplicateKey, 7},
+		// Keys are compared as unsigned characters.
+		{"d1:ai1e1:\xffi2ee", DecodingErrorCode::None, 0},
+		// Keys of a nested dictionary do not affect the outer dictionary.
+		{"d1:bd1:zi1ee1:ci2ee", DecodingErrorCode::None, 0},
+		{"d1:bd1:ai1ee1:ai2ee", DecodingErrorCode::UnsortedKeys, 12},
+		{"ld1:bi1eed1:ai1eee", DecodingErrorCode::None, 0},
+	};
+
+	for (const auto &test : testData) {
+		SCOPED_TRACE(test.data);
+		Reader reader(test.data, std::strlen(test.data));
+		reader.setKeyOrderChecking(true);
+
+		EXPECT_EQ(test.error, readAll(reader));
+		EXPECT_EQ(test.offset, reader.errorOffset());
+	}
+}
+
+TEST_F(ReaderTests,
+ReaderChecksKeyOrderOfDeeplyNestedDictionaries) {
+	std::string data;
+	for (std::size_t i = 0; i < 2 * Reader::INLINE_DEPTH; ++i) {
+		data += "d1:bi1e1:c";
+	}
+	data += "de";
+	for (std::size_t i = 0; i < 2 * Reader::INLINE_DEPTH; ++i) {
+		data += "1:di1ee";
+	}
+	std::string invalidData(data);
+	invalidData[invalidData.size() - 5] = 'a';
+	Reader reader(data);
+	reader.setKeyOrderChecking(true);
+	Reader invalidReader(invalidData);
+	invalidReader.setKeyOrderChecking(true);
+
+	EXPECT_EQ(DecodingErrorCode::None, readAll(reader));
+	EXPECT_EQ(DecodingErrorCode::UnsortedKeys, readAll(invalidReader));
+}
+
+//
+// Limits.
+//
+
+TEST_F(ReaderTests,
+ReaderReportsExceededLimits) {
+	DecoderLimits limits;
+	limits.maxDepth = 1;
+	std::string depthReaderData("lle");
+	Reader depthReader(depthReaderData);
+	depthReader.setLimits(limits);
+	EXPECT_EQ(DecodingErrorCode::DepthLimitExceeded, readAll(depthReader));
+
+	limits = DecoderLimits();
+	limits.maxInputLength = 3;
+	std::string inputReaderData("4:test");
+	Reader inputReader(inputReaderData);
+	inputReader.setLimits(limits);
+	EXPECT_EQ(DecodingErrorCode::InputLengthLimitExceeded,
+		readAll(inputReader));
+
+	limits = DecoderLimits();
+	limits.maxNumOfItems = 2;
+	std::string itemsReaderData("li1ee");
+	Reader itemsReader(itemsReaderData);
+	itemsReader.setLimits(limits);
+	EXPECT_EQ(DecodingErrorCode::None, readAll(itemsReader));
+	std::string moreItemsReaderData("li1ei2ee");
+	Reader moreItemsReader(moreItemsReaderData);
+	moreItemsReader.setLimits(limits);
+	EXPECT_EQ(DecodingErrorCode::NumOfItemsLimitExceeded,
+		readAll(moreItemsReader));
+
+	limits = DecoderLimits();
+	limits.maxStringLength = 3;
+	std::string stringReaderData("4:test");
+	Reader stringReader(stringReaderData);
+	stringReader.setLimits(limits);
+	EXPECT_EQ(DecodingErrorCode::StringLengthLimitExceeded,
+		readAll(stringReader));
+
+	limits = DecoderLimits();
+	limits.maxTotalStringLength = 5;
+	std::string totalReaderData("l3:abc3:defe");
+	Reader totalReader(totalReaderData);
+	totalReader.setLimits(limits);
+	EXPECT_EQ(DecodingErrorCode::TotalStringLengthLimitExceeded,
+		readAll(totalReader));
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,83 @@
+/**
+* @file      SchemaTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the Schema class.
+*/
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Schema.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class SchemaTests: public Test {};
+
+TEST_F(SchemaTests,
+SchemasOfScalarsHaveCorrectTypes) {
+	EXPECT_EQ(Schema::Type::Any, Schema::any()->getType());
+	EXPECT_EQ(Schema::Type::Integer, Schema::integer()->getType());
+	EXPECT_EQ(Schema::Type::String, Schema::string()->getType());
+}
+
+TEST_F(SchemaTests,
+ListSchemaHoldsSchemaOfItems) {
+	auto schema = Schema::list(Schema::string());
+
+	EXPECT_EQ(Schema::Type::List, schema->getType());
+	EXPECT_EQ(Schema::Type::String, schema->getItems().getType());
+}
+
+TEST_F(SchemaTests,
+DictionarySchemaHoldsFieldsSortedByKeys) {
+	auto schema = Schema::dictionary({
+		{"b", Schema::integer(), true},
+		{"\xff", Schema::string()},
+		{"a", Schema::string()},
+		{"ab", Schema::string(), true}
+	});
+
+	EXPECT_EQ(Schema::Type::Dictionary, schema->getType());
+	ASSERT_EQ(4u, schema->getFields().size());
+	EXPECT_EQ("a", schema->getFields()[0].key);
+	EXPECT_EQ("ab", schema->getFields()[1].key);
+	EXPECT_EQ("b", schema->getFields()[2].key);
+	EXPECT_EQ("\xff", schema->getFields()[3].key);
+	EXPECT_EQ(2u, schema->getNumOfRequiredFields());
+}
+
+TEST_F(SchemaTests,
+FindFieldReturnsIndexOfFieldWithGivenKey) {
+	auto schema = Schema::dictionary({
+		{"", Schema::integer()},
+		{"ab", Schema::integer()},
+		{"ac", Schema::integer()},
+		{"b", Schema::integer()}
+	});
+
+	EXPECT_EQ(0u, schema->findField("", 0));
+	EXPECT_EQ(2u, schema->findField("ac", 2));
+	EXPECT_EQ(2u, schema->findField("ac", 2, 3));
+	EXPECT_EQ(3u, schema->findField("bx", 1));
+	EXPECT_EQ(4u, schema->findField("a", 1));
+	EXPECT_EQ(4u, schema->findField("ad", 2, 2));
+}
+
+TEST_F(SchemaTests,
+SchemaCanBeSharedBySeveralSchemas) {
+	std::shared_ptr<Schema> name(Schema::string());
+	auto first = Schema::dictionary({{"name", name}});
+	auto second = Schema::list(name);
+
+	EXPECT_EQ(name.get(), first->getFields()[0].schema.get());
+	EXPECT_EQ(name.get(), &second->getItems());
+}
+
+} // namespace tests
+} // namespace bencoding
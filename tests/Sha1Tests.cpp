@@ -0,0 +1,77 @@
+/**
+* @file      Sha1Tests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the Sha1 class.
+*/
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Sha1.h"
+#include "Utils.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class Sha1Tests: public Test {
+protected:
+	/// Returns the hex-encoded digest of @a data.
+	std::string hexHash(const std::string &data) {
+		std::string hex;
+		appendAsHex(hex, Sha1::hash(data).data(), Sha1::DIGEST_SIZE);
+		return hex;
+	}
+};
+
+TEST_F(Sha1Tests,
+DigestHasCorrectSize) {
+	EXPECT_EQ(Sha1::DIGEST_SIZE, Sha1::hash("abc").size());
+}
+
+TEST_F(Sha1Tests,
+HashOfEmptyDataIsCorrect) {
+	EXPECT_EQ("da39a3ee5e6b4b0d3255bfef95601890afd80709",
+		hexHash(""));
+}
+
+TEST_F(Sha1Tests,
+HashOfShortDataIsCorrect) {
+	EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d",
+		hexHash("abc"));
+}
+
+TEST_F(Sha1Tests,
+HashOfDataAroundBlockBoundariesIsCorrect) {
+	EXPECT_EQ("c1c8bbdc22796e28c0e15163d20899b65621d65a",
+		hexHash(std::string(55, 'a')));
+	EXPECT_EQ("c2db330f6083854c99d4b5bfb6e8f29f201be699",
+		hexHash(std::string(56, 'a')));
+	EXPECT_EQ("0098ba824b5c16427bd7a1122a5a442a25ec644d",
+		hexHash(std::string(64, 'a')));
+	EXPECT_EQ("ee971065aaa017e0632a8ca6c77bb3bf8b1dfc56",
+		hexHash(std::string(119, 'a')));
+}
+
+TEST_F(Sha1Tests,
+HashOfDataPassedInPartsIsSameAsHashOfWholeData) {
+	std::string data(1000000, 'a');
+	Sha1 sha1;
+	for (std::size_t i = 0; i < data.size(); i += 999) {
+		sha1.update(data.data() + i,
+			std::min<std::size_t>(999, data.size() - i));
+	}
+	std::string hex;
+	auto digest = sha1.finish();
+	appendAsHex(hex, digest.data(), digest.size());
+
+	EXPECT_EQ("34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+		hex);
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,77 @@
+/**
+* @file      Sha256Tests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the Sha256 class.
+*/
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Sha256.h"
+#include "Utils.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class Sha256Tests: public Test {
+protected:
+	/// Returns the hex-encoded digest of @a data.
+	std::string hexHash(const std::string &data) {
+		std::string hex;
+		appendAsHex(hex, Sha256::hash(data).data(), Sha256::DIGEST_SIZE);
+		return hex;
+	}
+};
+
+TEST_F(Sha256Tests,
+DigestHasCorrectSize) {
+	EXPECT_EQ(Sha256::DIGEST_SIZE, Sha256::hash("abc").size());
+}
+
+TEST_F(Sha256Tests,
+HashOfEmptyDataIsCorrect) {
+	EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+		hexHash(""));
+}
+
+TEST_F(Sha256Tests,
+HashOfShortDataIsCorrect) {
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+		hexHash("abc"));
+}
+
+TEST_F(Sha256Tests,
+HashOfDataAroundBlockBoundariesIsCorrect) {
+	EXPECT_EQ("9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318",
+		hexHash(std::string(55, 'a')));
+	EXPECT_EQ("b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a",
+		hexHash(std::string(56, 'a')));
+	EXPECT_EQ("ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb",
+		hexHash(std::string(64, 'a')));
+	EXPECT_EQ("31eba51c313a5c08226adf18d4a359cfdfd8d2e816b13f4af952f7ea6584dcfb",
+		hexHash(std::string(119, 'a')));
+}
+
+TEST_F(Sha256Tests,
+HashOfDataPassedInPartsIsSameAsHashOfWholeData) {
+	std::string data(1000000, 'a');
+	Sha256 sha256;
+	for (std::size_t i = 0; i < data.size(); i += 999) {
+		sha256.update(data.data() + i,
+			std::min<std::size_t>(999, data.size() - i));
+	}
+	std::string hex;
+	auto digest = sha256.finish();
+	appendAsHex(hex, digest.data(), digest.size());
+
+	EXPECT_EQ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+		hex);
+}
+
+} // namespace tests
+} // namespace bencoding
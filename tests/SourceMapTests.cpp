@@ -0,0 +1,87 @@
+/**
+* @file      SourceMapTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the SourceMap class.
+*/
+
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "SourceMap.h"
+
+namespace bencoding {
+
+namespace tests {
+
+using namespace testing;
+
+class SourceMapTests: public Test {
+protected:
+	SourceMap sourceMap;
+};
+
+TEST_F(SourceMapTests,
+MapIsEmptyAfterCreation) {
+	EXPECT_TRUE(sourceMap.empty());
+	EXPECT_EQ(0u, sourceMap.size());
+}
+
+TEST_F(SourceMapTests,
+GetSpanReturnsAddedSpan) {
+	auto i = BInteger::create(1);
+
+	sourceMap.add(*i, 2, 5);
+
+	ASSERT_TRUE(sourceMap.contains(*i));
+	auto span = sourceMap.getSpan(*i);
+	EXPECT_EQ(2u, span.begin);
+	EXPECT_EQ(5u, span.end);
+	EXPECT_EQ(3u, span.length());
+	EXPECT_EQ(1u, sourceMap.size());
+}
+
+TEST_F(SourceMapTests,
+ItemsAreIdentifiedByTheirAddresses) {
+	auto i1 = BInteger::create(1);
+	auto i2 = BInteger::create(1);
+
+	sourceMap.add(*i1, 0, 3);
+
+	EXPECT_TRUE(sourceMap.contains(*i1));
+	EXPECT_FALSE(sourceMap.contains(*i2));
+}
+
+TEST_F(SourceMapTests,
+RemoveRemovesSpansOfItemAndItemsInsideIt) {
+	std::shared_ptr<BString> key(BString::create("a"));
+	std::shared_ptr<BList> l(BList::create({BInteger::create(2)}));
+	auto d = BDictionary::create({{key, l}});
+	auto other = BInteger::create(3);
+	sourceMap.add(*d, 0, 10);
+	sourceMap.add(*key, 1, 4);
+	sourceMap.add(*l, 4, 9);
+	sourceMap.add(*l->front(), 5, 8);
+	sourceMap.add(*other, 10, 13);
+
+	sourceMap.remove(*d);
+
+	EXPECT_EQ(1u, sourceMap.size());
+	EXPECT_TRUE(sourceMap.contains(*other));
+}
+
+TEST_F(SourceMapTests,
+GetSpanThrowsForItemWithoutSpan) {
+	auto i = BInteger::create(1);
+
+	EXPECT_THROW(sourceMap.getSpan(*i), std::out_of_range);
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -7,6 +7,7 @@
 
 #include "TestUtils.h"
 
+#include <algorithm>
 #include <ios>
 
 namespace bencoding {
@@ -26,5 +27,36 @@ void putIntoEOFState(std::istream &stream) {
 	stream.setstate(std::ios::eofbit);
 }
 
+/**
+* @brief Constructs a stream buffer providing @a data in chunks of @a
+*        chunkSize characters.
+*/
+ChunkedStreamBuf::ChunkedStreamBuf(const std::string &data,
+		std::size_t chunkSize): data(data), chunkSize(chunkSize) {}
+
+auto ChunkedStreamBuf::underflow() -> int_type {
+	if (pos == data.size()) {
+		return traits_type::eof();
+	}
+	if (chunkSize == 0) {
+		return traits_type::to_int_type(data[pos]);
+	}
+	auto size = std::min(chunkSize, data.size() - pos);
+	setg(&data[pos], &data[pos], &data[pos] + size);
+	pos += size;
+	return traits_type::to_int_type(data[pos - size]);
+}
+
+auto ChunkedStreamBuf::uflow() -> int_type {
+	if (chunkSize != 0) {
+		return std::streambuf::uflow();
+	}
+	int_type c = underflow();
+	if (c != traits_type::eof()) {
+		++pos;
+	}
+	return c;
+}
+
 } // namespace tests
 } // namespace bencoding
@@ -8,7 +8,9 @@
 #ifndef BENCODING_TEST_UTILS_H
 #define BENCODING_TEST_UTILS_H
 
+#include <cstddef>
 #include <istream>
+#include <streambuf>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -30,6 +32,26 @@ namespace tests {
 void putIntoErrorState(std::istream &stream);
 void putIntoEOFState(std::istream &stream);
 
+/**
+* @brief Stream buffer providing the given data in chunks of the given size.
+*
+* When the size is zero, no characters are buffered (every character is
+* provided separately, like an unbuffered @c std::cin does).
+*/
+class ChunkedStreamBuf: public std::streambuf {
+public:
+	ChunkedStreamBuf(const std::string &data, std::size_t chunkSize);
+
+protected:
+	virtual int_type underflow() override;
+	virtual int_type uflow() override;
+
+private:
+	std::string data;
+	std::size_t chunkSize;
+	std::size_t pos = 0;
+};
+
 } // namespace tests
 } // namespace bencoding
 
@@ -0,0 +1,133 @@
+/**
+* @file      ThreadPoolTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the ThreadPool class.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ThreadPool.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class ThreadPoolTests: public Test {};
+
+TEST_F(ThreadPoolTests,
+NumOfThreadsReturnsRequestedNumberOfThreads) {
+	auto pool = ThreadPool::create(3);
+
+	EXPECT_EQ(3, pool->numOfThreads());
+}
+
+TEST_F(ThreadPoolTests,
+PoolCreatedWithZeroThreadsUsesAtLeastOneThread) {
+	auto pool = ThreadPool::create(0);
+
+	EXPECT_GE(pool->numOfThreads(), 1);
+}
+
+TEST_F(ThreadPoolTests,
+RunRunsEveryTaskExactlyOnce) {
+	auto pool = ThreadPool::create(4);
+	std::vector<std::atomic<int>> counters(1000);
+	for (auto &counter : counters) {
+		counter = 0;
+	}
+
+	pool->run(counters.size(), [&](std::size_t i) { ++counters[i]; });
+
+	for (auto &counter : counters) {
+		EXPECT_EQ(1, counter);
+	}
+}
+
+TEST_F(ThreadPoolTests,
+RunCanBeCalledRepeatedly) {
+	auto pool = ThreadPool::create(4);
+	std::atomic<int> sum(0);
+
+	for (int i = 0; i < 100; ++i) {
+		pool->run(10, [&](std::size_t) { ++sum; });
+	}
+
+	EXPECT_EQ(1000, sum);
+}
+
+TEST_F(ThreadPoolTests,
+RunWithZeroTasksDoesNothing) {
+	auto pool = ThreadPool::create(2);
+	bool called = false;
+
+	pool->run(0, [&](std::size_t) { called = true; });
+
+	EXPECT_FALSE(called);
+}
+
+TEST_F(ThreadPoolTests,
+RunRunsEveryTaskExactlyOnceWhenTasksHaveDifferentLengths) {
+	auto pool = ThreadPool::create(4);
+	std::vector<std::atomic<int>> counters(200);
+	for (auto &counter : counters) {
+		counter = 0;
+	}
+
+	// The tasks at the beginning are much longer than the other ones, so
+	// the threads have to steal them from each other.
+	pool->run(counters.size(), [&](std::size_t i) {
+		if (i < 10) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		++counters[i];
+	});
+
+	for (auto &counter : counters) {
+		EXPECT_EQ(1, counter);
+	}
+}
+
+TEST_F(ThreadPoolTests,
+RunWithThreadIndexesPassesIndexesOfThreadsRunningTasks) {
+	auto pool = ThreadPool::create(4);
+	std::vector<std::atomic<int>> runningTasks(pool->numOfThreads());
+	for (auto &counter : runningTasks) {
+		counter = 0;
+	}
+	std::atomic<bool> failed(false);
+
+	pool->runWithThreadIndexes(1000, [&](std::size_t, std::size_t thread) {
+		if (thread >= runningTasks.size() || ++runningTasks[thread] != 1) {
+			failed = true;
+			return;
+		}
+		--runningTasks[thread];
+	});
+
+	EXPECT_FALSE(failed);
+}
+
+TEST_F(ThreadPoolTests,
+RunRethrowsExceptionThrownByTask) {
+	auto pool = ThreadPool::create(2);
+
+	EXPECT_THROW(
+		pool->run(10, [](std::size_t i) {
+			if (i == 5) {
+				throw std::runtime_error("error");
+			}
+		}),
+		std::runtime_error
+	);
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,191 @@
+/**
+* @file      TorrentMetainfoTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the TorrentMetainfo class.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BInteger.h"
+#include "BString.h"
+#include "Decoder.h"
+#include "TorrentMetainfo.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class TorrentMetainfoTests: public Test {
+protected:
+	/**
+	* @brief Returns a torrent with the given contents of the info
+	*        dictionary.
+	*/
+	std::shared_ptr<BItem> torrentWithInfo(const std::string &info) {
+		return decode("d8:announce3:url4:infod" + info + "ee");
+	}
+};
+
+TEST_F(TorrentMetainfoTests,
+SingleFileTorrentIsAccessible) {
+	std::string pieces(std::string(20, 'a') + std::string(20, 'b'));
+	auto torrent = torrentWithInfo("6:lengthi5e4:name4:file"
+		"12:piece lengthi4e6:pieces40:" + pieces);
+
+	auto metainfo = TorrentMetainfo::create(torrent);
+
+	EXPECT_EQ("file", metainfo->name());
+	EXPECT_EQ(4, metainfo->pieceLength());
+	EXPECT_EQ(5, metainfo->totalLength());
+	EXPECT_TRUE(metainfo->isSingleFile());
+	ASSERT_EQ(2u, metainfo->pieceCount());
+	EXPECT_EQ(std::string(20, 'b'), std::string(metainfo->pieceHash(1), 20));
+	auto files = metainfo->files();
+	ASSERT_EQ(1u, files.size());
+	auto file = *files.begin();
+	EXPECT_EQ(5, file.length);
+	EXPECT_EQ(0, file.offset);
+	EXPECT_EQ(nullptr, file.path);
+}
+
+TEST_F(TorrentMetainfoTests,
+PieceHashesPointIntoPiecesString) {
+	auto torrent = torrentWithInfo("6:lengthi1e4:name1:f"
+		"12:piece lengthi1e6:pieces20:" + std::string(20, 'h'));
+	auto metainfo = TorrentMetainfo::create(torrent);
+
+	auto pieces = (*metainfo->infoDictionary())[BString::create("pieces")];
+
+	EXPECT_EQ(pieces->as<BString>()->value().data(), metainfo->pieceHash(0));
+}
+
+TEST_F(TorrentMetainfoTests,
+FilesOfMultiFileTorrentAreIteratedWithOffsets) {
+	auto torrent = torrentWithInfo("5:filesl"
+		"d6:lengthi3e4:pathl1:a1:bee"
+		"d6:lengthi0e4:pathl1:cee"
+		"d6:lengthi6e4:pathl1:deee"
+		"4:name3:dir12:piece lengthi8e6:pieces40:" + std::string(40, 'x'));
+
+	auto metainfo = TorrentMetainfo::create(torrent);
+
+	EXPECT_FALSE(metainfo->isSingleFile());
+	EXPECT_EQ(9, metainfo->totalLength());
+	std::vector<TorrentMetainfo::File> files;
+	for (const auto &file : metainfo->files()) {
+		files.push_back(file);
+	}
+	ASSERT_EQ(3u, files.size());
+	EXPECT_EQ(3, files[0].length);
+	EXPECT_EQ(0, files[0].offset);
+	ASSERT_NE(nullptr, files[0].path);
+	ASSERT_EQ(2u, files[0].path->size());
+	EXPECT_EQ("b", files[0].path->back()->as<BString>()->value());
+	EXPECT_EQ(3, files[1].offset);
+	EXPECT_EQ(3, files[2].offset);
+	EXPECT_EQ(6, files[2].length);
+}
+
+TEST_F(TorrentMetainfoTests,
+FilesAreRecordedOnlyOnce) {
+	auto torrent = torrentWithInfo("5:filesl"
+		"d6:lengthi3e4:pathl1:aee"
+		"d6:lengthi6e4:pathl1:beee"
+		"4:name3:dir12:piece lengthi9e6:pieces20:" + std::string(20, 'x'));
+	auto metainfo = TorrentMetainfo::create(torrent);
+
+	auto first = metainfo->files();
+	auto second = metainfo->files();
+
+	EXPECT_EQ(2u, first.size());
+	EXPECT_EQ(2u, second.size());
+	EXPECT_EQ(3, (*++second.begin()).offset);
+}
+
+TEST_F(TorrentMetainfoTests,
+EmptyTorrentHasNoPieces) {
+	auto torrent = torrentWithInfo("6:lengthi0e4:name1:f"
+		"12:piece lengthi16e6:pieces0:");
+
+	auto metainfo = TorrentMetainfo::create(torrent);
+
+	EXPECT_EQ(0u, metainfo->pieceCount());
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenTorrentIsNotDictionary) {
+	EXPECT_THROW(TorrentMetainfo::create(BInteger::create(1)),
+		InvalidMetainfoError);
+	EXPECT_THROW(TorrentMetainfo::create(nullptr), InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenInfoIsMissing) {
+	EXPECT_THROW(TorrentMetainfo::create(decode("d8:announce3:urle")),
+		InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenRequiredKeyHasUnexpectedType) {
+	auto torrent = torrentWithInfo("6:lengthi1e4:namei1e"
+		"12:piece lengthi1e6:pieces20:" + std::string(20, 'h'));
+
+	EXPECT_THROW(TorrentMetainfo::create(torrent), InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenPiecesHaveInvalidLength) {
+	auto torrent = torrentWithInfo("6:lengthi1e4:name1:f"
+		"12:piece lengthi1e6:pieces19:" + std::string(19, 'h'));
+
+	EXPECT_THROW(TorrentMetainfo::create(torrent), InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenNumberOfPiecesDoesNotMatchLength) {
+	auto torrent = torrentWithInfo("6:lengthi5e4:name1:f"
+		"12:piece lengthi4e6:pieces20:" + std::string(20, 'h'));
+
+	EXPECT_THROW(TorrentMetainfo::create(torrent), InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenPieceLengthIsNotPositive) {
+	auto torrent = torrentWithInfo("6:lengthi0e4:name1:f"
+		"12:piece lengthi0e6:pieces0:");
+
+	EXPECT_THROW(TorrentMetainfo::create(torrent), InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenFileIsInvalid) {
+	std::string rest("4:name1:f12:piece lengthi1e6:pieces0:");
+
+	EXPECT_THROW(TorrentMetainfo::create(torrentWithInfo("5:filesli1ee" +
+		rest)), InvalidMetainfoError);
+	EXPECT_THROW(TorrentMetainfo::create(torrentWithInfo(
+		"5:filesld6:lengthi-1e4:pathl1:aeee" + rest)), InvalidMetainfoError);
+	EXPECT_THROW(TorrentMetainfo::create(torrentWithInfo(
+		"5:filesld6:lengthi0e4:pathleee" + rest)), InvalidMetainfoError);
+	EXPECT_THROW(TorrentMetainfo::create(torrentWithInfo(
+		"5:filesld6:lengthi0e4:pathli1eeee" + rest)), InvalidMetainfoError);
+}
+
+TEST_F(TorrentMetainfoTests,
+CreateThrowsWhenTotalLengthOverflows) {
+	auto torrent = torrentWithInfo("5:filesl"
+		"d6:lengthi9223372036854775807e4:pathl1:aee"
+		"d6:lengthi1e4:pathl1:bee"
+		"e4:name1:f12:piece lengthi1e6:pieces0:");
+
+	EXPECT_THROW(TorrentMetainfo::create(torrent), InvalidMetainfoError);
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -0,0 +1,280 @@
+/**
+* @file      TorrentV2IndexTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the TorrentV2Index class.
+*/
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "TorrentV2Index.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class TorrentV2IndexTests: public Test {
+protected:
+	/**
+	* @brief Returns an encoded v2 torrent with the given encoded file tree
+	*        and piece layers.
+	*/
+	static std::string torrent(const std::string &fileTree,
+			const std::string &pieceLayers = "de") {
+		return "d8:announce3:url4:infod9:file treed" + fileTree +
+			"e12:meta versioni2e4:name1:t12:piece lengthi16ee"
+			"12:piece layers" + pieceLayers + "e";
+	}
+
+	/**
+	* @brief Returns an encoded file with the given length and root.
+	*/
+	static std::string file(const std::string &length,
+			const std::string &root) {
+		return "d0:d6:lengthi" + length + "e11:pieces root32:" + root + "ee";
+	}
+
+	/// Length of Merkle roots.
+	static const std::size_t HASH_SIZE = TorrentV2Index::HASH_SIZE;
+
+	/// Merkle roots.
+	const std::string rootA = std::string(32, 'a');
+	const std::string rootB = std::string(32, 'b');
+};
+
+TEST_F(TorrentV2IndexTests,
+FileTreeIsFlattenedIntoFilesAndNames) {
+	std::string data(torrent(
+		"3:dird1:x" + file("40", rootA) + "1:y" + file("8", rootB) + "e"
+		"5:emptyd0:d6:lengthi0eee"
+	));
+
+	auto index = TorrentV2Index::create(data);
+
+	EXPECT_EQ(16, index->pieceLength());
+	const auto &files = index->files();
+	ASSERT_EQ(3u, files.size());
+	EXPECT_EQ("dir/x", index->path(files[0]));
+	EXPECT_EQ(40, files[0].length);
+	EXPECT_EQ(data.data() + data.find(rootA), files[0].piecesRoot);
+	EXPECT_EQ("dir\\y", index->path(files[1], '\\'));
+	EXPECT_EQ(8, files[1].length);
+	EXPECT_EQ("empty", index->path(files[2]));
+	EXPECT_EQ(0, files[2].length);
+	EXPECT_EQ(nullptr, files[2].piecesRoot);
+}
+
+TEST_F(TorrentV2IndexTests,
+NodesPointIntoDataAndToTheirParents) {
+	std::string data(torrent("3:dird4:file" + file("1", rootA) + "e"));
+
+	auto index = TorrentV2Index::create(data);
+
+	const auto &name = index->node(index->files()[0].node);
+	EXPECT_EQ("file", std::string(name.name, name.nameLength));
+	const auto &dir = index->node(name.parent);
+	EXPECT_EQ(data.data() + data.find("dir"), dir.name);
+	EXPECT_EQ(TorrentV2Index::NO_PARENT, dir.parent);
+}
+
+TEST_F(TorrentV2IndexTests,
+PieceLayersAreFoundByRoots) {
+	std::string hashes(std::string(32, '1') + std::string(32, '2') +
+		std::string(32, '3'));
+	std::string data(torrent(
+		"1:a" + file("40", rootA) + "1:b" + file("8", rootB),
+		"d32:" + rootA + "96:" + hashes + "e"
+	));
+
+	auto index = TorrentV2Index::create(data);
+
+	EXPECT_EQ(1u, index->numOfPieceLayers());
+	auto layer = index->pieceLayer(index->files()[0]);
+	ASSERT_TRUE(layer.found());
+	ASSERT_EQ(3u, layer.numOfHashes);
+	EXPECT_EQ(data.data() + data.find(hashes), layer.hashes);
+	EXPECT_EQ(std::string(32, '2'), std::string(layer.hash(1), 32));
+	EXPECT_FALSE(index->pieceLayer(index->files()[1]).found());
+	EXPECT_FALSE(index->pieceLayer(std::string(32, 'c').data()).found());
+}
+
+TEST_F(TorrentV2IndexTests,
+ManyPieceLayersAreFound) {
+	std::string layers;
+	for (char c = 'A'; c <= 'z'; ++c) {
+		// Roots sharing their first bytes force collisions in the table.
+		layers += "32:" + std::string(16, 'r') + std::string(16, c) +
+			"32:" + std::string(32, c);
+	}
+	std::string data(torrent("1:a" + file("1", rootA), "d" + layers + "e"));
+
+	auto index = TorrentV2Index::create(data);
+
+	EXPECT_EQ(58u, index->numOfPieceLayers());
+	for (char c = 'A'; c <= 'z'; ++c) {
+		std::string root(std::string(16, 'r') + std::string(16, c));
+		auto layer = index->pieceLayer(root.data());
+		ASSERT_TRUE(layer.found());
+		EXPECT_EQ(c, *layer.hash(0));
+	}
+}
+
+TEST_F(TorrentV2IndexTests,
+PieceLayersWithRootsSharingPrefixesAreFound) {
+	// Crafted roots that differ only in their last bytes must not slow down
+	// the indexing (it took seconds when the first bytes selected a slot).
+	const std::size_t numOfLayers = 50000;
+	auto getRoot = [](std::size_t i) {
+		std::string root(HASH_SIZE, 'p');
+		root[HASH_SIZE - 3] = static_cast<char>(i >> 16);
+		root[HASH_SIZE - 2] = static_cast<char>(i >> 8);
+		root[HASH_SIZE - 1] = static_cast<char>(i);
+		return root;
+	};
+	std::string layers;
+	for (std::size_t i = 0; i < numOfLayers; ++i) {
+		layers += "32:" + getRoot(i) + "32:" + rootA;
+	}
+	// The last layer of a repeated root is used.
+	layers += "32:" + getRoot(7) + "32:" + rootB;
+	std::string data(torrent("", "d" + layers + "e"));
+
+	auto index = TorrentV2Index::create(data);
+
+	EXPECT_EQ(numOfLayers, index->numOfPieceLayers());
+	for (std::size_t i = 0; i < numOfLayers; ++i) {
+		ASSERT_TRUE(index->pieceLayer(getRoot(i).data()).found());
+	}
+	EXPECT_EQ('b', *index->pieceLayer(getRoot(7).data()).hash(0));
+	EXPECT_FALSE(index->pieceLayer(getRoot(numOfLayers).data()).found());
+}
+
+TEST_F(TorrentV2IndexTests,
+TorrentWithoutFilesIsValid) {
+	std::string data(torrent(""));
+
+	auto index = TorrentV2Index::create(data);
+
+	EXPECT_TRUE(index->files().empty());
+	EXPECT_EQ(0u, index->numOfPieceLayers());
+	EXPECT_FALSE(index->pieceLayer(rootA.data()).found());
+}
+
+TEST_F(TorrentV2IndexTests,
+DeepFileTreeIsIndexedWithoutRecursion) {
+	std::string tree;
+	for (std::size_t i = 0; i < 100000; ++i) {
+		tree += "1:dd";
+	}
+	tree += "1:f" + file("1", rootA) + std::string(100000, 'e');
+	std::string data(torrent(tree));
+
+	auto index = TorrentV2Index::create(data);
+
+	ASSERT_EQ(1u, index->files().size());
+	EXPECT_EQ(200001u, index->path(index->files()[0]).size());
+}
+
+TEST_F(TorrentV2IndexTests,
+UnknownKeysAreSkipped) {
+	std::string data("d4:infod9:file treed1:a" + file("1", rootA) + "e"
+		"5:otherli1ed1:xi2eee12:meta versioni2e12:piece lengthi16ee"
+		"4:zzzzd1:a1:bee");
+
+	auto index = TorrentV2Index::create(data);
+
+	EXPECT_EQ(1u, index->files().size());
+	EXPECT_EQ(0u, index->numOfPieceLayers());
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenDataAreNotValidBencoding) {
+	std::string data("d4:infod");
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenThereAreCharactersAfterTorrent) {
+	std::string data(torrent("") + "x");
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenInfoIsMissing) {
+	std::string data("d8:announce3:urle");
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenMetaVersionIsNotTwo) {
+	std::string data("d4:infod9:file treede12:meta versioni1e"
+		"12:piece lengthi16eee");
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenPieceLengthIsNotPositive) {
+	std::string data("d4:infod9:file treede12:meta versioni2e"
+		"12:piece lengthi0eee");
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenFileTreeIsMissing) {
+	std::string data("d4:infod12:meta versioni2e12:piece lengthi16eee");
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenFileHasNoName) {
+	std::string data(torrent("0:d6:lengthi0ee"));
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenDirectoryIsNotDictionary) {
+	std::string data(torrent("3:diri1e"));
+
+	EXPECT_THROW(TorrentV2Index::create(data), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenFileLengthIsMissingOrNegative) {
+	std::string missing(torrent("1:ad0:d11:pieces root32:" + rootA + "ee"));
+	std::string negative(torrent("1:a" + file("-1", rootA)));
+
+	EXPECT_THROW(TorrentV2Index::create(missing), InvalidMetainfoError);
+	EXPECT_THROW(TorrentV2Index::create(negative), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenNonEmptyFileHasNoValidRoot) {
+	std::string missing(torrent("1:ad0:d6:lengthi1eee"));
+	std::string shortRoot(torrent("1:ad0:d6:lengthi1e11:pieces root3:abcee"));
+
+	EXPECT_THROW(TorrentV2Index::create(missing), InvalidMetainfoError);
+	EXPECT_THROW(TorrentV2Index::create(shortRoot), InvalidMetainfoError);
+}
+
+TEST_F(TorrentV2IndexTests,
+CreateThrowsExceptionWhenPieceLayerIsInvalid) {
+	std::string shortKey(torrent("", "d3:abc32:" + rootB + "e"));
+	std::string badLength(torrent("", "d32:" + rootA + "31:" +
+		std::string(31, 'x') + "e"));
+
+	EXPECT_THROW(TorrentV2Index::create(shortKey), InvalidMetainfoError);
+	EXPECT_THROW(TorrentV2Index::create(badLength), InvalidMetainfoError);
+}
+
+} // namespace tests
+} // namespace bencoding
@@ -5,6 +5,10 @@
 * @brief     Tests for the utilities.
 */
 
+#include <cstdio>
+#include <string>
+#include <utility>
+
 #include <gtest/gtest.h>
 
 #include "TestUtils.h"
@@ -121,6 +125,24 @@ StrToNumWithInvalidHexadecimalIntegerFails) {
 	EXPECT_EQ(-1, num);
 }
 
+//
+// formatInteger()
+//
+
+TEST_F(UtilsTests,
+FormatIntegerFormatsIntegersCorrectly) {
+	char buffer[MAX_FORMATTED_INTEGER_LENGTH];
+	char *end = buffer + sizeof(buffer);
+
+	EXPECT_EQ("0", std::string(formatInteger(end, 0), end));
+	EXPECT_EQ("13", std::string(formatInteger(end, 13), end));
+	EXPECT_EQ("-13", std::string(formatInteger(end, -13), end));
+	EXPECT_EQ("9223372036854775807",
+		std::string(formatInteger(end, INT64_MAX), end));
+	EXPECT_EQ("-9223372036854775808",
+		std::string(formatInteger(end, INT64_MIN), end));
+}
+
 //
 // readUpTo()
 //
@@ -252,6 +274,48 @@ ReadUntilDoesNotReadAnyDataWhenInputIsAtEOF) {
 	EXPECT_EQ("", readData);
 }
 
+//
+// isDigit()
+//
+
+TEST_F(UtilsTests,
+IsDigitReturnsTrueOnlyForDecimalDigits) {
+	EXPECT_TRUE(isDigit('0'));
+	EXPECT_TRUE(isDigit('9'));
+	EXPECT_FALSE(isDigit('a'));
+	EXPECT_FALSE(isDigit('-'));
+	EXPECT_FALSE(isDigit(static_cast<char>(0xB0)));
+	EXPECT_FALSE(isDigit(EOF));
+}
+
+//
+// loadBigEndian32()
+//
+
+TEST_F(UtilsTests,
+LoadBigEndian32ReadsMostSignificantByteFirst) {
+	const unsigned char bytes[] = {0x12, 0x34, 0xAB, 0xCD};
+
+	EXPECT_EQ(0x1234ABCDu, loadBigEndian32(bytes));
+}
+
+//
+// findField()
+//
+
+TEST_F(UtilsTests,
+FindFieldStartsAtFirstFieldAndWrapsAround) {
+	const std::string fields[] = {"a", "bb", "", "bc"};
+	auto getKey = [](const std::string &field) {
+		return std::make_pair(field.data(), field.size());
+	};
+
+	EXPECT_EQ(3u, findField(fields, 4, 2, "bc", 2, getKey));
+	EXPECT_EQ(0u, findField(fields, 4, 2, "a", 1, getKey));
+	EXPECT_EQ(2u, findField(fields, 4, 3, "", 0, getKey));
+	EXPECT_EQ(4u, findField(fields, 4, 1, "b", 1, getKey));
+}
+
 //
 // replace()
 //
@@ -286,5 +350,151 @@ ReplaceDeletesCharsInStringWhenWithWhatIsEmpty) {
 	EXPECT_EQ("bc", replace("abca", 'a', ""));
 }
 
+//
+// isValidUtf8()
+//
+
+TEST_F(UtilsTests,
+IsValidUtf8ReturnsTrueForValidUtf8) {
+	EXPECT_TRUE(isValidUtf8("", 0));
+	EXPECT_TRUE(isValidUtf8("abcdefghijklmnopqrstuvwxyz", 26));
+	EXPECT_TRUE(isValidUtf8("\xc5\x99", 2));
+	EXPECT_TRUE(isValidUtf8("\xe2\x82\xac", 3));
+	EXPECT_TRUE(isValidUtf8("\xf0\x9f\x98\x80", 4));
+	EXPECT_TRUE(isValidUtf8("abcdefgh\xc5\x99" "abcdefgh", 18));
+}
+
+TEST_F(UtilsTests,
+IsValidUtf8ReturnsFalseForInvalidUtf8) {
+	// Invalid leading byte.
+	EXPECT_FALSE(isValidUtf8("\xff", 1));
+	// Missing continuation byte.
+	EXPECT_FALSE(isValidUtf8("\xc5", 1));
+	EXPECT_FALSE(isValidUtf8("\xc5" "a", 2));
+	// Overlong encoding.
+	EXPECT_FALSE(isValidUtf8("\xc0\xaf", 2));
+	// Surrogate.
+	EXPECT_FALSE(isValidUtf8("\xed\xa0\x80", 3));
+	// Above U+10FFFF.
+	EXPECT_FALSE(isValidUtf8("\xf4\x90\x80\x80", 4));
+	// Invalid byte after a run of ASCII characters.
+	EXPECT_FALSE(isValidUtf8("abcdefghijklmnop\x80", 17));
+}
+
+//
+// appendAsHex()
+//
+
+TEST_F(UtilsTests,
+AppendAsHexAppendsHexadecimalRepresentation) {
+	std::string output("x");
+
+	appendAsHex(output, "\x00\x1f\xab\xff", 4);
+
+	EXPECT_EQ("x001fabff", output);
+}
+
+//
+// appendAsBase64()
+//
+
+TEST_F(UtilsTests,
+AppendAsBase64AppendsBase64Representation) {
+	// Test vectors from RFC 4648.
+	std::string output;
+	appendAsBase64(output, "", 0);
+	EXPECT_EQ("", output);
+
+	output.clear();
+	appendAsBase64(output, "f", 1);
+	EXPECT_EQ("Zg==", output);
+
+	output.clear();
+	appendAsBase64(output, "fo", 2);
+	EXPECT_EQ("Zm8=", output);
+
+	output.clear();
+	appendAsBase64(output, "foo", 3);
+	EXPECT_EQ("Zm9v", output);
+
+	output.clear();
+	appendAsBase64(output, "foobar", 6);
+	EXPECT_EQ("Zm9vYmFy", output);
+}
+
+//
+// findCharToEscapeInJson()
+//
+
+TEST_F(UtilsTests,
+FindCharToEscapeInJsonReturnsEndWhenThereIsNoSuchChar) {
+	const char str[] = "abcdefghijklmnopqrstuvwxyz";
+
+	EXPECT_EQ(str + 26, findCharToEscapeInJson(str, str + 26));
+}
+
+TEST_F(UtilsTests,
+FindCharToEscapeInJsonReturnsFirstQuoteBackslashOrControlChar) {
+	const char str[] = "abcdefghijk\"l\\m\n";
+
+	EXPECT_EQ(str + 11, findCharToEscapeInJson(str, str + 17));
+	EXPECT_EQ(str + 13, findCharToEscapeInJson(str + 12, str + 17));
+	EXPECT_EQ(str + 15, findCharToEscapeInJson(str + 14, str + 17));
+}
+
+//
+// appendFromHex()
+//
+
+TEST_F(UtilsTests,
+AppendFromHexAppendsDecodedBytes) {
+	std::string output("x");
+
+	EXPECT_TRUE(appendFromHex(output, "001fABff", 8));
+
+	EXPECT_EQ(std::string("x\x00\x1f\xab\xff", 5), output);
+}
+
+TEST_F(UtilsTests,
+AppendFromHexReturnsFalseForInvalidRepresentation) {
+	std::string output;
+
+	EXPECT_FALSE(appendFromHex(output, "abc", 3));
+	EXPECT_FALSE(appendFromHex(output, "0g", 2));
+}
+
+//
+// appendFromBase64()
+//
+
+TEST_F(UtilsTests,
+AppendFromBase64AppendsDecodedBytes) {
+	// Test vectors from RFC 4648.
+	std::string output;
+	EXPECT_TRUE(appendFromBase64(output, "", 0));
+	EXPECT_EQ("", output);
+
+	output.clear();
+	EXPECT_TRUE(appendFromBase64(output, "Zg==", 4));
+	EXPECT_EQ("f", output);
+
+	output.clear();
+	EXPECT_TRUE(appendFromBase64(output, "Zm8=", 4));
+	EXPECT_EQ("fo", output);
+
+	output.clear();
+	EXPECT_TRUE(appendFromBase64(output, "Zm9vYmFy", 8));
+	EXPECT_EQ("foobar", output);
+}
+
+TEST_F(UtilsTests,
+AppendFromBase64ReturnsFalseForInvalidRepresentation) {
+	std::string output;
+
+	EXPECT_FALSE(appendFromBase64(output, "Zg=", 3));
+	EXPECT_FALSE(appendFromBase64(output, "Z!==", 4));
+	EXPECT_FALSE(appendFromBase64(output, "Z===", 4));
+}
+
 } // namespace tests
 } // namespace bencoding
@@ -0,0 +1,194 @@
+/**
+* @file      WriterTests.cpp
+* @copyright (c) 2014 by Petr Zemek (s3rvac@gmail.com) and contributors
+* @license   BSD, see the @c LICENSE file for more details
+* @brief     Tests for the Writer class.
+*/
+
+#include <limits>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "BDictionary.h"
+#include "BInteger.h"
+#include "BList.h"
+#include "BString.h"
+#include "Encoder.h"
+#include "Writer.h"
+
+namespace bencoding {
+namespace tests {
+
+using namespace testing;
+
+class WriterTests: public Test {
+protected:
+	WriterTests(): writer(Writer::create()) {}
+
+protected:
+	std::unique_ptr<Writer> writer;
+};
+
+//
+// Dictionary writing.
+//
+
+TEST_F(WriterTests,
+EmptyDictionaryIsCorrectlyWritten) {
+	writer->beginDict().end();
+
+	EXPECT_EQ("de", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+DictionaryWithTwoItemsIsCorrectlyWritten) {
+	writer->beginDict()
+		.key("test1").integer(1)
+		.key("test2").integer(2)
+	.end();
+
+	EXPECT_EQ("d5:test1i1e5:test2i2ee", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+DictionaryWithEmptyKeyIsCorrectlyWritten) {
+	writer->beginDict()
+		.key("").integer(1)
+		.key("a").integer(2)
+	.end();
+
+	EXPECT_EQ("d0:i1e1:ai2ee", writer->encodedData());
+}
+
+//
+// Integer writing.
+//
+
+TEST_F(WriterTests,
+ZeroIsCorrectlyWritten) {
+	writer->integer(0);
+
+	EXPECT_EQ("i0e", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+NegativeIntegerIsCorrectlyWritten) {
+	writer->integer(-13);
+
+	EXPECT_EQ("i-13e", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+ExtremeIntegersAreCorrectlyWritten) {
+	auto min = std::numeric_limits<BInteger::ValueType>::min();
+	auto max = std::numeric_limits<BInteger::ValueType>::max();
+
+	writer->beginList().integer(min).integer(max).end();
+
+	EXPECT_EQ("li" + std::to_string(min) + "ei" + std::to_string(max) + "ee",
+		writer->encodedData());
+}
+
+//
+// List writing.
+//
+
+TEST_F(WriterTests,
+EmptyListIsCorrectlyWritten) {
+	writer->beginList().end();
+
+	EXPECT_EQ("le", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+NestedListsAreCorrectlyWritten) {
+	writer->beginList()
+		.beginList().integer(1).end()
+		.beginList().end()
+	.end();
+
+	EXPECT_EQ("lli1eelee", writer->encodedData());
+}
+
+//
+// String writing.
+//
+
+TEST_F(WriterTests,
+StringIsCorrectlyWritten) {
+	writer->string("test");
+
+	EXPECT_EQ("4:test", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+StringWithNullCharactersIsCorrectlyWritten) {
+	writer->string(std::string("a\0b", 3));
+
+	EXPECT_EQ(std::string("3:a\0b", 5), writer->encodedData());
+}
+
+//
+// Other.
+//
+
+TEST_F(WriterTests,
+RawValueIsWrittenAsIs) {
+	writer->beginList().raw("i1e").raw("4:test").end();
+
+	EXPECT_EQ("li1e4:teste", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+IsCompleteReturnsTrueOnlyAfterTopLevelValueIsWritten) {
+	EXPECT_FALSE(writer->isComplete());
+	writer->beginList();
+	EXPECT_FALSE(writer->isComplete());
+	writer->integer(1);
+	EXPECT_FALSE(writer->isComplete());
+	writer->end();
+	EXPECT_TRUE(writer->isComplete());
+}
+
+TEST_F(WriterTests,
+ClearAllowsToWriteAnotherValue) {
+	writer->integer(1);
+	writer->clear();
+	writer->integer(2);
+
+	EXPECT_EQ("i2e", writer->encodedData());
+}
+
+TEST_F(WriterTests,
+WriterCreatedWithStreamWritesIntoStream) {
+	std::ostringstream output;
+	auto streamWriter = Writer::create(output);
+
+	streamWriter->beginDict().key("a").string("b").end();
+
+	EXPECT_EQ("d1:a1:be", output.str());
+	EXPECT_EQ("", streamWriter->encodedData());
+}
+
+TEST_F(WriterTests,
+WrittenDataAreEqualToEncodedDataOfEquivalentTree) {
+	std::shared_ptr<BDictionary> bDictionary(BDictionary::create());
+	(*bDictionary)[BString::create("a")] = BInteger::create(-1);
+	(*bDictionary)[BString::create("b")] = BList::create({
+		BString::create("x"), BInteger::create(2)
+	});
+
+	writer->beginDict()
+		.key("a").integer(-1)
+		.key("b").beginList()
+			.string("x")
+			.integer(2)
+		.end()
+	.end();
+
+	EXPECT_EQ(encode(bDictionary), writer->encodedData());
+}
+
+} // namespace tests
+} // namespace bencoding